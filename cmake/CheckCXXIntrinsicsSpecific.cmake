@@ -74,5 +74,43 @@ if(SEAL_USE_INTRIN)
         SEAL__SUBBORROW_U64_FOUND
     )
 
+    # Check for AVX2 and AVX-512 intrinsics callable from functions compiled for those targets only
+    if(MSVC)
+        set(SEAL_TARGET_AVX2_CHECK "")
+        set(SEAL_TARGET_AVX512_CHECK "")
+    else()
+        set(SEAL_TARGET_AVX2_CHECK "__attribute__((target(\"avx2,fma\")))")
+        set(SEAL_TARGET_AVX512_CHECK "__attribute__((target(\"avx512f,avx512dq\")))")
+    endif()
+
+    # Check for AVX2 and FMA
+    check_cxx_source_compiles("
+        #include <${SEAL_INTRIN_HEADER}>
+        ${SEAL_TARGET_AVX2_CHECK} int f(unsigned long long a) {
+            __m256i x = _mm256_set1_epi64x(static_cast<long long>(a));
+            __m256d y = _mm256_fmsub_pd(_mm256_castsi256_pd(x), _mm256_castsi256_pd(x), _mm256_castsi256_pd(x));
+            x = _mm256_add_epi64(_mm256_mul_epu32(x, x), _mm256_castpd_si256(y));
+            return _mm256_extract_epi32(_mm256_unpacklo_epi64(x, _mm256_permute4x64_epi64(x, 0)), 0);
+        }
+        int main() {
+            return f(0);
+        }"
+        SEAL_AVX2_FOUND
+    )
+
+    # Check for AVX-512 (F and DQ)
+    check_cxx_source_compiles("
+        #include <${SEAL_INTRIN_HEADER}>
+        ${SEAL_TARGET_AVX512_CHECK} int f(unsigned long long a) {
+            __m512i x = _mm512_set1_epi64(static_cast<long long>(a));
+            x = _mm512_min_epu64(_mm512_mullo_epi64(x, x), _mm512_mul_epu32(x, x));
+            return static_cast<int>(_mm512_reduce_add_epi64(_mm512_permutex2var_epi64(x, x, x)));
+        }
+        int main() {
+            return f(0);
+        }"
+        SEAL_AVX512_FOUND
+    )
+
     cmake_pop_check_state()
 endif()
@@ -35,6 +35,11 @@ namespace sealbench
         parms_bfv.set_plain_modulus(PlainModulus::Batching(parms.first, 20));
         shared_ptr<BMEnv> bm_env_bfv = bm_env_map.find(parms_bfv)->second;
 
+        // For BFV benchmark cases with HPS multiplication
+        EncryptionParameters parms_bfv_hps = parms_bfv;
+        parms_bfv_hps.set_mul_method(mul_method_type::hps);
+        shared_ptr<BMEnv> bm_env_bfv_hps = bm_env_map.find(parms_bfv_hps)->second;
+
         // For BGV benchmark cases (default to 20-bit plain_modulus)
         EncryptionParameters parms_bgv(scheme_type::bgv);
         parms_bgv.set_poly_modulus_degree(parms.first);
@@ -77,7 +82,10 @@ namespace sealbench
         SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateSubPt, bm_bfv_sub_pt, bm_env_bfv);
         SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateMulCt, bm_bfv_mul_ct, bm_env_bfv);
         SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateMulPt, bm_bfv_mul_pt, bm_env_bfv);
+        SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateMulPtNTT, bm_bfv_mul_pt_ntt, bm_env_bfv);
         SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateSquare, bm_bfv_square, bm_env_bfv);
+        SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateMulCtHPS, bm_bfv_mul_ct, bm_env_bfv_hps);
+        SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateSquareHPS, bm_bfv_square, bm_env_bfv_hps);
         if (bm_env_bfv->context().first_context_data()->parms().coeff_modulus().size() > 1)
         {
             SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateModSwitchInplace, bm_bfv_modswitch_inplace, bm_env_bfv);
@@ -86,6 +94,7 @@ namespace sealbench
         {
             SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateRelinInplace, bm_bfv_relin_inplace, bm_env_bfv);
             SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateRotateRows, bm_bfv_rotate_rows, bm_env_bfv);
+            SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateRotateRowsNTT, bm_bfv_rotate_rows_ntt, bm_env_bfv);
             SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateRotateCols, bm_bfv_rotate_cols, bm_env_bfv);
         }
 
@@ -149,6 +158,14 @@ namespace sealbench
         SEAL_BENCHMARK_REGISTER(UTIL, n, 0, NTTInverseLowLevel, bm_util_ntt_inverse_low_level, bm_env_bfv);
         SEAL_BENCHMARK_REGISTER(UTIL, n, 0, NTTForwardLowLevelLazy, bm_util_ntt_forward_low_level_lazy, bm_env_bfv);
         SEAL_BENCHMARK_REGISTER(UTIL, n, 0, NTTInverseLowLevelLazy, bm_util_ntt_inverse_low_level_lazy, bm_env_bfv);
+        SEAL_BENCHMARK_REGISTER(UTIL, n, log_q, BaseConvert, bm_util_base_convert, bm_env_bfv);
+        if (bm_env_ckks->context().using_keyswitching())
+        {
+            SEAL_BENCHMARK_REGISTER(
+                UTIL, n, log_q, KeySwitchDefaultPool, bm_util_mempool_keyswitch, bm_env_ckks, false);
+            SEAL_BENCHMARK_REGISTER(
+                UTIL, n, log_q, KeySwitchHugePagePool, bm_util_mempool_keyswitch, bm_env_ckks, true);
+        }
     }
 
 } // namespace sealbench
@@ -181,6 +198,8 @@ int main(int argc, char **argv)
         parms_bfv.set_poly_modulus_degree(i.first);
         parms_bfv.set_coeff_modulus(i.second);
         parms_bfv.set_plain_modulus(PlainModulus::Batching(i.first, 20));
+        EncryptionParameters parms_bfv_hps = parms_bfv;
+        parms_bfv_hps.set_mul_method(mul_method_type::hps);
         EncryptionParameters parms_bgv(scheme_type::bgv);
         parms_bgv.set_poly_modulus_degree(i.first);
         parms_bgv.set_coeff_modulus(i.second);
@@ -193,6 +212,10 @@ int main(int argc, char **argv)
         {
             throw invalid_argument("duplicate parameter sets");
         }
+        if (bm_env_map.emplace(make_pair(parms_bfv_hps, make_shared<BMEnv>(parms_bfv_hps))).second == false)
+        {
+            throw invalid_argument("duplicate parameter sets");
+        }
         if (bm_env_map.emplace(make_pair(parms_bgv, make_shared<BMEnv>(parms_bgv))).second == false)
         {
             throw invalid_argument("duplicate parameter sets");
@@ -213,6 +236,13 @@ int main(int argc, char **argv)
         sealbench::register_bm_family(i, bm_env_map);
     }
 
+    // The memory pool benchmark does not depend on the parameters; it runs on increasing numbers of threads.
+    RegisterBenchmark("UTIL / MemoryPoolContention", sealbench::bm_util_mempool_contention)
+        ->ThreadRange(1, 64)
+        ->UseRealTime();
+    RegisterBenchmark("UTIL / MemoryPoolRequestSharedPool", sealbench::bm_util_mempool_request, false);
+    RegisterBenchmark("UTIL / MemoryPoolRequestArena", sealbench::bm_util_mempool_request, true);
+
     RunSpecifiedBenchmarks();
 
     // After running all benchmark cases, we print again the total memory consumption by SEAL memory pool.
@@ -356,6 +356,14 @@ namespace sealbench
     void bm_util_ntt_forward_low_level_lazy(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_util_ntt_inverse_low_level_lazy(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
 
+    // RNS benchmark cases
+    void bm_util_base_convert(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
+
+    // Memory pool benchmark cases
+    void bm_util_mempool_contention(benchmark::State &state);
+    void bm_util_mempool_request(benchmark::State &state, bool arena);
+    void bm_util_mempool_keyswitch(benchmark::State &state, std::shared_ptr<BMEnv> bm_env, bool huge_pages);
+
     // KeyGen benchmark cases
     void bm_keygen_secret(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_keygen_public(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
@@ -375,10 +383,12 @@ namespace sealbench
     void bm_bfv_sub_pt(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_bfv_mul_ct(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_bfv_mul_pt(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
+    void bm_bfv_mul_pt_ntt(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_bfv_square(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_bfv_modswitch_inplace(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_bfv_relin_inplace(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_bfv_rotate_rows(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
+    void bm_bfv_rotate_rows_ntt(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_bfv_rotate_cols(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
 
     // BGV-specific benchmark cases
@@ -186,6 +186,22 @@ namespace sealbench
         }
     }
 
+    void bm_bfv_mul_pt_ntt(State &state, shared_ptr<BMEnv> bm_env)
+    {
+        vector<Ciphertext> &ct = bm_env->ct();
+        Plaintext &pt = bm_env->pt()[0];
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            bm_env->randomize_ct_bfv(ct[0]);
+            ct[0].is_ntt_form() = true;
+            bm_env->randomize_pt_bfv(pt);
+
+            state.ResumeTiming();
+            bm_env->evaluator()->multiply_plain(ct[0], pt, ct[2]);
+        }
+    }
+
     void bm_bfv_square(State &state, shared_ptr<BMEnv> bm_env)
     {
         vector<Ciphertext> &ct = bm_env->ct();
@@ -240,6 +256,20 @@ namespace sealbench
         }
     }
 
+    void bm_bfv_rotate_rows_ntt(State &state, shared_ptr<BMEnv> bm_env)
+    {
+        vector<Ciphertext> &ct = bm_env->ct();
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            bm_env->randomize_ct_bfv(ct[0]);
+            ct[0].is_ntt_form() = true;
+
+            state.ResumeTiming();
+            bm_env->evaluator()->rotate_rows(ct[0], 1, bm_env->glk(), ct[2]);
+        }
+    }
+
     void bm_bfv_rotate_cols(State &state, shared_ptr<BMEnv> bm_env)
     {
         vector<Ciphertext> &ct = bm_env->ct();
@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/seal.h"
+#include "seal/util/pointer.h"
+#include "bench.h"
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace benchmark;
+using namespace sealbench;
+using namespace seal;
+using namespace std;
+
+/**
+This file defines benchmarks for the memory pool.
+*/
+
+namespace sealbench
+{
+    namespace
+    {
+        /**
+        Counts data TLB load misses of the calling thread with Linux perf events. Where perf events are not
+        available, e.g., in containers, the counter is invalid and reads zero.
+        */
+        class DTLBMissCounter
+        {
+        public:
+            DTLBMissCounter()
+            {
+#if defined(__linux__)
+                perf_event_attr attr{};
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+            }
+
+            ~DTLBMissCounter()
+            {
+#if defined(__linux__)
+                if (fd_ >= 0)
+                {
+                    close(fd_);
+                }
+#endif
+            }
+
+            bool is_valid() const
+            {
+                return fd_ >= 0;
+            }
+
+            void start()
+            {
+#if defined(__linux__)
+                if (fd_ >= 0)
+                {
+                    ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+                }
+#endif
+            }
+
+            void stop()
+            {
+#if defined(__linux__)
+                if (fd_ >= 0)
+                {
+                    ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+                }
+#endif
+            }
+
+            uint64_t count() const
+            {
+                uint64_t value = 0;
+#if defined(__linux__)
+                if (fd_ >= 0 && read(fd_, &value, sizeof(value)) != sizeof(value))
+                {
+                    value = 0;
+                }
+#endif
+                return value;
+            }
+
+        private:
+            int fd_ = -1;
+        };
+    } // namespace
+
+    void bm_util_mempool_contention(State &state)
+    {
+        // Every thread allocates and releases a few buffers from the global memory pool, as evaluation functions on
+        // small ciphertexts do. The time per iteration grows with the thread count if the pool serializes threads.
+        MemoryPoolHandle pool = seal::MemoryManager::GetPool(mm_prof_opt::mm_force_global);
+        for (auto _ : state)
+        {
+            auto buffer1(util::allocate_uint(4096, pool));
+            auto buffer2(util::allocate_uint(8192, pool));
+            auto buffer3(util::allocate_uint(4096, pool));
+            DoNotOptimize(buffer1.get());
+            DoNotOptimize(buffer2.get());
+            DoNotOptimize(buffer3.get());
+        }
+    }
+
+    void bm_util_mempool_request(State &state, bool arena)
+    {
+        // A request allocates many temporaries of a few sizes, keeps all of them, and then discards them together.
+        // A thread-safe pool serves them from its size classes; an arena, rewound after every request, serves them
+        // by moving a pointer.
+        constexpr size_t temporary_count = 256;
+        const size_t uint64_counts[]{ 2048, 4096, 8192, 16384 };
+        MemoryPoolHandle pool = arena ? MemoryPoolHandle::Arena() : MemoryPoolHandle::New();
+        vector<util::Pointer<uint64_t>> temporaries(temporary_count);
+        for (auto _ : state)
+        {
+            unique_ptr<MMProf> request(arena ? static_cast<MMProf *>(new MMProfArena(pool)) : new MMProfFixed(pool));
+            MemoryPoolHandle request_pool = request->get_pool(mm_prof_opt::mm_default);
+            for (size_t i = 0; i < temporary_count; i++)
+            {
+                temporaries[i] = util::allocate_uint(uint64_counts[i % 4], request_pool);
+                DoNotOptimize(temporaries[i].get());
+            }
+            for (auto &temporary : temporaries)
+            {
+                temporary.release();
+            }
+        }
+    }
+
+    void bm_util_mempool_keyswitch(State &state, shared_ptr<BMEnv> bm_env, bool huge_pages)
+    {
+        // Relinearization with the ciphertext and all temporaries in a memory pool of its own. With huge pages, the
+        // large buffers of key switching need far fewer TLB entries; the counter shows the data TLB misses per
+        // iteration where the system allows perf events.
+        MemoryPoolHandle pool = MemoryPoolHandle::New(false, huge_pages);
+        Ciphertext ct(bm_env->context(), pool);
+        DTLBMissCounter counter;
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            ct.resize(bm_env->context(), size_t(3));
+            bm_env->randomize_ct_ckks(ct);
+
+            state.ResumeTiming();
+            counter.start();
+            bm_env->evaluator()->relinearize_inplace(ct, bm_env->rlk(), pool);
+            counter.stop();
+        }
+        if (counter.is_valid())
+        {
+            state.counters["dTLB-load-misses"] =
+                Counter(static_cast<double>(counter.count()), Counter::kAvgIterations);
+        }
+    }
+} // namespace sealbench
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/seal.h"
+#include "seal/util/rns.h"
+#include "bench.h"
+
+using namespace benchmark;
+using namespace sealbench;
+using namespace seal;
+using namespace seal::util;
+using namespace std;
+
+/**
+This file defines benchmarks for RNS base conversion.
+*/
+
+namespace sealbench
+{
+    void bm_util_base_convert(State &state, shared_ptr<BMEnv> bm_env)
+    {
+        auto context_data = bm_env->context().first_context_data();
+        auto rns_tool = context_data->rns_tool();
+        size_t coeff_count = context_data->parms().poly_modulus_degree();
+        MemoryPoolHandle pool = seal::MemoryManager::GetPool();
+        BaseConverter converter(*rns_tool->base_q(), *rns_tool->base_Bsk(), pool);
+        auto destination(allocate_poly(coeff_count, rns_tool->base_Bsk()->size(), pool));
+        vector<Ciphertext> &ct = bm_env->ct();
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            bm_env->randomize_ct_bfv(ct[0]);
+
+            state.ResumeTiming();
+            converter.fast_convert_array(
+                ConstRNSIter(ct[0].data(), coeff_count), RNSIter(destination.get(), coeff_count), pool);
+        }
+    }
+} // namespace sealbench
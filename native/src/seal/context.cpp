@@ -70,6 +70,9 @@ namespace seal
         case error_type::failed_creating_rns_tool:
             return "failed_creating_rns_tool";
 
+        case error_type::invalid_special_prime_count:
+            return "invalid_special_prime_count";
+
         default:
             return "invalid parameter_error";
         }
@@ -127,6 +130,9 @@ namespace seal
         case error_type::failed_creating_rns_tool:
             return "RNSTool cannot be constructed";
 
+        case error_type::invalid_special_prime_count:
+            return "coeff_modulus's primes' count is not larger than special_prime_count";
+
         default:
             return "invalid parameter_error";
         }
@@ -394,8 +400,9 @@ namespace seal
         //   (2) cannot find inverse of punctured products in auxiliary base
         try
         {
-            context_data.rns_tool_ =
-                allocate<RNSTool>(pool_, poly_modulus_degree, *coeff_modulus_base, plain_modulus, pool_);
+            context_data.rns_tool_ = allocate<RNSTool>(
+                pool_, poly_modulus_degree, *coeff_modulus_base, plain_modulus, pool_,
+                parms.mul_method() == mul_method_type::hps);
         }
         catch (const exception &)
         {
@@ -419,12 +426,12 @@ namespace seal
         return context_data;
     }
 
-    parms_id_type SEALContext::create_next_context_data(const parms_id_type &prev_parms_id)
+    parms_id_type SEALContext::create_next_context_data(const parms_id_type &prev_parms_id, size_t drop_count)
     {
-        // Create the next set of parameters by removing last modulus
+        // Create the next set of parameters by removing last drop_count moduli
         auto next_parms = context_data_map_.at(prev_parms_id)->parms_;
         auto next_coeff_modulus = next_parms.coeff_modulus();
-        next_coeff_modulus.pop_back();
+        next_coeff_modulus.resize(next_coeff_modulus.size() - drop_count);
         next_parms.set_coeff_modulus(next_coeff_modulus);
         auto next_parms_id = next_parms.parms_id();
 
@@ -473,17 +480,26 @@ namespace seal
         context_data_map_.emplace(make_pair(parms.parms_id(), make_shared<const ContextData>(validate(parms))));
         key_parms_id_ = parms.parms_id();
 
+        // With several special primes there must be primes left for the data levels
+        size_t special_prime_count = parms.special_prime_count();
+        if (context_data_map_.at(key_parms_id_)->qualifiers_.parameters_set() && special_prime_count > 1 &&
+            parms.coeff_modulus().size() <= special_prime_count)
+        {
+            const_pointer_cast<ContextData>(context_data_map_.at(key_parms_id_))->qualifiers_.parameter_error =
+                error_type::invalid_special_prime_count;
+        }
+
         // Then create first_parms_id_ if the parameters are valid and there is
         // more than one modulus in coeff_modulus. This is equivalent to expanding
-        // the chain by one step. Otherwise, we set first_parms_id_ to equal
-        // key_parms_id_.
+        // the chain by dropping the special primes. Otherwise, we set first_parms_id_
+        // to equal key_parms_id_.
         if (!context_data_map_.at(key_parms_id_)->qualifiers_.parameters_set() || parms.coeff_modulus().size() == 1)
         {
             first_parms_id_ = key_parms_id_;
         }
         else
         {
-            auto next_parms_id = create_next_context_data(key_parms_id_);
+            auto next_parms_id = create_next_context_data(key_parms_id_, special_prime_count);
             first_parms_id_ = (next_parms_id == parms_id_zero) ? key_parms_id_ : next_parms_id;
         }
 
@@ -510,6 +526,28 @@ namespace seal
             }
         }
 
+        // Create the key switching pre-computations for each data level
+        if (using_keyswitching_)
+        {
+            auto &key_modulus = parms.coeff_modulus();
+            size_t decomp_modulus_size = key_modulus.size() - special_prime_count;
+            size_t digit_count = parms.decomposition_digit_count();
+            size_t digit_size = digit_count ? (decomp_modulus_size + digit_count - 1) / digit_count : size_t(1);
+            vector<Modulus> special_primes(
+                key_modulus.begin() + static_cast<ptrdiff_t>(decomp_modulus_size), key_modulus.end());
+            RNSBase base_p(special_primes, pool_);
+            Modulus plain_modulus = (parms.scheme() == scheme_type::bgv) ? parms.plain_modulus() : Modulus();
+
+            auto context_data_ptr = context_data_map_.at(first_parms_id_);
+            while (context_data_ptr)
+            {
+                auto &coeff_modulus = context_data_ptr->parms().coeff_modulus();
+                const_pointer_cast<ContextData>(context_data_ptr)->kswitch_tool_ = allocate<KSwitchTool>(
+                    pool_, RNSBase(coeff_modulus, pool_), base_p, digit_size, plain_modulus, pool_);
+                context_data_ptr = context_data_ptr->next_context_data_;
+            }
+        }
+
         // Set the chain_index for each context_data
         size_t parms_count = context_data_map_.size();
         auto context_data_ptr = context_data_map_.at(key_parms_id_);
@@ -112,6 +112,11 @@ namespace seal
             RNSTool cannot be constructed
             */
             failed_creating_rns_tool = 14,
+
+            /**
+            coeff_modulus does not have more primes than special_prime_count
+            */
+            invalid_special_prime_count = 15,
         };
 
         /**
@@ -319,6 +324,15 @@ namespace seal
                 return rns_tool_.get();
             }
 
+            /**
+            Returns a constant pointer to the KSwitchTool, which holds the pre-computations for key switching at this
+            level. The result is nullptr at the key level and if key switching is not supported.
+            */
+            SEAL_NODISCARD inline const util::KSwitchTool *kswitch_tool() const noexcept
+            {
+                return kswitch_tool_.get();
+            }
+
             /**
             Returns a constant pointer to the NTT tables.
             */
@@ -451,6 +465,8 @@ namespace seal
 
             util::Pointer<util::RNSTool> rns_tool_;
 
+            util::Pointer<util::KSwitchTool> kswitch_tool_;
+
             util::Pointer<util::NTTTables> small_ntt_tables_;
 
             util::Pointer<util::NTTTables> plain_ntt_tables_;
@@ -650,12 +666,12 @@ namespace seal
         ContextData validate(EncryptionParameters parms);
 
         /**
-        Create the next context_data by dropping the last element from coeff_modulus.
-        If the new encryption parameters are not valid, returns parms_id_zero.
-        Otherwise, returns the parms_id of the next parameter and appends the next
-        context_data to the chain.
+        Create the next context_data by dropping the last drop_count elements from
+        coeff_modulus. If the new encryption parameters are not valid, returns
+        parms_id_zero. Otherwise, returns the parms_id of the next parameter and
+        appends the next context_data to the chain.
         */
-        parms_id_type create_next_context_data(const parms_id_type &prev_parms);
+        parms_id_type create_next_context_data(const parms_id_type &prev_parms, std::size_t drop_count = 1);
 
         MemoryPoolHandle pool_;
 
@@ -113,11 +113,6 @@ namespace seal
 
     void Decryptor::bfv_decrypt(const Ciphertext &encrypted, Plaintext &destination, MemoryPoolHandle pool)
     {
-        if (encrypted.is_ntt_form())
-        {
-            throw invalid_argument("encrypted cannot be in NTT form");
-        }
-
         auto &context_data = *context_.get_context_data(encrypted.parms_id());
         auto &parms = context_data.parms();
         auto &coeff_modulus = parms.coeff_modulus();
@@ -137,6 +132,12 @@ namespace seal
         // The secret key powers are already NTT transformed.
         dot_product_ct_sk_array(encrypted, tmp_dest_modq, pool_);
 
+        // The scaling needs the result in normal form
+        if (encrypted.is_ntt_form())
+        {
+            inverse_ntt_negacyclic_harvey(tmp_dest_modq, coeff_modulus_size, iter(context_data.small_ntt_tables()));
+        }
+
         // Allocate a full size destination to write to
         destination.parms_id() = parms_id_zero;
         destination.resize(coeff_count);
@@ -399,10 +400,6 @@ namespace seal
         {
             throw logic_error("unsupported scheme");
         }
-        if (scheme == scheme_type::bfv && encrypted.is_ntt_form())
-        {
-            throw invalid_argument("BFV encrypted cannot be in NTT form");
-        }
         if (scheme == scheme_type::bgv && !encrypted.is_ntt_form())
         {
             throw invalid_argument("BGV encrypted must be in NTT form");
@@ -431,7 +428,7 @@ namespace seal
         // The secret key powers are already NTT transformed.
         dot_product_ct_sk_array(encrypted, noise_poly, pool_);
 
-        if (scheme == scheme_type::bgv)
+        if (encrypted.is_ntt_form())
         {
             inverse_ntt_negacyclic_harvey(noise_poly, coeff_modulus_size, ntt_tables);
         }
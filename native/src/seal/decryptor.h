@@ -45,7 +45,7 @@ namespace seal
     ciphertexts should remain by default in NTT form. We call these scheme-specific
     NTT states the "default NTT form". Decryption requires the input ciphertexts
     to be in the default NTT form, and will throw an exception if this is not the
-    case.
+    case. BFV ciphertexts are the exception: they are decrypted in either form.
     */
     class Decryptor
     {
@@ -70,6 +70,7 @@ namespace seal
         @throws std::invalid_argument if encrypted is not valid for the encryption
         parameters
         @throws std::invalid_argument if encrypted is not in the default NTT form
+        and the scheme is not BFV
         */
         void decrypt(const Ciphertext &encrypted, Plaintext &destination);
 
@@ -95,7 +96,8 @@ namespace seal
         @throws std::logic_error if the scheme is not BFV/BGV
         @throws std::invalid_argument if encrypted is not valid for the encryption
         parameters
-        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if the scheme is BGV and encrypted is not in
+        NTT form
         */
         SEAL_NODISCARD int invariant_noise_budget(const Ciphertext &encrypted);
 
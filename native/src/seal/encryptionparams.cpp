@@ -24,6 +24,17 @@ namespace seal
             uint64_t coeff_modulus_size64 = static_cast<uint64_t>(coeff_modulus_.size());
             uint8_t scheme = static_cast<uint8_t>(scheme_);
 
+            // Non-default key switching parameters are flagged in the scheme byte and saved after plain_modulus, so
+            // that the default layout is unchanged
+            if (!has_default_key_switching())
+            {
+                scheme |= key_switching_flag;
+            }
+            if (mul_method_ != mul_method_type::behz)
+            {
+                scheme |= mul_method_flag;
+            }
+
             stream.write(reinterpret_cast<const char *>(&scheme), sizeof(uint8_t));
             stream.write(reinterpret_cast<const char *>(&poly_modulus_degree64), sizeof(uint64_t));
             stream.write(reinterpret_cast<const char *>(&coeff_modulus_size64), sizeof(uint64_t));
@@ -34,6 +45,19 @@ namespace seal
 
             // Only BFV and BGV uses plain_modulus but save it in any case for simplicity
             plain_modulus_.save(stream, compr_mode_type::none);
+
+            if (!has_default_key_switching())
+            {
+                uint64_t special_prime_count64 = static_cast<uint64_t>(special_prime_count_);
+                uint64_t decomposition_digit_count64 = static_cast<uint64_t>(decomposition_digit_count_);
+                stream.write(reinterpret_cast<const char *>(&special_prime_count64), sizeof(uint64_t));
+                stream.write(reinterpret_cast<const char *>(&decomposition_digit_count64), sizeof(uint64_t));
+            }
+
+            if (mul_method_ != mul_method_type::behz)
+            {
+                stream.write(reinterpret_cast<const char *>(&mul_method_), sizeof(mul_method_type));
+            }
         }
         catch (const ios_base::failure &)
         {
@@ -59,6 +83,9 @@ namespace seal
             // Read the scheme identifier
             uint8_t scheme;
             stream.read(reinterpret_cast<char *>(&scheme), sizeof(uint8_t));
+            bool has_key_switching = (scheme & key_switching_flag) != 0;
+            bool has_mul_method = (scheme & mul_method_flag) != 0;
+            scheme &= static_cast<uint8_t>(~(key_switching_flag | mul_method_flag));
 
             // This constructor will throw if scheme is invalid
             EncryptionParameters parms(scheme);
@@ -95,6 +122,31 @@ namespace seal
             Modulus plain_modulus;
             plain_modulus.load(stream);
 
+            // Read the key switching parameters if present
+            uint64_t special_prime_count64 = 1;
+            uint64_t decomposition_digit_count64 = 0;
+            if (has_key_switching)
+            {
+                stream.read(reinterpret_cast<char *>(&special_prime_count64), sizeof(uint64_t));
+                stream.read(reinterpret_cast<char *>(&decomposition_digit_count64), sizeof(uint64_t));
+                if (!special_prime_count64 || special_prime_count64 > SEAL_COEFF_MOD_COUNT_MAX ||
+                    decomposition_digit_count64 > SEAL_COEFF_MOD_COUNT_MAX)
+                {
+                    throw logic_error("key switching parameters are invalid");
+                }
+            }
+
+            // Read the multiplication method if present
+            uint8_t mul_method = static_cast<uint8_t>(mul_method_type::behz);
+            if (has_mul_method)
+            {
+                stream.read(reinterpret_cast<char *>(&mul_method), sizeof(uint8_t));
+                if (!is_valid_mul_method(mul_method))
+                {
+                    throw logic_error("mul_method is invalid");
+                }
+            }
+
             // Supposedly everything worked so set the values of member variables
             parms.set_poly_modulus_degree(safe_cast<size_t>(poly_modulus_degree64));
             parms.set_coeff_modulus(coeff_modulus);
@@ -103,6 +155,15 @@ namespace seal
             // other schemes it is zero
             parms.set_plain_modulus(plain_modulus);
 
+            if (has_key_switching)
+            {
+                parms.set_special_prime_count(safe_cast<size_t>(special_prime_count64));
+                parms.set_decomposition_digit_count(safe_cast<size_t>(decomposition_digit_count64));
+            }
+
+            // set_mul_method checks that only BFV uses a non-default method
+            parms.set_mul_method(static_cast<mul_method_type>(mul_method));
+
             // Set the loaded parameters
             swap(*this, parms);
 
@@ -128,7 +189,9 @@ namespace seal
         size_t total_uint64_count = add_safe(
             size_t(1), // scheme
             size_t(1), // poly_modulus_degree
-            coeff_modulus_size, plain_modulus_.uint64_count());
+            coeff_modulus_size, plain_modulus_.uint64_count(),
+            has_default_key_switching() ? size_t(0) : size_t(2), // special_prime_count, decomposition_digit_count
+            mul_method_ == mul_method_type::behz ? size_t(0) : size_t(1)); // mul_method
 
         auto param_data(allocate_uint(total_uint64_count, pool_));
         uint64_t *param_data_ptr = param_data.get();
@@ -147,6 +210,19 @@ namespace seal
         set_uint(plain_modulus_.data(), plain_modulus_.uint64_count(), param_data_ptr);
         param_data_ptr += plain_modulus_.uint64_count();
 
+        // The default key switching parameters are not hashed, so they leave parms_id unchanged
+        if (!has_default_key_switching())
+        {
+            *param_data_ptr++ = static_cast<uint64_t>(special_prime_count_);
+            *param_data_ptr++ = static_cast<uint64_t>(decomposition_digit_count_);
+        }
+
+        // Likewise the default multiplication method is not hashed
+        if (mul_method_ != mul_method_type::behz)
+        {
+            *param_data_ptr++ = static_cast<uint64_t>(mul_method_);
+        }
+
         HashFunction::hash(param_data.get(), total_uint64_count, parms_id_);
 
         // Did we somehow manage to get a zero block as result? This is reserved for
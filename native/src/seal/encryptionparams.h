@@ -37,6 +37,18 @@ namespace seal
         bgv = 0x3
     };
 
+    /**
+    Describes the algorithm used to multiply BFV ciphertexts.
+    */
+    enum class mul_method_type : std::uint8_t
+    {
+        // Bajard-Eynard-Hasan-Zucca RNS multiplication with Montgomery reduction and Shenoy-Kumaresan conversion
+        behz = 0x0,
+
+        // Halevi-Polyakov-Shoup RNS multiplication with floating-point assisted exact base conversion
+        hps = 0x1
+    };
+
     /**
     The data type to store unique identifiers of encryption parameters.
     */
@@ -253,6 +265,101 @@ namespace seal
             set_plain_modulus(Modulus(plain_modulus));
         }
 
+        /**
+        Sets the number of special primes used in key switching. The last
+        special_prime_count primes of the coefficient modulus form the special
+        modulus P: they are present only at the key level, so the first data
+        level drops all of them at once. Key switching extends each digit of the
+        decomposition to P, multiplies with the key switching keys, and divides
+        the result by P. A larger special modulus reduces the noise added by key
+        switching and allows larger decomposition digits, but leaves less of the
+        coefficient modulus for computation. The default is a single special prime.
+
+        @param[in] special_prime_count The new number of special primes
+        @throws std::logic_error if a valid scheme is not set
+        @throws std::invalid_argument if special_prime_count is zero or larger
+        than SEAL_COEFF_MOD_COUNT_MAX
+        */
+        inline void set_special_prime_count(std::size_t special_prime_count)
+        {
+            if (scheme_ == scheme_type::none)
+            {
+                throw std::logic_error("special_prime_count is not supported for this scheme");
+            }
+            if (!special_prime_count || special_prime_count > SEAL_COEFF_MOD_COUNT_MAX)
+            {
+                throw std::invalid_argument("special_prime_count is invalid");
+            }
+
+            special_prime_count_ = special_prime_count;
+
+            // Re-compute the parms_id
+            compute_parms_id();
+        }
+
+        /**
+        Sets the number of digits in the key switching decomposition (often called
+        dnum). The primes of the coefficient modulus below the special primes are
+        split into decomposition_digit_count groups of consecutive primes of equal
+        size (the last group may be smaller), and key switching keys hold one
+        component per group. Fewer digits make key switching keys smaller and key
+        switching faster, but require a larger special modulus to keep the noise
+        growth in check. The default value zero uses one digit per prime.
+
+        @param[in] decomposition_digit_count The new number of digits, or zero
+        for one digit per prime
+        @throws std::logic_error if a valid scheme is not set
+        @throws std::invalid_argument if decomposition_digit_count is larger than
+        SEAL_COEFF_MOD_COUNT_MAX
+        */
+        inline void set_decomposition_digit_count(std::size_t decomposition_digit_count)
+        {
+            if (scheme_ == scheme_type::none)
+            {
+                throw std::logic_error("decomposition_digit_count is not supported for this scheme");
+            }
+            if (decomposition_digit_count > SEAL_COEFF_MOD_COUNT_MAX)
+            {
+                throw std::invalid_argument("decomposition_digit_count is invalid");
+            }
+
+            decomposition_digit_count_ = decomposition_digit_count;
+
+            // Re-compute the parms_id
+            compute_parms_id();
+        }
+
+        /**
+        Sets the algorithm used to multiply BFV ciphertexts. BEHZ (the default)
+        extends the ciphertexts to an auxiliary base with fast base conversions
+        and corrects the overflows with Montgomery reduction; HPS extends them
+        exactly with the help of floating-point arithmetic and scales the product
+        down in a single step, which saves base conversions and is typically
+        faster when the coefficient modulus consists of many primes. Both methods
+        produce valid ciphertexts of the same form.
+
+        @param[in] mul_method The new multiplication method
+        @throws std::logic_error if scheme is not scheme_type::bfv and mul_method
+        is not mul_method_type::behz
+        @throws std::invalid_argument if mul_method is not supported
+        */
+        inline void set_mul_method(mul_method_type mul_method)
+        {
+            if (scheme_ != scheme_type::bfv && mul_method != mul_method_type::behz)
+            {
+                throw std::logic_error("mul_method is not supported for this scheme");
+            }
+            if (!is_valid_mul_method(static_cast<std::uint8_t>(mul_method)))
+            {
+                throw std::invalid_argument("mul_method is invalid");
+            }
+
+            mul_method_ = mul_method;
+
+            // Re-compute the parms_id
+            compute_parms_id();
+        }
+
         /**
         Sets the random number generator factory to use for encryption. By default,
         the random generator is set to UniformRandomGeneratorFactory::default_factory().
@@ -298,6 +405,31 @@ namespace seal
             return plain_modulus_;
         }
 
+        /**
+        Returns the number of special primes used in key switching.
+        */
+        SEAL_NODISCARD inline std::size_t special_prime_count() const noexcept
+        {
+            return special_prime_count_;
+        }
+
+        /**
+        Returns the number of digits in the key switching decomposition, or zero
+        if there is one digit per prime.
+        */
+        SEAL_NODISCARD inline std::size_t decomposition_digit_count() const noexcept
+        {
+            return decomposition_digit_count_;
+        }
+
+        /**
+        Returns the algorithm used to multiply BFV ciphertexts.
+        */
+        SEAL_NODISCARD inline mul_method_type mul_method() const noexcept
+        {
+            return mul_method_;
+        }
+
         /**
         Returns a pointer to the random number generator factory to use for encryption.
         */
@@ -363,7 +495,9 @@ namespace seal
                     sizeof(std::uint64_t), // poly_modulus_degree_
                     sizeof(std::uint64_t), // coeff_modulus_size
                     coeff_modulus_total_size,
-                    util::safe_cast<std::size_t>(plain_modulus_.save_size(compr_mode_type::none))),
+                    util::safe_cast<std::size_t>(plain_modulus_.save_size(compr_mode_type::none)),
+                    has_default_key_switching() ? std::size_t(0) : 2 * sizeof(std::uint64_t),
+                    mul_method_ == mul_method_type::behz ? std::size_t(0) : sizeof(mul_method_)),
                 compr_mode);
 
             return util::safe_cast<std::streamoff>(util::add_safe(sizeof(Serialization::SEALHeader), members_size));
@@ -483,6 +617,35 @@ namespace seal
             return false;
         }
 
+        /**
+        Helper function to determine whether given std::uint8_t represents a valid
+        value for mul_method_type.
+        */
+        SEAL_NODISCARD bool is_valid_mul_method(std::uint8_t mul_method) const noexcept
+        {
+            switch (mul_method)
+            {
+            case static_cast<std::uint8_t>(mul_method_type::behz):
+                /* fall through */
+
+            case static_cast<std::uint8_t>(mul_method_type::hps):
+                return true;
+            }
+            return false;
+        }
+
+        // Set in the saved scheme byte when non-default key switching parameters follow plain_modulus
+        static constexpr std::uint8_t key_switching_flag = 0x80;
+
+        // Set in the saved scheme byte when a non-default multiplication method follows the key switching parameters
+        static constexpr std::uint8_t mul_method_flag = 0x40;
+
+        // True if key switching uses one special prime and one digit per prime
+        SEAL_NODISCARD inline bool has_default_key_switching() const noexcept
+        {
+            return special_prime_count_ == 1 && !decomposition_digit_count_;
+        }
+
         void compute_parms_id();
 
         void save_members(std::ostream &stream) const;
@@ -501,6 +664,12 @@ namespace seal
 
         Modulus plain_modulus_{};
 
+        std::size_t special_prime_count_ = 1;
+
+        std::size_t decomposition_digit_count_ = 0;
+
+        mul_method_type mul_method_ = mul_method_type::behz;
+
         parms_id_type parms_id_ = parms_id_zero;
     };
 } // namespace seal
@@ -6,6 +6,7 @@
 #include "seal/randomtostd.h"
 #include "seal/util/common.h"
 #include "seal/util/iterator.h"
+#include "seal/util/ntt.h"
 #include "seal/util/polyarithsmallmod.h"
 #include "seal/util/rlwe.h"
 #include "seal/util/scalingvariant.h"
@@ -134,6 +135,48 @@ namespace seal
                 Ciphertext temp(pool);
                 util::encrypt_zero_asymmetric(public_key_, context_, prev_parms_id, is_ntt_form, temp);
 
+                // Several special primes are divided out at once as in key switching
+                auto kswitch_tool = context_data.kswitch_tool();
+                if (prev_parms_id == context_.key_parms_id() && kswitch_tool &&
+                    kswitch_tool->special_prime_count() > 1)
+                {
+                    auto prev_ntt_tables = iter(prev_context_data.small_ntt_tables());
+                    auto coeff_modulus = iter(parms.coeff_modulus());
+                    auto inv_p_mod_q = iter(kswitch_tool->inv_p_mod_q());
+                    size_t special_prime_count = kswitch_tool->special_prime_count();
+                    SEAL_ITERATE(iter(temp, destination), temp.size(), [&](auto I) {
+                        // Bring the components modulo the special primes to normal form
+                        RNSIter t_special = get<0>(I) + coeff_modulus_size;
+                        if (is_ntt_form)
+                        {
+                            inverse_ntt_negacyclic_harvey(
+                                t_special, special_prime_count, prev_ntt_tables + coeff_modulus_size);
+                        }
+
+                        // delta = ct mod P, corrected for rounding or for the plaintext modulus, and converted to q
+                        SEAL_ALLOCATE_GET_RNS_ITER(t_delta, coeff_count, coeff_modulus_size, pool);
+                        kswitch_tool->mod_down_delta(t_special, t_delta, pool);
+                        if (is_ntt_form)
+                        {
+                            ntt_negacyclic_harvey(t_delta, coeff_modulus_size, prev_ntt_tables);
+                        }
+
+                        // P^(-1) * (ct - delta) mod qi
+                        SEAL_ITERATE(
+                            iter(get<0>(I), t_delta, coeff_modulus, inv_p_mod_q, get<1>(I)), coeff_modulus_size,
+                            [&](auto J) {
+                                sub_poly_coeffmod(get<0>(J), get<1>(J), coeff_count, get<2>(J), get<4>(J));
+                                multiply_poly_scalar_coeffmod(get<4>(J), coeff_count, get<3>(J), get<2>(J), get<4>(J));
+                            });
+                    });
+
+                    destination.parms_id() = parms_id;
+                    destination.is_ntt_form() = is_ntt_form;
+                    destination.scale() = temp.scale();
+                    destination.correction_factor() = temp.correction_factor();
+                    return;
+                }
+
                 // Modulus switching
                 SEAL_ITERATE(iter(temp, destination), temp.size(), [&](auto I) {
                     if (parms.scheme() == scheme_type::ckks)
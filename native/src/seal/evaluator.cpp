@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <cmath>
 #include <functional>
+#include <thread>
 
 using namespace std;
 using namespace seal::util;
@@ -116,6 +117,230 @@ namespace seal
             }
             return make_tuple(multiply_uint_mod(e1, factor1, plain_modulus), e1, e2);
         }
+
+        /**
+        Computes the dyadic products of ciphertext multiplication. With SEAL_USE_MONTGOMERY the second operand must be
+        in Montgomery form (see to_montgomery_poly_coeffmod) and the products use Montgomery reduction; otherwise
+        this is dyadic_product_coeffmod. Either way the result is in the form of the first operand.
+        */
+        template <typename... Args>
+        inline void ciphertext_dyadic_product(Args &&...args)
+        {
+#ifdef SEAL_USE_MONTGOMERY
+            dyadic_product_montgomery_coeffmod(forward<Args>(args)...);
+#else
+            dyadic_product_coeffmod(forward<Args>(args)...);
+#endif
+        }
+
+        /**
+        Computes the product of two ciphertexts x = (x[0], x[1]) and y = (y[0], y[1]) in NTT form, i.e.,
+        (x[0] * y[0], x[0] * y[1] + x[1] * y[0], x[1] * y[1]), overwriting x[0] and x[1] with the first two
+        components and writing the third component to x2. The inputs may alias each other.
+        */
+        void ntt_tensor_product(
+            RNSIter x0, RNSIter x1, ConstRNSIter y0, ConstRNSIter y1, RNSIter x2, ConstModulusIter coeff_modulus,
+            size_t coeff_modulus_size, MemoryPoolHandle pool)
+        {
+            size_t coeff_count = x0.poly_modulus_degree();
+
+            // We want to keep six polynomials in the L1 cache: x[0], x[1], x[2], y[0], y[1], temp.
+            // For a 32KiB cache, which can store 32768 / 8 = 4096 coefficients, = 682.67 coefficients per polynomial,
+            // we should keep the tile size at 682 or below. The tile size must divide coeff_count, i.e. be a power of
+            // two. Some testing shows similar performance with tile size 256 and 512, and worse performance on smaller
+            // tiles. We pick the smaller of the two to prevent L1 cache misses on processors with < 32 KiB L1 cache.
+            size_t tile_size = min<size_t>(coeff_count, size_t(256));
+            size_t num_tiles = coeff_count / tile_size;
+#ifdef SEAL_DEBUG
+            if (coeff_count % tile_size != 0)
+            {
+                throw invalid_argument("tile_size does not divide coeff_count");
+            }
+#endif
+
+            // Semantic misuse of RNSIter; each is really pointing to the data for each RNS factor in sequence
+            ConstRNSIter y0_iter(*y0, tile_size);
+            ConstRNSIter y1_iter(*y1, tile_size);
+            RNSIter x0_iter(*x0, tile_size);
+            RNSIter x1_iter(*x1, tile_size);
+            RNSIter x2_iter(*x2, tile_size);
+
+            // Temporary buffer to store intermediate results
+            SEAL_ALLOCATE_GET_COEFF_ITER(temp, tile_size, pool);
+#ifdef SEAL_USE_MONTGOMERY
+            // Each tile of y takes part in two products, so it is converted to Montgomery form once; this happens
+            // before any tile of x is overwritten, so x and y may still alias
+            SEAL_ALLOCATE_GET_COEFF_ITER(y0_tile, tile_size, pool);
+            SEAL_ALLOCATE_GET_COEFF_ITER(y1_tile, tile_size, pool);
+#endif
+
+            // Computes the output tile_size coefficients at a time
+            // Given input tuples of polynomials x = (x[0], x[1], x[2]), y = (y[0], y[1]), computes
+            // x = (x[0] * y[0], x[0] * y[1] + x[1] * y[0], x[1] * y[1])
+            // with appropriate modular reduction
+            SEAL_ITERATE(coeff_modulus, coeff_modulus_size, [&](auto I) {
+                SEAL_ITERATE(iter(size_t(0)), num_tiles, [&](SEAL_MAYBE_UNUSED auto J) {
+#ifdef SEAL_USE_MONTGOMERY
+                    to_montgomery_poly_coeffmod(y0_iter[0], tile_size, I, y0_tile);
+                    to_montgomery_poly_coeffmod(y1_iter[0], tile_size, I, y1_tile);
+#else
+                    ConstCoeffIter y0_tile = y0_iter[0];
+                    ConstCoeffIter y1_tile = y1_iter[0];
+#endif
+                    // Compute third output polynomial, overwriting input
+                    // x[2] = x[1] * y[1]
+                    ciphertext_dyadic_product(x1_iter[0], y1_tile, tile_size, I, x2_iter[0]);
+
+                    // Compute second output polynomial, overwriting input
+                    // temp = x[1] * y[0]
+                    ciphertext_dyadic_product(x1_iter[0], y0_tile, tile_size, I, temp);
+                    // x[1] = x[0] * y[1]
+                    ciphertext_dyadic_product(x0_iter[0], y1_tile, tile_size, I, x1_iter[0]);
+                    // x[1] += temp
+                    add_poly_coeffmod(x1_iter[0], temp, tile_size, I, x1_iter[0]);
+
+                    // Compute first output polynomial, overwriting input
+                    // x[0] = x[0] * y[0]
+                    ciphertext_dyadic_product(x0_iter[0], y0_tile, tile_size, I, x0_iter[0]);
+
+                    // Manually increment iterators
+                    x0_iter++;
+                    x1_iter++;
+                    x2_iter++;
+                    y0_iter++;
+                    y1_iter++;
+                });
+            });
+        }
+
+        /**
+        Calls func(i, pool) for every i in [0, count), on thread_pool if one is given. Calls running on a worker
+        thread receive the thread-local memory pool of that thread in place of pool, so workers never share a memory
+        pool that may not be thread-safe.
+        */
+        template <typename F>
+        void parallel_for(ThreadPool *thread_pool, size_t count, const MemoryPoolHandle &pool, F &&func)
+        {
+            if (!thread_pool || count < 2)
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    func(i, pool);
+                }
+                return;
+            }
+
+            auto caller_id = this_thread::get_id();
+            thread_pool->parallel_for(count, [&](size_t i) {
+                if (this_thread::get_id() == caller_id)
+                {
+                    func(i, pool);
+                }
+                else
+                {
+                    func(i, MemoryManager::GetPool(mm_prof_opt::mm_force_thread_local));
+                }
+            });
+        }
+
+        /**
+        Writes to destination the decomposition of a key switching target for the key modulus at index key_index,
+        with one digit per prime. The target t_target is in coefficient form; every component is reduced modulo the
+        key modulus and transformed to NTT form with output in [0, 4q). When the target is also available in NTT form
+        (target_ntt with target_in_ntt_form set), component I is copied from it instead; I is the index of the output
+        RNS component, which equals key_index for the primes below the special primes.
+        */
+        void decompose_key_switch_operand(
+            ConstRNSIter t_target, ConstRNSIter target_ntt, bool target_in_ntt_form, size_t decomp_modulus_size,
+            size_t I, size_t key_index, const vector<Modulus> &key_modulus, ConstNTTTablesIter key_ntt_tables,
+            RNSIter destination)
+        {
+            size_t coeff_count = t_target.poly_modulus_degree();
+
+            SEAL_ITERATE(iter(size_t(0)), decomp_modulus_size, [&](auto J) {
+                if (target_in_ntt_form && (I == J))
+                {
+                    set_uint(target_ntt[J], coeff_count, destination[J]);
+                }
+                // No need to perform RNS conversion (modular reduction)
+                else if (key_modulus[J] <= key_modulus[key_index])
+                {
+                    set_uint(t_target[J], coeff_count, destination[J]);
+                }
+                // Perform RNS conversion (modular reduction)
+                else
+                {
+                    modulo_poly_coeffs(t_target[J], coeff_count, key_modulus[key_index], destination[J]);
+                }
+            });
+
+            // NTT conversion lazy outputs in [0, 4q); all components share the modulus and are transformed together
+            if (target_in_ntt_form && (I < decomp_modulus_size))
+            {
+                ntt_negacyclic_harvey_lazy(destination, I, key_ntt_tables[key_index]);
+                ntt_negacyclic_harvey_lazy(
+                    destination + (I + 1), decomp_modulus_size - I - 1, key_ntt_tables[key_index]);
+            }
+            else
+            {
+                ntt_negacyclic_harvey_lazy(destination, decomp_modulus_size, key_ntt_tables[key_index]);
+            }
+        }
+
+        /**
+        Writes to destination the decomposition of a key switching target for all output RNS components: the primes
+        of the level followed by the special primes. Output component I holds one polynomial per digit in NTT form
+        with output in [0, 4q). The arguments are as in decompose_key_switch_operand.
+        */
+        void decompose_key_switch_target(
+            ConstRNSIter t_target, ConstRNSIter target_ntt, bool target_in_ntt_form, const KSwitchTool &kswitch_tool,
+            const vector<Modulus> &key_modulus, ConstNTTTablesIter key_ntt_tables, PolyIter destination,
+            MemoryPoolHandle pool, ThreadPool *thread_pool)
+        {
+            size_t coeff_count = t_target.poly_modulus_degree();
+            size_t decomp_modulus_size = kswitch_tool.base_q()->size();
+            size_t rns_modulus_size = decomp_modulus_size + kswitch_tool.special_prime_count();
+            size_t key_modulus_offset = key_modulus.size() - rns_modulus_size;
+            size_t digit_size = kswitch_tool.digit_size();
+            size_t digit_count = kswitch_tool.digit_count();
+
+            if (digit_size == 1)
+            {
+                parallel_for(thread_pool, rns_modulus_size, pool, [&](size_t I, const MemoryPoolHandle &) {
+                    size_t key_index = I < decomp_modulus_size ? I : I + key_modulus_offset;
+                    decompose_key_switch_operand(
+                        t_target, target_ntt, target_in_ntt_form, decomp_modulus_size, I, key_index, key_modulus,
+                        key_ntt_tables, destination[I]);
+                });
+                return;
+            }
+
+            // Extend each digit to all output components
+            parallel_for(thread_pool, digit_count, pool, [&](size_t J, const MemoryPoolHandle &local_pool) {
+                SEAL_ALLOCATE_GET_RNS_ITER(t_mod_up, coeff_count, rns_modulus_size, local_pool);
+                kswitch_tool.mod_up(t_target, J, t_mod_up, local_pool);
+                SEAL_ITERATE(iter(t_mod_up, destination), rns_modulus_size, [&](auto I) {
+                    set_uint(get<0>(I), coeff_count, get<1>(I)[J]);
+                });
+            });
+
+            parallel_for(thread_pool, rns_modulus_size, pool, [&](size_t I, const MemoryPoolHandle &) {
+                size_t key_index = I < decomp_modulus_size ? I : I + key_modulus_offset;
+                if (target_in_ntt_form && (I < decomp_modulus_size))
+                {
+                    // The digit containing this prime is available in NTT form
+                    size_t digit = I / digit_size;
+                    set_uint(target_ntt[I], coeff_count, destination[I][digit]);
+                    ntt_negacyclic_harvey_lazy(destination[I], digit, key_ntt_tables[key_index]);
+                    ntt_negacyclic_harvey_lazy(
+                        destination[I] + (digit + 1), digit_count - digit - 1, key_ntt_tables[key_index]);
+                }
+                else
+                {
+                    ntt_negacyclic_harvey_lazy(destination[I], digit_count, key_ntt_tables[key_index]);
+                }
+            });
+        }
     } // namespace
 
     Evaluator::Evaluator(const SEALContext &context) : context_(context)
@@ -127,6 +352,18 @@ namespace seal
         }
     }
 
+    Evaluator::Evaluator(const SEALContext &context, size_t thread_count) : Evaluator(context)
+    {
+        if (!thread_count)
+        {
+            thread_count = max<size_t>(thread::hardware_concurrency(), 1);
+        }
+        if (thread_count > 1)
+        {
+            thread_pool_ = make_unique<ThreadPool>(thread_count);
+        }
+    }
+
     void Evaluator::negate_inplace(Ciphertext &encrypted) const
     {
         // Verify parameters.
@@ -392,21 +629,127 @@ namespace seal
 #endif
     }
 
-    void Evaluator::bfv_multiply(Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool) const
+    void Evaluator::multiply_relin_inplace(
+        Ciphertext &encrypted1, const Ciphertext &encrypted2, const RelinKeys &relin_keys, MemoryPoolHandle pool) const
+    {
+        // Verify parameters.
+        if (!is_metadata_valid_for(encrypted1, context_) || !is_buffer_valid(encrypted1))
+        {
+            throw invalid_argument("encrypted1 is not valid for encryption parameters");
+        }
+        if (!is_metadata_valid_for(encrypted2, context_) || !is_buffer_valid(encrypted2))
+        {
+            throw invalid_argument("encrypted2 is not valid for encryption parameters");
+        }
+        if (encrypted1.parms_id() != encrypted2.parms_id())
+        {
+            throw invalid_argument("encrypted1 and encrypted2 parameter mismatch");
+        }
+        if (!context_.using_keyswitching())
+        {
+            throw logic_error("keyswitching is not supported by the context");
+        }
+        if (relin_keys.parms_id() != context_.key_parms_id())
+        {
+            throw invalid_argument("relin_keys is not valid for encryption parameters");
+        }
+        if (relin_keys.size() < sub_safe(add_safe(encrypted1.size(), encrypted2.size()), size_t(3)))
+        {
+            throw invalid_argument("not enough relinearization keys");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        // Larger ciphertexts are multiplied and relinearized separately
+        if (encrypted1.size() != 2 || encrypted2.size() != 2)
+        {
+            multiply_inplace(encrypted1, encrypted2, pool);
+            relinearize_inplace(encrypted1, relin_keys, move(pool));
+            return;
+        }
+
+        // Extract encryption parameters.
+        auto &context_data = *context_.get_context_data(encrypted1.parms_id());
+        size_t coeff_count = context_data.parms().poly_modulus_degree();
+        size_t coeff_modulus_size = context_data.parms().coeff_modulus().size();
+
+        // The third component of the product goes straight to key switching
+        SEAL_ALLOCATE_GET_RNS_ITER(relin_target, coeff_count, coeff_modulus_size, pool);
+        switch (context_data.parms().scheme())
+        {
+        case scheme_type::bfv:
+            bfv_multiply(encrypted1, encrypted2, pool, relin_target);
+            break;
+
+        case scheme_type::ckks:
+            ckks_multiply(encrypted1, encrypted2, pool, relin_target);
+            break;
+
+        case scheme_type::bgv:
+            bgv_multiply(encrypted1, encrypted2, pool, relin_target);
+            break;
+
+        default:
+            throw invalid_argument("unsupported scheme");
+        }
+        switch_key_inplace(
+            encrypted1, relin_target, static_cast<const KSwitchKeys &>(relin_keys), RelinKeys::get_index(2), pool);
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (encrypted1.is_transparent())
+        {
+            throw logic_error("result ciphertext is transparent");
+        }
+#endif
+    }
+
+    void Evaluator::multiply_relin_rescale_inplace(
+        Ciphertext &encrypted1, const Ciphertext &encrypted2, const RelinKeys &relin_keys, MemoryPoolHandle pool) const
+    {
+        // Verify parameters.
+        auto context_data_ptr = context_.get_context_data(encrypted1.parms_id());
+        if (!context_data_ptr)
+        {
+            throw invalid_argument("encrypted1 is not valid for encryption parameters");
+        }
+        if (context_data_ptr->parms().scheme() != scheme_type::ckks)
+        {
+            throw invalid_argument("unsupported operation for scheme type");
+        }
+        if (!context_data_ptr->next_context_data())
+        {
+            throw invalid_argument("end of modulus switching chain reached");
+        }
+
+        multiply_relin_inplace(encrypted1, encrypted2, relin_keys, pool);
+        rescale_to_next_inplace(encrypted1, move(pool));
+    }
+
+    void Evaluator::bfv_multiply(
+        Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool, RNSIter relin_target) const
     {
-        if (encrypted1.is_ntt_form() || encrypted2.is_ntt_form())
+        if (encrypted1.is_ntt_form() != encrypted2.is_ntt_form())
         {
-            throw invalid_argument("encrypted1 or encrypted2 cannot be in NTT form");
+            throw invalid_argument("NTT form mismatch");
         }
 
         // Extract encryption parameters.
         auto &context_data = *context_.get_context_data(encrypted1.parms_id());
         auto &parms = context_data.parms();
+        if (parms.mul_method() == mul_method_type::hps)
+        {
+            bfv_multiply_hps(encrypted1, encrypted2, move(pool), relin_target);
+            return;
+        }
+
         size_t coeff_count = parms.poly_modulus_degree();
         size_t base_q_size = parms.coeff_modulus().size();
         size_t encrypted1_size = encrypted1.size();
         size_t encrypted2_size = encrypted2.size();
         uint64_t plain_modulus = parms.plain_modulus().value();
+        bool ntt_form = encrypted1.is_ntt_form();
 
         auto rns_tool = context_data.rns_tool();
         size_t base_Bsk_size = rns_tool->base_Bsk()->size();
@@ -428,6 +771,7 @@ namespace seal
         // Set up iterators for NTT tables
         auto base_q_ntt_tables = iter(context_data.small_ntt_tables());
         auto base_Bsk_ntt_tables = iter(rns_tool->base_Bsk_ntt_tables());
+        ThreadPool *thread_pool = thread_pool_.get();
 
         // Microsoft SEAL uses BEHZ-style RNS multiplication. This process is somewhat complex and consists of the
         // following steps:
@@ -440,9 +784,17 @@ namespace seal
         // (6) Multiply the result by t (plain_modulus)
         // (7) Scale the result by q using a divide-and-floor algorithm, switching base to Bsk
         // (8) Use Shenoy-Kumaresan method to convert the result to base q
+        //
+        // Ciphertexts in NTT form skip the transform of step (3) in base q, but the base extension of step (1) needs
+        // a copy in normal form, and the result of step (8) is transformed back to NTT form.
 
-        // Resize encrypted1 to destination size
-        encrypted1.resize(context_, context_data.parms_id(), dest_size);
+        // Resize encrypted1 to destination size; with a relinearization target the third component is written there
+        // instead
+        if (relin_target && dest_size != 3)
+        {
+            throw logic_error("relinearization target requires ciphertexts of size 2");
+        }
+        encrypted1.resize(context_, context_data.parms_id(), relin_target ? size_t(2) : dest_size);
 
         // This lambda function takes as input an IterTuple with three components:
         //
@@ -452,21 +804,32 @@ namespace seal
         //
         // It performs steps (1)-(3) of the BEHZ multiplication (see above) on the given input polynomial (given as an
         // RNSIter or ConstRNSIter) and writes the results in base q and base Bsk to the given output
-        // iterators.
-        auto behz_extend_base_convert_to_ntt = [&](auto I) {
-            // Make copy of input polynomial (in base q) and convert to NTT form
-            // Lazy reduction
-            set_poly(get<0>(I), coeff_count, base_q_size, get<1>(I));
-            ntt_negacyclic_harvey_lazy(get<1>(I), base_q_size, base_q_ntt_tables);
-
+        // iterators, allocating from local_pool.
+        auto behz_extend_base_convert_to_ntt = [&](auto I, const MemoryPoolHandle &local_pool) {
             // Allocate temporary space for a polynomial in the Bsk U {m_tilde} base
-            SEAL_ALLOCATE_GET_RNS_ITER(temp, coeff_count, base_Bsk_m_tilde_size, pool);
+            SEAL_ALLOCATE_GET_RNS_ITER(temp, coeff_count, base_Bsk_m_tilde_size, local_pool);
 
-            // (1) Convert from base q to base Bsk U {m_tilde}
-            rns_tool->fastbconv_m_tilde(get<0>(I), temp, pool);
+            // Make copy of input polynomial (in base q) and convert to NTT form unless it already is
+            set_poly(get<0>(I), coeff_count, base_q_size, get<1>(I));
+            if (ntt_form)
+            {
+                // (1) Convert a copy in normal form from base q to base Bsk U {m_tilde}
+                SEAL_ALLOCATE_GET_RNS_ITER(temp_q, coeff_count, base_q_size, local_pool);
+                set_poly(get<0>(I), coeff_count, base_q_size, temp_q);
+                inverse_ntt_negacyclic_harvey(temp_q, base_q_size, base_q_ntt_tables);
+                rns_tool->fastbconv_m_tilde(temp_q, temp, local_pool);
+            }
+            else
+            {
+                // Lazy reduction
+                ntt_negacyclic_harvey_lazy(get<1>(I), base_q_size, base_q_ntt_tables);
+
+                // (1) Convert from base q to base Bsk U {m_tilde}
+                rns_tool->fastbconv_m_tilde(get<0>(I), temp, local_pool);
+            }
 
             // (2) Reduce q-overflows in with Montgomery reduction, switching base to Bsk
-            rns_tool->sm_mrq(temp, get<2>(I), pool);
+            rns_tool->sm_mrq(temp, get<2>(I), local_pool);
 
             // Transform to NTT form in base Bsk
             // Lazy reduction
@@ -479,14 +842,29 @@ namespace seal
         // Allocate space for a base Bsk output of behz_extend_base_convert_to_ntt for encrypted1
         SEAL_ALLOCATE_GET_POLY_ITER(encrypted1_Bsk, encrypted1_size, coeff_count, base_Bsk_size, pool);
 
-        // Perform BEHZ steps (1)-(3) for encrypted1
-        SEAL_ITERATE(iter(encrypted1, encrypted1_q, encrypted1_Bsk), encrypted1_size, behz_extend_base_convert_to_ntt);
-
         // Repeat for encrypted2
         SEAL_ALLOCATE_GET_POLY_ITER(encrypted2_q, encrypted2_size, coeff_count, base_q_size, pool);
         SEAL_ALLOCATE_GET_POLY_ITER(encrypted2_Bsk, encrypted2_size, coeff_count, base_Bsk_size, pool);
 
-        SEAL_ITERATE(iter(encrypted2, encrypted2_q, encrypted2_Bsk), encrypted2_size, behz_extend_base_convert_to_ntt);
+        // Perform BEHZ steps (1)-(3) for all components of encrypted1 and encrypted2; they are independent
+        auto encrypted1_extend_iter = iter(encrypted1, encrypted1_q, encrypted1_Bsk);
+        auto encrypted2_extend_iter = iter(encrypted2, encrypted2_q, encrypted2_Bsk);
+        parallel_for(
+            thread_pool, encrypted1_size + encrypted2_size, pool, [&](size_t i, const MemoryPoolHandle &local_pool) {
+                if (i < encrypted1_size)
+                {
+                    behz_extend_base_convert_to_ntt(encrypted1_extend_iter[i], local_pool);
+                }
+                else
+                {
+                    behz_extend_base_convert_to_ntt(encrypted2_extend_iter[i - encrypted1_size], local_pool);
+                }
+            });
+#ifdef SEAL_USE_MONTGOMERY
+        // Every component of encrypted2 takes part in several products, so it is converted to Montgomery form once
+        to_montgomery_poly_coeffmod(encrypted2_q, encrypted2_size, base_q, encrypted2_q);
+        to_montgomery_poly_coeffmod(encrypted2_Bsk, encrypted2_size, base_Bsk, encrypted2_Bsk);
+#endif
 
         // Allocate temporary space for the output of step (4)
         // We allocate space separately for the base q and the base Bsk components
@@ -494,7 +872,7 @@ namespace seal
         SEAL_ALLOCATE_ZERO_GET_POLY_ITER(temp_dest_Bsk, dest_size, coeff_count, base_Bsk_size, pool);
 
         // Perform BEHZ step (4): dyadic multiplication on arbitrary size ciphertexts
-        SEAL_ITERATE(iter(size_t(0)), dest_size, [&](auto I) {
+        parallel_for(thread_pool, dest_size, pool, [&](size_t I, const MemoryPoolHandle &local_pool) {
             // We iterate over relevant components of encrypted1 and encrypted2 in increasing order for
             // encrypted1 and reversed (decreasing) order for encrypted2. The bounds for the indices of
             // the relevant terms are obtained as follows.
@@ -528,8 +906,8 @@ namespace seal
 
                 SEAL_ITERATE(iter(shifted_in1_iter, shifted_reversed_in2_iter), steps, [&](auto J) {
                     SEAL_ITERATE(iter(J, base_iter, shifted_out_iter), base_size, [&](auto K) {
-                        SEAL_ALLOCATE_GET_COEFF_ITER(temp, coeff_count, pool);
-                        dyadic_product_coeffmod(get<0, 0>(K), get<0, 1>(K), coeff_count, get<1>(K), temp);
+                        SEAL_ALLOCATE_GET_COEFF_ITER(temp, coeff_count, local_pool);
+                        ciphertext_dyadic_product(get<0, 0>(K), get<0, 1>(K), coeff_count, get<1>(K), temp);
                         add_poly_coeffmod(temp, get<2>(K), coeff_count, get<1>(K), get<2>(K));
                     });
                 });
@@ -542,13 +920,17 @@ namespace seal
 
         // Perform BEHZ step (5): transform data from NTT form
         // Lazy reduction here. The following multiply_poly_scalar_coeffmod will correct the value back to [0, p)
-        inverse_ntt_negacyclic_harvey_lazy(temp_dest_q, dest_size, base_q_ntt_tables);
-        inverse_ntt_negacyclic_harvey_lazy(temp_dest_Bsk, dest_size, base_Bsk_ntt_tables);
+        inverse_ntt_negacyclic_harvey_lazy(temp_dest_q, dest_size, base_q_ntt_tables, thread_pool);
+        inverse_ntt_negacyclic_harvey_lazy(temp_dest_Bsk, dest_size, base_Bsk_ntt_tables, thread_pool);
 
         // Perform BEHZ steps (6)-(8)
-        SEAL_ITERATE(iter(temp_dest_q, temp_dest_Bsk, encrypted1), dest_size, [&](auto I) {
+        PolyIter encrypted1_iter = iter(encrypted1);
+        auto temp_dest_iter = iter(temp_dest_q, temp_dest_Bsk, size_t(0));
+        parallel_for(thread_pool, dest_size, pool, [&](size_t i, const MemoryPoolHandle &local_pool) {
+            auto I = temp_dest_iter[i];
+
             // Bring together the base q and base Bsk components into a single allocation
-            SEAL_ALLOCATE_GET_RNS_ITER(temp_q_Bsk, coeff_count, base_q_size + base_Bsk_size, pool);
+            SEAL_ALLOCATE_GET_RNS_ITER(temp_q_Bsk, coeff_count, base_q_size + base_Bsk_size, local_pool);
 
             // Step (6): multiply base q components by t (plain_modulus)
             multiply_poly_scalar_coeffmod(get<0>(I), base_q_size, plain_modulus, base_q, temp_q_Bsk);
@@ -556,17 +938,164 @@ namespace seal
             multiply_poly_scalar_coeffmod(get<1>(I), base_Bsk_size, plain_modulus, base_Bsk, temp_q_Bsk + base_q_size);
 
             // Allocate yet another temporary for fast divide-and-floor result in base Bsk
-            SEAL_ALLOCATE_GET_RNS_ITER(temp_Bsk, coeff_count, base_Bsk_size, pool);
+            SEAL_ALLOCATE_GET_RNS_ITER(temp_Bsk, coeff_count, base_Bsk_size, local_pool);
 
             // Step (7): divide by q and floor, producing a result in base Bsk
-            rns_tool->fast_floor(temp_q_Bsk, temp_Bsk, pool);
+            rns_tool->fast_floor(temp_q_Bsk, temp_Bsk, local_pool);
 
             // Step (8): use Shenoy-Kumaresan method to convert the result to base q and write to encrypted1
-            rns_tool->fastbconv_sk(temp_Bsk, get<2>(I), pool);
+            RNSIter destination = (relin_target && get<2>(I) == 2) ? relin_target : encrypted1_iter[get<2>(I)];
+            rns_tool->fastbconv_sk(temp_Bsk, destination, local_pool);
+            if (ntt_form)
+            {
+                ntt_negacyclic_harvey(destination, base_q_size, base_q_ntt_tables);
+            }
         });
     }
 
-    void Evaluator::ckks_multiply(Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool) const
+    void Evaluator::bfv_multiply_hps(
+        Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool, RNSIter relin_target) const
+    {
+        // Extract encryption parameters.
+        auto &context_data = *context_.get_context_data(encrypted1.parms_id());
+        auto &parms = context_data.parms();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t base_q_size = parms.coeff_modulus().size();
+        size_t encrypted1_size = encrypted1.size();
+        size_t encrypted2_size = encrypted2.size();
+        bool square = &encrypted1 == &encrypted2;
+        bool ntt_form = encrypted1.is_ntt_form();
+
+        auto rns_tool = context_data.rns_tool();
+        size_t base_qP_size = rns_tool->base_qP()->size();
+
+        // Determine destination.size()
+        size_t dest_size = sub_safe(add_safe(encrypted1_size, encrypted2_size), size_t(1));
+
+        // Size check
+        if (!product_fits_in(dest_size, coeff_count, base_qP_size))
+        {
+            throw logic_error("invalid parameters");
+        }
+
+        // Set up iterators for bases
+        auto base_qP = iter(rns_tool->base_qP()->base());
+
+        // Set up iterators for NTT tables
+        auto base_qP_ntt_tables = iter(rns_tool->base_qP_ntt_tables());
+        ThreadPool *thread_pool = thread_pool_.get();
+
+        // HPS multiplication consists of the following steps:
+        //
+        // (1) Lift encrypted1 and encrypted2 (initially in base q) to base q U P with exact base conversion
+        // (2) Transform the data to NTT form
+        // (3) Compute the ciphertext polynomial product using dyadic multiplication
+        // (4) Transform the data back from NTT form
+        // (5) Scale the result by t/q and round, producing a result in base P
+        // (6) Convert the result exactly to base q
+        //
+        // Unlike BEHZ, the lift needs no correction of q-overflows and steps (5) and (6) take one base conversion
+        // each, at the price of a floating-point sum per coefficient. Ciphertexts in NTT form are transformed to
+        // normal form only for the lift, and the result of step (6) is transformed back to NTT form.
+
+        if (relin_target && dest_size != 3)
+        {
+            throw logic_error("relinearization target requires ciphertexts of size 2");
+        }
+
+        // Steps (1)-(2) for one input polynomial; the results in base q and base P are stored contiguously
+        auto hps_extend_to_ntt = [&](ConstRNSIter input, RNSIter output, const MemoryPoolHandle &local_pool) {
+            set_poly(input, coeff_count, base_q_size, output);
+            if (ntt_form)
+            {
+                SEAL_ALLOCATE_GET_RNS_ITER(temp_q, coeff_count, base_q_size, local_pool);
+                set_poly(input, coeff_count, base_q_size, temp_q);
+                inverse_ntt_negacyclic_harvey(temp_q, base_q_size, base_qP_ntt_tables);
+                rns_tool->hps_extend(temp_q, output + base_q_size, local_pool);
+
+                // Lazy reduction; only the base P part needs the transform
+                ntt_negacyclic_harvey_lazy(
+                    output + base_q_size, base_qP_size - base_q_size, base_qP_ntt_tables + base_q_size);
+            }
+            else
+            {
+                rns_tool->hps_extend(input, output + base_q_size, local_pool);
+
+                // Lazy reduction
+                ntt_negacyclic_harvey_lazy(output, base_qP_size, base_qP_ntt_tables);
+            }
+        };
+
+        // The operands are extended before encrypted1 is resized, since they may be the same object
+        SEAL_ALLOCATE_GET_POLY_ITER(encrypted1_qP, encrypted1_size, coeff_count, base_qP_size, pool);
+        SEAL_ALLOCATE_GET_POLY_ITER(
+            encrypted2_qP_alloc, square ? size_t(0) : encrypted2_size, coeff_count, base_qP_size, pool);
+        ConstPolyIter encrypted2_qP = square ? encrypted1_qP : encrypted2_qP_alloc;
+
+        size_t extend_count = square ? encrypted1_size : encrypted1_size + encrypted2_size;
+        parallel_for(thread_pool, extend_count, pool, [&](size_t i, const MemoryPoolHandle &local_pool) {
+            if (i < encrypted1_size)
+            {
+                hps_extend_to_ntt(iter(encrypted1)[i], encrypted1_qP[i], local_pool);
+            }
+            else
+            {
+                hps_extend_to_ntt(
+                    iter(encrypted2)[i - encrypted1_size], encrypted2_qP_alloc[i - encrypted1_size], local_pool);
+            }
+        });
+#ifdef SEAL_USE_MONTGOMERY
+        // Every component of encrypted2 takes part in several products, so it is converted to Montgomery form once;
+        // when squaring, the converted components are kept apart from encrypted1_qP
+        SEAL_ALLOCATE_GET_POLY_ITER(
+            encrypted2_qP_montgomery, square ? encrypted2_size : size_t(0), coeff_count, base_qP_size, pool);
+        PolyIter encrypted2_qP_target = square ? encrypted2_qP_montgomery : encrypted2_qP_alloc;
+        to_montgomery_poly_coeffmod(encrypted2_qP, encrypted2_size, base_qP, encrypted2_qP_target);
+        encrypted2_qP = encrypted2_qP_target;
+#endif
+
+        // Resize encrypted1 to destination size; with a relinearization target the third component is written there
+        // instead
+        encrypted1.resize(context_, context_data.parms_id(), relin_target ? size_t(2) : dest_size);
+
+        // Step (3): dyadic multiplication on arbitrary size ciphertexts
+        SEAL_ALLOCATE_ZERO_GET_POLY_ITER(temp_dest_qP, dest_size, coeff_count, base_qP_size, pool);
+        parallel_for(thread_pool, dest_size, pool, [&](size_t I, const MemoryPoolHandle &local_pool) {
+            // As in BEHZ, iterate over encrypted1 in increasing and over encrypted2 in decreasing order
+            size_t curr_encrypted1_last = min<size_t>(I, encrypted1_size - 1);
+            size_t curr_encrypted2_first = min<size_t>(I, encrypted2_size - 1);
+            size_t curr_encrypted1_first = I - curr_encrypted2_first;
+            size_t steps = curr_encrypted1_last - curr_encrypted1_first + 1;
+
+            auto shifted_in1_iter = ConstPolyIter(encrypted1_qP) + curr_encrypted1_first;
+            auto shifted_reversed_in2_iter = reverse_iter(encrypted2_qP + curr_encrypted2_first);
+            SEAL_ALLOCATE_GET_COEFF_ITER(temp, coeff_count, local_pool);
+            SEAL_ITERATE(iter(shifted_in1_iter, shifted_reversed_in2_iter), steps, [&](auto J) {
+                SEAL_ITERATE(iter(J, base_qP, temp_dest_qP[I]), base_qP_size, [&](auto K) {
+                    ciphertext_dyadic_product(get<0, 0>(K), get<0, 1>(K), coeff_count, get<1>(K), temp);
+                    add_poly_coeffmod(temp, get<2>(K), coeff_count, get<1>(K), get<2>(K));
+                });
+            });
+        });
+
+        // Step (4): transform data from NTT form
+        // Lazy reduction here; the scaling accepts inputs up to twice the moduli
+        inverse_ntt_negacyclic_harvey_lazy(temp_dest_qP, dest_size, base_qP_ntt_tables, thread_pool);
+
+        // Steps (5)-(6)
+        PolyIter encrypted1_iter = iter(encrypted1);
+        parallel_for(thread_pool, dest_size, pool, [&](size_t i, const MemoryPoolHandle &local_pool) {
+            RNSIter destination = (relin_target && i == 2) ? relin_target : encrypted1_iter[i];
+            rns_tool->hps_scale_and_round(temp_dest_qP[i], destination, local_pool);
+            if (ntt_form)
+            {
+                ntt_negacyclic_harvey(destination, base_q_size, base_qP_ntt_tables);
+            }
+        });
+    }
+
+    void Evaluator::ckks_multiply(
+        Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool, RNSIter relin_target) const
     {
         if (!(encrypted1.is_ntt_form() && encrypted2.is_ntt_form()))
         {
@@ -594,8 +1123,12 @@ namespace seal
         // Set up iterator for the base
         auto coeff_modulus = iter(parms.coeff_modulus());
 
-        // Prepare destination
-        encrypted1.resize(context_, context_data.parms_id(), dest_size);
+        // Prepare destination; with a relinearization target the third component is written there instead
+        if (relin_target && dest_size != 3)
+        {
+            throw logic_error("relinearization target requires ciphertexts of size 2");
+        }
+        encrypted1.resize(context_, context_data.parms_id(), relin_target ? size_t(2) : dest_size);
 
         // Set up iterators for input ciphertexts
         PolyIter encrypted1_iter = iter(encrypted1);
@@ -603,68 +1136,15 @@ namespace seal
 
         if (dest_size == 3)
         {
-            // We want to keep six polynomials in the L1 cache: x[0], x[1], x[2], y[0], y[1], temp.
-            // For a 32KiB cache, which can store 32768 / 8 = 4096 coefficients, = 682.67 coefficients per polynomial,
-            // we should keep the tile size at 682 or below. The tile size must divide coeff_count, i.e. be a power of
-            // two. Some testing shows similar performance with tile size 256 and 512, and worse performance on smaller
-            // tiles. We pick the smaller of the two to prevent L1 cache misses on processors with < 32 KiB L1 cache.
-            size_t tile_size = min<size_t>(coeff_count, size_t(256));
-            size_t num_tiles = coeff_count / tile_size;
-#ifdef SEAL_DEBUG
-            if (coeff_count % tile_size != 0)
-            {
-                throw invalid_argument("tile_size does not divide coeff_count");
-            }
-#endif
-
-            // Semantic misuse of RNSIter; each is really pointing to the data for each RNS factor in sequence
-            ConstRNSIter encrypted2_0_iter(*encrypted2_iter[0], tile_size);
-            ConstRNSIter encrypted2_1_iter(*encrypted2_iter[1], tile_size);
-            RNSIter encrypted1_0_iter(*encrypted1_iter[0], tile_size);
-            RNSIter encrypted1_1_iter(*encrypted1_iter[1], tile_size);
-            RNSIter encrypted1_2_iter(*encrypted1_iter[2], tile_size);
-
-            // Temporary buffer to store intermediate results
-            SEAL_ALLOCATE_GET_COEFF_ITER(temp, tile_size, pool);
-
-            // Computes the output tile_size coefficients at a time
-            // Given input tuples of polynomials x = (x[0], x[1], x[2]), y = (y[0], y[1]), computes
-            // x = (x[0] * y[0], x[0] * y[1] + x[1] * y[0], x[1] * y[1])
-            // with appropriate modular reduction
-            SEAL_ITERATE(coeff_modulus, coeff_modulus_size, [&](auto I) {
-                SEAL_ITERATE(iter(size_t(0)), num_tiles, [&](SEAL_MAYBE_UNUSED auto J) {
-                    // Compute third output polynomial, overwriting input
-                    // x[2] = x[1] * y[1]
-                    dyadic_product_coeffmod(
-                        encrypted1_1_iter[0], encrypted2_1_iter[0], tile_size, I, encrypted1_2_iter[0]);
-
-                    // Compute second output polynomial, overwriting input
-                    // temp = x[1] * y[0]
-                    dyadic_product_coeffmod(encrypted1_1_iter[0], encrypted2_0_iter[0], tile_size, I, temp);
-                    // x[1] = x[0] * y[1]
-                    dyadic_product_coeffmod(
-                        encrypted1_0_iter[0], encrypted2_1_iter[0], tile_size, I, encrypted1_1_iter[0]);
-                    // x[1] += temp
-                    add_poly_coeffmod(encrypted1_1_iter[0], temp, tile_size, I, encrypted1_1_iter[0]);
-
-                    // Compute first output polynomial, overwriting input
-                    // x[0] = x[0] * y[0]
-                    dyadic_product_coeffmod(
-                        encrypted1_0_iter[0], encrypted2_0_iter[0], tile_size, I, encrypted1_0_iter[0]);
-
-                    // Manually increment iterators
-                    encrypted1_0_iter++;
-                    encrypted1_1_iter++;
-                    encrypted1_2_iter++;
-                    encrypted2_0_iter++;
-                    encrypted2_1_iter++;
-                });
-            });
+            ntt_tensor_product(
+                encrypted1_iter[0], encrypted1_iter[1], encrypted2_iter[0], encrypted2_iter[1],
+                relin_target ? relin_target : encrypted1_iter[2], coeff_modulus, coeff_modulus_size, pool);
         }
         else
         {
             // Allocate temporary space for the result
             SEAL_ALLOCATE_ZERO_GET_POLY_ITER(temp, dest_size, coeff_count, coeff_modulus_size, pool);
+            SEAL_ALLOCATE_GET_COEFF_ITER(prod, coeff_count, pool);
 
             SEAL_ITERATE(iter(size_t(0)), dest_size, [&](auto I) {
                 // We iterate over relevant components of encrypted1 and encrypted2 in increasing order for
@@ -688,7 +1168,6 @@ namespace seal
                     // Extra care needed here:
                     // temp_iter must be dereferenced once to produce an appropriate RNSIter
                     SEAL_ITERATE(iter(J, coeff_modulus, temp[I]), coeff_modulus_size, [&](auto K) {
-                        SEAL_ALLOCATE_GET_COEFF_ITER(prod, coeff_count, pool);
                         dyadic_product_coeffmod(get<0, 0>(K), get<0, 1>(K), coeff_count, get<1>(K), prod);
                         add_poly_coeffmod(prod, get<2>(K), coeff_count, get<1>(K), get<2>(K));
                     });
@@ -707,7 +1186,8 @@ namespace seal
         }
     }
 
-    void Evaluator::bgv_multiply(Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool) const
+    void Evaluator::bgv_multiply(
+        Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool, RNSIter relin_target) const
     {
         if (!encrypted1.is_ntt_form() || !encrypted2.is_ntt_form())
         {
@@ -729,78 +1209,29 @@ namespace seal
         // Set up iterator for the base
         auto coeff_modulus = iter(parms.coeff_modulus());
 
-        // Prepare destination
-        encrypted1.resize(context_, context_data.parms_id(), dest_size);
+        // Prepare destination; with a relinearization target the third component is written there instead
+        if (relin_target && dest_size != 3)
+        {
+            throw logic_error("relinearization target requires ciphertexts of size 2");
+        }
+        encrypted1.resize(context_, context_data.parms_id(), relin_target ? size_t(2) : dest_size);
 
         // Convert c0 and c1 to ntt
         // Set up iterators for input ciphertexts
         PolyIter encrypted1_iter = iter(encrypted1);
         ConstPolyIter encrypted2_iter = iter(encrypted2);
 
-        if (dest_size == 3)
-        {
-            // We want to keep six polynomials in the L1 cache: x[0], x[1], x[2], y[0], y[1], temp.
-            // For a 32KiB cache, which can store 32768 / 8 = 4096 coefficients, = 682.67 coefficients per polynomial,
-            // we should keep the tile size at 682 or below. The tile size must divide coeff_count, i.e. be a power of
-            // two. Some testing shows similar performance with tile size 256 and 512, and worse performance on smaller
-            // tiles. We pick the smaller of the two to prevent L1 cache misses on processors with < 32 KiB L1 cache.
-            size_t tile_size = min<size_t>(coeff_count, size_t(256));
-            size_t num_tiles = coeff_count / tile_size;
-#ifdef SEAL_DEBUG
-            if (coeff_count % tile_size != 0)
-            {
-                throw invalid_argument("tile_size does not divide coeff_count");
-            }
-#endif
-
-            // Semantic misuse of RNSIter; each is really pointing to the data for each RNS factor in sequence
-            ConstRNSIter encrypted2_0_iter(*encrypted2_iter[0], tile_size);
-            ConstRNSIter encrypted2_1_iter(*encrypted2_iter[1], tile_size);
-            RNSIter encrypted1_0_iter(*encrypted1_iter[0], tile_size);
-            RNSIter encrypted1_1_iter(*encrypted1_iter[1], tile_size);
-            RNSIter encrypted1_2_iter(*encrypted1_iter[2], tile_size);
-
-            // Temporary buffer to store intermediate results
-            SEAL_ALLOCATE_GET_COEFF_ITER(temp, tile_size, pool);
-
-            // Computes the output tile_size coefficients at a time
-            // Given input tuples of polynomials x = (x[0], x[1], x[2]), y = (y[0], y[1]), computes
-            // x = (x[0] * y[0], x[0] * y[1] + x[1] * y[0], x[1] * y[1])
-            // with appropriate modular reduction
-            SEAL_ITERATE(coeff_modulus, coeff_modulus_size, [&](auto I) {
-                SEAL_ITERATE(iter(size_t(0)), num_tiles, [&](SEAL_MAYBE_UNUSED auto J) {
-                    // Compute third output polynomial, overwriting input
-                    // x[2] = x[1] * y[1]
-                    dyadic_product_coeffmod(
-                        encrypted1_1_iter[0], encrypted2_1_iter[0], tile_size, I, encrypted1_2_iter[0]);
-
-                    // Compute second output polynomial, overwriting input
-                    // temp = x[1] * y[0]
-                    dyadic_product_coeffmod(encrypted1_1_iter[0], encrypted2_0_iter[0], tile_size, I, temp);
-                    // x[1] = x[0] * y[1]
-                    dyadic_product_coeffmod(
-                        encrypted1_0_iter[0], encrypted2_1_iter[0], tile_size, I, encrypted1_1_iter[0]);
-                    // x[1] += temp
-                    add_poly_coeffmod(encrypted1_1_iter[0], temp, tile_size, I, encrypted1_1_iter[0]);
-
-                    // Compute first output polynomial, overwriting input
-                    // x[0] = x[0] * y[0]
-                    dyadic_product_coeffmod(
-                        encrypted1_0_iter[0], encrypted2_0_iter[0], tile_size, I, encrypted1_0_iter[0]);
-
-                    // Manually increment iterators
-                    encrypted1_0_iter++;
-                    encrypted1_1_iter++;
-                    encrypted1_2_iter++;
-                    encrypted2_0_iter++;
-                    encrypted2_1_iter++;
-                });
-            });
+        if (dest_size == 3)
+        {
+            ntt_tensor_product(
+                encrypted1_iter[0], encrypted1_iter[1], encrypted2_iter[0], encrypted2_iter[1],
+                relin_target ? relin_target : encrypted1_iter[2], coeff_modulus, coeff_modulus_size, pool);
         }
         else
         {
             // Allocate temporary space for the result
             SEAL_ALLOCATE_ZERO_GET_POLY_ITER(temp, dest_size, coeff_count, coeff_modulus_size, pool);
+            SEAL_ALLOCATE_GET_COEFF_ITER(prod, coeff_count, pool);
 
             SEAL_ITERATE(iter(size_t(0)), dest_size, [&](auto I) {
                 // We iterate over relevant components of encrypted1 and encrypted2 in increasing order for
@@ -824,7 +1255,6 @@ namespace seal
                     // Extra care needed here:
                     // temp_iter must be dereferenced once to produce an appropriate RNSIter
                     SEAL_ITERATE(iter(J, coeff_modulus, temp[I]), coeff_modulus_size, [&](auto K) {
-                        SEAL_ALLOCATE_GET_COEFF_ITER(prod, coeff_count, pool);
                         dyadic_product_coeffmod(get<0, 0>(K), get<0, 1>(K), coeff_count, get<1>(K), prod);
                         add_poly_coeffmod(prod, get<2>(K), coeff_count, get<1>(K), get<2>(K));
                     });
@@ -877,11 +1307,6 @@ namespace seal
 
     void Evaluator::bfv_square(Ciphertext &encrypted, MemoryPoolHandle pool) const
     {
-        if (encrypted.is_ntt_form())
-        {
-            throw invalid_argument("encrypted cannot be in NTT form");
-        }
-
         // Extract encryption parameters.
         auto &context_data = *context_.get_context_data(encrypted.parms_id());
         auto &parms = context_data.parms();
@@ -894,8 +1319,15 @@ namespace seal
         size_t base_Bsk_size = rns_tool->base_Bsk()->size();
         size_t base_Bsk_m_tilde_size = rns_tool->base_Bsk_m_tilde()->size();
 
-        // Optimization implemented currently only for size 2 ciphertexts
-        if (encrypted_size != 2)
+        // HPS shares the extension of the operand between both sides of the product
+        if (parms.mul_method() == mul_method_type::hps)
+        {
+            bfv_multiply_hps(encrypted, encrypted, move(pool));
+            return;
+        }
+
+        // Optimization implemented currently only for size 2 ciphertexts in normal form
+        if (encrypted_size != 2 || encrypted.is_ntt_form())
         {
             bfv_multiply(encrypted, encrypted, move(pool));
             return;
@@ -1176,14 +1608,14 @@ namespace seal
         // Calculate number of relinearize_one_step calls needed
         size_t relins_needed = encrypted_size - destination_size;
 
-        // Iterator pointing to the last component of encrypted
+        // Switch the components from the last one down, each with the key for its power of the secret key; the
+        // results are accumulated in the first two components
         auto encrypted_iter = iter(encrypted);
-        encrypted_iter += encrypted_size - 1;
-
         SEAL_ITERATE(iter(size_t(0)), relins_needed, [&](auto I) {
+            size_t key_power = encrypted_size - 1 - I;
             this->switch_key_inplace(
-                encrypted, *encrypted_iter, static_cast<const KSwitchKeys &>(relin_keys),
-                RelinKeys::get_index(encrypted_size - 1 - I), pool);
+                encrypted, encrypted_iter[key_power], static_cast<const KSwitchKeys &>(relin_keys),
+                RelinKeys::get_index(key_power), pool);
         });
 
         // Put the output of final relinearization into destination.
@@ -1203,10 +1635,6 @@ namespace seal
     {
         // Assuming at this point encrypted is already validated.
         auto context_data_ptr = context_.get_context_data(encrypted.parms_id());
-        if (context_data_ptr->parms().scheme() == scheme_type::bfv && encrypted.is_ntt_form())
-        {
-            throw invalid_argument("BFV encrypted cannot be in NTT form");
-        }
         if (context_data_ptr->parms().scheme() == scheme_type::ckks && !encrypted.is_ntt_form())
         {
             throw invalid_argument("CKKS encrypted must be in NTT form");
@@ -1236,9 +1664,18 @@ namespace seal
         switch (next_parms.scheme())
         {
         case scheme_type::bfv:
-            SEAL_ITERATE(iter(encrypted_copy), encrypted_size, [&](auto I) {
-                rns_tool->divide_and_round_q_last_inplace(I, pool);
-            });
+            if (encrypted.is_ntt_form())
+            {
+                SEAL_ITERATE(iter(encrypted_copy), encrypted_size, [&](auto I) {
+                    rns_tool->divide_and_round_q_last_ntt_inplace(I, context_data.small_ntt_tables(), pool);
+                });
+            }
+            else
+            {
+                SEAL_ITERATE(iter(encrypted_copy), encrypted_size, [&](auto I) {
+                    rns_tool->divide_and_round_q_last_inplace(I, pool);
+                });
+            }
             break;
 
         case scheme_type::ckks:
@@ -1750,10 +2187,6 @@ namespace seal
         auto &parms = context_data.parms();
         if (parms.scheme() == scheme_type::bfv)
         {
-            if (encrypted.is_ntt_form())
-            {
-                throw invalid_argument("BFV encrypted cannot be in NTT form");
-            }
             if (plain.is_ntt_form())
             {
                 throw invalid_argument("BFV plain cannot be in NTT form");
@@ -1805,7 +2238,19 @@ namespace seal
         {
         case scheme_type::bfv:
         {
-            multiply_add_plain_with_scaling_variant(plain, context_data, *iter(encrypted));
+            if (encrypted.is_ntt_form())
+            {
+                // Scale the plaintext into a zero polynomial and transform it to NTT form
+                SEAL_ALLOCATE_ZERO_GET_RNS_ITER(plain_scaled, coeff_count, coeff_modulus_size, pool);
+                multiply_add_plain_with_scaling_variant(plain, context_data, plain_scaled);
+                ntt_negacyclic_harvey(plain_scaled, coeff_modulus_size, iter(context_data.small_ntt_tables()));
+                RNSIter encrypted_iter(encrypted.data(), coeff_count);
+                add_poly_coeffmod(encrypted_iter, plain_scaled, coeff_modulus_size, coeff_modulus, encrypted_iter);
+            }
+            else
+            {
+                multiply_add_plain_with_scaling_variant(plain, context_data, *iter(encrypted));
+            }
             break;
         }
 
@@ -1858,10 +2303,6 @@ namespace seal
         auto &parms = context_data.parms();
         if (parms.scheme() == scheme_type::bfv)
         {
-            if (encrypted.is_ntt_form())
-            {
-                throw invalid_argument("BFV encrypted cannot be in NTT form");
-            }
             if (plain.is_ntt_form())
             {
                 throw invalid_argument("BFV plain cannot be in NTT form");
@@ -1913,7 +2354,19 @@ namespace seal
         {
         case scheme_type::bfv:
         {
-            multiply_sub_plain_with_scaling_variant(plain, context_data, *iter(encrypted));
+            if (encrypted.is_ntt_form())
+            {
+                // Scale the plaintext into a zero polynomial and transform it to NTT form
+                SEAL_ALLOCATE_ZERO_GET_RNS_ITER(plain_scaled, coeff_count, coeff_modulus_size, pool);
+                multiply_add_plain_with_scaling_variant(plain, context_data, plain_scaled);
+                ntt_negacyclic_harvey(plain_scaled, coeff_modulus_size, iter(context_data.small_ntt_tables()));
+                RNSIter encrypted_iter(encrypted.data(), coeff_count);
+                sub_poly_coeffmod(encrypted_iter, plain_scaled, coeff_modulus_size, coeff_modulus, encrypted_iter);
+            }
+            else
+            {
+                multiply_sub_plain_with_scaling_variant(plain, context_data, *iter(encrypted));
+            }
             break;
         }
 
@@ -1996,6 +2449,112 @@ namespace seal
 #endif
     }
 
+    void Evaluator::inner_product_plain(
+        const vector<Ciphertext> &encrypteds, const vector<Plaintext> &plains, Ciphertext &destination,
+        MemoryPoolHandle pool) const
+    {
+        // Verify parameters.
+        if (encrypteds.empty())
+        {
+            throw invalid_argument("encrypteds cannot be empty");
+        }
+        if (encrypteds.size() != plains.size())
+        {
+            throw invalid_argument("encrypteds and plains have different sizes");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+        const Ciphertext &first = encrypteds[0];
+        size_t encrypted_size = 0;
+        for (size_t i = 0; i < encrypteds.size(); i++)
+        {
+            const Ciphertext &encrypted = encrypteds[i];
+            const Plaintext &plain = plains[i];
+            if (&encrypted == &destination)
+            {
+                throw invalid_argument("encrypteds must be different from destination");
+            }
+            if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
+            {
+                throw invalid_argument("encrypted is not valid for encryption parameters");
+            }
+            if (!is_metadata_valid_for(plain, context_) || !is_buffer_valid(plain))
+            {
+                throw invalid_argument("plain is not valid for encryption parameters");
+            }
+            if (!encrypted.is_ntt_form() || !plain.is_ntt_form())
+            {
+                throw invalid_argument("encrypted and plain must be in NTT form");
+            }
+            if (encrypted.parms_id() != first.parms_id() || plain.parms_id() != first.parms_id())
+            {
+                throw invalid_argument("encrypteds and plains parameter mismatch");
+            }
+            if (!util::are_close<double>(encrypted.scale() * plain.scale(), first.scale() * plains[0].scale()))
+            {
+                throw invalid_argument("scale mismatch");
+            }
+            if (encrypted.correction_factor() != first.correction_factor())
+            {
+                throw invalid_argument("correction factor mismatch");
+            }
+            encrypted_size = max(encrypted_size, encrypted.size());
+        }
+
+        // Extract encryption parameters.
+        auto &context_data = *context_.get_context_data(first.parms_id());
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_modulus_size = coeff_modulus.size();
+        size_t count = encrypteds.size();
+
+        double new_scale = first.scale() * plains[0].scale();
+        if (!is_scale_within_bounds(new_scale, context_data))
+        {
+            throw invalid_argument("scale out of bounds");
+        }
+
+        destination.resize(context_, first.parms_id(), encrypted_size);
+        destination.is_ntt_form() = true;
+        destination.scale() = new_scale;
+        destination.correction_factor() = first.correction_factor();
+
+        // The RNS components are independent; each one accumulates the products of all operands that are large
+        // enough and reduces every coefficient once
+        auto destination_iter = iter(destination);
+        parallel_for(
+            thread_pool_.get(), encrypted_size * coeff_modulus_size, pool,
+            [&](size_t index, const MemoryPoolHandle &local_pool) {
+                size_t I = index / coeff_modulus_size;
+                size_t J = index % coeff_modulus_size;
+                auto operands1(allocate<ConstCoeffIter>(count, local_pool));
+                auto operands2(allocate<ConstCoeffIter>(count, local_pool));
+                size_t term_count = 0;
+                for (size_t k = 0; k < count; k++)
+                {
+                    if (encrypteds[k].size() > I)
+                    {
+                        operands1[term_count] = iter(encrypteds[k])[I][J];
+                        operands2[term_count] = ConstRNSIter(plains[k].data(), coeff_count)[J];
+                        term_count++;
+                    }
+                }
+                dyadic_product_accumulate_coeffmod(
+                    operands1.get(), operands2.get(), term_count, coeff_count, coeff_modulus[J],
+                    destination_iter[I][J]);
+            });
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (destination.is_transparent())
+        {
+            throw logic_error("result ciphertext is transparent");
+        }
+#endif
+    }
+
     void Evaluator::multiply_plain_normal(Ciphertext &encrypted, const Plaintext &plain, MemoryPoolHandle pool) const
     {
         // Extract encryption parameters.
@@ -2412,7 +2971,7 @@ namespace seal
         // DO NOT CHANGE EXECUTION ORDER OF FOLLOWING SECTION
         // BEGIN: Apply Galois for each ciphertext
         // Execution order is sensitive, since apply_galois is not inplace!
-        if (parms.scheme() == scheme_type::bfv)
+        if (parms.scheme() == scheme_type::bfv && !encrypted.is_ntt_form())
         {
             // !!! DO NOT CHANGE EXECUTION ORDER!!!
 
@@ -2426,7 +2985,9 @@ namespace seal
             // Next transform encrypted.data(1)
             galois_tool->apply_galois(encrypted_iter[1], coeff_modulus_size, galois_elt, coeff_modulus, temp);
         }
-        else if (parms.scheme() == scheme_type::ckks || parms.scheme() == scheme_type::bgv)
+        else if (
+            parms.scheme() == scheme_type::bfv || parms.scheme() == scheme_type::ckks ||
+            parms.scheme() == scheme_type::bgv)
         {
             // !!! DO NOT CHANGE EXECUTION ORDER!!!
 
@@ -2520,6 +3081,154 @@ namespace seal
         }
     }
 
+    void Evaluator::rotate_many_internal(
+        const Ciphertext &encrypted, const vector<int> &steps, const GaloisKeys &galois_keys,
+        vector<Ciphertext> &destination, MemoryPoolHandle pool) const
+    {
+        // Verify parameters.
+        if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
+        if (!context_data.qualifiers().using_batching)
+        {
+            throw logic_error("encryption parameters do not support batching");
+        }
+        if (galois_keys.parms_id() != context_.key_parms_id())
+        {
+            throw invalid_argument("galois_keys is not valid for encryption parameters");
+        }
+        if (!context_.using_keyswitching())
+        {
+            throw logic_error("keyswitching is not supported by the context");
+        }
+        if (encrypted.size() > 2)
+        {
+            throw invalid_argument("encrypted size must be 2");
+        }
+        if (context_data.parms().scheme() != scheme_type::bfv && !encrypted.is_ntt_form())
+        {
+            throw invalid_argument("encrypted must be in NTT form");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+        for (auto &each_destination : destination)
+        {
+            if (&each_destination == &encrypted)
+            {
+                throw invalid_argument("encrypted cannot be an element of destination");
+            }
+        }
+
+        // Extract encryption parameters.
+        auto &parms = context_data.parms();
+        auto scheme = parms.scheme();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t decomp_modulus_size = coeff_modulus.size();
+        auto &kswitch_tool = *context_data.kswitch_tool();
+        size_t rns_modulus_size = decomp_modulus_size + kswitch_tool.special_prime_count();
+        size_t digit_count = kswitch_tool.digit_count();
+        auto &key_context_data = *context_.key_context_data();
+        auto &key_modulus = key_context_data.parms().coeff_modulus();
+        auto key_ntt_tables = iter(key_context_data.small_ntt_tables());
+        // Use key_context_data where permutation tables exist since previous runs.
+        auto galois_tool = key_context_data.galois_tool();
+
+        // Size check
+        if (!product_fits_in(coeff_count, rns_modulus_size, digit_count))
+        {
+            throw logic_error("invalid parameters");
+        }
+
+        // Galois elements of the steps for which a key is present; others fall back to rotate_internal
+        vector<uint32_t> galois_elts(steps.size(), 0);
+        bool any_hoisted = false;
+        for (size_t i = 0; i < steps.size(); i++)
+        {
+            if (steps[i] != 0)
+            {
+                uint32_t galois_elt = context_data.galois_tool()->get_elt_from_step(steps[i]);
+                if (galois_keys.has_key(galois_elt))
+                {
+                    galois_elts[i] = galois_elt;
+                    any_hoisted = true;
+                }
+            }
+        }
+
+        // The decomposition of encrypted.data(1) is computed once and shared by all rotations: an automorphism
+        // commutes with the RNS decomposition up to the choice of representatives, and in NTT form it is a
+        // permutation of the coefficients, so each rotation only needs to permute the decomposed operands.
+        bool input_in_ntt_form = encrypted.is_ntt_form();
+        Pointer<uint64_t> t_decomposed;
+        if (any_hoisted)
+        {
+            t_decomposed = allocate_poly_array(rns_modulus_size, coeff_count, digit_count, pool);
+        }
+        PolyIter decomposed_iter(t_decomposed.get(), coeff_count, digit_count);
+        if (any_hoisted)
+        {
+            // Create a copy of encrypted.data(1) in normal form
+            SEAL_ALLOCATE_GET_RNS_ITER(t_target, coeff_count, decomp_modulus_size, pool);
+            ConstRNSIter target_iter(encrypted.data(1), coeff_count);
+            set_uint(target_iter, decomp_modulus_size * coeff_count, t_target);
+            if (input_in_ntt_form)
+            {
+                inverse_ntt_negacyclic_harvey(t_target, decomp_modulus_size, key_ntt_tables);
+            }
+
+            decompose_key_switch_target(
+                t_target, target_iter, input_in_ntt_form, kswitch_tool, key_modulus, key_ntt_tables, decomposed_iter,
+                pool, thread_pool_.get());
+        }
+
+        destination.resize(steps.size());
+        for (size_t i = 0; i < steps.size(); i++)
+        {
+            Ciphertext &rotated = destination[i];
+            rotated = encrypted;
+            if (!galois_elts[i])
+            {
+                // No rotation, or no key for this step; rotate_internal composes it from the available keys
+                rotate_internal(rotated, steps[i], galois_keys, pool);
+                continue;
+            }
+
+            // Apply Galois to encrypted.data(0) and wipe rotated.data(1)
+            auto encrypted_iter = iter(encrypted);
+            auto rotated_iter = iter(rotated);
+            if (!input_in_ntt_form)
+            {
+                galois_tool->apply_galois(
+                    encrypted_iter[0], decomp_modulus_size, galois_elts[i], coeff_modulus, rotated_iter[0]);
+            }
+            else
+            {
+                galois_tool->apply_galois_ntt(encrypted_iter[0], decomp_modulus_size, galois_elts[i], rotated_iter[0]);
+            }
+            set_zero_poly(coeff_count, decomp_modulus_size, rotated.data(1));
+
+            // Calculate (sigma(d) * galois_key[0], sigma(d) * galois_key[1]) + (sigma(ct[0]), 0)
+            switch_key_decomposed_inplace(
+                rotated,
+                [&](size_t I, RNSIter t_ntt) {
+                    galois_tool->apply_galois_ntt(decomposed_iter[I], digit_count, galois_elts[i], t_ntt);
+                },
+                static_cast<const KSwitchKeys &>(galois_keys), GaloisKeys::get_index(galois_elts[i]), pool);
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+            // Transparent ciphertext output is not allowed.
+            if (rotated.is_transparent())
+            {
+                throw logic_error("result ciphertext is transparent");
+            }
+#endif
+        }
+    }
+
     void Evaluator::switch_key_inplace(
         Ciphertext &encrypted, ConstRNSIter target_iter, const KSwitchKeys &kswitch_keys, size_t kswitch_keys_index,
         MemoryPoolHandle pool) const
@@ -2559,10 +3268,6 @@ namespace seal
         {
             throw invalid_argument("pool is uninitialized");
         }
-        if (scheme == scheme_type::bfv && encrypted.is_ntt_form())
-        {
-            throw invalid_argument("BFV encrypted cannot be in NTT form");
-        }
         if (scheme == scheme_type::ckks && !encrypted.is_ntt_form())
         {
             throw invalid_argument("CKKS encrypted must be in NTT form");
@@ -2577,18 +3282,87 @@ namespace seal
         size_t decomp_modulus_size = parms.coeff_modulus().size();
         auto &key_modulus = key_parms.coeff_modulus();
         size_t key_modulus_size = key_modulus.size();
-        size_t rns_modulus_size = decomp_modulus_size + 1;
+        auto &kswitch_tool = *context_data.kswitch_tool();
+        size_t rns_modulus_size = decomp_modulus_size + kswitch_tool.special_prime_count();
+        size_t digit_count = kswitch_tool.digit_count();
         auto key_ntt_tables = iter(key_context_data.small_ntt_tables());
-        auto modswitch_factors = key_context_data.rns_tool()->inv_q_last_mod_q();
 
         // Size check
-        if (!product_fits_in(coeff_count, rns_modulus_size, size_t(2)))
+        if (!product_fits_in(coeff_count, rns_modulus_size, size_t(2)) ||
+            !product_fits_in(coeff_count, rns_modulus_size, digit_count))
         {
             throw logic_error("invalid parameters");
         }
 
+        // Create a copy of target_iter
+        SEAL_ALLOCATE_GET_RNS_ITER(t_target, coeff_count, decomp_modulus_size, pool);
+        set_uint(target_iter, decomp_modulus_size * coeff_count, t_target);
+
+        // In CKKS or BGV, and in BFV in NTT form, t_target is in NTT form; switch back to normal form
+        bool input_in_ntt_form = encrypted.is_ntt_form();
+        if (input_in_ntt_form)
+        {
+            inverse_ntt_negacyclic_harvey(t_target, decomp_modulus_size, key_ntt_tables, thread_pool_.get());
+        }
+
+        if (kswitch_tool.digit_size() == 1)
+        {
+            // Decompose for one output RNS component at a time
+            switch_key_decomposed_inplace(
+                encrypted,
+                [&](size_t I, RNSIter t_ntt) {
+                    size_t key_index = I < decomp_modulus_size ? I : I + key_modulus_size - rns_modulus_size;
+                    decompose_key_switch_operand(
+                        t_target, target_iter, input_in_ntt_form, decomp_modulus_size, I, key_index, key_modulus,
+                        key_ntt_tables, t_ntt);
+                },
+                kswitch_keys, kswitch_keys_index, pool);
+        }
+        else
+        {
+            // The base conversion of a digit yields all output RNS components at once
+            auto t_decomposed(allocate_poly_array(rns_modulus_size, coeff_count, digit_count, pool));
+            PolyIter decomposed_iter(t_decomposed.get(), coeff_count, digit_count);
+            decompose_key_switch_target(
+                t_target, target_iter, input_in_ntt_form, kswitch_tool, key_modulus, key_ntt_tables, decomposed_iter,
+                pool, thread_pool_.get());
+
+            switch_key_decomposed_inplace(
+                encrypted,
+                [&](size_t I, RNSIter t_ntt) { set_poly(decomposed_iter[I], coeff_count, digit_count, t_ntt); },
+                kswitch_keys, kswitch_keys_index, pool);
+        }
+    }
+
+    void Evaluator::switch_key_decomposed_inplace(
+        Ciphertext &encrypted, const function<void(size_t, RNSIter)> &decompose, const KSwitchKeys &kswitch_keys,
+        size_t kswitch_keys_index, MemoryPoolHandle pool) const
+    {
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
+        auto &key_context_data = *context_.key_context_data();
+        auto &key_parms = key_context_data.parms();
+        auto scheme = parms.scheme();
+
+        // Extract encryption parameters.
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t decomp_modulus_size = parms.coeff_modulus().size();
+        auto &key_modulus = key_parms.coeff_modulus();
+        size_t key_modulus_size = key_modulus.size();
+        auto &kswitch_tool = *context_data.kswitch_tool();
+        size_t special_prime_count = kswitch_tool.special_prime_count();
+        size_t rns_modulus_size = decomp_modulus_size + special_prime_count;
+        size_t digit_count = kswitch_tool.digit_count();
+        auto key_ntt_tables = iter(key_context_data.small_ntt_tables());
+        auto modswitch_factors = key_context_data.rns_tool()->inv_q_last_mod_q();
+        ThreadPool *thread_pool = thread_pool_.get();
+
         // Prepare input
         auto &key_vector = kswitch_keys.data()[kswitch_keys_index];
+        if (key_vector.size() < digit_count)
+        {
+            throw invalid_argument("kswitch_keys is not valid for encryption parameters");
+        }
         size_t key_component_count = key_vector[0].data().size();
 
         // Check only the used component in KSwitchKeys.
@@ -2600,59 +3374,49 @@ namespace seal
             }
         }
 
-        // Create a copy of target_iter
-        SEAL_ALLOCATE_GET_RNS_ITER(t_target, coeff_count, decomp_modulus_size, pool);
-        set_uint(target_iter, decomp_modulus_size * coeff_count, t_target);
+        // Temporary result
+        auto t_poly_prod(allocate_zero_poly_array(key_component_count, coeff_count, rns_modulus_size, pool));
 
-        // In CKKS or BGV, t_target is in NTT form; switch back to normal form
-        if (scheme == scheme_type::ckks || scheme == scheme_type::bgv)
+        // Without a thread pool the RNS components are processed one at a time, so the lazy accumulator and the
+        // decomposed operands are allocated once and reused for every component
+        bool serial = !thread_pool || rns_modulus_size < 2;
+        Pointer<uint64_t> t_poly_lazy_serial;
+        Pointer<uint64_t> t_ntt_serial;
+        if (serial)
         {
-            inverse_ntt_negacyclic_harvey(t_target, decomp_modulus_size, key_ntt_tables);
+            t_poly_lazy_serial = allocate_poly_array(key_component_count, coeff_count, 2, pool);
+            t_ntt_serial = allocate_poly(coeff_count, digit_count, pool);
         }
 
-        // Temporary result
-        auto t_poly_prod(allocate_zero_poly_array(key_component_count, coeff_count, rns_modulus_size, pool));
-
-        SEAL_ITERATE(iter(size_t(0)), rns_modulus_size, [&](auto I) {
-            size_t key_index = (I == decomp_modulus_size ? key_modulus_size - 1 : I);
+        // The RNS components are independent
+        parallel_for(thread_pool, rns_modulus_size, pool, [&](size_t I, const MemoryPoolHandle &local_pool) {
+            size_t key_index = (I < decomp_modulus_size ? I : I + key_modulus_size - rns_modulus_size);
 
             // Product of two numbers is up to 60 + 60 = 120 bits, so we can sum up to 256 of them without reduction.
             size_t lazy_reduction_summand_bound = size_t(SEAL_MULTIPLY_ACCUMULATE_USER_MOD_MAX);
             size_t lazy_reduction_counter = lazy_reduction_summand_bound;
 
-            // Allocate memory for a lazy accumulator (128-bit coefficients)
-            auto t_poly_lazy(allocate_zero_poly_array(key_component_count, coeff_count, 2, pool));
+            // Lazy accumulator (128-bit coefficients) and decomposed operands, one per digit, in NTT form for the
+            // modulus with index key_index
+            Pointer<uint64_t> t_poly_lazy_local;
+            Pointer<uint64_t> t_ntt_local;
+            if (!serial)
+            {
+                t_poly_lazy_local = allocate_poly_array(key_component_count, coeff_count, 2, local_pool);
+                t_ntt_local = allocate_poly(coeff_count, digit_count, local_pool);
+            }
+            uint64_t *t_poly_lazy = serial ? t_poly_lazy_serial.get() : t_poly_lazy_local.get();
+            set_zero_uint(mul_safe(key_component_count, coeff_count, size_t(2)), t_poly_lazy);
 
             // Semantic misuse of PolyIter; this is really pointing to the data for a single RNS factor
-            PolyIter accumulator_iter(t_poly_lazy.get(), 2, coeff_count);
+            PolyIter accumulator_iter(t_poly_lazy, 2, coeff_count);
 
-            // Multiply with keys and perform lazy reduction on product's coefficients
-            SEAL_ITERATE(iter(size_t(0)), decomp_modulus_size, [&](auto J) {
-                SEAL_ALLOCATE_GET_COEFF_ITER(t_ntt, coeff_count, pool);
-                ConstCoeffIter t_operand;
+            RNSIter t_ntt(serial ? t_ntt_serial.get() : t_ntt_local.get(), coeff_count);
+            decompose(I, t_ntt);
 
-                // RNS-NTT form exists in input
-                if ((scheme == scheme_type::ckks || scheme == scheme_type::bgv) && (I == J))
-                {
-                    t_operand = target_iter[J];
-                }
-                // Perform RNS-NTT conversion
-                else
-                {
-                    // No need to perform RNS conversion (modular reduction)
-                    if (key_modulus[J] <= key_modulus[key_index])
-                    {
-                        set_uint(t_target[J], coeff_count, t_ntt);
-                    }
-                    // Perform RNS conversion (modular reduction)
-                    else
-                    {
-                        modulo_poly_coeffs(t_target[J], coeff_count, key_modulus[key_index], t_ntt);
-                    }
-                    // NTT conversion lazy outputs in [0, 4q)
-                    ntt_negacyclic_harvey_lazy(t_ntt, key_ntt_tables[key_index]);
-                    t_operand = t_ntt;
-                }
+            // Multiply with keys and perform lazy reduction on product's coefficients
+            SEAL_ITERATE(iter(size_t(0)), digit_count, [&](auto J) {
+                ConstCoeffIter t_operand = t_ntt[J];
 
                 // Multiply with keys and modular accumulate products in a lazy fashion
                 SEAL_ITERATE(iter(key_vector[J].data(), accumulator_iter), key_component_count, [&](auto K) {
@@ -2711,6 +3475,41 @@ namespace seal
 
         // Perform modulus switching with scaling
         PolyIter t_poly_prod_iter(t_poly_prod.get(), coeff_count, rns_modulus_size);
+        if (special_prime_count > 1)
+        {
+            auto coeff_modulus = iter(parms.coeff_modulus());
+            auto inv_p_mod_q = iter(kswitch_tool.inv_p_mod_q());
+            SEAL_ITERATE(iter(encrypted, t_poly_prod_iter), key_component_count, [&](auto I) {
+                // Bring the components modulo the special primes to normal form
+                RNSIter t_special = get<1>(I) + decomp_modulus_size;
+                inverse_ntt_negacyclic_harvey(
+                    t_special, special_prime_count, key_ntt_tables + (key_modulus_size - special_prime_count),
+                    thread_pool);
+
+                // delta = ct mod P, corrected for rounding or for the plaintext modulus, and converted to q
+                SEAL_ALLOCATE_GET_RNS_ITER(t_delta, coeff_count, decomp_modulus_size, pool);
+                kswitch_tool.mod_down_delta(t_special, t_delta, pool);
+                if (!encrypted.is_ntt_form())
+                {
+                    inverse_ntt_negacyclic_harvey(get<1>(I), decomp_modulus_size, key_ntt_tables, thread_pool);
+                }
+                else
+                {
+                    ntt_negacyclic_harvey(t_delta, decomp_modulus_size, key_ntt_tables, thread_pool);
+                }
+
+                // P^(-1) * (ct - delta) mod qi
+                SEAL_ITERATE(
+                    iter(get<0>(I), get<1>(I), t_delta, coeff_modulus, inv_p_mod_q), decomp_modulus_size,
+                    [&](auto J) {
+                        sub_poly_coeffmod(get<1>(J), get<2>(J), coeff_count, get<3>(J), get<1>(J));
+                        multiply_poly_scalar_coeffmod(get<1>(J), coeff_count, get<4>(J), get<3>(J), get<1>(J));
+                        add_poly_coeffmod(get<1>(J), get<0>(J), coeff_count, get<3>(J), get<0>(J));
+                    });
+            });
+            return;
+        }
+
         SEAL_ITERATE(iter(encrypted, t_poly_prod_iter), key_component_count, [&](auto I) {
             if (scheme == scheme_type::bgv)
             {
@@ -2731,9 +3530,12 @@ namespace seal
                     multiply_poly_scalar_coeffmod(k, coeff_count, qk_inv_qp, plain_modulus, k);
                 }
 
-                SEAL_ALLOCATE_ZERO_GET_COEFF_ITER(delta, coeff_count, pool);
-                SEAL_ALLOCATE_ZERO_GET_COEFF_ITER(c_mod_qi, coeff_count, pool);
-                SEAL_ITERATE(iter(I, key_modulus, modswitch_factors, key_ntt_tables), decomp_modulus_size, [&](auto J) {
+                auto rns_iter = iter(I, key_modulus, modswitch_factors, key_ntt_tables);
+                parallel_for(thread_pool, decomp_modulus_size, pool, [&](size_t j, const MemoryPoolHandle &local_pool) {
+                    auto J = rns_iter[j];
+                    SEAL_ALLOCATE_GET_COEFF_ITER(delta, coeff_count, local_pool);
+                    SEAL_ALLOCATE_GET_COEFF_ITER(c_mod_qi, coeff_count, local_pool);
+
                     // delta = k mod q_i
                     modulo_poly_coeffs(k, coeff_count, get<1>(J), delta);
                     // delta = k * q_k mod q_i
@@ -2769,8 +3571,10 @@ namespace seal
                     J = barrett_reduce_64(J + qk_half, key_modulus[key_modulus_size - 1]);
                 });
 
-                SEAL_ITERATE(iter(I, key_modulus, key_ntt_tables, modswitch_factors), decomp_modulus_size, [&](auto J) {
-                    SEAL_ALLOCATE_GET_COEFF_ITER(t_ntt, coeff_count, pool);
+                auto rns_iter = iter(I, key_modulus, key_ntt_tables, modswitch_factors);
+                parallel_for(thread_pool, decomp_modulus_size, pool, [&](size_t j, const MemoryPoolHandle &local_pool) {
+                    auto J = rns_iter[j];
+                    SEAL_ALLOCATE_GET_COEFF_ITER(t_ntt, coeff_count, local_pool);
 
                     // (ct mod 4qk) mod qi
                     uint64_t qi = get<1>(J).value();
@@ -2789,7 +3593,7 @@ namespace seal
                     SEAL_ITERATE(t_ntt, coeff_count, [fix](auto &K) { K += fix; });
 
                     uint64_t qi_lazy = qi << 1; // some multiples of qi
-                    if (scheme == scheme_type::ckks)
+                    if (encrypted.is_ntt_form())
                     {
                         // This ntt_negacyclic_harvey_lazy results in [0, 4*qi).
                         ntt_negacyclic_harvey_lazy(t_ntt, get<2>(J));
@@ -2802,7 +3606,7 @@ namespace seal
                         qi_lazy = qi << 2;
 #endif
                     }
-                    else if (scheme == scheme_type::bfv)
+                    else
                     {
                         inverse_ntt_negacyclic_harvey_lazy(get<0, 1>(J), get<2>(J));
                     }
@@ -13,7 +13,10 @@
 #include "seal/secretkey.h"
 #include "seal/valcheck.h"
 #include "seal/util/iterator.h"
+#include "seal/util/threadpool.h"
+#include <functional>
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <vector>
 
@@ -66,6 +69,14 @@ namespace seal
     input(s), with the exception of the transform_to_ntt and transform_from_ntt functions, which change the state.
     Ideally, unless these two functions are called, all other functions should "just work".
 
+    @par NTT-resident BFV
+    BFV ciphertexts may also be kept in NTT form, like BGV ciphertexts: after transform_to_ntt, additions, plain
+    additions and multiplications, multiplications, relinearization, rotations and modulus switching accept them and
+    return results in NTT form, and the Decryptor decrypts them directly. Plaintexts passed to add_plain and sub_plain
+    stay in coefficient representation. Multiplication only transforms the copies it needs for its base extension,
+    so a chain of plain multiplications and key switching operations avoids a transform of the ciphertext per
+    operation. Both operands of a multiplication must be in the same form.
+
     @see EncryptionParameters for more details on encryption parameters.
     @see BatchEncoder for more details on batching
     @see RelinKeys for more details on relinearization keys.
@@ -82,6 +93,29 @@ namespace seal
         */
         Evaluator(const SEALContext &context);
 
+        /**
+        Creates an Evaluator instance initialized with the specified SEALContext that runs the independent loops of
+        key switching, BFV multiplication, and inner_product_plain over RNS components and ciphertext components on
+        an internal pool of thread_count threads. The thread calling an evaluation function takes part in the work
+        and allocates from the memory pool passed to the function; the other threads allocate from their
+        thread-local memory pools. Calls made concurrently from several threads on the same Evaluator are correct but
+        only one of them runs in parallel at a time.
+
+        @param[in] context The SEALContext
+        @param[in] thread_count The number of threads including the calling thread, or 0 for the number of hardware
+        threads
+        @throws std::invalid_argument if the encryption parameters are not valid
+        */
+        Evaluator(const SEALContext &context, std::size_t thread_count);
+
+        /**
+        Returns the number of threads used by the evaluation functions, including the calling thread.
+        */
+        SEAL_NODISCARD inline std::size_t thread_count() const noexcept
+        {
+            return thread_pool_ ? thread_pool_->thread_count() : 1;
+        }
+
         /**
         Negates a ciphertext.
 
@@ -330,6 +364,130 @@ namespace seal
             relinearize_inplace(destination, relin_keys, std::move(pool));
         }
 
+        /**
+        Multiplies two ciphertexts and relinearizes the product. If both ciphertexts have size 2, the third component
+        of the product is fed directly into key switching and the size 3 ciphertext is never materialized; otherwise
+        this function is equivalent to multiply_inplace followed by relinearize_inplace. The result is stored in
+        encrypted1. Dynamic memory allocations in the process are allocated from the memory pool pointed to by the
+        given MemoryPoolHandle.
+
+        @param[in] encrypted1 The first ciphertext to multiply
+        @param[in] encrypted2 The second ciphertext to multiply
+        @param[in] relin_keys The relinearization keys
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted1, encrypted2, or relin_keys is not valid for the encryption
+        parameters
+        @throws std::invalid_argument if encrypted1 or encrypted2 is not in the default NTT form
+        @throws std::invalid_argument if encrypted1 and encrypted2 are at different level
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if the size of relin_keys is too small
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void multiply_relin_inplace(
+            Ciphertext &encrypted1, const Ciphertext &encrypted2, const RelinKeys &relin_keys,
+            MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
+        /**
+        Multiplies two ciphertexts and relinearizes the product. This function computes the relinearized product of
+        encrypted1 and encrypted2 as multiply_relin_inplace does and stores the result in the destination parameter.
+        Dynamic memory allocations in the process are allocated from the memory pool pointed to by the given
+        MemoryPoolHandle.
+
+        @param[in] encrypted1 The first ciphertext to multiply
+        @param[in] encrypted2 The second ciphertext to multiply
+        @param[in] relin_keys The relinearization keys
+        @param[out] destination The ciphertext to overwrite with the relinearized product
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted1, encrypted2, or relin_keys is not valid for the encryption
+        parameters
+        @throws std::invalid_argument if encrypted1 or encrypted2 is not in the default NTT form
+        @throws std::invalid_argument if encrypted1 and encrypted2 are at different level
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if the size of relin_keys is too small
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void multiply_relin(
+            const Ciphertext &encrypted1, const Ciphertext &encrypted2, const RelinKeys &relin_keys,
+            Ciphertext &destination, MemoryPoolHandle pool = MemoryManager::GetPool()) const
+        {
+            if (&encrypted2 == &destination)
+            {
+                multiply_relin_inplace(destination, encrypted1, relin_keys, std::move(pool));
+            }
+            else
+            {
+                destination = encrypted1;
+                multiply_relin_inplace(destination, encrypted2, relin_keys, std::move(pool));
+            }
+        }
+
+        /**
+        Multiplies two CKKS ciphertexts, relinearizes the product, and rescales the result to the next level as
+        multiply_relin_inplace followed by rescale_to_next_inplace would. The result is stored in encrypted1. Dynamic
+        memory allocations in the process are allocated from the memory pool pointed to by the given
+        MemoryPoolHandle.
+
+        @param[in] encrypted1 The first ciphertext to multiply
+        @param[in] encrypted2 The second ciphertext to multiply
+        @param[in] relin_keys The relinearization keys
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if the scheme is not scheme_type::ckks
+        @throws std::invalid_argument if encrypted1, encrypted2, or relin_keys is not valid for the encryption
+        parameters
+        @throws std::invalid_argument if encrypted1 or encrypted2 is not in NTT form
+        @throws std::invalid_argument if encrypted1 and encrypted2 are at different level
+        @throws std::invalid_argument if encrypted1 and encrypted2 are already at lowest level
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if the size of relin_keys is too small
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void multiply_relin_rescale_inplace(
+            Ciphertext &encrypted1, const Ciphertext &encrypted2, const RelinKeys &relin_keys,
+            MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
+        /**
+        Multiplies two CKKS ciphertexts, relinearizes the product, and rescales the result to the next level as
+        multiply_relin_rescale_inplace does, and stores the result in the destination parameter. Dynamic memory
+        allocations in the process are allocated from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted1 The first ciphertext to multiply
+        @param[in] encrypted2 The second ciphertext to multiply
+        @param[in] relin_keys The relinearization keys
+        @param[out] destination The ciphertext to overwrite with the result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if the scheme is not scheme_type::ckks
+        @throws std::invalid_argument if encrypted1, encrypted2, or relin_keys is not valid for the encryption
+        parameters
+        @throws std::invalid_argument if encrypted1 or encrypted2 is not in NTT form
+        @throws std::invalid_argument if encrypted1 and encrypted2 are at different level
+        @throws std::invalid_argument if encrypted1 and encrypted2 are already at lowest level
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if the size of relin_keys is too small
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void multiply_relin_rescale(
+            const Ciphertext &encrypted1, const Ciphertext &encrypted2, const RelinKeys &relin_keys,
+            Ciphertext &destination, MemoryPoolHandle pool = MemoryManager::GetPool()) const
+        {
+            if (&encrypted2 == &destination)
+            {
+                multiply_relin_rescale_inplace(destination, encrypted1, relin_keys, std::move(pool));
+            }
+            else
+            {
+                destination = encrypted1;
+                multiply_relin_rescale_inplace(destination, encrypted2, relin_keys, std::move(pool));
+            }
+        }
+
         /**
         Given a ciphertext encrypted modulo q_1...q_k, this function switches the modulus down to q_1...q_{k-1} and
         stores the result in the destination parameter. Dynamic memory allocations in the process are allocated from the
@@ -850,6 +1008,33 @@ namespace seal
             multiply_plain_inplace(destination, plain, std::move(pool));
         }
 
+        /**
+        Computes the inner product of a vector of ciphertexts with a vector of plaintexts, i.e., the sum of
+        encrypteds[i] * plains[i], and stores the result in the destination parameter. All operands must be in NTT
+        form and at the same level. The products are accumulated with 128-bit intermediate values and every
+        coefficient is reduced only once, which is considerably faster than calling multiply_plain and add_many.
+        The ciphertexts may have different sizes; the result has the size of the largest one. For the CKKS scheme
+        all products must have the same scale, and for the BGV scheme all ciphertexts must have the same correction
+        factor. Dynamic memory allocations in the process are allocated from the memory pool pointed to by the given
+        MemoryPoolHandle.
+
+        @param[in] encrypteds The ciphertexts to multiply
+        @param[in] plains The plaintexts to multiply
+        @param[out] destination The ciphertext to overwrite with the inner product
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypteds is empty or encrypteds and plains have different sizes
+        @throws std::invalid_argument if any of the operands is not valid for the encryption parameters
+        @throws std::invalid_argument if any of the operands is not in NTT form
+        @throws std::invalid_argument if the operands are at different levels
+        @throws std::invalid_argument if the products have different scales or correction factors
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void inner_product_plain(
+            const std::vector<Ciphertext> &encrypteds, const std::vector<Plaintext> &plains, Ciphertext &destination,
+            MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
         /**
         Transforms a plaintext to NTT domain. This functions applies the Number Theoretic Transform to a plaintext by
         first embedding integers modulo the plaintext modulus to integers modulo the coefficient modulus and then
@@ -1080,7 +1265,7 @@ namespace seal
         the encryption parameters
         @throws std::invalid_argument if galois_keys do not correspond to the top
         level parameters in the current context
-        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if the scheme is BGV and encrypted is not in NTT form
         @throws std::invalid_argument if encrypted has size larger than 2
         @throws std::invalid_argument if steps has too big absolute value
         @throws std::invalid_argument if necessary Galois keys are not present
@@ -1096,6 +1281,46 @@ namespace seal
             rotate_rows_inplace(destination, steps, galois_keys, std::move(pool));
         }
 
+        /**
+        Rotates plaintext matrix rows cyclically by several step counts at once. When batching is used with the
+        BFV/BGV scheme, this function writes to destination[i] the encrypted plaintext matrix rows rotated cyclically to
+        the left (steps[i] > 0) or to the right (steps[i] < 0). The key switching decomposition of the input is
+        computed only once and shared by all rotations that have a Galois key, so rotating by k steps costs much less
+        than k calls to rotate_rows. Steps with no Galois key are rotated as in rotate_rows. Dynamic memory allocations
+        in the process are allocated from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to rotate
+        @param[in] steps The numbers of steps to rotate (positive left, negative right)
+        @param[in] galois_keys The Galois keys
+        @param[out] destination The vector to overwrite with one rotated ciphertext per element of steps
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::bfv or scheme_type::bgv
+        @throws std::logic_error if the encryption parameters do not support batching
+        @throws std::invalid_argument if encrypted or galois_keys is not valid for
+        the encryption parameters
+        @throws std::invalid_argument if galois_keys do not correspond to the top
+        level parameters in the current context
+        @throws std::invalid_argument if encrypted is not in the default NTT form
+        @throws std::invalid_argument if encrypted has size larger than 2
+        @throws std::invalid_argument if encrypted is an element of destination
+        @throws std::invalid_argument if any of steps has too big absolute value
+        @throws std::invalid_argument if necessary Galois keys are not present
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void rotate_rows_many(
+            const Ciphertext &encrypted, const std::vector<int> &steps, const GaloisKeys &galois_keys,
+            std::vector<Ciphertext> &destination, MemoryPoolHandle pool = MemoryManager::GetPool()) const
+        {
+            auto scheme = context_.key_context_data()->parms().scheme();
+            if (scheme != scheme_type::bfv && scheme != scheme_type::bgv)
+            {
+                throw std::logic_error("unsupported scheme");
+            }
+            rotate_many_internal(encrypted, steps, galois_keys, destination, std::move(pool));
+        }
+
         /**
         Rotates plaintext matrix columns cyclically. When batching is used with the BFV scheme, this function rotates
         the encrypted plaintext matrix columns cyclically. Since the size of the batched matrix is 2-by-(N/2), where N
@@ -1112,7 +1337,7 @@ namespace seal
         the encryption parameters
         @throws std::invalid_argument if galois_keys do not correspond to the top
         level parameters in the current context
-        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if the scheme is BGV and encrypted is not in NTT form
         @throws std::invalid_argument if encrypted has size larger than 2
         @throws std::invalid_argument if necessary Galois keys are not present
         @throws std::invalid_argument if pool is uninitialized
@@ -1148,7 +1373,7 @@ namespace seal
         the encryption parameters
         @throws std::invalid_argument if galois_keys do not correspond to the top
         level parameters in the current context
-        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if the scheme is BGV and encrypted is not in NTT form
         @throws std::invalid_argument if encrypted has size larger than 2
         @throws std::invalid_argument if necessary Galois keys are not present
         @throws std::invalid_argument if pool is uninitialized
@@ -1215,7 +1440,7 @@ namespace seal
         the encryption parameters
         @throws std::invalid_argument if galois_keys do not correspond to the top
         level parameters in the current context
-        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if the scheme is BGV and encrypted is not in NTT form
         @throws std::invalid_argument if encrypted has size larger than 2
         @throws std::invalid_argument if steps has too big absolute value
         @throws std::invalid_argument if necessary Galois keys are not present
@@ -1231,6 +1456,44 @@ namespace seal
             rotate_vector_inplace(destination, steps, galois_keys, std::move(pool));
         }
 
+        /**
+        Rotates plaintext vector cyclically by several step counts at once. When using the CKKS scheme, this function
+        writes to destination[i] the encrypted plaintext vector rotated cyclically to the left (steps[i] > 0) or to the
+        right (steps[i] < 0). The key switching decomposition of the input is computed only once and shared by all
+        rotations that have a Galois key, so rotating by k steps costs much less than k calls to rotate_vector. Steps
+        with no Galois key are rotated as in rotate_vector. Dynamic memory allocations in the process are allocated
+        from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to rotate
+        @param[in] steps The numbers of steps to rotate (positive left, negative right)
+        @param[in] galois_keys The Galois keys
+        @param[out] destination The vector to overwrite with one rotated ciphertext per element of steps
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::ckks
+        @throws std::invalid_argument if encrypted or galois_keys is not valid for
+        the encryption parameters
+        @throws std::invalid_argument if galois_keys do not correspond to the top
+        level parameters in the current context
+        @throws std::invalid_argument if encrypted is not in the default NTT form
+        @throws std::invalid_argument if encrypted has size larger than 2
+        @throws std::invalid_argument if encrypted is an element of destination
+        @throws std::invalid_argument if any of steps has too big absolute value
+        @throws std::invalid_argument if necessary Galois keys are not present
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void rotate_vector_many(
+            const Ciphertext &encrypted, const std::vector<int> &steps, const GaloisKeys &galois_keys,
+            std::vector<Ciphertext> &destination, MemoryPoolHandle pool = MemoryManager::GetPool()) const
+        {
+            if (context_.key_context_data()->parms().scheme() != scheme_type::ckks)
+            {
+                throw std::logic_error("unsupported scheme");
+            }
+            rotate_many_internal(encrypted, steps, galois_keys, destination, std::move(pool));
+        }
+
         /**
         Complex conjugates plaintext slot values. When using the CKKS scheme, this function complex conjugates all
         values in the underlying plaintext. Dynamic memory allocations in the process are allocated from the memory pool
@@ -1245,7 +1508,7 @@ namespace seal
         the encryption parameters
         @throws std::invalid_argument if galois_keys do not correspond to the top
         level parameters in the current context
-        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if the scheme is BGV and encrypted is not in NTT form
         @throws std::invalid_argument if encrypted has size larger than 2
         @throws std::invalid_argument if necessary Galois keys are not present
         @throws std::invalid_argument if pool is uninitialized
@@ -1277,7 +1540,7 @@ namespace seal
         the encryption parameters
         @throws std::invalid_argument if galois_keys do not correspond to the top
         level parameters in the current context
-        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if the scheme is BGV and encrypted is not in NTT form
         @throws std::invalid_argument if encrypted has size larger than 2
         @throws std::invalid_argument if necessary Galois keys are not present
         @throws std::invalid_argument if pool is uninitialized
@@ -1306,11 +1569,24 @@ namespace seal
 
         Evaluator &operator=(Evaluator &&assign) = delete;
 
-        void bfv_multiply(Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool) const;
+        // If relin_target is set, both ciphertexts must have size 2; encrypted1 keeps size 2 and receives the first
+        // two components of the product, and the third component is written to relin_target
+        void bfv_multiply(
+            Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool,
+            util::RNSIter relin_target = util::RNSIter()) const;
+
+        // HPS variant of bfv_multiply; encrypted1 and encrypted2 may be the same object
+        void bfv_multiply_hps(
+            Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool,
+            util::RNSIter relin_target = util::RNSIter()) const;
 
-        void ckks_multiply(Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool) const;
+        void ckks_multiply(
+            Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool,
+            util::RNSIter relin_target = util::RNSIter()) const;
 
-        void bgv_multiply(Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool) const;
+        void bgv_multiply(
+            Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool,
+            util::RNSIter relin_target = util::RNSIter()) const;
 
         void bfv_square(Ciphertext &encrypted, MemoryPoolHandle pool) const;
 
@@ -1332,6 +1608,10 @@ namespace seal
         void rotate_internal(
             Ciphertext &encrypted, int steps, const GaloisKeys &galois_keys, MemoryPoolHandle pool) const;
 
+        void rotate_many_internal(
+            const Ciphertext &encrypted, const std::vector<int> &steps, const GaloisKeys &galois_keys,
+            std::vector<Ciphertext> &destination, MemoryPoolHandle pool) const;
+
         inline void conjugate_internal(
             Ciphertext &encrypted, const GaloisKeys &galois_keys, MemoryPoolHandle pool) const
         {
@@ -1359,10 +1639,19 @@ namespace seal
             Ciphertext &encrypted, util::ConstRNSIter target_iter, const KSwitchKeys &kswitch_keys,
             std::size_t key_index, MemoryPoolHandle pool = MemoryManager::GetPool()) const;
 
+        // Key switching with the target decomposition supplied by decompose, which writes to its RNSIter argument the
+        // operands in NTT form for the key modulus at the given index (the special prime for the last index)
+        void switch_key_decomposed_inplace(
+            Ciphertext &encrypted, const std::function<void(std::size_t, util::RNSIter)> &decompose,
+            const KSwitchKeys &kswitch_keys, std::size_t kswitch_keys_index, MemoryPoolHandle pool) const;
+
         void multiply_plain_normal(Ciphertext &encrypted, const Plaintext &plain, MemoryPoolHandle pool) const;
 
         void multiply_plain_ntt(Ciphertext &encrypted_ntt, const Plaintext &plain_ntt) const;
 
         SEALContext context_;
+
+        // Runs the parallel loops; null for an Evaluator that runs on the calling thread only
+        std::unique_ptr<util::ThreadPool> thread_pool_;
     };
 } // namespace seal
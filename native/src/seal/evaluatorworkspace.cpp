@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/evaluatorworkspace.h"
+#include "seal/util/common.h"
+#include "seal/util/rns.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+using namespace seal::util;
+
+namespace seal
+{
+    namespace
+    {
+        // Bound on the number of temporaries that are alive at the same time in one operation; each of them may
+        // waste up to one alignment unit of the workspace
+        constexpr size_t max_live_allocation_count = 32;
+    } // namespace
+
+    EvaluatorWorkspace::EvaluatorWorkspace(const SEALContext &context, parms_id_type parms_id)
+        : stack_(make_shared<MemoryPoolStack>(EstimateByteCount(context, parms_id))), pool_(stack_)
+    {}
+
+    size_t EvaluatorWorkspace::EstimateByteCount(const SEALContext &context, parms_id_type parms_id)
+    {
+        if (!context.parameters_set())
+        {
+            throw invalid_argument("encryption parameters are not set correctly");
+        }
+        auto context_data_ptr = context.get_context_data(parms_id);
+        if (!context_data_ptr)
+        {
+            throw invalid_argument("parms_id is not valid for encryption parameters");
+        }
+
+        auto &context_data = *context_data_ptr;
+        auto &parms = context_data.parms();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_modulus_size = parms.coeff_modulus().size();
+
+        // The estimates count the polynomials modulo a single prime that are alive at the peak of each operation.
+        // Multiplication of size 2 ciphertexts in CKKS and BGV; modulus switching and rescaling of a size 3
+        // ciphertext, with the temporaries of the division by the last prime
+        size_t poly_count = add_safe(mul_safe(coeff_modulus_size, size_t(5)), size_t(3));
+
+        if (parms.scheme() == scheme_type::bfv)
+        {
+            // BEHZ multiplication: both operands and the product in base q and base Bsk, and the temporaries of the
+            // base extensions and of the flooring
+            size_t base_Bsk_size = context_data.rns_tool()->base_Bsk()->size();
+            poly_count = max(
+                poly_count, add_safe(mul_safe(coeff_modulus_size, size_t(9)), mul_safe(base_Bsk_size, size_t(10))));
+
+            // HPS multiplication: both operands and the product in base q U P, and the temporaries of the scaling
+            // and of the exact base conversions
+            if (auto base_qP = context_data.rns_tool()->base_qP())
+            {
+                poly_count = max(
+                    poly_count, add_safe(mul_safe(base_qP->size(), size_t(8)), coeff_modulus_size, size_t(2)));
+            }
+        }
+
+        if (auto kswitch_tool = context_data.kswitch_tool())
+        {
+            // Key switching: the copy of the target, its decomposition, the accumulated products in the extended
+            // base, the lazy accumulator, the modulus switching temporaries, and the permuted input of a rotation
+            size_t special_prime_count = kswitch_tool->special_prime_count();
+            size_t rns_modulus_size = add_safe(coeff_modulus_size, special_prime_count);
+            size_t digit_count = kswitch_tool->digit_count();
+            size_t decomposed_count = digit_count > 1 ? mul_safe(rns_modulus_size, digit_count) : size_t(0);
+            poly_count = max(
+                poly_count, add_safe(
+                                decomposed_count, mul_safe(rns_modulus_size, size_t(3)),
+                                mul_safe(coeff_modulus_size, size_t(4)), special_prime_count, digit_count, size_t(4)));
+        }
+
+        return add_safe(
+            mul_safe(poly_count, coeff_count, sizeof(uint64_t)),
+            mul_safe(max_live_allocation_count, MemoryPoolHeadStack::alignment));
+    }
+} // namespace seal
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/context.h"
+#include "seal/encryptionparams.h"
+#include "seal/memorymanager.h"
+#include "seal/util/mempool.h"
+#include <cstddef>
+#include <memory>
+
+namespace seal
+{
+    /**
+    Memory for the temporaries of the Evaluator, reserved once and reused by every operation. The Evaluator
+    functions take a MemoryPoolHandle for their temporaries; passing an EvaluatorWorkspace instead makes them
+    allocate from a single memory block by moving a pointer up and down, without looking up size classes and
+    without reserving memory once the workspace is large enough.
+
+    @par Sizing
+    The workspace is sized at construction for the operations at a given level: multiplication, relinearization,
+    rotation, conjugation, rescaling and modulus switching. The size is an estimate; if an operation needs more
+    memory, the workspace reserves another block, and the blocks are merged into one when the operation returns.
+    After each operation has been run once, repeating it does not reserve memory.
+
+    @par Thread Safety
+    An EvaluatorWorkspace must be used by one thread at a time. When the Evaluator runs on a thread pool, the
+    temporaries of the worker threads come from their thread-local memory pools and only those of the calling
+    thread come from the workspace.
+
+    @par Lifetime
+    Only temporaries should be allocated from a workspace. Objects that outlive an operation, such as ciphertexts
+    constructed with the workspace as their memory pool, keep their memory in use and force later operations to
+    reserve more.
+    */
+    class EvaluatorWorkspace
+    {
+    public:
+        /**
+        Creates an EvaluatorWorkspace sized for the operations at the highest data level of the given context.
+
+        @param[in] context The SEALContext
+        @throws std::invalid_argument if the encryption parameters are not valid
+        */
+        explicit EvaluatorWorkspace(const SEALContext &context) : EvaluatorWorkspace(context, context.first_parms_id())
+        {}
+
+        /**
+        Creates an EvaluatorWorkspace sized for the operations at the level given by parms_id. A workspace sized
+        for a level is large enough for all lower levels.
+
+        @param[in] context The SEALContext
+        @param[in] parms_id The parms_id of the level
+        @throws std::invalid_argument if the encryption parameters are not valid
+        @throws std::invalid_argument if parms_id is not valid for the encryption parameters
+        */
+        EvaluatorWorkspace(const SEALContext &context, parms_id_type parms_id);
+
+        /**
+        Returns a MemoryPoolHandle to the memory of the workspace.
+        */
+        SEAL_NODISCARD inline MemoryPoolHandle pool() const noexcept
+        {
+            return pool_;
+        }
+
+        /**
+        Returns a MemoryPoolHandle to the memory of the workspace, so that the workspace can be passed to the
+        Evaluator functions in place of a MemoryPoolHandle.
+        */
+        SEAL_NODISCARD inline operator MemoryPoolHandle() const noexcept
+        {
+            return pool_;
+        }
+
+        /**
+        Returns the number of bytes reserved by the workspace.
+        */
+        SEAL_NODISCARD inline std::size_t reserved_byte_count() const noexcept
+        {
+            return stack_->alloc_byte_count();
+        }
+
+        /**
+        Returns an estimate of the number of bytes of temporaries needed by the Evaluator operations at the level
+        given by parms_id.
+
+        @param[in] context The SEALContext
+        @param[in] parms_id The parms_id of the level
+        @throws std::invalid_argument if the encryption parameters are not valid
+        @throws std::invalid_argument if parms_id is not valid for the encryption parameters
+        */
+        SEAL_NODISCARD static std::size_t EstimateByteCount(const SEALContext &context, parms_id_type parms_id);
+
+    private:
+        std::shared_ptr<util::MemoryPoolStack> stack_;
+
+        MemoryPoolHandle pool_;
+    };
+} // namespace seal
@@ -307,6 +307,9 @@ namespace seal
 
         size_t coeff_count = context_.key_context_data()->parms().poly_modulus_degree();
         size_t decomp_mod_count = context_.first_context_data()->parms().coeff_modulus().size();
+        auto &kswitch_tool = *context_.first_context_data()->kswitch_tool();
+        size_t digit_size = kswitch_tool.digit_size();
+        size_t digit_count = kswitch_tool.digit_count();
         auto &key_context_data = *context_.key_context_data();
         auto &key_parms = key_context_data.parms();
         auto &key_modulus = key_parms.coeff_modulus();
@@ -318,17 +321,21 @@ namespace seal
         }
 
         // KSwitchKeys data allocated from pool given by MemoryManager::GetPool.
-        destination.resize(decomp_mod_count);
+        destination.resize(digit_count);
 
-        SEAL_ITERATE(iter(new_key, key_modulus, destination, size_t(0)), decomp_mod_count, [&](auto I) {
+        // One key per digit; the key for a digit adds P * new_key to the RNS factors of its primes
+        SEAL_ITERATE(iter(new_key, key_modulus, kswitch_tool.p_mod_q(), size_t(0)), decomp_mod_count, [&](auto I) {
+            PublicKey &digit_key = destination[get<3>(I) / digit_size];
+            if (get<3>(I) % digit_size == 0)
+            {
+                encrypt_zero_symmetric(
+                    secret_key_, context_, key_context_data.parms_id(), true, save_seed, digit_key.data());
+            }
             SEAL_ALLOCATE_GET_COEFF_ITER(temp, coeff_count, pool_);
-            encrypt_zero_symmetric(
-                secret_key_, context_, key_context_data.parms_id(), true, save_seed, get<2>(I).data());
-            uint64_t factor = barrett_reduce_64(key_modulus.back().value(), get<1>(I));
-            multiply_poly_scalar_coeffmod(get<0>(I), coeff_count, factor, get<1>(I), temp);
+            multiply_poly_scalar_coeffmod(get<0>(I), coeff_count, get<2>(I), get<1>(I), temp);
 
             // We use the SeqIter at get<3>(I) to find the i-th RNS factor of the first destination polynomial.
-            CoeffIter destination_iter = (*iter(get<2>(I).data()))[get<3>(I)];
+            CoeffIter destination_iter = (*iter(digit_key.data()))[get<3>(I)];
             add_poly_coeffmod(destination_iter, temp, coeff_count, get<1>(I), destination_iter);
         });
     }
@@ -117,6 +117,46 @@ namespace seal
             return create_relin_keys(1, true);
         }
 
+        /**
+        Generates relinearization keys for the secret key powers 2 through
+        count + 1 and stores the result in destination. With these keys, a
+        ciphertext of size up to count + 2 can be relinearized back to size 2
+        at once, so that relinearization can be deferred over several
+        multiplications. Every time this function is called, new
+        relinearization keys will be generated.
+
+        @param[in] count The number of relinearization keys to generate
+        @param[out] destination The relinearization keys to overwrite with the
+        generated relinearization keys
+        @throws std::logic_error if the encryption parameters do not support
+        keyswitching
+        @throws std::invalid_argument if count is zero or too large
+        */
+        inline void create_relin_keys(std::size_t count, RelinKeys &destination)
+        {
+            destination = create_relin_keys(count, false);
+        }
+
+        /**
+        Generates and returns relinearization keys for the secret key powers 2
+        through count + 1 as a serializable object. Every time this function is
+        called, new relinearization keys will be generated.
+
+        Half of the key data is pseudo-randomly generated from a seed to reduce
+        the object size. The resulting serializable object cannot be used
+        directly and is meant to be serialized for the size reduction to have an
+        impact.
+
+        @param[in] count The number of relinearization keys to generate
+        @throws std::logic_error if the encryption parameters do not support
+        keyswitching
+        @throws std::invalid_argument if count is zero or too large
+        */
+        SEAL_NODISCARD inline Serializable<RelinKeys> create_relin_keys(std::size_t count)
+        {
+            return create_relin_keys(count, true);
+        }
+
         /**
         Generates Galois keys and stores the result in destination. Every time
         this function is called, new Galois keys will be generated.
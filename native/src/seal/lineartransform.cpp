@@ -0,0 +1,397 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/lineartransform.h"
+#include "seal/valcheck.h"
+#include "seal/util/common.h"
+#include "seal/util/iterator.h"
+#include "seal/util/pointer.h"
+#include "seal/util/polyarithsmallmod.h"
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <utility>
+
+using namespace std;
+using namespace seal::util;
+
+namespace seal
+{
+    namespace
+    {
+        // Reduces the diagonal indices modulo the dimension and checks that they are distinct
+        template <typename T>
+        map<size_t, const vector<T> *> normalize_diagonals(const map<int, vector<T>> &diagonals, size_t dimension)
+        {
+            if (diagonals.empty())
+            {
+                throw invalid_argument("diagonals cannot be empty");
+            }
+
+            map<size_t, const vector<T> *> result;
+            for (const auto &diagonal : diagonals)
+            {
+                int signed_dimension = static_cast<int>(dimension);
+                size_t offset =
+                    static_cast<size_t>(((diagonal.first % signed_dimension) + signed_dimension) % signed_dimension);
+                if (!result.emplace(offset, &diagonal.second).second)
+                {
+                    throw invalid_argument("diagonal indices are not distinct");
+                }
+            }
+            return result;
+        }
+
+        // Rotates each block of dimension values in a vector to the right by step positions
+        template <typename T>
+        vector<T> rotate_diagonal(const vector<T> &values, size_t dimension, size_t step)
+        {
+            vector<T> result(values.size());
+            for (size_t block = 0; block < values.size(); block += dimension)
+            {
+                for (size_t i = 0; i < dimension; i++)
+                {
+                    result[block + (i + step) % dimension] = values[block + i];
+                }
+            }
+            return result;
+        }
+    } // namespace
+
+    LinearTransform::LinearTransform(
+        const SEALContext &context, const CKKSEncoder &encoder,
+        const map<int, vector<complex<double>>> &diagonals, parms_id_type parms_id, double scale,
+        size_t baby_step_count, MemoryPoolHandle pool)
+        : context_(context), parms_id_(parms_id), scale_(scale)
+    {
+        // Verify parameters
+        if (!context_.parameters_set())
+        {
+            throw invalid_argument("encryption parameters are not set correctly");
+        }
+        auto context_data_ptr = context_.get_context_data(parms_id_);
+        if (!context_data_ptr)
+        {
+            throw invalid_argument("parms_id is not valid for encryption parameters");
+        }
+        if (context_data_ptr->parms().scheme() != scheme_type::ckks)
+        {
+            throw invalid_argument("unsupported scheme");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        dimension_ = encoder.slot_count();
+        auto offsets = normalize_diagonals(diagonals, dimension_);
+        for (const auto &offset : offsets)
+        {
+            if (offset.second->size() != dimension_)
+            {
+                throw invalid_argument("diagonal has incorrect size");
+            }
+        }
+
+        vector<size_t> offset_list;
+        for (const auto &offset : offsets)
+        {
+            offset_list.push_back(offset.first);
+        }
+        set_steps(offset_list, baby_step_count);
+
+        // Encode the diagonals pre-rotated by the giant steps
+        for (auto &giant_step : giant_steps_)
+        {
+            for (size_t baby_index : giant_step.baby_indices)
+            {
+                size_t offset = (static_cast<size_t>(giant_step.step) + static_cast<size_t>(baby_steps_[baby_index])) %
+                                dimension_;
+                giant_step.diagonals.emplace_back(pool);
+                encoder.encode(
+                    rotate_diagonal(*offsets[offset], dimension_, static_cast<size_t>(giant_step.step)), parms_id_,
+                    scale_, giant_step.diagonals.back(), pool);
+            }
+        }
+    }
+
+    LinearTransform::LinearTransform(
+        const SEALContext &context, const BatchEncoder &encoder, const map<int, vector<uint64_t>> &diagonals,
+        parms_id_type parms_id, size_t baby_step_count, MemoryPoolHandle pool)
+        : context_(context), parms_id_(parms_id)
+    {
+        // Verify parameters
+        if (!context_.parameters_set())
+        {
+            throw invalid_argument("encryption parameters are not set correctly");
+        }
+        auto context_data_ptr = context_.get_context_data(parms_id_);
+        if (!context_data_ptr)
+        {
+            throw invalid_argument("parms_id is not valid for encryption parameters");
+        }
+        auto scheme = context_data_ptr->parms().scheme();
+        if (scheme != scheme_type::bfv && scheme != scheme_type::bgv)
+        {
+            throw invalid_argument("unsupported scheme");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        size_t slot_count = encoder.slot_count();
+        dimension_ = slot_count >> 1;
+        auto offsets = normalize_diagonals(diagonals, dimension_);
+        for (const auto &offset : offsets)
+        {
+            if (offset.second->size() != dimension_ && offset.second->size() != slot_count)
+            {
+                throw invalid_argument("diagonal has incorrect size");
+            }
+        }
+
+        vector<size_t> offset_list;
+        for (const auto &offset : offsets)
+        {
+            offset_list.push_back(offset.first);
+        }
+        set_steps(offset_list, baby_step_count);
+
+        // Encode the diagonals pre-rotated by the giant steps and transform them to NTT form
+        Evaluator evaluator(context_);
+        for (auto &giant_step : giant_steps_)
+        {
+            for (size_t baby_index : giant_step.baby_indices)
+            {
+                size_t offset = (static_cast<size_t>(giant_step.step) + static_cast<size_t>(baby_steps_[baby_index])) %
+                                dimension_;
+                vector<uint64_t> values(*offsets[offset]);
+                if (values.size() == dimension_)
+                {
+                    // The same diagonal applies to both rows
+                    values.resize(slot_count);
+                    copy_n(values.cbegin(), dimension_, values.begin() + static_cast<ptrdiff_t>(dimension_));
+                }
+                giant_step.diagonals.emplace_back(pool);
+                encoder.encode(
+                    rotate_diagonal(values, dimension_, static_cast<size_t>(giant_step.step)),
+                    giant_step.diagonals.back());
+                evaluator.transform_to_ntt_inplace(giant_step.diagonals.back(), parms_id_, pool);
+            }
+        }
+    }
+
+    void LinearTransform::set_steps(const vector<size_t> &offsets, size_t baby_step_count)
+    {
+        if (baby_step_count > dimension_)
+        {
+            throw invalid_argument("baby_step_count is too large");
+        }
+
+        // Count the rotations needed for a given baby step count
+        auto rotation_count = [&](size_t n1) {
+            set<size_t> babies;
+            set<size_t> giants;
+            for (size_t offset : offsets)
+            {
+                if (offset % n1)
+                {
+                    babies.insert(offset % n1);
+                }
+                if (offset / n1)
+                {
+                    giants.insert(offset / n1);
+                }
+            }
+            return babies.size() + giants.size();
+        };
+
+        if (!baby_step_count)
+        {
+            // Try all powers of two; baby steps are hoisted, so prefer the larger count on a tie
+            size_t best_count = rotation_count(1);
+            baby_step_count = 1;
+            for (size_t n1 = 2; n1 <= dimension_; n1 <<= 1)
+            {
+                size_t count = rotation_count(n1);
+                if (count <= best_count)
+                {
+                    best_count = count;
+                    baby_step_count = n1;
+                }
+            }
+        }
+        baby_step_count_ = baby_step_count;
+
+        // Collect the baby steps in increasing order
+        set<size_t> babies;
+        for (size_t offset : offsets)
+        {
+            babies.insert(offset % baby_step_count_);
+        }
+        baby_steps_.assign(babies.begin(), babies.end());
+
+        // Group the diagonals by giant step
+        giant_steps_.clear();
+        for (size_t offset : offsets)
+        {
+            int step = static_cast<int>((offset / baby_step_count_) * baby_step_count_);
+            if (giant_steps_.empty() || giant_steps_.back().step != step)
+            {
+                giant_steps_.push_back({ step, {}, {} });
+            }
+            size_t baby_index = static_cast<size_t>(
+                distance(babies.begin(), babies.find(offset % baby_step_count_)));
+            giant_steps_.back().baby_indices.push_back(baby_index);
+        }
+    }
+
+    vector<int> LinearTransform::galois_steps() const
+    {
+        vector<int> steps;
+        for (int step : baby_steps_)
+        {
+            if (step)
+            {
+                steps.push_back(step);
+            }
+        }
+        for (const auto &giant_step : giant_steps_)
+        {
+            if (giant_step.step)
+            {
+                steps.push_back(giant_step.step);
+            }
+        }
+        return steps;
+    }
+
+    void LinearTransform::accumulate_giant_step(
+        const GiantStep &giant_step, const vector<Ciphertext> &rotated, Ciphertext &destination,
+        MemoryPoolHandle pool) const
+    {
+        auto &context_data = *context_.get_context_data(parms_id_);
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_modulus_size = coeff_modulus.size();
+        size_t term_count = giant_step.diagonals.size();
+
+        const Ciphertext &first = rotated[giant_step.baby_indices[0]];
+        destination.resize(context_, parms_id_, 2);
+        destination.is_ntt_form() = true;
+        destination.scale() = first.scale() * scale_;
+        destination.correction_factor() = first.correction_factor();
+
+        // Every RNS component of the sum is reduced only once
+        auto operands1(allocate<ConstCoeffIter>(term_count, pool));
+        auto operands2(allocate<ConstCoeffIter>(term_count, pool));
+        auto destination_iter = iter(destination);
+        for (size_t j = 0; j < 2; j++)
+        {
+            SEAL_ITERATE(iter(destination_iter[j], coeff_modulus, size_t(0)), coeff_modulus_size, [&](auto I) {
+                for (size_t term = 0; term < term_count; term++)
+                {
+                    operands1[term] = iter(rotated[giant_step.baby_indices[term]])[j][get<2>(I)];
+                    operands2[term] = ConstRNSIter(giant_step.diagonals[term].data(), coeff_count)[get<2>(I)];
+                }
+                dyadic_product_accumulate_coeffmod(
+                    operands1.get(), operands2.get(), term_count, coeff_count, get<1>(I), get<0>(I));
+            });
+        }
+    }
+
+    void LinearTransform::apply(
+        const Evaluator &evaluator, const Ciphertext &encrypted, const GaloisKeys &galois_keys,
+        Ciphertext &destination, MemoryPoolHandle pool) const
+    {
+        // Verify parameters.
+        if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        if (encrypted.size() != 2)
+        {
+            throw invalid_argument("encrypted size must be 2");
+        }
+        if (encrypted.parms_id() != parms_id_)
+        {
+            throw invalid_argument("encrypted is not at the level of the transform");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        auto &context_data = *context_.get_context_data(parms_id_);
+        auto scheme = context_data.parms().scheme();
+        if (scheme == scheme_type::ckks)
+        {
+            double new_scale = encrypted.scale() * scale_;
+            int scale_bit_count = static_cast<int>(log2(new_scale));
+            if (new_scale <= 0 || scale_bit_count >= context_data.total_coeff_modulus_bit_count())
+            {
+                throw invalid_argument("scale out of bounds");
+            }
+        }
+
+        // Rotate the input by all baby steps at once, sharing the decomposition
+        vector<Ciphertext> rotated;
+        if (scheme == scheme_type::ckks)
+        {
+            evaluator.rotate_vector_many(encrypted, baby_steps_, galois_keys, rotated, pool);
+        }
+        else
+        {
+            evaluator.rotate_rows_many(encrypted, baby_steps_, galois_keys, rotated, pool);
+        }
+        // BFV ciphertexts in coefficient form are multiplied with the diagonals in NTT form and converted back
+        bool convert_ntt = scheme == scheme_type::bfv && !encrypted.is_ntt_form();
+        if (convert_ntt)
+        {
+            for (auto &ciphertext : rotated)
+            {
+                evaluator.transform_to_ntt_inplace(ciphertext);
+            }
+        }
+
+        Ciphertext giant_sum(pool);
+        for (size_t i = 0; i < giant_steps_.size(); i++)
+        {
+            const GiantStep &giant_step = giant_steps_[i];
+            accumulate_giant_step(giant_step, rotated, giant_sum, pool);
+            if (convert_ntt)
+            {
+                evaluator.transform_from_ntt_inplace(giant_sum);
+            }
+            if (giant_step.step)
+            {
+                if (scheme == scheme_type::ckks)
+                {
+                    evaluator.rotate_vector_inplace(giant_sum, giant_step.step, galois_keys, pool);
+                }
+                else
+                {
+                    evaluator.rotate_rows_inplace(giant_sum, giant_step.step, galois_keys, pool);
+                }
+            }
+
+            if (i)
+            {
+                evaluator.add_inplace(destination, giant_sum);
+            }
+            else
+            {
+                destination = giant_sum;
+            }
+        }
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (destination.is_transparent())
+        {
+            throw logic_error("result ciphertext is transparent");
+        }
+#endif
+    }
+} // namespace seal
@@ -0,0 +1,244 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/batchencoder.h"
+#include "seal/ciphertext.h"
+#include "seal/ckks.h"
+#include "seal/context.h"
+#include "seal/encryptionparams.h"
+#include "seal/evaluator.h"
+#include "seal/galoiskeys.h"
+#include "seal/memorymanager.h"
+#include "seal/plaintext.h"
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace seal
+{
+    /**
+    Evaluates a fixed plaintext matrix-vector product on encrypted vectors. The matrix is
+    given by its diagonals: for a matrix M of dimension n the diagonal with index k holds
+    the values M[i][(i + k) mod n], and the product is the sum over all diagonals of the
+    diagonal multiplied slot-wise with the input vector rotated by k steps. For the CKKS
+    scheme n is the number of slots; for the BFV and BGV schemes n is the row size of the
+    batching matrix, and both rows are transformed simultaneously.
+
+    @par Baby-Step Giant-Step
+    Diagonal indices are written as k = g*n1 + b for a baby step count n1. The input is
+    rotated once for every baby step b using hoisted rotations, the baby-step rotations
+    are multiplied with the correspondingly pre-rotated diagonals and accumulated with a
+    single modular reduction, and the accumulated result for every giant step g is rotated
+    by g*n1 steps. For a dense matrix this needs about 2*sqrt(n) rotations instead of n.
+    The diagonals are encoded once at construction, in NTT form at a fixed level.
+
+    @par Galois Keys
+    The rotation steps required by apply are returned by galois_steps, and the Galois keys
+    passed to apply should be created for exactly these steps, for example with
+    KeyGenerator::create_galois_keys(const std::vector<int> &, GaloisKeys &).
+
+    @see Evaluator::rotate_vector_many and Evaluator::rotate_rows_many for hoisted rotations.
+    */
+    class LinearTransform
+    {
+    public:
+        /**
+        Creates a LinearTransform for the CKKS scheme from the diagonals of a matrix whose
+        dimension equals the number of slots. Diagonal indices may be negative and are taken
+        modulo the number of slots. The diagonals are encoded with the given scale at the
+        level given by parms_id.
+
+        @param[in] context The SEALContext
+        @param[in] encoder The CKKSEncoder used to encode the diagonals
+        @param[in] diagonals The non-zero diagonals of the matrix indexed by their offset
+        @param[in] parms_id The parms_id of the ciphertexts the transform is applied to
+        @param[in] scale The scale at which the diagonals are encoded
+        @param[in] baby_step_count The baby step count n1, or zero to choose it automatically
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if the encryption parameters are not valid for CKKS
+        @throws std::invalid_argument if diagonals is empty, a diagonal does not have size
+        equal to the number of slots, or two diagonal indices coincide modulo the number of slots
+        @throws std::invalid_argument if parms_id is not valid for the encryption parameters
+        @throws std::invalid_argument if baby_step_count is larger than the number of slots
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        LinearTransform(
+            const SEALContext &context, const CKKSEncoder &encoder,
+            const std::map<int, std::vector<std::complex<double>>> &diagonals, parms_id_type parms_id, double scale,
+            std::size_t baby_step_count = 0, MemoryPoolHandle pool = MemoryManager::GetPool());
+
+        /**
+        Creates a LinearTransform for the BFV or BGV scheme from the diagonals of a matrix
+        whose dimension equals the row size of the batching matrix. Diagonal indices may be
+        negative and are taken modulo the row size. A diagonal with row size entries applies
+        to both rows; a diagonal with as many entries as there are slots holds the diagonal
+        for the first row followed by the diagonal for the second row. The diagonals are
+        encoded at the level given by parms_id.
+
+        @param[in] context The SEALContext
+        @param[in] encoder The BatchEncoder used to encode the diagonals
+        @param[in] diagonals The non-zero diagonals of the matrix indexed by their offset
+        @param[in] parms_id The parms_id of the ciphertexts the transform is applied to
+        @param[in] baby_step_count The baby step count n1, or zero to choose it automatically
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if the encryption parameters are not valid for batching
+        @throws std::invalid_argument if diagonals is empty, a diagonal has an invalid size or
+        values larger than the plaintext modulus, or two diagonal indices coincide modulo the
+        row size
+        @throws std::invalid_argument if parms_id is not valid for the encryption parameters
+        @throws std::invalid_argument if baby_step_count is larger than the row size
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        LinearTransform(
+            const SEALContext &context, const BatchEncoder &encoder,
+            const std::map<int, std::vector<std::uint64_t>> &diagonals, parms_id_type parms_id,
+            std::size_t baby_step_count = 0, MemoryPoolHandle pool = MemoryManager::GetPool());
+
+        /**
+        Returns the non-zero diagonals of a square matrix, indexed by their offset from
+        zero to the dimension of the matrix minus one. The result can be passed to the
+        constructors of LinearTransform.
+
+        @param[in] matrix The square matrix given as a vector of rows
+        @throws std::invalid_argument if matrix is empty or not square
+        */
+        template <typename T>
+        SEAL_NODISCARD static std::map<int, std::vector<T>> Diagonals(const std::vector<std::vector<T>> &matrix)
+        {
+            std::size_t dimension = matrix.size();
+            if (!dimension)
+            {
+                throw std::invalid_argument("matrix cannot be empty");
+            }
+            for (const auto &row : matrix)
+            {
+                if (row.size() != dimension)
+                {
+                    throw std::invalid_argument("matrix is not square");
+                }
+            }
+
+            std::map<int, std::vector<T>> diagonals;
+            for (std::size_t k = 0; k < dimension; k++)
+            {
+                std::vector<T> diagonal(dimension);
+                bool is_zero = true;
+                for (std::size_t i = 0; i < dimension; i++)
+                {
+                    diagonal[i] = matrix[i][(i + k) % dimension];
+                    is_zero = is_zero && (diagonal[i] == T{});
+                }
+                if (!is_zero)
+                {
+                    diagonals.emplace(static_cast<int>(k), std::move(diagonal));
+                }
+            }
+            return diagonals;
+        }
+
+        /**
+        Applies the linear transform to a ciphertext and stores the result in the destination
+        parameter. The ciphertext must be at the level the transform was created for. For the
+        CKKS scheme the scale of the result is the product of the scale of encrypted and the
+        scale of the diagonals. A BFV ciphertext may be in NTT form, and the result is then
+        also in NTT form.
+
+        @param[in] evaluator The Evaluator for the SEALContext of the transform
+        @param[in] encrypted The ciphertext to transform
+        @param[in] galois_keys The Galois keys for the steps returned by galois_steps
+        @param[out] destination The ciphertext to overwrite with the transformed ciphertext
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted does not have size 2
+        @throws std::invalid_argument if encrypted is not at the level of the transform
+        @throws std::invalid_argument if galois_keys is not valid for the encryption parameters
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void apply(
+            const Evaluator &evaluator, const Ciphertext &encrypted, const GaloisKeys &galois_keys,
+            Ciphertext &destination, MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
+        /**
+        Returns the rotation steps needed by apply: the non-zero baby steps followed by the
+        non-zero giant steps.
+        */
+        SEAL_NODISCARD std::vector<int> galois_steps() const;
+
+        /**
+        Returns the number of rotations performed by apply.
+        */
+        SEAL_NODISCARD inline std::size_t rotation_count() const
+        {
+            return galois_steps().size();
+        }
+
+        /**
+        Returns a reference to the parms_id of the ciphertexts the transform applies to.
+        */
+        SEAL_NODISCARD inline const parms_id_type &parms_id() const noexcept
+        {
+            return parms_id_;
+        }
+
+        /**
+        Returns the scale of the encoded diagonals. For the BFV and BGV schemes this is 1.0.
+        */
+        SEAL_NODISCARD inline double scale() const noexcept
+        {
+            return scale_;
+        }
+
+        /**
+        Returns the baby step count n1.
+        */
+        SEAL_NODISCARD inline std::size_t baby_step_count() const noexcept
+        {
+            return baby_step_count_;
+        }
+
+        /**
+        Returns the dimension of the matrix.
+        */
+        SEAL_NODISCARD inline std::size_t dimension() const noexcept
+        {
+            return dimension_;
+        }
+
+    private:
+        struct GiantStep
+        {
+            int step;
+
+            std::vector<std::size_t> baby_indices;
+
+            std::vector<Plaintext> diagonals;
+        };
+
+        void set_steps(const std::vector<std::size_t> &offsets, std::size_t baby_step_count);
+
+        void accumulate_giant_step(
+            const GiantStep &giant_step, const std::vector<Ciphertext> &rotated, Ciphertext &destination,
+            MemoryPoolHandle pool) const;
+
+        SEALContext context_;
+
+        parms_id_type parms_id_ = parms_id_zero;
+
+        double scale_ = 1.0;
+
+        std::size_t dimension_ = 0;
+
+        std::size_t baby_step_count_ = 0;
+
+        std::vector<int> baby_steps_;
+
+        std::vector<GiantStep> giant_steps_;
+    };
+} // namespace seal
@@ -7,6 +7,51 @@ using namespace std;
 
 namespace seal
 {
+    MMProfNUMA::MMProfNUMA(bool clear_on_destruction, bool huge_pages)
+    {
+        size_t node_count = util::numa_node_count();
+        if (node_count == 1)
+        {
+            pools_.push_back(MemoryPoolHandle::New(clear_on_destruction, huge_pages));
+            return;
+        }
+        for (size_t node = 0; node < node_count; node++)
+        {
+            pools_.push_back(MemoryPoolHandle(
+                make_shared<util::MemoryPoolMT>(clear_on_destruction, huge_pages, static_cast<int>(node))));
+        }
+    }
+
+    MemoryPoolHandle MMProfNUMA::get_pool(mm_prof_opt_t)
+    {
+        return pools_[util::current_numa_node() % pools_.size()];
+    }
+
+    MMProfArena::MMProfArena(MemoryPoolHandle arena) : pool_(move(arena))
+    {
+        if (!pool_ || !dynamic_cast<util::MemoryPoolArena *>(&static_cast<util::MemoryPool &>(pool_)))
+        {
+            throw invalid_argument("arena is not an arena memory pool");
+        }
+    }
+
+    MMProfArena::~MMProfArena() noexcept
+    {
+        // An arena used only by this profile is freed with it
+        auto &arena = static_cast<util::MemoryPoolArena &>(static_cast<util::MemoryPool &>(pool_));
+        if (pool_.use_count() > 1 && arena.idle())
+        {
+            try
+            {
+                arena.reset();
+            }
+            catch (...)
+            {
+                // Merging the chunks failed and the memory was freed; the arena reserves memory again when used
+            }
+        }
+    }
+
 #ifndef _M_CEE
     mutex MemoryManager::switch_mutex_;
 #else
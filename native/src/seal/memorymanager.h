@@ -6,10 +6,12 @@
 #include "seal/util/defines.h"
 #include "seal/util/globals.h"
 #include "seal/util/mempool.h"
+#include <functional>
 #include <memory>
 #include <stdexcept>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 /*
 For .NET Framework wrapper support (C++/CLI) we need to
@@ -24,6 +26,22 @@ For .NET Framework wrapper support (C++/CLI) we need to
 
 namespace seal
 {
+    /**
+    Usage statistics of a memory pool, as returned by MemoryPoolHandle::stats().
+    */
+    using MemoryPoolStats = util::MemoryPoolStats;
+
+    /**
+    Usage statistics of the allocations of one size in a memory pool.
+    */
+    using MemoryPoolSizeClassStats = util::MemoryPoolSizeClassStats;
+
+    /**
+    Policy for returning memory of a memory pool to the system, as set with
+    MemoryPoolHandle::set_trim_policy().
+    */
+    using MemoryPoolTrimPolicy = util::MemoryPoolTrimPolicy;
+
     /**
     Manages a shared pointer to a memory pool. Microsoft SEAL uses memory pools
     for improved performance due to the large number of memory allocations
@@ -156,10 +174,34 @@ namespace seal
         @param[in] clear_on_destruction Indicates whether the memory pool data
         should be cleared when destroyed. This can be important when memory pools
         are used to store private data.
+        @param[in] huge_pages Indicates whether the memory pool should back large
+        allocations with 2 MB huge pages and align every allocation to 64 bytes.
+        On Linux, explicit huge pages are used if the system has them reserved,
+        and transparent huge pages otherwise. This reduces TLB misses on large
+        ciphertexts and keys at the cost of rounding large allocations up to whole
+        huge pages. On other systems only the alignment is guaranteed.
+        */
+        SEAL_NODISCARD inline static MemoryPoolHandle New(bool clear_on_destruction = false, bool huge_pages = false)
+        {
+            return MemoryPoolHandle(std::make_shared<util::MemoryPoolMT>(clear_on_destruction, huge_pages));
+        }
+
+        /**
+        Returns a MemoryPoolHandle pointing to a new thread-safe arena memory pool.
+        An arena serves every allocation by moving a pointer forward through large
+        chunks of memory and does not reuse released memory; all of its memory is
+        freed at once when the memory pool is destroyed, that is, when the last
+        MemoryPoolHandle pointing to it, including those held by objects such as
+        ciphertexts allocated from it, is destroyed. This suits computations that
+        allocate many temporary objects and then discard all of them.
+
+        @param[in] reserve_byte_count The size of the first chunk of memory, or
+        zero for a default size; later chunks are at least twice as large as the
+        previous one
         */
-        SEAL_NODISCARD inline static MemoryPoolHandle New(bool clear_on_destruction = false)
+        SEAL_NODISCARD inline static MemoryPoolHandle Arena(std::size_t reserve_byte_count = 0)
         {
-            return MemoryPoolHandle(std::make_shared<util::MemoryPoolMT>(clear_on_destruction));
+            return MemoryPoolHandle(std::make_shared<util::MemoryPoolArena>(reserve_byte_count));
         }
 
         /**
@@ -200,6 +242,79 @@ namespace seal
             return !pool_ ? std::size_t(0) : pool_->alloc_byte_count();
         }
 
+        /**
+        Returns usage statistics of the memory pool pointed to by the current
+        MemoryPoolHandle: for each allocation size the reserved, in-use, and
+        peak item counts and how many requests reused released memory (hits)
+        or needed new memory (misses), as well as totals and the age of the
+        pool. For an uninitialized MemoryPoolHandle the statistics are empty.
+        */
+        SEAL_NODISCARD inline MemoryPoolStats stats() const
+        {
+            return !pool_ ? MemoryPoolStats() : pool_->stats();
+        }
+
+        /**
+        Sets a function that is called with the statistics of the memory pool
+        whenever the pool reserves more memory, e.g., to export them to a
+        metrics system. The function is called on the allocating thread, so it
+        should return quickly and must not allocate from the same pool. Passing
+        an empty function removes the callback. The callback belongs to the
+        memory pool and is therefore shared by all handles to it.
+
+        @param[in] callback The function to call with the statistics
+        @throws std::logic_error if the MemoryPoolHandle is uninitialized
+        */
+        inline void set_stats_callback(std::function<void(const MemoryPoolStats &)> callback)
+        {
+            if (!pool_)
+            {
+                throw std::logic_error("pool not initialized");
+            }
+            pool_->set_stats_callback(std::move(callback));
+        }
+
+        /**
+        Returns memory to the system. This function releases the memory of every
+        allocation size of which no allocation is currently in use, and returns
+        the number of bytes released. Memory of allocation sizes still in use is
+        kept. For an uninitialized MemoryPoolHandle this function does nothing.
+        */
+        inline std::size_t trim()
+        {
+            return !pool_ ? std::size_t(0) : pool_->trim();
+        }
+
+        /**
+        Sets a policy for returning memory to the system automatically. The memory
+        pool can be bounded by a number of reserved bytes, above which it releases
+        the allocation sizes with no allocation in use, least recently used first,
+        whenever it reserves more memory. It can also release allocation sizes not
+        used for a given time; this is checked periodically while the pool is
+        used. The policy belongs to the memory pool and is therefore shared by all
+        handles to it.
+
+        @param[in] policy The policy to apply; zero values disable the limits
+        @throws std::logic_error if the MemoryPoolHandle is uninitialized
+        */
+        inline void set_trim_policy(const MemoryPoolTrimPolicy &policy)
+        {
+            if (!pool_)
+            {
+                throw std::logic_error("pool not initialized");
+            }
+            pool_->set_trim_policy(policy);
+        }
+
+        /**
+        Returns the policy for returning memory to the system. For an uninitialized
+        MemoryPoolHandle the policy has no limits.
+        */
+        SEAL_NODISCARD inline MemoryPoolTrimPolicy trim_policy() const noexcept
+        {
+            return !pool_ ? MemoryPoolTrimPolicy() : pool_->trim_policy();
+        }
+
         /**
         Returns the number of MemoryPoolHandle objects sharing this memory pool.
         */
@@ -387,6 +502,126 @@ namespace seal
     private:
         MemoryPoolHandle pool_;
     };
+
+    /**
+    A memory manager profile that keeps one thread-safe memory pool for every NUMA
+    node and returns a MemoryPoolHandle pointing to the memory pool of the node the
+    calling thread runs on. The memory of each pool prefers its node where possible:
+    allocations of at least one page are given a preferred-node memory policy, and
+    the kernel still falls back to other nodes when the node has no free memory.
+    Smaller allocations follow the default first-touch placement, and threads may
+    migrate between nodes, so their memory is not guaranteed to be local. On
+    systems with a single node, or where the NUMA topology is not known, there is a
+    single memory pool with no node preference.
+    */
+    class MMProfNUMA : public MMProf
+    {
+    public:
+        /**
+        Creates a new MMProfNUMA with a new thread-safe memory pool for every NUMA
+        node.
+
+        @param[in] clear_on_destruction Indicates whether the memory pools clear
+        their memory when destroyed
+        @param[in] huge_pages Indicates whether the memory pools back large
+        allocations with huge pages
+        */
+        MMProfNUMA(bool clear_on_destruction = false, bool huge_pages = false);
+
+        /**
+        Destroys the MMProfNUMA.
+        */
+        virtual ~MMProfNUMA() noexcept override
+        {}
+
+        /**
+        Returns a MemoryPoolHandle pointing to the memory pool of the NUMA node the
+        calling thread runs on. The mm_prof_opt_t input parameter has no effect.
+        */
+        SEAL_NODISCARD virtual MemoryPoolHandle get_pool(mm_prof_opt_t) override;
+
+        /**
+        Returns the number of memory pools, one for every NUMA node.
+        */
+        SEAL_NODISCARD inline std::size_t pool_count() const noexcept
+        {
+            return pools_.size();
+        }
+
+        /**
+        Returns a MemoryPoolHandle pointing to the memory pool of a given NUMA node.
+
+        @param[in] node The NUMA node
+        @throws std::out_of_range if node is not less than pool_count()
+        */
+        SEAL_NODISCARD inline MemoryPoolHandle pool_for_node(std::size_t node) const
+        {
+            return pools_.at(node);
+        }
+
+    private:
+        std::vector<MemoryPoolHandle> pools_;
+    };
+
+    /**
+    A memory manager profile that always returns a MemoryPoolHandle pointing to
+    an arena memory pool (see MemoryPoolHandle::Arena). Used with MMProfGuard, it
+    makes every object allocated in a scope with the default memory pool take its
+    memory from the arena by moving a pointer forward. When the scope ends and no
+    object allocated in it remains, all of that memory becomes available again at
+    once: an arena of its own is freed, and a given arena is rewound to serve the
+    next scope from memory already reserved, in a single chunk.
+
+        MemoryPoolHandle arena = MemoryPoolHandle::Arena();
+        // For every request
+        {
+            MMProfGuard guard(std::make_unique<MMProfArena>(arena));
+            // Ciphertexts, plaintexts and Evaluator temporaries use the arena
+        }
+
+    Objects that must outlive the scope should be allocated from another memory
+    pool, as they keep their memory, and that of all later allocations, in use.
+    */
+    class MMProfArena : public MMProf
+    {
+    public:
+        /**
+        Creates a new MMProfArena with a new arena memory pool.
+
+        @param[in] reserve_byte_count The size of the first chunk of memory of the
+        arena, or zero for a default size
+        */
+        MMProfArena(std::size_t reserve_byte_count = 0) : pool_(MemoryPoolHandle::Arena(reserve_byte_count))
+        {}
+
+        /**
+        Creates a new MMProfArena with a given arena memory pool, which is rewound
+        when the MMProfArena is destroyed.
+
+        @param[in] arena A MemoryPoolHandle created by MemoryPoolHandle::Arena
+        @throws std::invalid_argument if arena is uninitialized or does not point
+        to an arena memory pool
+        */
+        MMProfArena(MemoryPoolHandle arena);
+
+        /**
+        Destroys the MMProfArena. If no allocation from the arena is in use, its
+        memory is made available again.
+        */
+        virtual ~MMProfArena() noexcept override;
+
+        /**
+        Returns a MemoryPoolHandle pointing to the arena memory pool. The
+        mm_prof_opt_t input parameter has no effect.
+        */
+        SEAL_NODISCARD inline virtual MemoryPoolHandle get_pool(mm_prof_opt_t) override
+        {
+            return pool_;
+        }
+
+    private:
+        MemoryPoolHandle pool_;
+    };
 #ifndef _M_CEE
     /**
     A memory manager profile that always returns a MemoryPoolHandle pointing to
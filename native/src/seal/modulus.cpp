@@ -72,6 +72,7 @@ namespace seal
             uint64_count_ = 1;
             value_ = 0;
             const_ratio_ = { { 0, 0, 0 } };
+            montgomery_inv_ = 0;
             is_prime_ = false;
         }
         else if ((value >> SEAL_MOD_BIT_COUNT_MAX != 0) || (value == 1))
@@ -97,6 +98,18 @@ namespace seal
             // We store also the remainder
             const_ratio_[2] = numerator[0];
 
+            // Compute the inverse modulo 2^64 for Montgomery reduction with Newton's iteration; value_ * value_ is 1
+            // modulo 8 for odd value_, and every iteration doubles the number of correct low bits
+            montgomery_inv_ = 0;
+            if (value_ & 1)
+            {
+                montgomery_inv_ = value_;
+                for (int i = 0; i < 5; i++)
+                {
+                    montgomery_inv_ *= 2 - value_ * montgomery_inv_;
+                }
+            }
+
             uint64_count_ = 1;
 
             // Set the primality flag
@@ -227,4 +240,22 @@ namespace seal
         }
         return result;
     }
+
+    vector<Modulus> CoeffModulus::CreateSmallWord(size_t poly_modulus_degree, int bit_count)
+    {
+        if (bit_count < SEAL_USER_MOD_BIT_COUNT_MIN ||
+            bit_count > SEAL_COEFF_MOD_COUNT_MAX * SEAL_SMALL_MOD_BIT_COUNT_MAX)
+        {
+            throw invalid_argument("bit_count is invalid");
+        }
+
+        // Split bit_count as evenly as possible into the fewest bit-lengths that take the 32-bit word kernels
+        int count = (bit_count + SEAL_SMALL_MOD_BIT_COUNT_MAX - 1) / SEAL_SMALL_MOD_BIT_COUNT_MAX;
+        vector<int> bit_sizes(safe_cast<size_t>(count), bit_count / count);
+        for (int i = 0; i < bit_count % count; i++)
+        {
+            bit_sizes[safe_cast<size_t>(i)]++;
+        }
+        return Create(poly_modulus_degree, move(bit_sizes));
+    }
 } // namespace seal
@@ -127,6 +127,15 @@ namespace seal
             return const_ratio_;
         }
 
+        /**
+        Returns the inverse of the value of the current Modulus modulo 2^64, which is used by Montgomery reduction
+        (see util::montgomery_reduce_128), or zero if the value is even.
+        */
+        SEAL_NODISCARD inline std::uint64_t montgomery_inv() const noexcept
+        {
+            return montgomery_inv_;
+        }
+
         /**
         Returns whether the value of the current Modulus is zero.
         */
@@ -372,6 +381,8 @@ namespace seal
 
         std::array<std::uint64_t, 3> const_ratio_{ { 0, 0, 0 } };
 
+        std::uint64_t montgomery_inv_ = 0;
+
         std::size_t uint64_count_ = 0;
 
         int bit_count_ = 0;
@@ -515,6 +526,28 @@ namespace seal
         */
         SEAL_NODISCARD static std::vector<Modulus> Create(
             std::size_t poly_modulus_degree, const Modulus &plain_modulus, std::vector<int> bit_sizes);
+
+        /**
+        Returns a custom coefficient modulus of small-word primes suitable for use with the specified
+        poly_modulus_degree. The return value will be a vector consisting of as few Modulus elements as possible
+        representing distinct prime numbers such that:
+        1) have bit-lengths of at most SEAL_SMALL_MOD_BIT_COUNT_MAX (30) bits, which differ by at most one and add
+        up to bit_count, and
+        2) are congruent to 1 modulo 2*poly_modulus_degree.
+
+        The SIMD kernels for NTTs and dyadic products multiply such primes as 32-bit words, which is much faster
+        than the 64-bit arithmetic needed for larger primes. Coefficients are still stored as 64-bit words, so memory
+        use and memory traffic do not shrink. The price is a longer coefficient modulus, which makes key switching do
+        more work per prime.
+
+        @param[in] poly_modulus_degree The value of the poly_modulus_degree encryption parameter
+        @param[in] bit_count The total bit-length of the primes to be generated
+        @throws std::invalid_argument if poly_modulus_degree is not a power-of-two
+        or is too large
+        @throws std::invalid_argument if bit_count is out of bounds
+        @throws std::logic_error if not enough suitable primes could be found
+        */
+        SEAL_NODISCARD static std::vector<Modulus> CreateSmallWord(std::size_t poly_modulus_degree, int bit_count);
     };
 
     /**
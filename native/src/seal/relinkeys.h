@@ -19,12 +19,14 @@ namespace seal
     of sizes K and L results in a ciphertext of size K+L-1. Unfortunately, this
     growth in size slows down further multiplications and increases noise growth.
     Relinearization is an operation that has no semantic meaning, but it reduces
-    the size of ciphertexts back to 2. Microsoft SEAL can only relinearize size 3
-    ciphertexts back to size 2, so if the ciphertexts grow larger than size 3,
-    there is no way to reduce their size. Relinearization requires an instance of
-    RelinKeys to be created by the secret key owner and to be shared with the
-    evaluator. Note that plain multiplication is fundamentally different from
-    normal multiplication and does not result in ciphertext size growth.
+    the size of ciphertexts back to 2. Relinearizing a ciphertext of size K
+    requires the keys for the secret key powers 2 through K-1. By default only
+    the key for the second power is generated, which relinearizes size 3
+    ciphertexts; KeyGenerator::create_relin_keys can also generate the keys for
+    higher powers. Relinearization requires an instance of RelinKeys to be
+    created by the secret key owner and to be shared with the evaluator. Note
+    that plain multiplication is fundamentally different from normal
+    multiplication and does not result in ciphertext size growth.
 
     @par When to Relinearize
     Typically, one should always relinearize after each multiplications. However,
@@ -34,7 +36,9 @@ namespace seal
     makes sense to not relinearize each product, but instead add them first and
     only then relinearize the sum. This is particularly important when using the
     CKKS scheme, where relinearization is much more computationally costly than
-    multiplications and additions.
+    multiplications and additions. With keys for higher powers, the products may
+    themselves be of ciphertexts larger than size 2, and the sum is relinearized
+    with one key switching per extra component.
 
     @par Thread Safety
     In general, reading from RelinKeys is thread-safe as long as no other thread
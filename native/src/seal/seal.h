@@ -12,8 +12,10 @@
 #include "seal/encryptionparams.h"
 #include "seal/encryptor.h"
 #include "seal/evaluator.h"
+#include "seal/evaluatorworkspace.h"
 #include "seal/galoiskeys.h"
 #include "seal/keygenerator.h"
+#include "seal/lineartransform.h"
 #include "seal/memorymanager.h"
 #include "seal/modulus.h"
 #include "seal/plaintext.h"
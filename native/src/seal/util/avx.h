@@ -0,0 +1,401 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/util/defines.h"
+#include <cstdint>
+
+#if defined(SEAL_USE_AVX2) || defined(SEAL_USE_AVX512)
+
+namespace seal
+{
+    namespace util
+    {
+        /*
+        Lane-wise 64-bit modular arithmetic helpers for AVX2 (4 lanes) and AVX-512 (8 lanes). All values are
+        unsigned 64-bit integers. Unless stated otherwise the helpers require every input to be less than 2^63, which
+        holds for all lazily reduced values in [0, 4 * modulus) since moduli are at most SEAL_MOD_BIT_COUNT_MAX bits.
+        */
+
+#ifdef SEAL_USE_AVX2
+        /**
+        Returns the high 64 bits of the 128-bit products of x and y.
+        */
+        SEAL_TARGET_AVX2 inline __m256i multiply_uint64_hw64_avx2(__m256i x, __m256i y)
+        {
+            const __m256i low_mask = _mm256_set1_epi64x(0xFFFFFFFF);
+            __m256i x_hi = _mm256_srli_epi64(x, 32);
+            __m256i y_hi = _mm256_srli_epi64(y, 32);
+            __m256i lo_lo = _mm256_mul_epu32(x, y);
+            __m256i hi_lo = _mm256_mul_epu32(x_hi, y);
+            __m256i lo_hi = _mm256_mul_epu32(x, y_hi);
+            __m256i hi_hi = _mm256_mul_epu32(x_hi, y_hi);
+
+            // Neither sum below can overflow 64 bits
+            __m256i cross = _mm256_add_epi64(hi_lo, _mm256_srli_epi64(lo_lo, 32));
+            __m256i cross_carry = _mm256_add_epi64(lo_hi, _mm256_and_si256(cross, low_mask));
+            return _mm256_add_epi64(
+                _mm256_add_epi64(hi_hi, _mm256_srli_epi64(cross, 32)), _mm256_srli_epi64(cross_carry, 32));
+        }
+
+        /**
+        Returns the low 64 bits of the products of x and y.
+        */
+        SEAL_TARGET_AVX2 inline __m256i multiply_uint64_lw64_avx2(__m256i x, __m256i y)
+        {
+            __m256i lo_lo = _mm256_mul_epu32(x, y);
+            __m256i hi_lo = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), y);
+            __m256i lo_hi = _mm256_mul_epu32(x, _mm256_srli_epi64(y, 32));
+            return _mm256_add_epi64(lo_lo, _mm256_slli_epi64(_mm256_add_epi64(hi_lo, lo_hi), 32));
+        }
+
+        /**
+        Returns x - bound if x >= bound, and x otherwise.
+        Correctness: x and bound must be less than 2^63.
+        */
+        SEAL_TARGET_AVX2 inline __m256i guard_avx2(__m256i x, __m256i bound)
+        {
+            return _mm256_sub_epi64(x, _mm256_andnot_si256(_mm256_cmpgt_epi64(bound, x), bound));
+        }
+
+        /**
+        Returns x * y mod modulus or x * y mod modulus + modulus, where y is given by its operand and quotient as in
+        MultiplyUIntModOperand. This is the vector form of multiply_uint_mod_lazy.
+        */
+        SEAL_TARGET_AVX2 inline __m256i multiply_uint_mod_lazy_avx2(
+            __m256i x, __m256i y_operand, __m256i y_quotient, __m256i modulus)
+        {
+            __m256i tmp = multiply_uint64_hw64_avx2(x, y_quotient);
+            return _mm256_sub_epi64(multiply_uint64_lw64_avx2(x, y_operand), multiply_uint64_lw64_avx2(tmp, modulus));
+        }
+
+        /**
+        Computes the full 128-bit products of x and y. This holds for all 64-bit x and y.
+        */
+        SEAL_TARGET_AVX2 inline void multiply_uint64_avx2(__m256i x, __m256i y, __m256i &hw64, __m256i &lw64)
+        {
+            const __m256i low_mask = _mm256_set1_epi64x(0xFFFFFFFF);
+            __m256i x_hi = _mm256_srli_epi64(x, 32);
+            __m256i y_hi = _mm256_srli_epi64(y, 32);
+            __m256i lo_lo = _mm256_mul_epu32(x, y);
+            __m256i hi_lo = _mm256_mul_epu32(x_hi, y);
+            __m256i lo_hi = _mm256_mul_epu32(x, y_hi);
+            __m256i hi_hi = _mm256_mul_epu32(x_hi, y_hi);
+
+            __m256i cross = _mm256_add_epi64(hi_lo, _mm256_srli_epi64(lo_lo, 32));
+            __m256i cross_carry = _mm256_add_epi64(lo_hi, _mm256_and_si256(cross, low_mask));
+            hw64 = _mm256_add_epi64(
+                _mm256_add_epi64(hi_hi, _mm256_srli_epi64(cross, 32)), _mm256_srli_epi64(cross_carry, 32));
+            lw64 = _mm256_or_si256(_mm256_slli_epi64(cross_carry, 32), _mm256_and_si256(lo_lo, low_mask));
+        }
+
+        /**
+        Returns all-ones in the lanes where x < y as unsigned integers, and zero elsewhere. This holds for all 64-bit
+        x and y.
+        */
+        SEAL_TARGET_AVX2 inline __m256i cmplt_epu64_avx2(__m256i x, __m256i y)
+        {
+            const __m256i sign = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+            return _mm256_cmpgt_epi64(_mm256_xor_si256(y, sign), _mm256_xor_si256(x, sign));
+        }
+
+        /**
+        Returns x mod modulus for any 64-bit x. This is the vector form of barrett_reduce_64, where const_ratio_1 is
+        modulus.const_ratio()[1].
+        */
+        SEAL_TARGET_AVX2 inline __m256i barrett_reduce_64_avx2(__m256i x, __m256i const_ratio_1, __m256i modulus)
+        {
+            __m256i tmp = multiply_uint64_hw64_avx2(x, const_ratio_1);
+            return guard_avx2(_mm256_sub_epi64(x, multiply_uint64_lw64_avx2(tmp, modulus)), modulus);
+        }
+
+        /**
+        Returns (hw64 * 2^64 + lw64) mod modulus. This is the vector form of barrett_reduce_128, where const_ratio_0
+        and const_ratio_1 are the words of modulus.const_ratio().
+        */
+        SEAL_TARGET_AVX2 inline __m256i barrett_reduce_128_avx2(
+            __m256i hw64, __m256i lw64, __m256i const_ratio_0, __m256i const_ratio_1, __m256i modulus)
+        {
+            // Round 1
+            __m256i carry = multiply_uint64_hw64_avx2(lw64, const_ratio_0);
+            __m256i tmp2_hw64, tmp2_lw64;
+            multiply_uint64_avx2(lw64, const_ratio_1, tmp2_hw64, tmp2_lw64);
+            __m256i tmp1 = _mm256_add_epi64(tmp2_lw64, carry);
+            __m256i tmp3 = _mm256_sub_epi64(tmp2_hw64, cmplt_epu64_avx2(tmp1, carry));
+
+            // Round 2
+            multiply_uint64_avx2(hw64, const_ratio_0, tmp2_hw64, tmp2_lw64);
+            tmp1 = _mm256_add_epi64(tmp1, tmp2_lw64);
+            carry = _mm256_sub_epi64(tmp2_hw64, cmplt_epu64_avx2(tmp1, tmp2_lw64));
+
+            // This is all we care about
+            tmp1 = _mm256_add_epi64(
+                _mm256_add_epi64(multiply_uint64_lw64_avx2(hw64, const_ratio_1), tmp3), carry);
+
+            // Barrett subtraction; one more subtraction is enough
+            return guard_avx2(_mm256_sub_epi64(lw64, multiply_uint64_lw64_avx2(tmp1, modulus)), modulus);
+        }
+
+        /**
+        Returns (hw64 * 2^64 + lw64) * 2^(-64) mod modulus. This is the vector form of montgomery_reduce_128, where
+        montgomery_inv is modulus.montgomery_inv(). This holds for all inputs less than modulus * 2^64.
+        */
+        SEAL_TARGET_AVX2 inline __m256i montgomery_reduce_128_avx2(
+            __m256i hw64, __m256i lw64, __m256i montgomery_inv, __m256i modulus)
+        {
+            __m256i tmp = multiply_uint64_hw64_avx2(multiply_uint64_lw64_avx2(lw64, montgomery_inv), modulus);
+            return _mm256_add_epi64(
+                _mm256_sub_epi64(hw64, tmp), _mm256_and_si256(cmplt_epu64_avx2(hw64, tmp), modulus));
+        }
+
+        /*
+        32-bit word arithmetic for moduli of at most SEAL_SMALL_MOD_BIT_COUNT_MAX bits. All operands fit in the low
+        halves of the lanes, so every product is a single 32x32 -> 64-bit multiplication.
+        */
+
+        /**
+        Returns x * y mod modulus or x * y mod modulus + modulus, where y is given by its operand and
+        y_quotient_32 = floor(y * 2^32 / modulus), the high word of its quotient in MultiplyUIntModOperand.
+        Correctness: x must be less than 2^32, and modulus at most SEAL_SMALL_MOD_BIT_COUNT_MAX bits.
+        */
+        SEAL_TARGET_AVX2 inline __m256i multiply_uint_mod_lazy_32_avx2(
+            __m256i x, __m256i y_operand, __m256i y_quotient_32, __m256i modulus)
+        {
+            __m256i tmp = _mm256_srli_epi64(_mm256_mul_epu32(x, y_quotient_32), 32);
+            return _mm256_sub_epi64(_mm256_mul_epu32(x, y_operand), _mm256_mul_epu32(tmp, modulus));
+        }
+
+        /**
+        Returns x * y mod modulus by Barrett reduction of the product with k = modulus.bit_count(), where shift is
+        k - 1 and ratio = floor(2^(2k) / modulus).
+        Correctness: x and y must be less than modulus, and modulus at most SEAL_SMALL_MOD_BIT_COUNT_MAX bits.
+        */
+        SEAL_TARGET_AVX2 inline __m256i multiply_uint_mod_32_avx2(
+            __m256i x, __m256i y, __m128i shift, __m256i ratio, __m256i modulus)
+        {
+            // The product is less than 2^(2k), so both factors of the quotient estimate are less than 2^(k + 1),
+            // and the estimate is off by at most two
+            __m256i z = _mm256_mul_epu32(x, y);
+            __m256i tmp = _mm256_mul_epu32(_mm256_srl_epi64(z, shift), ratio);
+            tmp = _mm256_srl_epi64(tmp, _mm_add_epi64(shift, _mm_cvtsi32_si128(2)));
+            z = _mm256_sub_epi64(z, _mm256_mul_epu32(tmp, modulus));
+            return guard_avx2(guard_avx2(z, _mm256_add_epi64(modulus, modulus)), modulus);
+        }
+
+        /*
+        Double-precision arithmetic for moduli of at most SEAL_FMA_MOD_BIT_COUNT_MAX bits. The values are integers
+        held exactly in doubles, and products are split into their rounded high part and exact low part with FMA, so
+        the vector multipliers for doubles replace the emulation of 64-bit multiplications.
+        */
+
+        /**
+        Converts integers less than 2^52 to doubles.
+        */
+        SEAL_TARGET_AVX2 inline __m256d uint52_to_double_avx2(__m256i x)
+        {
+            const __m256d two_pow_52 = _mm256_set1_pd(4503599627370496.0);
+            return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(x, _mm256_castpd_si256(two_pow_52))), two_pow_52);
+        }
+
+        /**
+        Converts doubles holding integers in [0, 2^52) to integers.
+        */
+        SEAL_TARGET_AVX2 inline __m256i double_to_uint52_avx2(__m256d x)
+        {
+            const __m256d two_pow_52 = _mm256_set1_pd(4503599627370496.0);
+            return _mm256_xor_si256(
+                _mm256_castpd_si256(_mm256_add_pd(x, two_pow_52)), _mm256_castpd_si256(two_pow_52));
+        }
+
+        /**
+        Returns x + bound in the lanes where x is negative, and x elsewhere.
+        */
+        SEAL_TARGET_AVX2 inline __m256d guard_negative_double_avx2(__m256d x, __m256d bound)
+        {
+            return _mm256_add_pd(x, _mm256_and_pd(_mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_LT_OQ), bound));
+        }
+
+        /**
+        Returns x - bound in the lanes where x >= bound, and x elsewhere.
+        */
+        SEAL_TARGET_AVX2 inline __m256d guard_double_avx2(__m256d x, __m256d bound)
+        {
+            return _mm256_sub_pd(x, _mm256_and_pd(_mm256_cmp_pd(x, bound, _CMP_GE_OQ), bound));
+        }
+
+        /**
+        Returns x mod modulus, where modulus_inv is the double closest to 1 / modulus.
+        Correctness: x must be an integer less than 2^52.
+        */
+        SEAL_TARGET_AVX2 inline __m256d reduce_double_avx2(__m256d x, __m256d modulus, __m256d modulus_inv)
+        {
+            // The quotient is off by at most one, so the remainder is in [-modulus, 2 * modulus)
+            __m256d c = _mm256_round_pd(_mm256_mul_pd(x, modulus_inv), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+            return guard_double_avx2(guard_negative_double_avx2(_mm256_fnmadd_pd(c, modulus, x), modulus), modulus);
+        }
+
+        /**
+        Returns x * y - c * modulus, where c is the quotient of x * y by modulus computed from the rounded product,
+        and modulus_inv is the double closest to 1 / modulus. The result is exact and in [-2 * modulus, 3 * modulus).
+        Correctness: modulus must be at most SEAL_FMA_MOD_BIT_COUNT_MAX bits, x must be an integer less than 2^52,
+        and y an integer less than modulus.
+        */
+        SEAL_TARGET_AVX2 inline __m256d multiply_double_mod_unguarded_avx2(
+            __m256d x, __m256d y, __m256d modulus, __m256d modulus_inv)
+        {
+            // x * y = h + l exactly. Since x * y / modulus < 2^52, the quotient is off by at most two, and both
+            // h - c * modulus and the sum are integers below 2^52 in absolute value, so they are exact.
+            __m256d h = _mm256_mul_pd(x, y);
+            __m256d l = _mm256_fmsub_pd(x, y, h);
+            __m256d c = _mm256_round_pd(_mm256_mul_pd(h, modulus_inv), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+            return _mm256_add_pd(_mm256_fnmadd_pd(c, modulus, h), l);
+        }
+
+        /**
+        Returns x * y mod modulus or x * y mod modulus + modulus, the double-precision counterpart of
+        multiply_uint_mod_lazy. Here two_times_modulus is 2 * modulus.
+        Correctness: Follows the condition of multiply_double_mod_unguarded_avx2.
+        */
+        SEAL_TARGET_AVX2 inline __m256d multiply_double_mod_lazy_avx2(
+            __m256d x, __m256d y, __m256d modulus, __m256d modulus_inv, __m256d two_times_modulus)
+        {
+            __m256d z = multiply_double_mod_unguarded_avx2(x, y, modulus, modulus_inv);
+            return guard_double_avx2(guard_negative_double_avx2(z, two_times_modulus), two_times_modulus);
+        }
+
+        /**
+        Returns x * y mod modulus, the double-precision counterpart of multiply_uint_mod.
+        Correctness: Follows the condition of multiply_double_mod_unguarded_avx2.
+        */
+        SEAL_TARGET_AVX2 inline __m256d multiply_double_mod_avx2(
+            __m256d x, __m256d y, __m256d modulus, __m256d modulus_inv, __m256d two_times_modulus)
+        {
+            return guard_double_avx2(
+                multiply_double_mod_lazy_avx2(x, y, modulus, modulus_inv, two_times_modulus), modulus);
+        }
+#endif
+
+#ifdef SEAL_USE_AVX512
+        /**
+        Returns the high 64 bits of the 128-bit products of x and y.
+        */
+        SEAL_TARGET_AVX512 inline __m512i multiply_uint64_hw64_avx512(__m512i x, __m512i y)
+        {
+            const __m512i low_mask = _mm512_set1_epi64(0xFFFFFFFF);
+            __m512i x_hi = _mm512_srli_epi64(x, 32);
+            __m512i y_hi = _mm512_srli_epi64(y, 32);
+            __m512i lo_lo = _mm512_mul_epu32(x, y);
+            __m512i hi_lo = _mm512_mul_epu32(x_hi, y);
+            __m512i lo_hi = _mm512_mul_epu32(x, y_hi);
+            __m512i hi_hi = _mm512_mul_epu32(x_hi, y_hi);
+
+            // Neither sum below can overflow 64 bits
+            __m512i cross = _mm512_add_epi64(hi_lo, _mm512_srli_epi64(lo_lo, 32));
+            __m512i cross_carry = _mm512_add_epi64(lo_hi, _mm512_and_si512(cross, low_mask));
+            return _mm512_add_epi64(
+                _mm512_add_epi64(hi_hi, _mm512_srli_epi64(cross, 32)), _mm512_srli_epi64(cross_carry, 32));
+        }
+
+        /**
+        Returns x - bound if x >= bound, and x otherwise.
+        This holds for all 64-bit x and bound.
+        */
+        SEAL_TARGET_AVX512 inline __m512i guard_avx512(__m512i x, __m512i bound)
+        {
+            return _mm512_min_epu64(x, _mm512_sub_epi64(x, bound));
+        }
+
+        /**
+        Returns x * y mod modulus or x * y mod modulus + modulus, where y is given by its operand and quotient as in
+        MultiplyUIntModOperand. This is the vector form of multiply_uint_mod_lazy.
+        */
+        SEAL_TARGET_AVX512 inline __m512i multiply_uint_mod_lazy_avx512(
+            __m512i x, __m512i y_operand, __m512i y_quotient, __m512i modulus)
+        {
+            __m512i tmp = multiply_uint64_hw64_avx512(x, y_quotient);
+            return _mm512_sub_epi64(_mm512_mullo_epi64(x, y_operand), _mm512_mullo_epi64(tmp, modulus));
+        }
+
+        /**
+        Returns x * y mod modulus or x * y mod modulus + modulus, where y is given by its operand and
+        y_quotient_32 = floor(y * 2^32 / modulus), the high word of its quotient in MultiplyUIntModOperand.
+        Correctness: x must be less than 2^32, and modulus at most SEAL_SMALL_MOD_BIT_COUNT_MAX bits.
+        */
+        SEAL_TARGET_AVX512 inline __m512i multiply_uint_mod_lazy_32_avx512(
+            __m512i x, __m512i y_operand, __m512i y_quotient_32, __m512i modulus)
+        {
+            __m512i tmp = _mm512_srli_epi64(_mm512_mul_epu32(x, y_quotient_32), 32);
+            return _mm512_sub_epi64(_mm512_mul_epu32(x, y_operand), _mm512_mul_epu32(tmp, modulus));
+        }
+
+        /**
+        Returns x * y mod modulus by Barrett reduction of the product with k = modulus.bit_count(), where shift is
+        k - 1 and ratio = floor(2^(2k) / modulus).
+        Correctness: x and y must be less than modulus, and modulus at most SEAL_SMALL_MOD_BIT_COUNT_MAX bits.
+        */
+        SEAL_TARGET_AVX512 inline __m512i multiply_uint_mod_32_avx512(
+            __m512i x, __m512i y, __m128i shift, __m512i ratio, __m512i modulus)
+        {
+            // The estimate of the quotient is off by at most two
+            __m512i z = _mm512_mul_epu32(x, y);
+            __m512i tmp = _mm512_mul_epu32(_mm512_srl_epi64(z, shift), ratio);
+            tmp = _mm512_srl_epi64(tmp, _mm_add_epi64(shift, _mm_cvtsi32_si128(2)));
+            z = _mm512_sub_epi64(z, _mm512_mul_epu32(tmp, modulus));
+            return guard_avx512(guard_avx512(z, _mm512_add_epi64(modulus, modulus)), modulus);
+        }
+
+        /**
+        Returns x mod modulus for any 64-bit x. This is the vector form of barrett_reduce_64, where const_ratio_1 is
+        modulus.const_ratio()[1].
+        */
+        SEAL_TARGET_AVX512 inline __m512i barrett_reduce_64_avx512(__m512i x, __m512i const_ratio_1, __m512i modulus)
+        {
+            __m512i tmp = multiply_uint64_hw64_avx512(x, const_ratio_1);
+            return guard_avx512(_mm512_sub_epi64(x, _mm512_mullo_epi64(tmp, modulus)), modulus);
+        }
+
+        /**
+        Returns (hw64 * 2^64 + lw64) mod modulus. This is the vector form of barrett_reduce_128, where const_ratio_0
+        and const_ratio_1 are the words of modulus.const_ratio().
+        */
+        SEAL_TARGET_AVX512 inline __m512i barrett_reduce_128_avx512(
+            __m512i hw64, __m512i lw64, __m512i const_ratio_0, __m512i const_ratio_1, __m512i modulus)
+        {
+            const __m512i one = _mm512_set1_epi64(1);
+
+            // Round 1
+            __m512i carry = multiply_uint64_hw64_avx512(lw64, const_ratio_0);
+            __m512i tmp1 = _mm512_add_epi64(_mm512_mullo_epi64(lw64, const_ratio_1), carry);
+            __m512i tmp3 = multiply_uint64_hw64_avx512(lw64, const_ratio_1);
+            tmp3 = _mm512_mask_add_epi64(tmp3, _mm512_cmplt_epu64_mask(tmp1, carry), tmp3, one);
+
+            // Round 2
+            __m512i tmp2_lw64 = _mm512_mullo_epi64(hw64, const_ratio_0);
+            tmp1 = _mm512_add_epi64(tmp1, tmp2_lw64);
+            carry = multiply_uint64_hw64_avx512(hw64, const_ratio_0);
+            carry = _mm512_mask_add_epi64(carry, _mm512_cmplt_epu64_mask(tmp1, tmp2_lw64), carry, one);
+
+            // This is all we care about
+            tmp1 = _mm512_add_epi64(_mm512_add_epi64(_mm512_mullo_epi64(hw64, const_ratio_1), tmp3), carry);
+
+            // Barrett subtraction; one more subtraction is enough
+            return guard_avx512(_mm512_sub_epi64(lw64, _mm512_mullo_epi64(tmp1, modulus)), modulus);
+        }
+
+        /**
+        Returns (hw64 * 2^64 + lw64) * 2^(-64) mod modulus. This is the vector form of montgomery_reduce_128, where
+        montgomery_inv is modulus.montgomery_inv(). This holds for all inputs less than modulus * 2^64.
+        */
+        SEAL_TARGET_AVX512 inline __m512i montgomery_reduce_128_avx512(
+            __m512i hw64, __m512i lw64, __m512i montgomery_inv, __m512i modulus)
+        {
+            __m512i tmp = multiply_uint64_hw64_avx512(_mm512_mullo_epi64(lw64, montgomery_inv), modulus);
+            __m512i result = _mm512_sub_epi64(hw64, tmp);
+            return _mm512_mask_add_epi64(result, _mm512_cmplt_epu64_mask(hw64, tmp), result, modulus);
+        }
+#endif
+    } // namespace util
+} // namespace seal
+
+#endif
@@ -77,6 +77,12 @@ __extension__ typedef unsigned __int128 uint128_t;
 #define SEAL_SUB_BORROW_UINT64(operand1, operand2, borrow, result) _subborrow_u64(borrow, operand1, operand2, result)
 #endif
 
+// Functions using AVX2 or AVX-512 intrinsics are compiled for those targets individually
+#if defined(SEAL_USE_AVX2) || defined(SEAL_USE_AVX512)
+#define SEAL_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SEAL_TARGET_AVX512 __attribute__((target("avx512f,avx512dq")))
+#endif
+
 #endif // SEAL_USE_INTRIN
 
 #endif
@@ -36,6 +36,14 @@ static_assert(sizeof(unsigned long long) == 8, "Require sizeof(unsigned long lon
 // Bit-length of internally used coefficient moduli, e.g., auxiliary base in BFV
 #define SEAL_INTERNAL_MOD_BIT_COUNT 61
 
+// Bit-length bound of coefficient moduli for which the AVX2 kernels multiply in double precision with FMA; all
+// values below 4 * modulus must be exact doubles
+#define SEAL_FMA_MOD_BIT_COUNT_MAX 50
+
+// Bit-length bound of coefficient moduli for which the SIMD kernels multiply 32-bit words; all values below
+// 4 * modulus must fit in 32 bits
+#define SEAL_SMALL_MOD_BIT_COUNT_MAX 30
+
 // Bounds for bit-length of user-defined coefficient moduli
 #define SEAL_USER_MOD_BIT_COUNT_MAX 60
 #define SEAL_USER_MOD_BIT_COUNT_MIN 2
@@ -136,6 +144,14 @@ namespace seal
 #define SEAL_FORCE_INLINE inline
 #endif
 
+// Compile a function for the AVX2 or AVX-512 target
+#ifndef SEAL_TARGET_AVX2
+#define SEAL_TARGET_AVX2
+#endif
+#ifndef SEAL_TARGET_AVX512
+#define SEAL_TARGET_AVX512
+#endif
+
 // Use `if constexpr' from C++17
 #ifdef SEAL_USE_IF_CONSTEXPR
 #define SEAL_IF_CONSTEXPR if constexpr
@@ -10,6 +10,7 @@
 #include "seal/util/pointer.h"
 #include "seal/util/uintarithsmallmod.h"
 #include "seal/util/uintcore.h"
+#include <algorithm>
 #include <stdexcept>
 
 namespace seal
@@ -355,7 +356,124 @@ namespace seal
                 }
             }
 
+            /**
+            Performs in place the first log_height iterations of transform_to_rev on a vector of 2^log_height * width
+            values, viewed as a row-major matrix with 2^log_height rows. These iterations transform every column
+            independently, so columns are processed in narrow tiles that stay in cache. Afterwards each row only needs
+            the remaining iterations, as in the four-step (Bailey) decomposition of the transform.
+
+            @param[values] inputs in normal order
+            @param[log_height] log 2 of the number of rows, must be positive
+            @param[width] number of columns
+            @param[roots] powers of a root in bit-reversed order, as for transform_to_rev of the full size
+            */
+            void transform_columns_to_rev(
+                ValueType *values, int log_height, std::size_t width, const RootType *roots) const
+            {
+                std::size_t height = std::size_t(1) << log_height;
+                for (std::size_t column = 0; column < width; column += column_tile_width)
+                {
+                    std::size_t tile_width = std::min(width - column, column_tile_width);
+                    const RootType *r = roots;
+                    std::size_t gap = (height >> 1) * width;
+                    for (std::size_t m = 1; m < height; m <<= 1, gap >>= 1)
+                    {
+                        ValueType *x = values + column;
+                        for (std::size_t i = 0; i < m; i++, x += gap << 1)
+                        {
+                            ++r;
+                            for (ValueType *row = x; row != x + gap; row += width)
+                            {
+                                ValueType *y = row + gap;
+                                for (std::size_t j = 0; j < tile_width; j++)
+                                {
+                                    ValueType u = arithmetic_.guard(row[j]);
+                                    ValueType v = arithmetic_.mul_root(y[j], *r);
+                                    row[j] = arithmetic_.add(u, v);
+                                    y[j] = arithmetic_.sub(u, v);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            /**
+            Performs in place the last log_height iterations of transform_from_rev on a vector of 2^log_height * width
+            values, viewed as a row-major matrix with 2^log_height rows, after the rows have been transformed. See
+            transform_columns_to_rev.
+
+            @param[values] inputs with transformed rows, outputs in normal order
+            @param[log_height] log 2 of the number of rows, must be positive
+            @param[width] number of columns
+            @param[roots] the last 2^log_height - 1 powers of a root used by transform_from_rev of the full size, that
+            is, the powers of the full size starting at index 2^log_height * width - 2^log_height
+            @param[scalar] an optional scalar that is multiplied to all output values
+            */
+            void transform_columns_from_rev(
+                ValueType *values, int log_height, std::size_t width, const RootType *roots,
+                const ScalarType *scalar = nullptr) const
+            {
+                std::size_t height = std::size_t(1) << log_height;
+                RootType last_r = roots[height - 1];
+                if (scalar != nullptr)
+                {
+                    last_r = arithmetic_.mul_root_scalar(last_r, *scalar);
+                }
+                for (std::size_t column = 0; column < width; column += column_tile_width)
+                {
+                    std::size_t tile_width = std::min(width - column, column_tile_width);
+                    const RootType *r = roots;
+                    std::size_t gap = width;
+                    for (std::size_t m = height >> 1; m > 1; m >>= 1, gap <<= 1)
+                    {
+                        ValueType *x = values + column;
+                        for (std::size_t i = 0; i < m; i++, x += gap << 1)
+                        {
+                            ++r;
+                            for (ValueType *row = x; row != x + gap; row += width)
+                            {
+                                ValueType *y = row + gap;
+                                for (std::size_t j = 0; j < tile_width; j++)
+                                {
+                                    ValueType u = row[j];
+                                    ValueType v = y[j];
+                                    row[j] = arithmetic_.guard(arithmetic_.add(u, v));
+                                    y[j] = arithmetic_.mul_root(arithmetic_.sub(u, v), *r);
+                                }
+                            }
+                        }
+                    }
+
+                    ValueType *x = values + column;
+                    for (ValueType *row = x; row != x + gap; row += width)
+                    {
+                        ValueType *y = row + gap;
+                        for (std::size_t j = 0; j < tile_width; j++)
+                        {
+                            if (scalar != nullptr)
+                            {
+                                ValueType u = arithmetic_.guard(row[j]);
+                                ValueType v = y[j];
+                                row[j] = arithmetic_.mul_scalar(arithmetic_.guard(arithmetic_.add(u, v)), *scalar);
+                                y[j] = arithmetic_.mul_root(arithmetic_.sub(u, v), last_r);
+                            }
+                            else
+                            {
+                                ValueType u = row[j];
+                                ValueType v = y[j];
+                                row[j] = arithmetic_.guard(arithmetic_.add(u, v));
+                                y[j] = arithmetic_.mul_root(arithmetic_.sub(u, v), last_r);
+                            }
+                        }
+                    }
+                }
+            }
+
         private:
+            // Number of columns processed together by transform_columns_to_rev and transform_columns_from_rev
+            static constexpr std::size_t column_tile_width = 16;
+
             Arithmetic<ValueType, RootType, ScalarType> arithmetic_;
         };
     } // namespace util
@@ -91,6 +91,12 @@ __extension__ typedef unsigned __int128 uint128_t;
 #endif //(__GNUC__ == 7) && (__GNUC_MINOR__ >= 2)
 #endif
 
+// Functions using AVX2 or AVX-512 intrinsics are compiled for those targets individually
+#if defined(SEAL_USE_AVX2) || defined(SEAL_USE_AVX512)
+#define SEAL_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SEAL_TARGET_AVX512 __attribute__((target("avx512f,avx512dq")))
+#endif
+
 #endif // SEAL_USE_INTRIN
 
 #endif
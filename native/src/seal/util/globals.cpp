@@ -18,6 +18,8 @@ namespace seal
 #else
 #pragma message("WARNING: Thread-local memory pools disabled to support /clr")
 #endif
+            const simd_level_type simd_level{ select_simd_level_from_environment() };
+
             const map<size_t, vector<Modulus>> &GetDefaultCoeffModulus128()
             {
                 static const map<size_t, vector<Modulus>> default_coeff_modulus_128{
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "seal/util/hestdparms.h"
+#include "seal/util/simd.h"
 #include <cstddef>
 #include <map>
 #include <memory>
@@ -30,6 +31,12 @@ For .NET Framework wrapper support (C++/CLI) we need to
 #ifndef _M_CEE
             extern thread_local std::shared_ptr<MemoryPool> const tls_memory_pool;
 #endif
+            /**
+            The SIMD level of the arithmetic kernels. It is selected once when the library is loaded from the running
+            CPU and can be lowered with the environment variable SEAL_SIMD_LEVEL (none, avx2, or avx512).
+            */
+            extern const simd_level_type simd_level;
+
             /**
             Default value for the standard deviation of the noise (error) distribution.
             */
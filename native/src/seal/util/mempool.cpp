@@ -7,6 +7,16 @@
 #include <cmath>
 #include <numeric>
 #include <stdexcept>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#if defined(__linux__)
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
@@ -26,96 +36,617 @@ namespace seal
         // ensure symbol is created.
         constexpr size_t MemoryPool::first_alloc_count;
 
-        MemoryPoolHeadMT::MemoryPoolHeadMT(size_t item_byte_count, bool clear_on_destruction)
-            : clear_on_destruction_(clear_on_destruction), locked_(false), item_byte_count_(item_byte_count),
-              item_count_(MemoryPool::first_alloc_count), first_item_(nullptr)
+        namespace
         {
-            if ((item_byte_count_ == 0) || (item_byte_count_ > MemoryPool::max_batch_alloc_byte_count) ||
-                (mul_safe(item_byte_count_, MemoryPool::first_alloc_count) > MemoryPool::max_batch_alloc_byte_count))
+            // Slabs of at least half of this size are backed by huge pages if requested
+            constexpr size_t huge_page_byte_count = size_t(1) << 21;
+
+            // Alignment of items in pools that use huge pages
+            constexpr size_t slab_alignment = 64;
+
+#if defined(__linux__)
+            // Slabs of at least this size are mapped and prefer a NUMA node if requested
+            constexpr size_t page_byte_count = size_t(1) << 12;
+
+            // Largest number of NUMA nodes that slabs can prefer
+            constexpr size_t max_numa_node_count = 1024;
+
+            // Sets the memory policy of the pages in [ptr, ptr + byte_count) to prefer numa_node. The pages are
+            // placed when first touched, on another node if numa_node has no free memory. Failure leaves the default
+            // policy, which places pages on the node of the thread that touches them first.
+            void prefer_numa_node(void *ptr, size_t byte_count, int numa_node) noexcept
             {
-                throw invalid_argument("invalid allocation size");
+#ifdef SYS_mbind
+                if (static_cast<size_t>(numa_node) >= max_numa_node_count)
+                {
+                    return;
+                }
+
+                // MPOL_PREFERRED in <numaif.h>
+                constexpr int mpol_preferred = 1;
+                constexpr size_t mask_bit_count = sizeof(unsigned long) * static_cast<size_t>(bits_per_byte);
+                unsigned long node_mask[max_numa_node_count / mask_bit_count]{};
+                node_mask[static_cast<size_t>(numa_node) / mask_bit_count] =
+                    1UL << (static_cast<size_t>(numa_node) % mask_bit_count);
+                syscall(SYS_mbind, ptr, byte_count, mpol_preferred, node_mask, max_numa_node_count + 1, 0);
+#else
+                (void)ptr;
+                (void)byte_count;
+                (void)numa_node;
+#endif
             }
 
-            // Initial allocation
-            allocation new_alloc;
-            try
+            // Maps byte_count bytes, a multiple of huge_page_byte_count, backed by explicit huge pages if the system
+            // has them reserved, or else aligned for transparent huge pages; returns nullptr on failure
+            seal_byte *map_huge_pages(size_t byte_count) noexcept
+            {
+#ifdef MAP_HUGETLB
+                void *huge_ptr =
+                    mmap(nullptr, byte_count, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (huge_ptr != MAP_FAILED)
+                {
+                    return static_cast<seal_byte *>(huge_ptr);
+                }
+#endif
+                // Map more than needed and unmap the parts outside an aligned range
+                size_t mapped_byte_count = byte_count + huge_page_byte_count;
+                void *ptr =
+                    mmap(nullptr, mapped_byte_count, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (ptr == MAP_FAILED)
+                {
+                    return nullptr;
+                }
+                uintptr_t start = reinterpret_cast<uintptr_t>(ptr);
+                uintptr_t aligned_start = (start + huge_page_byte_count - 1) & ~uintptr_t(huge_page_byte_count - 1);
+                uintptr_t aligned_end = aligned_start + byte_count;
+                if (aligned_start > start)
+                {
+                    munmap(ptr, aligned_start - start);
+                }
+                if (start + mapped_byte_count > aligned_end)
+                {
+                    munmap(reinterpret_cast<void *>(aligned_end), start + mapped_byte_count - aligned_end);
+                }
+#ifdef MADV_HUGEPAGE
+                madvise(reinterpret_cast<void *>(aligned_start), byte_count, MADV_HUGEPAGE);
+#endif
+                return reinterpret_cast<seal_byte *>(aligned_start);
+            }
+#endif
+            // Allocates memory for alloc.size items and sets alloc.data_ptr and alloc.base_ptr. With huge_pages,
+            // large slabs are resized to whole huge pages, which changes alloc.size, and all slabs are aligned to
+            // slab_alignment; item_byte_count must then be a multiple of slab_alignment. With a non-negative
+            // numa_node, slabs of whole pages are resized and prefer the node; smaller slabs follow the default
+            // first-touch placement.
+            void allocate_slab(
+                MemoryPoolHead::allocation &alloc, size_t item_byte_count, bool huge_pages, int numa_node = -1)
             {
-                new_alloc.data_ptr = SEAL_MALLOC(mul_safe(MemoryPool::first_alloc_count, item_byte_count_));
+                size_t byte_count = mul_safe(alloc.size, item_byte_count);
+#if defined(__linux__)
+                if (numa_node >= 0 && !huge_pages && byte_count >= page_byte_count)
+                {
+                    size_t mapped_byte_count =
+                        mul_safe(add_safe(byte_count, page_byte_count - 1) / page_byte_count, page_byte_count);
+                    void *ptr = mmap(
+                        nullptr, mapped_byte_count, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                    if (ptr != MAP_FAILED)
+                    {
+                        prefer_numa_node(ptr, mapped_byte_count, numa_node);
+                        alloc.data_ptr = static_cast<seal_byte *>(ptr);
+                        alloc.base_ptr = alloc.data_ptr;
+                        alloc.mapped_byte_count = mapped_byte_count;
+                        alloc.size = mapped_byte_count / item_byte_count;
+                        return;
+                    }
+                }
+#endif
+                if (!huge_pages)
+                {
+                    try
+                    {
+                        alloc.data_ptr = SEAL_MALLOC(byte_count);
+                    }
+                    catch (const bad_alloc &)
+                    {
+                        // Allocation failed; rethrow
+                        throw;
+                    }
+                    if (alloc.data_ptr == nullptr)
+                    {
+                        // Allocation failed; rethrow
+                        throw bad_alloc();
+                    }
+                    alloc.base_ptr = alloc.data_ptr;
+                    return;
+                }
+#if defined(__linux__)
+                if (byte_count >= huge_page_byte_count / 2 || item_byte_count >= huge_page_byte_count / 32)
+                {
+                    // Use the nearest number of whole huge pages that holds at least one item
+                    size_t page_count = max(
+                        add_safe(byte_count, huge_page_byte_count / 2) / huge_page_byte_count,
+                        add_safe(item_byte_count, huge_page_byte_count - 1) / huge_page_byte_count);
+                    size_t mapped_byte_count = mul_safe(page_count, huge_page_byte_count);
+                    alloc.data_ptr = map_huge_pages(mapped_byte_count);
+                    if (alloc.data_ptr)
+                    {
+                        if (numa_node >= 0)
+                        {
+                            prefer_numa_node(alloc.data_ptr, mapped_byte_count, numa_node);
+                        }
+                        alloc.base_ptr = alloc.data_ptr;
+                        alloc.mapped_byte_count = mapped_byte_count;
+                        alloc.size = mapped_byte_count / item_byte_count;
+                        return;
+                    }
+                }
+#endif
+                // Align the memory within a slightly larger allocation
+                try
+                {
+                    alloc.base_ptr = SEAL_MALLOC(add_safe(byte_count, slab_alignment));
+                }
+                catch (const bad_alloc &)
+                {
+                    // Allocation failed; rethrow
+                    throw;
+                }
+                if (alloc.base_ptr == nullptr)
+                {
+                    // Allocation failed; rethrow
+                    throw bad_alloc();
+                }
+                uintptr_t start = reinterpret_cast<uintptr_t>(alloc.base_ptr);
+                uintptr_t aligned_start = (start + slab_alignment - 1) & ~uintptr_t(slab_alignment - 1);
+                alloc.data_ptr = alloc.base_ptr + (aligned_start - start);
             }
-            catch (const bad_alloc &)
+
+            // Releases the memory of a slab allocated with allocate_slab, clearing it first if requested
+            void free_slab(MemoryPoolHead::allocation &alloc, size_t item_byte_count, bool clear) noexcept
             {
-                // Allocation failed; rethrow
-                throw;
+                if (clear)
+                {
+                    seal_memzero(alloc.data_ptr, mul_safe(item_byte_count, alloc.size));
+                }
+#if defined(__linux__)
+                if (alloc.mapped_byte_count)
+                {
+                    munmap(alloc.data_ptr, alloc.mapped_byte_count);
+                    return;
+                }
+#endif
+                SEAL_FREE(alloc.base_ptr);
             }
-            if (new_alloc.data_ptr == nullptr)
+        } // namespace
+
+        size_t numa_node_count() noexcept
+        {
+#if defined(__linux__)
+            static const size_t node_count = []() -> size_t {
+                try
+                {
+                    // The possible nodes are listed as ranges, such as 0-3 or 0,2-3, in increasing order
+                    ifstream file("/sys/devices/system/node/possible");
+                    string nodes;
+                    if (!(file >> nodes))
+                    {
+                        return 1;
+                    }
+                    size_t last_begin = nodes.find_last_not_of("0123456789") + 1;
+                    size_t last_node = stoul(nodes.substr(last_begin));
+                    return min(last_node + 1, max_numa_node_count);
+                }
+                catch (...)
+                {
+                    return 1;
+                }
+            }();
+            return node_count;
+#else
+            return 1;
+#endif
+        }
+
+        size_t current_numa_node() noexcept
+        {
+#if defined(__linux__) && defined(SYS_getcpu)
+            // Each thread asks the kernel only every numa_node_refresh_count calls; a thread that migrates to
+            // another node in between keeps using the pool of its previous node until the next refresh
+            constexpr uint32_t numa_node_refresh_count = 1024;
+            static thread_local uint32_t calls_until_refresh = 0;
+            static thread_local size_t node = 0;
+            if (!calls_until_refresh--)
             {
-                // Allocation failed; rethrow
-                throw bad_alloc();
+                calls_until_refresh = numa_node_refresh_count - 1;
+                unsigned cpu = 0;
+                unsigned new_node = 0;
+                node = (!syscall(SYS_getcpu, &cpu, &new_node, nullptr) && new_node < numa_node_count())
+                           ? static_cast<size_t>(new_node)
+                           : 0;
             }
+            return node;
+#else
+            return 0;
+#endif
+        }
+
+#ifndef _M_CEE
+        namespace
+        {
+            // Gives every thread a distinct index into the magazines of MemoryPoolHeadMT; the index of a finished
+            // thread is given to the next new thread, which then takes over the items left in its magazines.
+            class MagazineIndex
+            {
+            public:
+                MagazineIndex()
+                {
+                    Registry &reg = registry();
+                    lock_guard<mutex> lock(reg.mutex);
+                    if (reg.released.empty())
+                    {
+                        value = reg.next_value++;
+                    }
+                    else
+                    {
+                        value = reg.released.back();
+                        reg.released.pop_back();
+                    }
+                }
 
+                ~MagazineIndex() noexcept
+                {
+                    Registry &reg = registry();
+                    lock_guard<mutex> lock(reg.mutex);
+                    reg.released.push_back(value);
+
+                    // Any later use by this thread, e.g., from other thread-local destructors, bypasses the magazines
+                    value = MemoryPoolHeadMT::magazine_count;
+                }
+
+                size_t value;
+
+            private:
+                struct Registry
+                {
+                    std::mutex mutex;
+
+                    vector<size_t> released;
+
+                    size_t next_value = 0;
+                };
+
+                static Registry &registry()
+                {
+                    // Never destroyed, so that threads still running at exit can release their index
+                    static Registry *reg = new Registry;
+                    return *reg;
+                }
+            };
+        } // namespace
+#endif
+
+        // Required for C++14 compliance: static constexpr member variables are not necessarily inlined so need to
+        // ensure symbol is created.
+        constexpr size_t MemoryPoolHeadMT::magazine_capacity;
+
+        // Required for C++14 compliance: static constexpr member variables are not necessarily inlined so need to
+        // ensure symbol is created.
+        constexpr size_t MemoryPoolHeadMT::magazine_count;
+
+        MemoryPoolHeadMT::MemoryPoolHeadMT(
+            size_t item_byte_count, bool clear_on_destruction, bool huge_pages, int numa_node)
+            : clear_on_destruction_(clear_on_destruction), huge_pages_(huge_pages), numa_node_(numa_node),
+              item_byte_count_(item_byte_count),
+              item_count_(MemoryPool::first_alloc_count), magazines_(new Magazine[magazine_count]),
+              peak_item_count_(MemoryPool::first_alloc_count)
+        {
+            if ((item_byte_count_ == 0) || (item_byte_count_ > MemoryPool::max_batch_alloc_byte_count) ||
+                (mul_safe(item_byte_count_, MemoryPool::first_alloc_count) > MemoryPool::max_batch_alloc_byte_count))
+            {
+                throw invalid_argument("invalid allocation size");
+            }
+
+            // Initial allocation
+            allocation new_alloc;
             new_alloc.size = MemoryPool::first_alloc_count;
-            new_alloc.free = MemoryPool::first_alloc_count;
+            allocate_slab(new_alloc, item_byte_count_, huge_pages_, numa_node_);
+
+            new_alloc.free = new_alloc.size;
             new_alloc.head_ptr = new_alloc.data_ptr;
             allocs_.clear();
             allocs_.push_back(new_alloc);
+            item_count_ = new_alloc.size;
+            peak_item_count_ = new_alloc.size;
         }
 
         MemoryPoolHeadMT::~MemoryPoolHeadMT() noexcept
         {
-            bool expected = false;
-            while (!locked_.compare_exchange_strong(expected, true, memory_order_acquire))
+            // Delete the items (but not the memory); every item ever created is in the segments, whether it is in a
+            // magazine, in the shared free list, or still in use
+            for (uint32_t index = 0; index < created_count_; index++)
             {
-                expected = false;
+                delete item_at(index);
             }
+            created_count_ = 0;
 
-            // Delete the items (but not the memory)
-            MemoryPoolItem *curr_item = first_item_;
-            while (curr_item)
+            // Delete the memory, clearing it first if needed
+            for (auto &alloc : allocs_)
             {
-                MemoryPoolItem *next_item = curr_item->next();
-                delete curr_item;
-                curr_item = next_item;
+                free_slab(alloc, item_byte_count_, clear_on_destruction_);
             }
-            first_item_ = nullptr;
 
-            // Do we need to clear the memory?
-            if (clear_on_destruction_)
+            allocs_.clear();
+        }
+
+        auto MemoryPoolHeadMT::thread_magazine() noexcept -> Magazine *
+        {
+#ifndef _M_CEE
+            static thread_local MagazineIndex magazine_index;
+            return (magazine_index.value < magazine_count) ? magazines_.get() + magazine_index.value : nullptr;
+#else
+            return nullptr;
+#endif
+        }
+
+        void MemoryPoolHeadMT::push_shared(MemoryPoolItem *first) noexcept
+        {
+            // Link the items by index
+            MemoryPoolItem *last = first;
+            while (last->next())
             {
-                // Delete the memory
-                for (auto &alloc : allocs_)
-                {
-                    size_t curr_alloc_byte_count = mul_safe(item_byte_count_, alloc.size);
-                    seal_memzero(alloc.data_ptr, curr_alloc_byte_count);
+                last->next_index().store(last->next()->index() + 1, memory_order_relaxed);
+                last = last->next();
+            }
+
+            uint64_t old_first = shared_first_.load(memory_order_relaxed);
+            uint64_t new_first;
+            do
+            {
+                last->next_index().store(static_cast<uint32_t>(old_first), memory_order_relaxed);
+                new_first = (old_first & ~uint64_t(0xFFFFFFFF)) | (static_cast<uint64_t>(first->index()) + 1);
+            } while (
+                !shared_first_.compare_exchange_weak(old_first, new_first, memory_order_release, memory_order_relaxed));
+        }
+
+        MemoryPoolItem *MemoryPoolHeadMT::pop_shared() noexcept
+        {
+            uint64_t old_first = shared_first_.load(memory_order_acquire);
+            while (static_cast<uint32_t>(old_first))
+            {
+                MemoryPoolItem *item = item_at(static_cast<uint32_t>(old_first) - 1);
 
-                    // Delete this allocation
-                    SEAL_FREE(alloc.data_ptr);
+                // The item may be taken by another thread at any time, in which case the tag changes and the
+                // compare-and-swap fails, so reading its next index is safe
+                uint64_t new_first = ((old_first >> 32) + 1) << 32;
+                new_first |= item->next_index().load(memory_order_relaxed);
+                if (shared_first_.compare_exchange_weak(
+                        old_first, new_first, memory_order_acquire, memory_order_acquire))
+                {
+                    item->next() = nullptr;
+                    return item;
                 }
             }
+            return nullptr;
+        }
+
+        MemoryPoolItem *MemoryPoolHeadMT::new_item()
+        {
+            if (created_count_ == numeric_limits<uint32_t>::max())
+            {
+                throw runtime_error("maximum item count reached");
+            }
+
+            // Make sure the segment for the new item exists
+            int segment = get_significant_bit_count(static_cast<uint64_t>(created_count_) + 1) - 1;
+            if (!segments_[segment])
+            {
+                segments_[segment].reset(new MemoryPoolItem *[size_t(1) << segment]);
+            }
+
+            allocation &last_alloc = allocs_.back();
+            seal_byte *data = nullptr;
+            if (last_alloc.free > 0)
+            {
+                // There is memory
+                data = last_alloc.head_ptr;
+                last_alloc.free--;
+                last_alloc.head_ptr += item_byte_count_;
+            }
             else
             {
-                // Delete the memory
-                for (auto &alloc : allocs_)
+                // There is no memory
+                allocation new_alloc;
+
+                // Increase allocation size unless we are already at max
+                size_t new_size =
+                    safe_cast<size_t>(ceil(MemoryPool::alloc_size_multiplier * static_cast<double>(last_alloc.size)));
+                size_t new_alloc_byte_count = mul_safe(new_size, item_byte_count_);
+                if (new_alloc_byte_count > MemoryPool::max_batch_alloc_byte_count)
                 {
-                    // Delete this allocation
-                    SEAL_FREE(alloc.data_ptr);
+                    new_size = last_alloc.size;
                 }
+
+                new_alloc.size = new_size;
+                allocate_slab(new_alloc, item_byte_count_, huge_pages_, numa_node_);
+
+                new_alloc.free = new_alloc.size - 1;
+                new_alloc.head_ptr = new_alloc.data_ptr + item_byte_count_;
+                allocs_.push_back(new_alloc);
+                item_count_.fetch_add(new_alloc.size, memory_order_relaxed);
+                peak_item_count_ = max(peak_item_count_, item_count_.load(memory_order_relaxed));
+                data = new_alloc.data_ptr;
             }
 
-            allocs_.clear();
+            MemoryPoolItem *item = new MemoryPoolItem(data, created_count_);
+            uint64_t position = static_cast<uint64_t>(created_count_) + 1;
+            segments_[segment][position - (uint64_t(1) << segment)] = item;
+            created_count_++;
+            return item;
+        }
+
+        MemoryPoolSizeClassStats MemoryPoolHeadMT::stats() const
+        {
+            MemoryPoolSizeClassStats result;
+            result.item_byte_count = item_byte_count_;
+            result.item_count = item_count();
+
+            uint64_t get_count = shared_get_count_.load(memory_order_relaxed);
+            uint64_t add_count = shared_add_count_.load(memory_order_relaxed);
+            for (size_t i = 0; i < magazine_count; i++)
+            {
+                get_count += magazines_[i].get_count.load(memory_order_relaxed);
+                add_count += magazines_[i].add_count.load(memory_order_relaxed);
+            }
+
+            {
+                lock_guard<mutex> lock(alloc_mutex_);
+                result.miss_count = created_count_;
+                result.peak_item_count = peak_item_count_;
+            }
+
+            // The counters are read while other threads may change them
+            result.miss_count = min<uint64_t>(result.miss_count, get_count);
+            result.hit_count = get_count - result.miss_count;
+            result.in_use_count = static_cast<size_t>(min<uint64_t>(
+                (get_count > add_count) ? get_count - add_count : 0, static_cast<uint64_t>(result.item_count)));
+            return result;
+        }
+
+        bool MemoryPoolHeadMT::idle() const noexcept
+        {
+            uint64_t get_count = shared_get_count_.load(memory_order_relaxed);
+            uint64_t add_count = shared_add_count_.load(memory_order_acquire);
+            for (size_t i = 0; i < magazine_count; i++)
+            {
+                get_count += magazines_[i].get_count.load(memory_order_relaxed);
+                add_count += magazines_[i].add_count.load(memory_order_acquire);
+            }
+            return get_count == add_count;
         }
 
         MemoryPoolItem *MemoryPoolHeadMT::get()
         {
-            bool expected = false;
-            while (!locked_.compare_exchange_strong(expected, true, memory_order_acquire))
+            // Take the most recently released item of this thread
+            Magazine *magazine = thread_magazine();
+            if (magazine)
+            {
+                magazine->get_count.store(magazine->get_count.load(memory_order_relaxed) + 1, memory_order_relaxed);
+            }
+            else
+            {
+                shared_get_count_.fetch_add(1, memory_order_relaxed);
+            }
+            if (magazine && magazine->first)
+            {
+                MemoryPoolItem *item = magazine->first;
+                magazine->first = item->next();
+                magazine->count--;
+                item->next() = nullptr;
+                return item;
+            }
+
+            // Otherwise take one released by any thread
+            MemoryPoolItem *item = pop_shared();
+            if (item)
+            {
+                return item;
+            }
+
+            // Pool is empty
+            lock_guard<mutex> lock(alloc_mutex_);
+            return new_item();
+        }
+
+        void MemoryPoolHeadMT::add(MemoryPoolItem *new_first) noexcept
+        {
+            Magazine *magazine = thread_magazine();
+            if (!magazine)
             {
-                expected = false;
+                new_first->next() = nullptr;
+                push_shared(new_first);
+                shared_add_count_.fetch_add(1, memory_order_release);
+                return;
             }
+
+            // A full magazine goes to the shared free list as a whole, most recently released item first
+            if (magazine->count == magazine_capacity)
+            {
+                push_shared(magazine->first);
+                magazine->first = nullptr;
+                magazine->count = 0;
+            }
+            new_first->next() = magazine->first;
+            magazine->first = new_first;
+            magazine->count++;
+            magazine->add_count.store(magazine->add_count.load(memory_order_relaxed) + 1, memory_order_release);
+        }
+
+        MemoryPoolHeadST::MemoryPoolHeadST(size_t item_byte_count, bool clear_on_destruction, bool huge_pages)
+            : clear_on_destruction_(clear_on_destruction), huge_pages_(huge_pages), item_byte_count_(item_byte_count),
+              item_count_(MemoryPool::first_alloc_count), first_item_(nullptr),
+              peak_item_count_(MemoryPool::first_alloc_count)
+        {
+            if ((item_byte_count_ == 0) || (item_byte_count_ > MemoryPool::max_batch_alloc_byte_count) ||
+                (mul_safe(item_byte_count_, MemoryPool::first_alloc_count) > MemoryPool::max_batch_alloc_byte_count))
+            {
+                throw invalid_argument("invalid allocation size");
+            }
+
+            // Initial allocation
+            allocation new_alloc;
+            new_alloc.size = MemoryPool::first_alloc_count;
+            allocate_slab(new_alloc, item_byte_count_, huge_pages_);
+
+            new_alloc.free = new_alloc.size;
+            new_alloc.head_ptr = new_alloc.data_ptr;
+            allocs_.clear();
+            allocs_.push_back(new_alloc);
+            item_count_ = new_alloc.size;
+            peak_item_count_ = new_alloc.size;
+        }
+
+        MemoryPoolHeadST::~MemoryPoolHeadST() noexcept
+        {
+            // Delete the items (but not the memory)
+            MemoryPoolItem *curr_item = first_item_;
+            while (curr_item)
+            {
+                MemoryPoolItem *next_item = curr_item->next();
+                delete curr_item;
+                curr_item = next_item;
+            }
+            first_item_ = nullptr;
+
+            // Delete the memory, clearing it first if needed
+            for (auto &alloc : allocs_)
+            {
+                free_slab(alloc, item_byte_count_, clear_on_destruction_);
+            }
+
+            allocs_.clear();
+        }
+
+        MemoryPoolSizeClassStats MemoryPoolHeadST::stats() const
+        {
+            MemoryPoolSizeClassStats result;
+            result.item_byte_count = item_byte_count_;
+            result.item_count = item_count_;
+            result.in_use_count = safe_cast<size_t>(get_count_ - add_count_);
+            result.peak_item_count = peak_item_count_;
+            result.hit_count = get_count_ - miss_count_;
+            result.miss_count = miss_count_;
+            return result;
+        }
+
+        MemoryPoolItem *MemoryPoolHeadST::get()
+        {
             MemoryPoolItem *old_first = first_item_;
+            get_count_++;
 
             // Is pool empty?
             if (old_first == nullptr)
             {
+                miss_count_++;
                 allocation &last_alloc = allocs_.back();
                 MemoryPoolItem *new_item = nullptr;
                 if (last_alloc.free > 0)
@@ -130,202 +661,514 @@ namespace seal
                     // Pool is empty; there is no memory
                     allocation new_alloc;
 
-                    // Increase allocation size unless we are already at max
-                    size_t new_size = safe_cast<size_t>(
-                        ceil(MemoryPool::alloc_size_multiplier * static_cast<double>(last_alloc.size)));
-                    size_t new_alloc_byte_count = mul_safe(new_size, item_byte_count_);
-                    if (new_alloc_byte_count > MemoryPool::max_batch_alloc_byte_count)
-                    {
-                        new_size = last_alloc.size;
-                        new_alloc_byte_count = new_size * item_byte_count_;
-                    }
+                    // Increase allocation size unless we are already at max
+                    size_t new_size = safe_cast<size_t>(
+                        ceil(MemoryPool::alloc_size_multiplier * static_cast<double>(last_alloc.size)));
+                    size_t new_alloc_byte_count = mul_safe(new_size, item_byte_count_);
+                    if (new_alloc_byte_count > MemoryPool::max_batch_alloc_byte_count)
+                    {
+                        new_size = last_alloc.size;
+                    }
+
+                    new_alloc.size = new_size;
+                    allocate_slab(new_alloc, item_byte_count_, huge_pages_);
+
+                    new_alloc.free = new_alloc.size - 1;
+                    new_alloc.head_ptr = new_alloc.data_ptr + item_byte_count_;
+                    allocs_.push_back(new_alloc);
+                    item_count_ += new_alloc.size;
+                    peak_item_count_ = max(peak_item_count_, item_count_);
+                    new_item = new MemoryPoolItem(new_alloc.data_ptr);
+                }
+
+                return new_item;
+            }
+
+            // Pool is not empty
+            first_item_ = old_first->next();
+            old_first->next() = nullptr;
+            return old_first;
+        }
+
+        // Required for C++14 compliance: static constexpr member variables are not necessarily inlined so need to
+        // ensure symbol is created.
+        constexpr size_t MemoryPoolHeadStack::alignment;
+
+        MemoryPoolHeadStack::MemoryPoolHeadStack(size_t reserve_byte_count)
+        {
+            if (reserve_byte_count)
+            {
+                reserve(reserve_byte_count);
+            }
+        }
+
+        MemoryPoolHeadStack::~MemoryPoolHeadStack() noexcept
+        {
+            for (auto &block : blocks_)
+            {
+                free_slab(block, alignment, false);
+            }
+            blocks_.clear();
+        }
+
+        void MemoryPoolHeadStack::add_block(size_t unit_count)
+        {
+            allocation new_block;
+            new_block.size = unit_count;
+            allocate_slab(new_block, alignment, true);
+            new_block.free = new_block.size;
+            new_block.head_ptr = new_block.data_ptr;
+            blocks_.push_back(new_block);
+
+            reserved_byte_count_ += new_block.size * alignment;
+            peak_reserved_byte_count_ = max(peak_reserved_byte_count_, reserved_byte_count_);
+        }
+
+        void MemoryPoolHeadStack::reserve(size_t byte_count)
+        {
+            size_t unit_count = add_safe(byte_count, alignment - 1) / alignment;
+            size_t total_unit_count = 0;
+            for (auto &block : blocks_)
+            {
+                total_unit_count += block.size;
+            }
+            if (blocks_.size() == 1 && total_unit_count >= unit_count)
+            {
+                return;
+            }
+
+            // Replace all blocks with one
+            release();
+            add_block(max(unit_count, total_unit_count));
+        }
+
+        size_t MemoryPoolHeadStack::release() noexcept
+        {
+            size_t released = reserved_byte_count_;
+            for (auto &block : blocks_)
+            {
+                free_slab(block, alignment, false);
+            }
+            blocks_.clear();
+            reserved_byte_count_ = 0;
+            return released;
+        }
+
+        MemoryPoolSizeClassStats MemoryPoolHeadStack::stats() const
+        {
+            MemoryPoolSizeClassStats result;
+            result.item_byte_count = 1;
+            result.item_count = reserved_byte_count_;
+            result.in_use_count = in_use_byte_count_;
+            result.peak_item_count = peak_reserved_byte_count_;
+            result.hit_count = hit_count_;
+            result.miss_count = miss_count_;
+            return result;
+        }
+
+        MemoryPoolItem *MemoryPoolHeadStack::get()
+        {
+            // Merge the blocks reserved during the previous sequence of allocations
+            if (entries_.empty() && blocks_.size() > 1)
+            {
+                reserve(reserved_byte_count_);
+            }
+
+            size_t unit_count = max<size_t>(add_safe(next_byte_count_, alignment - 1) / alignment, 1);
+            if (blocks_.empty() || blocks_.back().free < unit_count)
+            {
+                add_block(max(unit_count, blocks_.empty() ? size_t(0) : blocks_.back().size));
+                miss_count_++;
+            }
+            else
+            {
+                hit_count_++;
+            }
+
+            allocation &block = blocks_.back();
+            seal_byte *data = block.head_ptr;
+            block.head_ptr += unit_count * alignment;
+            block.free -= unit_count;
+            in_use_byte_count_ += unit_count * alignment;
+
+            size_t position = entries_.size();
+            if (position == items_.size())
+            {
+                items_.emplace_back(new MemoryPoolItem(data, safe_cast<uint32_t>(position)));
+            }
+            else
+            {
+                items_[position]->set_data(data);
+            }
+            entries_.push_back(entry{ blocks_.size() - 1, next_byte_count_, unit_count, false });
+            return items_[position].get();
+        }
+
+        void MemoryPoolHeadStack::add(MemoryPoolItem *new_first) noexcept
+        {
+            entries_[new_first->index()].released = true;
+
+            // Reclaim the memory of the released allocations at the top
+            while (!entries_.empty() && entries_.back().released)
+            {
+                const entry &top = entries_.back();
+                allocation &block = blocks_[top.block];
+                block.head_ptr -= top.unit_count * alignment;
+                block.free += top.unit_count;
+                in_use_byte_count_ -= top.unit_count * alignment;
+                entries_.pop_back();
+            }
+        }
+
+        // Required for C++14 compliance: static constexpr member variables are not necessarily inlined so need to
+        // ensure symbol is created.
+        constexpr size_t MemoryPoolHeadArena::alignment;
+
+        // Required for C++14 compliance: static constexpr member variables are not necessarily inlined so need to
+        // ensure symbol is created.
+        constexpr size_t MemoryPoolHeadArena::default_chunk_byte_count;
+
+        // Required for C++14 compliance: static constexpr member variables are not necessarily inlined so need to
+        // ensure symbol is created.
+        constexpr size_t MemoryPoolHeadArena::first_item_chunk_size;
+
+        MemoryPoolHeadArena::MemoryPoolHeadArena(size_t reserve_byte_count)
+            : first_chunk_byte_count_(reserve_byte_count ? reserve_byte_count : default_chunk_byte_count)
+        {}
+
+        MemoryPoolHeadArena::~MemoryPoolHeadArena() noexcept
+        {
+            release();
+        }
+
+        void MemoryPoolHeadArena::add_chunk(
+            vector<unique_ptr<chunk>> &chunks, atomic<chunk *> &current, size_t size, size_t unit_byte_count)
+        {
+            auto new_chunk = make_unique<chunk>();
+            new_chunk->alloc.size = size;
+            new_chunk->unit_byte_count = unit_byte_count;
+            allocate_slab(new_chunk->alloc, unit_byte_count, unit_byte_count == alignment);
+            chunks.push_back(move(new_chunk));
+            current.store(chunks.back().get(), memory_order_release);
+        }
+
+        void MemoryPoolHeadArena::free_chunks(vector<unique_ptr<chunk>> &chunks, atomic<chunk *> &current) noexcept
+        {
+            for (auto &each_chunk : chunks)
+            {
+                free_slab(each_chunk->alloc, each_chunk->unit_byte_count, false);
+            }
+            chunks.clear();
+            current.store(nullptr, memory_order_relaxed);
+        }
+
+        template <typename AddChunk>
+        seal_byte *MemoryPoolHeadArena::take(atomic<chunk *> &current, size_t unit_count, AddChunk &&add_chunk)
+        {
+            while (true)
+            {
+                chunk *taken_from = current.load(memory_order_acquire);
+                if (taken_from)
+                {
+                    size_t offset = taken_from->used.fetch_add(unit_count, memory_order_relaxed);
+                    if (offset <= taken_from->alloc.size && unit_count <= taken_from->alloc.size - offset)
+                    {
+                        return taken_from->alloc.data_ptr + offset * taken_from->unit_byte_count;
+                    }
+                }
+
+                // The chunk is full; unless another thread has already done so, reserve a larger one
+                lock_guard<mutex> lock(chunks_mutex_);
+                if (current.load(memory_order_acquire) == taken_from)
+                {
+                    add_chunk(taken_from);
+                }
+            }
+        }
+
+        MemoryPoolItem *MemoryPoolHeadArena::get()
+        {
+            throw logic_error("allocation size is required");
+        }
+
+        MemoryPoolItem *MemoryPoolHeadArena::get(size_t byte_count)
+        {
+            size_t unit_count = max<size_t>(add_safe(byte_count, alignment - 1) / alignment, 1);
+            bool missed = false;
+            seal_byte *data = take(current_, unit_count, [&](chunk *full) {
+                size_t size = full ? mul_safe(full->alloc.size, size_t(2))
+                                   : add_safe(first_chunk_byte_count_, alignment - 1) / alignment;
+                add_chunk(chunks_, current_, max(size, unit_count), alignment);
+
+                size_t new_byte_count = mul_safe(chunks_.back()->alloc.size, alignment);
+                size_t reserved = reserved_byte_count_.fetch_add(new_byte_count, memory_order_relaxed) + new_byte_count;
+                if (reserved > peak_reserved_byte_count_.load(memory_order_relaxed))
+                {
+                    peak_reserved_byte_count_.store(reserved, memory_order_relaxed);
+                }
+                missed = true;
+            });
+            seal_byte *item_data = take(current_items_, 1, [&](chunk *full) {
+                size_t size = full ? mul_safe(full->alloc.size, size_t(2)) : first_item_chunk_size;
+                add_chunk(item_chunks_, current_items_, size, sizeof(ArenaItem));
+            });
+
+            in_use_byte_count_.fetch_add(byte_count, memory_order_relaxed);
+            (missed ? miss_count_ : hit_count_).fetch_add(1, memory_order_relaxed);
+            return new (item_data) ArenaItem(data, byte_count);
+        }
+
+        void MemoryPoolHeadArena::add(MemoryPoolItem *new_first) noexcept
+        {
+            // The item is kept in its chunk and needs no destruction
+            in_use_byte_count_.fetch_sub(static_cast<ArenaItem *>(new_first)->byte_count, memory_order_release);
+        }
 
-                    try
-                    {
-                        new_alloc.data_ptr = SEAL_MALLOC(new_alloc_byte_count);
-                    }
-                    catch (const bad_alloc &)
-                    {
-                        // Allocation failed; rethrow
-                        throw;
-                    }
-                    if (new_alloc.data_ptr == nullptr)
+        void MemoryPoolHeadArena::reset()
+        {
+            lock_guard<mutex> lock(chunks_mutex_);
+
+            // Replace all chunks with one as large as all of them together
+            auto merge = [&](vector<unique_ptr<chunk>> &chunks, atomic<chunk *> &current) {
+                if (chunks.size() > 1)
+                {
+                    size_t total_size = 0;
+                    for (auto &each_chunk : chunks)
                     {
-                        // Allocation failed; rethrow
-                        throw bad_alloc();
+                        total_size += each_chunk->alloc.size;
                     }
-
-                    new_alloc.size = new_size;
-                    new_alloc.free = new_size - 1;
-                    new_alloc.head_ptr = new_alloc.data_ptr + item_byte_count_;
-                    allocs_.push_back(new_alloc);
-                    item_count_ += new_size;
-                    new_item = new MemoryPoolItem(new_alloc.data_ptr);
+                    size_t unit_byte_count = chunks.back()->unit_byte_count;
+                    free_chunks(chunks, current);
+                    add_chunk(chunks, current, total_size, unit_byte_count);
                 }
+                else if (!chunks.empty())
+                {
+                    chunks.back()->used.store(0, memory_order_relaxed);
+                }
+            };
+            merge(item_chunks_, current_items_);
+            size_t reserved = reserved_byte_count_.load(memory_order_relaxed);
+            reserved_byte_count_.store(0, memory_order_relaxed);
+            merge(chunks_, current_);
+            reserved_byte_count_.store(chunks_.empty() ? size_t(0) : reserved, memory_order_relaxed);
+        }
 
-                locked_.store(false, memory_order_release);
-                return new_item;
-            }
-
-            // Pool is not empty
-            first_item_ = old_first->next();
-            old_first->next() = nullptr;
-            locked_.store(false, memory_order_release);
-            return old_first;
+        size_t MemoryPoolHeadArena::release() noexcept
+        {
+            lock_guard<mutex> lock(chunks_mutex_);
+            free_chunks(item_chunks_, current_items_);
+            free_chunks(chunks_, current_);
+            return reserved_byte_count_.exchange(0, memory_order_relaxed);
         }
 
-        MemoryPoolHeadST::MemoryPoolHeadST(size_t item_byte_count, bool clear_on_destruction)
-            : clear_on_destruction_(clear_on_destruction), item_byte_count_(item_byte_count),
-              item_count_(MemoryPool::first_alloc_count), first_item_(nullptr)
+        MemoryPoolSizeClassStats MemoryPoolHeadArena::stats() const
         {
-            if ((item_byte_count_ == 0) || (item_byte_count_ > MemoryPool::max_batch_alloc_byte_count) ||
-                (mul_safe(item_byte_count_, MemoryPool::first_alloc_count) > MemoryPool::max_batch_alloc_byte_count))
+            MemoryPoolSizeClassStats result;
+            result.item_byte_count = 1;
+            result.item_count = reserved_byte_count_.load(memory_order_relaxed);
+            result.in_use_count = in_use_byte_count_.load(memory_order_relaxed);
+            result.peak_item_count = peak_reserved_byte_count_.load(memory_order_relaxed);
+            result.hit_count = hit_count_.load(memory_order_relaxed);
+            result.miss_count = miss_count_.load(memory_order_relaxed);
+            return result;
+        }
+
+        const size_t MemoryPool::max_single_alloc_byte_count = []() -> size_t {
+            int bit_shift = static_cast<int>(ceil(log2(MemoryPool::alloc_size_multiplier)));
+            if (bit_shift < 0 || unsigned_geq(bit_shift, sizeof(size_t) * static_cast<size_t>(bits_per_byte)))
             {
-                throw invalid_argument("invalid allocation size");
+                throw logic_error("alloc_size_multiplier too large");
             }
+            return numeric_limits<size_t>::max() >> bit_shift;
+        }();
 
-            // Initial allocation
-            allocation new_alloc;
-            try
+        const size_t MemoryPool::max_batch_alloc_byte_count = []() -> size_t {
+            int bit_shift = static_cast<int>(ceil(log2(MemoryPool::alloc_size_multiplier)));
+            if (bit_shift < 0 || unsigned_geq(bit_shift, sizeof(size_t) * static_cast<size_t>(bits_per_byte)))
             {
-                new_alloc.data_ptr = SEAL_MALLOC(mul_safe(MemoryPool::first_alloc_count, item_byte_count_));
+                throw logic_error("alloc_size_multiplier too large");
             }
-            catch (const bad_alloc &)
+            return numeric_limits<size_t>::max() >> bit_shift;
+        }();
+
+        MemoryPoolStats MemoryPool::stats() const
+        {
+            MemoryPoolStats result;
+            result.size_classes = size_class_stats();
+            for (const auto &size_class : result.size_classes)
             {
-                // Allocation failed; rethrow
-                throw;
+                result.alloc_byte_count =
+                    add_safe(result.alloc_byte_count, mul_safe(size_class.item_count, size_class.item_byte_count));
+                result.in_use_byte_count =
+                    add_safe(result.in_use_byte_count, mul_safe(size_class.in_use_count, size_class.item_byte_count));
+                result.peak_alloc_byte_count = add_safe(
+                    result.peak_alloc_byte_count, mul_safe(size_class.peak_item_count, size_class.item_byte_count));
+                result.hit_count += size_class.hit_count;
+                result.miss_count += size_class.miss_count;
             }
-            if (new_alloc.data_ptr == nullptr)
+            result.age = chrono::steady_clock::now() - creation_time_;
+            return result;
+        }
+
+        void MemoryPool::set_stats_callback(StatsCallback callback)
+        {
+            shared_ptr<const StatsCallback> new_callback;
+            if (callback)
             {
-                // Allocation failed; rethrow
-                throw bad_alloc();
+                new_callback = make_shared<const StatsCallback>(move(callback));
             }
-
-            new_alloc.size = MemoryPool::first_alloc_count;
-            new_alloc.free = MemoryPool::first_alloc_count;
-            new_alloc.head_ptr = new_alloc.data_ptr;
-            allocs_.clear();
-            allocs_.push_back(new_alloc);
+            atomic_store(&stats_callback_, move(new_callback));
         }
 
-        MemoryPoolHeadST::~MemoryPoolHeadST() noexcept
+        size_t MemoryPool::trim()
         {
-            // Delete the items (but not the memory)
-            MemoryPoolItem *curr_item = first_item_;
-            while (curr_item)
+            size_t released = trim_idle(chrono::steady_clock::duration::zero(), numeric_limits<size_t>::max());
+#if defined(__GLIBC__)
+            // Freed memory may stay in the heap of the C library otherwise
+            if (released)
             {
-                MemoryPoolItem *next_item = curr_item->next();
-                delete curr_item;
-                curr_item = next_item;
+                malloc_trim(0);
             }
-            first_item_ = nullptr;
+#endif
+            return released;
+        }
+
+        void MemoryPool::set_trim_policy(const MemoryPoolTrimPolicy &policy) noexcept
+        {
+            max_alloc_byte_count_.store(policy.max_alloc_byte_count, memory_order_relaxed);
+            max_idle_ticks_.store(policy.max_idle_time.count(), memory_order_relaxed);
+            idle_trim_enabled_.store(policy.max_idle_time.count() > 0, memory_order_relaxed);
+        }
 
-            // Do we need to clear the memory?
-            if (clear_on_destruction_)
+        MemoryPoolTrimPolicy MemoryPool::trim_policy() const noexcept
+        {
+            MemoryPoolTrimPolicy policy;
+            policy.max_alloc_byte_count = max_alloc_byte_count_.load(memory_order_relaxed);
+            policy.max_idle_time = chrono::steady_clock::duration(max_idle_ticks_.load(memory_order_relaxed));
+            return policy;
+        }
+
+        size_t MemoryPool::release_idle(
+            vector<MemoryPoolHead *> &pools, chrono::steady_clock::duration min_idle_time,
+            size_t target_alloc_byte_count)
+        {
+            auto now = chrono::steady_clock::now();
+
+            // A pool head counts as used at the first call that sees a new get count
+            size_t alloc_byte_count = 0;
+            vector<pair<chrono::steady_clock::time_point, size_t>> candidates;
+            for (size_t i = 0; i < pools.size(); i++)
             {
-                // Delete the memory
-                for (auto &alloc : allocs_)
+                MemoryPoolSizeClassStats head_stats = pools[i]->stats();
+                uint64_t get_count = head_stats.hit_count + head_stats.miss_count;
+                auto emplaced = activity_.emplace(pools[i], head_activity{ get_count, now });
+                head_activity &activity = emplaced.first->second;
+                if (activity.get_count != get_count)
                 {
-                    size_t curr_alloc_byte_count = mul_safe(item_byte_count_, alloc.size);
-                    seal_memzero(alloc.data_ptr, curr_alloc_byte_count);
+                    activity.get_count = get_count;
+                    activity.last_active = now;
+                }
 
-                    // Delete this allocation
-                    SEAL_FREE(alloc.data_ptr);
+                alloc_byte_count =
+                    add_safe(alloc_byte_count, mul_safe(head_stats.item_count, head_stats.item_byte_count));
+                if (pools[i]->idle())
+                {
+                    candidates.emplace_back(activity.last_active, i);
                 }
             }
-            else
+
+            // Release the least recently used first
+            sort(candidates.begin(), candidates.end());
+            size_t released = 0;
+            vector<bool> remove(pools.size(), false);
+            for (const auto &candidate : candidates)
             {
-                // Delete the memory
-                for (auto &alloc : allocs_)
+                if (now - candidate.first < min_idle_time && alloc_byte_count <= target_alloc_byte_count)
                 {
-                    // Delete this allocation
-                    SEAL_FREE(alloc.data_ptr);
+                    break;
                 }
+                MemoryPoolHead *head = pools[candidate.second];
+                size_t head_byte_count = mul_safe(head->item_count(), head->item_byte_count());
+                alloc_byte_count -= head_byte_count;
+                released += head_byte_count;
+                remove[candidate.second] = true;
+            }
+            if (!released)
+            {
+                return 0;
             }
 
-            allocs_.clear();
-        }
-
-        MemoryPoolItem *MemoryPoolHeadST::get()
-        {
-            MemoryPoolItem *old_first = first_item_;
-
-            // Is pool empty?
-            if (old_first == nullptr)
+            size_t kept = 0;
+            for (size_t i = 0; i < pools.size(); i++)
             {
-                allocation &last_alloc = allocs_.back();
-                MemoryPoolItem *new_item = nullptr;
-                if (last_alloc.free > 0)
+                if (remove[i])
                 {
-                    // Pool is empty; there is memory
-                    new_item = new MemoryPoolItem(last_alloc.head_ptr);
-                    last_alloc.free--;
-                    last_alloc.head_ptr += item_byte_count_;
+                    activity_.erase(pools[i]);
+                    delete pools[i];
                 }
                 else
                 {
-                    // Pool is empty; there is no memory
-                    allocation new_alloc;
-
-                    // Increase allocation size unless we are already at max
-                    size_t new_size = safe_cast<size_t>(
-                        ceil(MemoryPool::alloc_size_multiplier * static_cast<double>(last_alloc.size)));
-                    size_t new_alloc_byte_count = mul_safe(new_size, item_byte_count_);
-                    if (new_alloc_byte_count > MemoryPool::max_batch_alloc_byte_count)
-                    {
-                        new_size = last_alloc.size;
-                        new_alloc_byte_count = new_size * item_byte_count_;
-                    }
-
-                    try
-                    {
-                        new_alloc.data_ptr = SEAL_MALLOC(new_alloc_byte_count);
-                    }
-                    catch (const bad_alloc &)
-                    {
-                        // Allocation failed; rethrow
-                        throw;
-                    }
-                    if (new_alloc.data_ptr == nullptr)
-                    {
-                        // Allocation failed; rethrow
-                        throw bad_alloc();
-                    }
-
-                    new_alloc.size = new_size;
-                    new_alloc.free = new_size - 1;
-                    new_alloc.head_ptr = new_alloc.data_ptr + item_byte_count_;
-                    allocs_.push_back(new_alloc);
-                    item_count_ += new_size;
-                    new_item = new MemoryPoolItem(new_alloc.data_ptr);
+                    pools[kept++] = pools[i];
                 }
-
-                return new_item;
             }
+            pools.resize(kept);
+            return released;
+        }
 
-            // Pool is not empty
-            first_item_ = old_first->next();
-            old_first->next() = nullptr;
-            return old_first;
+        bool MemoryPool::trim_check_tick() noexcept
+        {
+#ifndef _M_CEE
+            static thread_local uint32_t tick = 0;
+            return (++tick & 0x3FF) == 0;
+#else
+            return true;
+#endif
         }
 
-        const size_t MemoryPool::max_single_alloc_byte_count = []() -> size_t {
-            int bit_shift = static_cast<int>(ceil(log2(MemoryPool::alloc_size_multiplier)));
-            if (bit_shift < 0 || unsigned_geq(bit_shift, sizeof(size_t) * static_cast<size_t>(bits_per_byte)))
+        void MemoryPool::after_get(bool grew)
+        {
+            if (grew)
             {
-                throw logic_error("alloc_size_multiplier too large");
+                shared_ptr<const StatsCallback> callback = atomic_load(&stats_callback_);
+                if (callback)
+                {
+                    (*callback)(stats());
+                }
             }
-            return numeric_limits<size_t>::max() >> bit_shift;
-        }();
 
-        const size_t MemoryPool::max_batch_alloc_byte_count = []() -> size_t {
-            int bit_shift = static_cast<int>(ceil(log2(MemoryPool::alloc_size_multiplier)));
-            if (bit_shift < 0 || unsigned_geq(bit_shift, sizeof(size_t) * static_cast<size_t>(bits_per_byte)))
+            MemoryPoolTrimPolicy policy = trim_policy();
+            chrono::steady_clock::duration min_idle_time = chrono::steady_clock::duration::max();
+            size_t target_alloc_byte_count = numeric_limits<size_t>::max();
+            if (policy.max_idle_time.count() > 0)
             {
-                throw logic_error("alloc_size_multiplier too large");
+                // Look at the idle size classes twice per max_idle_time; only one thread does it
+                auto now = chrono::steady_clock::now().time_since_epoch().count();
+                auto next_check = next_trim_check_.load(memory_order_relaxed);
+                if (now >= next_check &&
+                    next_trim_check_.compare_exchange_strong(
+                        next_check, now + max(policy.max_idle_time.count() / 2, decltype(now)(1)),
+                        memory_order_relaxed))
+                {
+                    min_idle_time = policy.max_idle_time;
+                }
             }
-            return numeric_limits<size_t>::max() >> bit_shift;
-        }();
+            if (grew && policy.max_alloc_byte_count)
+            {
+                target_alloc_byte_count = policy.max_alloc_byte_count;
+            }
+            if (min_idle_time == chrono::steady_clock::duration::max() &&
+                target_alloc_byte_count == numeric_limits<size_t>::max())
+            {
+                return;
+            }
+
+            if (trim_idle(min_idle_time, target_alloc_byte_count))
+            {
+#if defined(__GLIBC__)
+                malloc_trim(0);
+#endif
+            }
+        }
 
         MemoryPoolMT::~MemoryPoolMT() noexcept
         {
@@ -348,6 +1191,12 @@ namespace seal
                 return Pointer<seal_byte>();
             }
 
+            // Allocations from huge pages are padded to keep every item aligned
+            if (huge_pages_)
+            {
+                byte_count = (byte_count + 63) & ~size_t(63);
+            }
+
             // Attempt to find size.
             ReaderLock reader_lock(pools_locker_.acquire_read());
             size_t start = 0;
@@ -367,7 +1216,15 @@ namespace seal
                 }
                 else
                 {
-                    return Pointer<seal_byte>(mid_head);
+                    size_t item_count = mid_head->item_count();
+                    Pointer<seal_byte> result(mid_head);
+                    bool grew = mid_head->item_count() != item_count;
+                    if (grew || trim_check_due())
+                    {
+                        reader_lock.unlock();
+                        after_get(grew);
+                    }
+                    return result;
                 }
             }
             reader_lock.unlock();
@@ -391,7 +1248,15 @@ namespace seal
                 }
                 else
                 {
-                    return Pointer<seal_byte>(mid_head);
+                    size_t item_count = mid_head->item_count();
+                    Pointer<seal_byte> result(mid_head);
+                    bool grew = mid_head->item_count() != item_count;
+                    if (grew || trim_check_due())
+                    {
+                        writer_lock.unlock();
+                        after_get(grew);
+                    }
+                    return result;
                 }
             }
 
@@ -402,7 +1267,8 @@ namespace seal
                 throw runtime_error("maximum pool head count reached");
             }
 
-            MemoryPoolHead *new_head = new MemoryPoolHeadMT(byte_count, clear_on_destruction_);
+            MemoryPoolHead *new_head =
+                new MemoryPoolHeadMT(byte_count, clear_on_destruction_, huge_pages_, numa_node_);
             if (!pools_.empty())
             {
                 pools_.insert(pools_.begin() + static_cast<ptrdiff_t>(start), new_head);
@@ -412,7 +1278,10 @@ namespace seal
                 pools_.emplace_back(new_head);
             }
 
-            return Pointer<seal_byte>(new_head);
+            Pointer<seal_byte> result(new_head);
+            writer_lock.unlock();
+            after_get(true);
+            return result;
         }
 
         size_t MemoryPoolMT::alloc_byte_count() const
@@ -424,6 +1293,25 @@ namespace seal
             });
         }
 
+        vector<MemoryPoolSizeClassStats> MemoryPoolMT::size_class_stats() const
+        {
+            ReaderLock lock(pools_locker_.acquire_read());
+
+            vector<MemoryPoolSizeClassStats> result;
+            result.reserve(pools_.size());
+            for (MemoryPoolHead *head : pools_)
+            {
+                result.push_back(head->stats());
+            }
+            return result;
+        }
+
+        size_t MemoryPoolMT::trim_idle(chrono::steady_clock::duration min_idle_time, size_t target_alloc_byte_count)
+        {
+            WriterLock lock(pools_locker_.acquire_write());
+            return release_idle(pools_, min_idle_time, target_alloc_byte_count);
+        }
+
         MemoryPoolST::~MemoryPoolST() noexcept
         {
             for (MemoryPoolHead *head : pools_)
@@ -444,6 +1332,12 @@ namespace seal
                 return Pointer<seal_byte>();
             }
 
+            // Allocations from huge pages are padded to keep every item aligned
+            if (huge_pages_)
+            {
+                byte_count = (byte_count + 63) & ~size_t(63);
+            }
+
             // Attempt to find size.
             size_t start = 0;
             size_t end = pools_.size();
@@ -462,7 +1356,14 @@ namespace seal
                 }
                 else
                 {
-                    return Pointer<seal_byte>(mid_head);
+                    size_t item_count = mid_head->item_count();
+                    Pointer<seal_byte> result(mid_head);
+                    bool grew = mid_head->item_count() != item_count;
+                    if (grew || trim_check_due())
+                    {
+                        after_get(grew);
+                    }
+                    return result;
                 }
             }
 
@@ -473,7 +1374,7 @@ namespace seal
                 throw runtime_error("maximum pool head count reached");
             }
 
-            MemoryPoolHead *new_head = new MemoryPoolHeadST(byte_count, clear_on_destruction_);
+            MemoryPoolHead *new_head = new MemoryPoolHeadST(byte_count, clear_on_destruction_, huge_pages_);
             if (!pools_.empty())
             {
                 pools_.insert(pools_.begin() + static_cast<ptrdiff_t>(start), new_head);
@@ -483,7 +1384,9 @@ namespace seal
                 pools_.emplace_back(new_head);
             }
 
-            return Pointer<seal_byte>(new_head);
+            Pointer<seal_byte> result(new_head);
+            after_get(true);
+            return result;
         }
 
         size_t MemoryPoolST::alloc_byte_count() const
@@ -492,5 +1395,115 @@ namespace seal
                 return add_safe(byte_count, mul_safe(head->item_count(), head->item_byte_count()));
             });
         }
+
+        vector<MemoryPoolSizeClassStats> MemoryPoolST::size_class_stats() const
+        {
+            vector<MemoryPoolSizeClassStats> result;
+            result.reserve(pools_.size());
+            for (MemoryPoolHead *head : pools_)
+            {
+                result.push_back(head->stats());
+            }
+            return result;
+        }
+
+        size_t MemoryPoolST::trim_idle(chrono::steady_clock::duration min_idle_time, size_t target_alloc_byte_count)
+        {
+            return release_idle(pools_, min_idle_time, target_alloc_byte_count);
+        }
+
+        Pointer<seal_byte> MemoryPoolStack::get_for_byte_count(size_t byte_count)
+        {
+            if (byte_count > max_single_alloc_byte_count)
+            {
+                throw invalid_argument("invalid allocation size");
+            }
+            else if (byte_count == 0)
+            {
+                return Pointer<seal_byte>();
+            }
+
+            size_t reserved_byte_count = head_.item_count();
+            head_.set_next_byte_count(byte_count);
+            Pointer<seal_byte> result(&head_);
+            bool grew = head_.item_count() != reserved_byte_count;
+            if (grew || trim_check_due())
+            {
+                after_get(grew);
+            }
+            return result;
+        }
+
+        void MemoryPoolStack::reserve(size_t byte_count)
+        {
+            if (!head_.idle())
+            {
+                throw logic_error("memory pool is in use");
+            }
+            head_.reserve(byte_count);
+        }
+
+        vector<MemoryPoolSizeClassStats> MemoryPoolStack::size_class_stats() const
+        {
+            return { head_.stats() };
+        }
+
+        size_t MemoryPoolStack::trim_idle(chrono::steady_clock::duration min_idle_time, size_t target_alloc_byte_count)
+        {
+            // The memory is one block reused by every allocation, so it is only released by trim() or to meet the
+            // capacity limit
+            if (!head_.idle() || (min_idle_time > chrono::steady_clock::duration::zero() &&
+                                  head_.item_count() <= target_alloc_byte_count))
+            {
+                return 0;
+            }
+            return head_.release();
+        }
+
+        Pointer<seal_byte> MemoryPoolArena::get_for_byte_count(size_t byte_count)
+        {
+            if (byte_count > max_single_alloc_byte_count)
+            {
+                throw invalid_argument("invalid allocation size");
+            }
+            else if (byte_count == 0)
+            {
+                return Pointer<seal_byte>();
+            }
+
+            size_t reserved_byte_count = head_.item_count();
+            Pointer<seal_byte> result(&head_, head_.get(byte_count));
+            bool grew = head_.item_count() != reserved_byte_count;
+            if (grew || trim_check_due())
+            {
+                after_get(grew);
+            }
+            return result;
+        }
+
+        void MemoryPoolArena::reset()
+        {
+            if (!head_.idle())
+            {
+                throw logic_error("memory pool is in use");
+            }
+            head_.reset();
+        }
+
+        vector<MemoryPoolSizeClassStats> MemoryPoolArena::size_class_stats() const
+        {
+            return { head_.stats() };
+        }
+
+        size_t MemoryPoolArena::trim_idle(chrono::steady_clock::duration min_idle_time, size_t target_alloc_byte_count)
+        {
+            // Memory is only reused after a reset, so all of it is released by trim() or to meet the capacity limit
+            if (!head_.idle() || (min_idle_time > chrono::steady_clock::duration::zero() &&
+                                  head_.item_count() <= target_alloc_byte_count))
+            {
+                return 0;
+            }
+            return head_.release();
+        }
     } // namespace util
 } // namespace seal
@@ -9,13 +9,17 @@
 #include "seal/util/locks.h"
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <new>
 #include <stdexcept>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace seal
@@ -37,6 +41,9 @@ namespace seal
             MemoryPoolItem(seal_byte *data) noexcept : data_(data)
             {}
 
+            MemoryPoolItem(seal_byte *data, std::uint32_t index) noexcept : data_(data), index_(index)
+            {}
+
             SEAL_NODISCARD inline seal_byte *data() noexcept
             {
                 return data_;
@@ -47,6 +54,12 @@ namespace seal
                 return data_;
             }
 
+            // Points an item that is not in use to different memory
+            inline void set_data(seal_byte *data) noexcept
+            {
+                data_ = data;
+            }
+
             SEAL_NODISCARD inline MemoryPoolItem *&next() noexcept
             {
                 return next_;
@@ -57,6 +70,18 @@ namespace seal
                 return next_;
             }
 
+            // Position of this item among the items of a MemoryPoolHeadMT
+            SEAL_NODISCARD inline std::uint32_t index() const noexcept
+            {
+                return index_;
+            }
+
+            // Index plus one of the next item in the shared free list of a MemoryPoolHeadMT, or zero for the last item
+            SEAL_NODISCARD inline std::atomic<std::uint32_t> &next_index() noexcept
+            {
+                return next_index_;
+            }
+
         private:
             MemoryPoolItem(const MemoryPoolItem &copy) = delete;
 
@@ -65,14 +90,141 @@ namespace seal
             seal_byte *data_ = nullptr;
 
             MemoryPoolItem *next_ = nullptr;
+
+            std::uint32_t index_ = 0;
+
+            std::atomic<std::uint32_t> next_index_{ 0 };
         };
 
+        /**
+        Usage statistics of one size class of a memory pool, i.e., of all allocations of one byte size.
+        */
+        struct MemoryPoolSizeClassStats
+        {
+            /**
+            Byte size of the allocations in this size class.
+            */
+            std::size_t item_byte_count = 0;
+
+            /**
+            Number of allocations that the memory reserved for this size class can hold.
+            */
+            std::size_t item_count = 0;
+
+            /**
+            Number of allocations currently in use.
+            */
+            std::size_t in_use_count = 0;
+
+            /**
+            Largest value item_count has had, i.e., the high-water mark of the memory reserved for this size class.
+            */
+            std::size_t peak_item_count = 0;
+
+            /**
+            Number of requests served with memory that had been used and released before.
+            */
+            std::uint64_t hit_count = 0;
+
+            /**
+            Number of requests that needed memory never used before.
+            */
+            std::uint64_t miss_count = 0;
+
+            /**
+            Returns the number of allocations reserved but not currently in use.
+            */
+            SEAL_NODISCARD inline std::size_t free_count() const noexcept
+            {
+                return item_count - in_use_count;
+            }
+        };
+
+        /**
+        Usage statistics of a memory pool. The values are read without stopping other threads that use the pool, so
+        they need not form a consistent snapshot while the pool is in use.
+        */
+        struct MemoryPoolStats
+        {
+            /**
+            Statistics of each size class, in decreasing order of byte size.
+            */
+            std::vector<MemoryPoolSizeClassStats> size_classes;
+
+            /**
+            Total number of bytes reserved by the memory pool.
+            */
+            std::size_t alloc_byte_count = 0;
+
+            /**
+            Number of reserved bytes currently in use.
+            */
+            std::size_t in_use_byte_count = 0;
+
+            /**
+            Sum over the size classes of their largest reserved byte counts.
+            */
+            std::size_t peak_alloc_byte_count = 0;
+
+            /**
+            Total number of requests served with memory that had been used before.
+            */
+            std::uint64_t hit_count = 0;
+
+            /**
+            Total number of requests that needed memory never used before.
+            */
+            std::uint64_t miss_count = 0;
+
+            /**
+            Time elapsed since the memory pool was created.
+            */
+            std::chrono::steady_clock::duration age{ 0 };
+
+            /**
+            Returns the average number of allocation requests per second since the memory pool was created. The
+            allocation rate over an interval is obtained from the difference of two MemoryPoolStats.
+            */
+            SEAL_NODISCARD inline double allocation_rate() const noexcept
+            {
+                double seconds = std::chrono::duration<double>(age).count();
+                return (seconds > 0) ? static_cast<double>(hit_count + miss_count) / seconds : 0.0;
+            }
+        };
+
+        /**
+        Policy for returning memory of a memory pool to the system. Only memory of size classes with no allocation in
+        use can be returned.
+        */
+        struct MemoryPoolTrimPolicy
+        {
+            /**
+            Number of reserved bytes above which the memory pool releases size classes with no allocation in use,
+            least recently used first, or zero for no limit. Memory in use is not limited, so the pool still grows
+            beyond this when needed.
+            */
+            std::size_t max_alloc_byte_count = 0;
+
+            /**
+            Time after which an unused size class with no allocation in use is released, or zero to keep it.
+            */
+            std::chrono::steady_clock::duration max_idle_time{ 0 };
+        };
+
+        // Returns the number of NUMA nodes the system can have, or 1 if this is not known
+        SEAL_NODISCARD std::size_t numa_node_count() noexcept;
+
+        // Returns the NUMA node of the processor the calling thread runs on, or 0 if this is not known. The node is
+        // cached per thread and refreshed only every few calls, so it can be stale right after a thread migrates.
+        SEAL_NODISCARD std::size_t current_numa_node() noexcept;
+
         class MemoryPoolHead
         {
         public:
             struct allocation
             {
-                allocation() : size(0), data_ptr(nullptr), free(0), head_ptr(nullptr)
+                allocation()
+                    : size(0), data_ptr(nullptr), free(0), head_ptr(nullptr), base_ptr(nullptr), mapped_byte_count(0)
                 {}
 
                 // Size of the allocation (number of items it can hold)
@@ -86,6 +238,12 @@ namespace seal
 
                 // Pointer to current head of allocation
                 seal_byte *head_ptr;
+
+                // Pointer to free; differs from data_ptr if the allocation was aligned
+                seal_byte *base_ptr;
+
+                // Size of the memory mapping holding the allocation, or zero if it was not mapped directly
+                std::size_t mapped_byte_count;
             };
 
             // The overriding functions are noexcept(false)
@@ -94,20 +252,52 @@ namespace seal
             // Byte size of the allocations (items) owned by this pool
             virtual std::size_t item_byte_count() const noexcept = 0;
 
+            // Byte size of an item taken from this pool; differs from item_byte_count() only for pools serving
+            // allocations of different sizes
+            virtual std::size_t item_byte_count_of(const MemoryPoolItem *item) const noexcept
+            {
+                (void)item;
+                return item_byte_count();
+            }
+
             // Total number of items allocated
             virtual std::size_t item_count() const noexcept = 0;
 
+            // Usage statistics of this pool
+            virtual MemoryPoolSizeClassStats stats() const = 0;
+
+            // Returns whether every item taken from this pool has been returned; the caller must ensure that get() is
+            // not called concurrently
+            virtual bool idle() const noexcept = 0;
+
             virtual MemoryPoolItem *get() = 0;
 
             // Return item back to this pool
             virtual void add(MemoryPoolItem *new_first) noexcept = 0;
         };
 
+        /**
+        A pool head that can be shared by any number of threads without locks on the common path. Free items are kept
+        on a lock-free shared list, in front of which every thread has a magazine: a small list of free items that only
+        it uses. Items released by a thread go to its magazine, and a full magazine is moved to the shared list in one
+        step. Items are indexed so that the shared list can tag its top with a counter, which makes it safe from the
+        ABA problem. Only the creation of new items takes a lock.
+        */
         class MemoryPoolHeadMT : public MemoryPoolHead
         {
         public:
-            // Creates a new MemoryPoolHeadMT with allocation for one single item.
-            MemoryPoolHeadMT(std::size_t item_byte_count, bool clear_on_destruction = false);
+            // Number of free items a thread keeps for one pool head before moving them to the shared free list
+            static constexpr std::size_t magazine_capacity = 16;
+
+            // Number of threads that can have a magazine at the same time; other threads use the shared free list
+            static constexpr std::size_t magazine_count = 64;
+
+            // Creates a new MemoryPoolHeadMT with allocation for one single item. With huge_pages, large allocations
+            // are backed by huge pages and all are aligned to 64 bytes, for which item_byte_count must be a multiple
+            // of 64. With a non-negative numa_node, allocations of whole pages prefer that NUMA node.
+            MemoryPoolHeadMT(
+                std::size_t item_byte_count, bool clear_on_destruction = false, bool huge_pages = false,
+                int numa_node = -1);
 
             ~MemoryPoolHeadMT() noexcept override;
 
@@ -120,47 +310,101 @@ namespace seal
             // Returns the total number of items allocated
             SEAL_NODISCARD inline std::size_t item_count() const noexcept override
             {
-                return item_count_;
+                return item_count_.load(std::memory_order_relaxed);
             }
 
+            SEAL_NODISCARD MemoryPoolSizeClassStats stats() const override;
+
+            SEAL_NODISCARD bool idle() const noexcept override;
+
             MemoryPoolItem *get() override;
 
-            inline void add(MemoryPoolItem *new_first) noexcept override
-            {
-                bool expected = false;
-                while (!locked_.compare_exchange_strong(expected, true, std::memory_order_acquire))
-                {
-                    expected = false;
-                }
-                MemoryPoolItem *old_first = first_item_;
-                new_first->next() = old_first;
-                first_item_ = new_first;
-                locked_.store(false, std::memory_order_release);
-            }
+            void add(MemoryPoolItem *new_first) noexcept override;
 
         private:
+            // The free items of one thread, on a cache line of their own, and how many items the thread has taken
+            // and released; the counters are written only by the owning thread and read by stats() and idle(), and
+            // add_count is updated last in add() so that idle() implies that no add() is still running
+            struct alignas(64) Magazine
+            {
+                MemoryPoolItem *first = nullptr;
+
+                std::size_t count = 0;
+
+                std::atomic<std::uint64_t> get_count{ 0 };
+
+                std::atomic<std::uint64_t> add_count{ 0 };
+            };
+
+            // Items are stored in segments of doubling size; segment i holds 2^i items
+            static constexpr std::size_t segment_count = 32;
+
             MemoryPoolHeadMT(const MemoryPoolHeadMT &copy) = delete;
 
             MemoryPoolHeadMT &operator=(const MemoryPoolHeadMT &assign) = delete;
 
+            // Returns the magazine of the calling thread, or nullptr if the thread has none
+            SEAL_NODISCARD Magazine *thread_magazine() noexcept;
+
+            // Moves the items linked through next() from first to the shared free list
+            void push_shared(MemoryPoolItem *first) noexcept;
+
+            // Takes an item from the shared free list, or returns nullptr if it is empty
+            SEAL_NODISCARD MemoryPoolItem *pop_shared() noexcept;
+
+            // Creates a new item, allocating more memory if needed; the caller must hold alloc_mutex_
+            SEAL_NODISCARD MemoryPoolItem *new_item();
+
+            SEAL_NODISCARD inline MemoryPoolItem *item_at(std::uint32_t index) const noexcept
+            {
+                std::uint64_t position = static_cast<std::uint64_t>(index) + 1;
+                int segment = get_significant_bit_count(position) - 1;
+                return segments_[segment][position - (std::uint64_t(1) << segment)];
+            }
+
             const bool clear_on_destruction_;
 
-            mutable std::atomic<bool> locked_;
+            const bool huge_pages_;
+
+            const int numa_node_;
 
             const std::size_t item_byte_count_;
 
-            volatile std::size_t item_count_;
+            std::atomic<std::size_t> item_count_;
+
+            // Top of the shared free list: the index plus one of the first item in the low 32 bits, or zero for an
+            // empty list, and in the high 32 bits a counter that every removal increments, so that a compare-and-swap
+            // based on an outdated top fails even if the same item is on top again
+            std::atomic<std::uint64_t> shared_first_{ 0 };
+
+            std::unique_ptr<Magazine[]> magazines_;
+
+            // Numbers of items taken and released by threads without a magazine
+            std::atomic<std::uint64_t> shared_get_count_{ 0 };
+
+            std::atomic<std::uint64_t> shared_add_count_{ 0 };
+
+            // Protects all members below
+            mutable std::mutex alloc_mutex_;
 
             std::vector<allocation> allocs_;
 
-            MemoryPoolItem *volatile first_item_;
+            // All items created by this pool head; the segments never move, so an index read from the shared free
+            // list refers to a valid item even if another thread has taken it in the meantime
+            std::unique_ptr<MemoryPoolItem *[]> segments_[segment_count];
+
+            std::uint32_t created_count_ = 0;
+
+            std::size_t peak_item_count_;
         };
 
         class MemoryPoolHeadST : public MemoryPoolHead
         {
         public:
-            // Creates a new MemoryPoolHeadST with allocation for one single item.
-            MemoryPoolHeadST(std::size_t item_byte_count, bool clear_on_destruction = false);
+            // Creates a new MemoryPoolHeadST with allocation for one single item. With huge_pages, large allocations
+            // are backed by huge pages and all are aligned to 64 bytes, for which item_byte_count must be a multiple
+            // of 64.
+            MemoryPoolHeadST(std::size_t item_byte_count, bool clear_on_destruction = false, bool huge_pages = false);
 
             ~MemoryPoolHeadST() noexcept override;
 
@@ -176,12 +420,20 @@ namespace seal
                 return item_count_;
             }
 
+            SEAL_NODISCARD MemoryPoolSizeClassStats stats() const override;
+
+            SEAL_NODISCARD inline bool idle() const noexcept override
+            {
+                return get_count_ == add_count_;
+            }
+
             SEAL_NODISCARD MemoryPoolItem *get() override;
 
             inline void add(MemoryPoolItem *new_first) noexcept override
             {
                 new_first->next() = first_item_;
                 first_item_ = new_first;
+                add_count_++;
             }
 
         private:
@@ -191,6 +443,8 @@ namespace seal
 
             const bool clear_on_destruction_;
 
+            const bool huge_pages_;
+
             std::size_t item_byte_count_;
 
             std::size_t item_count_;
@@ -198,6 +452,245 @@ namespace seal
             std::vector<allocation> allocs_;
 
             MemoryPoolItem *first_item_;
+
+            std::uint64_t get_count_ = 0;
+
+            std::uint64_t add_count_ = 0;
+
+            std::uint64_t miss_count_ = 0;
+
+            std::size_t peak_item_count_;
+        };
+
+        /**
+        A pool head that serves allocations of any size from blocks of memory used like a stack. Allocations are
+        counted in bytes, rounded up to multiples of 64, and are aligned to 64 bytes. Releasing the most recent
+        allocations makes their memory available again; an allocation released out of order is reclaimed once all
+        later ones are released. If the last block is full, another block is reserved, and the next time no
+        allocation is in use all blocks are merged into one, so that a repeated sequence of allocations is
+        eventually served without reserving memory. Not thread-safe.
+        */
+        class MemoryPoolHeadStack : public MemoryPoolHead
+        {
+        public:
+            // Granularity and alignment of the allocations
+            static constexpr std::size_t alignment = 64;
+
+            // Creates a new MemoryPoolHeadStack with a block of at least reserve_byte_count bytes, if non-zero
+            MemoryPoolHeadStack(std::size_t reserve_byte_count = 0);
+
+            ~MemoryPoolHeadStack() noexcept override;
+
+            // Allocations are counted in bytes
+            SEAL_NODISCARD inline std::size_t item_byte_count() const noexcept override
+            {
+                return 1;
+            }
+
+            SEAL_NODISCARD inline std::size_t item_byte_count_of(const MemoryPoolItem *item) const noexcept override
+            {
+                return entries_[item->index()].byte_count;
+            }
+
+            // Returns the total number of bytes reserved
+            SEAL_NODISCARD inline std::size_t item_count() const noexcept override
+            {
+                return reserved_byte_count_;
+            }
+
+            SEAL_NODISCARD MemoryPoolSizeClassStats stats() const override;
+
+            SEAL_NODISCARD inline bool idle() const noexcept override
+            {
+                return entries_.empty();
+            }
+
+            // Sets the byte count for the next call to get()
+            inline void set_next_byte_count(std::size_t byte_count) noexcept
+            {
+                next_byte_count_ = byte_count;
+            }
+
+            SEAL_NODISCARD MemoryPoolItem *get() override;
+
+            void add(MemoryPoolItem *new_first) noexcept override;
+
+            // Makes sure that a single block holds at least byte_count bytes; must be called while idle
+            void reserve(std::size_t byte_count);
+
+            // Frees all blocks and returns the number of bytes released; must be called while idle
+            std::size_t release() noexcept;
+
+        private:
+            // An allocation in use or released out of order
+            struct entry
+            {
+                std::size_t block;
+
+                std::size_t byte_count;
+
+                std::size_t unit_count;
+
+                bool released;
+            };
+
+            MemoryPoolHeadStack(const MemoryPoolHeadStack &copy) = delete;
+
+            MemoryPoolHeadStack &operator=(const MemoryPoolHeadStack &assign) = delete;
+
+            // Appends a block of unit_count units of alignment bytes
+            void add_block(std::size_t unit_count);
+
+            // Blocks of units of alignment bytes
+            std::vector<allocation> blocks_;
+
+            // Allocations in the order they were made
+            std::vector<entry> entries_;
+
+            // Item for each position in entries_; reused for later allocations at the same position
+            std::vector<std::unique_ptr<MemoryPoolItem>> items_;
+
+            std::size_t next_byte_count_ = 0;
+
+            std::size_t reserved_byte_count_ = 0;
+
+            std::size_t peak_reserved_byte_count_ = 0;
+
+            std::size_t in_use_byte_count_ = 0;
+
+            std::uint64_t hit_count_ = 0;
+
+            std::uint64_t miss_count_ = 0;
+        };
+
+        /**
+        A pool head that serves allocations of any size by moving a pointer forward through chunks of memory; released
+        allocations are not reused, and all memory is given back at once by reset() or when the head is destroyed. The
+        items of the allocations are taken the same way from chunks of their own. Allocations are rounded up to
+        multiples of 64 bytes and are aligned to 64 bytes. Any number of threads can allocate at the same time; a new
+        chunk, at least twice as large as the last, is reserved under a lock when the current chunk is full. Memory is
+        given back only while no allocation is in use or being made.
+        */
+        class MemoryPoolHeadArena : public MemoryPoolHead
+        {
+        public:
+            // Granularity and alignment of the allocations
+            static constexpr std::size_t alignment = 64;
+
+            // Size of the first chunk if no size is given
+            static constexpr std::size_t default_chunk_byte_count = std::size_t(1) << 16;
+
+            // Creates a new MemoryPoolHeadArena whose first chunk holds at least reserve_byte_count bytes, or
+            // default_chunk_byte_count bytes if zero; the chunk is reserved by the first allocation
+            MemoryPoolHeadArena(std::size_t reserve_byte_count = 0);
+
+            ~MemoryPoolHeadArena() noexcept override;
+
+            // Allocations are counted in bytes
+            SEAL_NODISCARD inline std::size_t item_byte_count() const noexcept override
+            {
+                return 1;
+            }
+
+            SEAL_NODISCARD inline std::size_t item_byte_count_of(const MemoryPoolItem *item) const noexcept override
+            {
+                return static_cast<const ArenaItem *>(item)->byte_count;
+            }
+
+            // Returns the total number of bytes reserved
+            SEAL_NODISCARD inline std::size_t item_count() const noexcept override
+            {
+                return reserved_byte_count_.load(std::memory_order_relaxed);
+            }
+
+            SEAL_NODISCARD MemoryPoolSizeClassStats stats() const override;
+
+            SEAL_NODISCARD inline bool idle() const noexcept override
+            {
+                return in_use_byte_count_.load(std::memory_order_acquire) == 0;
+            }
+
+            // Allocations need a size; use get(std::size_t)
+            SEAL_NODISCARD MemoryPoolItem *get() override;
+
+            // Returns an item for byte_count bytes
+            SEAL_NODISCARD MemoryPoolItem *get(std::size_t byte_count);
+
+            // Counts the item as released; its memory is reused only after reset()
+            void add(MemoryPoolItem *new_first) noexcept override;
+
+            // Makes all memory available again, keeping a single chunk as large as all chunks together; must be
+            // called while idle and not concurrently with get()
+            void reset();
+
+            // Frees all chunks and returns the number of bytes released; must be called while idle and not
+            // concurrently with get()
+            std::size_t release() noexcept;
+
+        private:
+            struct ArenaItem : public MemoryPoolItem
+            {
+                ArenaItem(seal_byte *data, std::size_t item_byte_count) noexcept
+                    : MemoryPoolItem(data), byte_count(item_byte_count)
+                {}
+
+                std::size_t byte_count;
+            };
+
+            // Memory handed out in units of a fixed size by moving a counter forward
+            struct chunk
+            {
+                allocation alloc;
+
+                std::size_t unit_byte_count;
+
+                // Units handed out; may exceed alloc.size when concurrent requests overrun the chunk
+                std::atomic<std::size_t> used{ 0 };
+            };
+
+            // Number of items in the first chunk of items
+            static constexpr std::size_t first_item_chunk_size = 256;
+
+            MemoryPoolHeadArena(const MemoryPoolHeadArena &copy) = delete;
+
+            MemoryPoolHeadArena &operator=(const MemoryPoolHeadArena &assign) = delete;
+
+            // Takes unit_count units from the current chunk; when it is full, calls add_chunk with the full chunk,
+            // or nullptr if there is none, under chunks_mutex_ unless another thread has already replaced it
+            template <typename AddChunk>
+            SEAL_NODISCARD seal_byte *take(std::atomic<chunk *> &current, std::size_t unit_count, AddChunk &&add_chunk);
+
+            // Appends a chunk of at least size units to chunks and makes it current; requires chunks_mutex_
+            void add_chunk(
+                std::vector<std::unique_ptr<chunk>> &chunks, std::atomic<chunk *> &current, std::size_t size,
+                std::size_t unit_byte_count);
+
+            // Frees chunks; requires chunks_mutex_
+            void free_chunks(std::vector<std::unique_ptr<chunk>> &chunks, std::atomic<chunk *> &current) noexcept;
+
+            const std::size_t first_chunk_byte_count_;
+
+            std::mutex chunks_mutex_;
+
+            // Memory for the data of the allocations, in units of alignment bytes
+            std::vector<std::unique_ptr<chunk>> chunks_;
+
+            std::atomic<chunk *> current_{ nullptr };
+
+            // Memory for the items of the allocations, kept apart from the data so that items are close together
+            std::vector<std::unique_ptr<chunk>> item_chunks_;
+
+            std::atomic<chunk *> current_items_{ nullptr };
+
+            std::atomic<std::size_t> reserved_byte_count_{ 0 };
+
+            std::atomic<std::size_t> peak_reserved_byte_count_{ 0 };
+
+            std::atomic<std::size_t> in_use_byte_count_{ 0 };
+
+            std::atomic<std::uint64_t> hit_count_{ 0 };
+
+            std::atomic<std::uint64_t> miss_count_{ 0 };
         };
 
         class MemoryPool
@@ -216,6 +709,9 @@ namespace seal
 
             static constexpr std::size_t first_alloc_count = 1;
 
+            // Function receiving the statistics of a memory pool
+            using StatsCallback = std::function<void(const MemoryPoolStats &)>;
+
             virtual ~MemoryPool() = default;
 
             virtual Pointer<seal_byte> get_for_byte_count(std::size_t byte_count) = 0;
@@ -223,12 +719,92 @@ namespace seal
             virtual std::size_t pool_count() const = 0;
 
             virtual std::size_t alloc_byte_count() const = 0;
+
+            // Usage statistics of all size classes
+            SEAL_NODISCARD MemoryPoolStats stats() const;
+
+            // Sets a function to call with the statistics whenever the pool reserves more memory; an empty function
+            // removes the callback
+            void set_stats_callback(StatsCallback callback);
+
+            // Releases the memory of all size classes with no allocation in use and returns the number of bytes
+            // released
+            std::size_t trim();
+
+            // Sets the policy applied whenever the pool reserves more memory and, for max_idle_time, periodically
+            // while the pool is used
+            void set_trim_policy(const MemoryPoolTrimPolicy &policy) noexcept;
+
+            SEAL_NODISCARD MemoryPoolTrimPolicy trim_policy() const noexcept;
+
+        protected:
+            // Usage statistics of each pool head
+            virtual std::vector<MemoryPoolSizeClassStats> size_class_stats() const = 0;
+
+            // Releases size classes by calling release_idle with exclusive access to the pool heads
+            virtual std::size_t trim_idle(
+                std::chrono::steady_clock::duration min_idle_time, std::size_t target_alloc_byte_count) = 0;
+
+            // Deletes the idle pool heads not used for min_idle_time and then, while more than
+            // target_alloc_byte_count bytes are reserved, the other idle pool heads, least recently used first;
+            // returns the number of bytes released
+            std::size_t release_idle(
+                std::vector<MemoryPoolHead *> &pools, std::chrono::steady_clock::duration min_idle_time,
+                std::size_t target_alloc_byte_count);
+
+            // Returns whether get_for_byte_count should call after_get even if the pool did not grow
+            SEAL_NODISCARD inline bool trim_check_due() noexcept
+            {
+                return idle_trim_enabled_.load(std::memory_order_relaxed) && trim_check_tick();
+            }
+
+            // Calls the statistics callback if the pool grew and applies the trim policy if needed; must be called
+            // without holding locks of the pool
+            void after_get(bool grew);
+
+        private:
+            // Used by trim_check_due to look at the clock only once every few calls on each thread
+            static bool trim_check_tick() noexcept;
+
+            // Bookkeeping of release_idle for one pool head
+            struct head_activity
+            {
+                std::uint64_t get_count;
+
+                std::chrono::steady_clock::time_point last_active;
+            };
+
+            const std::chrono::steady_clock::time_point creation_time_ = std::chrono::steady_clock::now();
+
+            // Accessed only with std::atomic_load and std::atomic_store
+            std::shared_ptr<const StatsCallback> stats_callback_;
+
+            std::atomic<std::size_t> max_alloc_byte_count_{ 0 };
+
+            std::atomic<std::chrono::steady_clock::rep> max_idle_ticks_{ 0 };
+
+            std::atomic<bool> idle_trim_enabled_{ false };
+
+            // Time of the next periodic application of max_idle_time
+            std::atomic<std::chrono::steady_clock::rep> next_trim_check_{ 0 };
+
+            // Accessed only by release_idle
+            std::unordered_map<const MemoryPoolHead *, head_activity> activity_;
         };
 
         class MemoryPoolMT : public MemoryPool
         {
         public:
-            MemoryPoolMT(bool clear_on_destruction = false) : clear_on_destruction_(clear_on_destruction){};
+            // With huge_pages, large allocations are backed by huge pages and all allocations are aligned to 64 bytes.
+            // With a non-negative numa_node, allocations of whole pages prefer that NUMA node.
+            MemoryPoolMT(bool clear_on_destruction = false, bool huge_pages = false, int numa_node = -1)
+                : clear_on_destruction_(clear_on_destruction), huge_pages_(huge_pages), numa_node_(numa_node){};
+
+            // Returns the NUMA node the memory prefers, or -1 if it has no node preference
+            SEAL_NODISCARD inline int numa_node() const noexcept
+            {
+                return numa_node_;
+            }
 
             ~MemoryPoolMT() noexcept override;
 
@@ -243,12 +819,21 @@ namespace seal
             SEAL_NODISCARD std::size_t alloc_byte_count() const override;
 
         protected:
+            SEAL_NODISCARD std::vector<MemoryPoolSizeClassStats> size_class_stats() const override;
+
+            std::size_t trim_idle(
+                std::chrono::steady_clock::duration min_idle_time, std::size_t target_alloc_byte_count) override;
+
             MemoryPoolMT(const MemoryPoolMT &copy) = delete;
 
             MemoryPoolMT &operator=(const MemoryPoolMT &assign) = delete;
 
             const bool clear_on_destruction_;
 
+            const bool huge_pages_;
+
+            const int numa_node_;
+
             mutable ReaderWriterLocker pools_locker_;
 
             std::vector<MemoryPoolHead *> pools_;
@@ -257,7 +842,9 @@ namespace seal
         class MemoryPoolST : public MemoryPool
         {
         public:
-            MemoryPoolST(bool clear_on_destruction = false) : clear_on_destruction_(clear_on_destruction){};
+            // With huge_pages, large allocations are backed by huge pages and all allocations are aligned to 64 bytes
+            MemoryPoolST(bool clear_on_destruction = false, bool huge_pages = false)
+                : clear_on_destruction_(clear_on_destruction), huge_pages_(huge_pages){};
 
             ~MemoryPoolST() noexcept override;
 
@@ -271,13 +858,101 @@ namespace seal
             std::size_t alloc_byte_count() const override;
 
         protected:
+            SEAL_NODISCARD std::vector<MemoryPoolSizeClassStats> size_class_stats() const override;
+
+            std::size_t trim_idle(
+                std::chrono::steady_clock::duration min_idle_time, std::size_t target_alloc_byte_count) override;
+
             MemoryPoolST(const MemoryPoolST &copy) = delete;
 
             MemoryPoolST &operator=(const MemoryPoolST &assign) = delete;
 
             const bool clear_on_destruction_;
 
+            const bool huge_pages_;
+
             std::vector<MemoryPoolHead *> pools_;
         };
+
+        /**
+        A memory pool that serves all allocations from a MemoryPoolHeadStack. Allocating and releasing memory in
+        the order of a stack, as the temporaries of most functions are, takes constant time and needs no search for
+        a size class. Not thread-safe.
+        */
+        class MemoryPoolStack : public MemoryPool
+        {
+        public:
+            // Creates a new MemoryPoolStack with a block of at least reserve_byte_count bytes, if non-zero
+            MemoryPoolStack(std::size_t reserve_byte_count = 0) : head_(reserve_byte_count)
+            {}
+
+            SEAL_NODISCARD Pointer<seal_byte> get_for_byte_count(std::size_t byte_count) override;
+
+            SEAL_NODISCARD inline std::size_t pool_count() const override
+            {
+                return head_.item_count() ? std::size_t(1) : std::size_t(0);
+            }
+
+            SEAL_NODISCARD inline std::size_t alloc_byte_count() const override
+            {
+                return head_.item_count();
+            }
+
+            // Makes sure that at least byte_count bytes can be allocated without reserving memory
+            void reserve(std::size_t byte_count);
+
+        protected:
+            SEAL_NODISCARD std::vector<MemoryPoolSizeClassStats> size_class_stats() const override;
+
+            std::size_t trim_idle(
+                std::chrono::steady_clock::duration min_idle_time, std::size_t target_alloc_byte_count) override;
+
+            MemoryPoolStack(const MemoryPoolStack &copy) = delete;
+
+            MemoryPoolStack &operator=(const MemoryPoolStack &assign) = delete;
+
+            MemoryPoolHeadStack head_;
+        };
+
+        class MemoryPoolArena : public MemoryPool
+        {
+        public:
+            // Creates a new MemoryPoolArena whose first chunk holds at least reserve_byte_count bytes, if non-zero
+            MemoryPoolArena(std::size_t reserve_byte_count = 0) : head_(reserve_byte_count)
+            {}
+
+            SEAL_NODISCARD Pointer<seal_byte> get_for_byte_count(std::size_t byte_count) override;
+
+            SEAL_NODISCARD inline std::size_t pool_count() const override
+            {
+                return head_.item_count() ? std::size_t(1) : std::size_t(0);
+            }
+
+            SEAL_NODISCARD inline std::size_t alloc_byte_count() const override
+            {
+                return head_.item_count();
+            }
+
+            // Returns whether no allocation is in use
+            SEAL_NODISCARD inline bool idle() const noexcept
+            {
+                return head_.idle();
+            }
+
+            // Makes all memory available again; no allocation may be in use or made concurrently
+            void reset();
+
+        protected:
+            SEAL_NODISCARD std::vector<MemoryPoolSizeClassStats> size_class_stats() const override;
+
+            std::size_t trim_idle(
+                std::chrono::steady_clock::duration min_idle_time, std::size_t target_alloc_byte_count) override;
+
+            MemoryPoolArena(const MemoryPoolArena &copy) = delete;
+
+            MemoryPoolArena &operator=(const MemoryPoolArena &assign) = delete;
+
+            MemoryPoolHeadArena head_;
+        };
     } // namespace util
 } // namespace seal
@@ -2,6 +2,7 @@
 // Licensed under the MIT license.
 
 #include "seal/util/ntt.h"
+#include "seal/util/globals.h"
 #include "seal/util/uintarith.h"
 #include "seal/util/uintarithsmallmod.h"
 #include <algorithm>
@@ -226,6 +227,281 @@ namespace seal
 {
     namespace util
     {
+        namespace
+        {
+            /*
+            Transforms of at least 2^ntt_blocked_coeff_count_power_min coefficients are blocked: the coefficients are
+            viewed as a row-major matrix with rows of 2^ntt_block_coeff_count_power coefficients, which fit in the L1
+            cache. The first iterations of the forward transform then run on narrow tiles of columns, and the remaining
+            iterations on each row with a contiguous table of roots. The inverse transform runs in the opposite order.
+            Every butterfly sees exactly the same inputs as in the unblocked transform, so the outputs are identical.
+            */
+            constexpr int ntt_blocked_coeff_count_power_min = 15;
+
+            constexpr int ntt_block_coeff_count_power = 11;
+
+#ifndef SEAL_USE_INTEL_HEXL
+            /*
+            Forward transform of batch_size vectors spaced batch_stride apart, of 2^tables.block_coeff_count_power()
+            values each if transforms are blocked, or of all coefficients otherwise
+            */
+            void transform_to_rev(
+                uint64_t *values, size_t batch_size, size_t batch_stride, int log_n,
+                const MultiplyUIntModOperand *roots, const NTTTables &tables)
+            {
+                if (tables.transform_kernels().to_rev)
+                {
+                    tables.transform_kernels().to_rev(values, batch_size, batch_stride, log_n, roots, tables.modulus());
+                    return;
+                }
+                for (size_t k = 0; k < batch_size; k++, values += batch_stride)
+                {
+                    tables.ntt_handler().transform_to_rev(values, log_n, roots);
+                }
+            }
+
+            // Inverse transform of batch_size vectors spaced batch_stride apart, of the same size as transform_to_rev
+            void transform_from_rev(
+                uint64_t *values, size_t batch_size, size_t batch_stride, int log_n,
+                const MultiplyUIntModOperand *roots, const MultiplyUIntModOperand *scalar, const NTTTables &tables)
+            {
+                if (tables.transform_kernels().from_rev)
+                {
+                    tables.transform_kernels().from_rev(
+                        values, batch_size, batch_stride, log_n, roots, scalar, tables.modulus());
+                    return;
+                }
+                for (size_t k = 0; k < batch_size; k++, values += batch_stride)
+                {
+                    tables.ntt_handler().transform_from_rev(values, log_n, roots, scalar);
+                }
+            }
+
+            void transform_columns_to_rev(
+                uint64_t *values, int log_height, size_t width, const MultiplyUIntModOperand *roots,
+                const NTTTables &tables)
+            {
+                switch (global_variables::simd_level)
+                {
+#ifdef SEAL_USE_AVX512
+                case simd_level_type::avx512:
+                    ntt_transform_columns_to_rev_avx512(values, log_height, width, roots, tables.modulus());
+                    return;
+#endif
+#ifdef SEAL_USE_AVX2
+                case simd_level_type::avx2:
+                    ntt_transform_columns_to_rev_avx2(values, log_height, width, roots, tables.modulus());
+                    return;
+#endif
+                default:
+                    break;
+                }
+                tables.ntt_handler().transform_columns_to_rev(values, log_height, width, roots);
+            }
+
+            void transform_columns_from_rev(
+                uint64_t *values, int log_height, size_t width, const MultiplyUIntModOperand *roots,
+                const MultiplyUIntModOperand &scalar, const NTTTables &tables)
+            {
+                switch (global_variables::simd_level)
+                {
+#ifdef SEAL_USE_AVX512
+                case simd_level_type::avx512:
+                    ntt_transform_columns_from_rev_avx512(values, log_height, width, roots, scalar, tables.modulus());
+                    return;
+#endif
+#ifdef SEAL_USE_AVX2
+                case simd_level_type::avx2:
+                    ntt_transform_columns_from_rev_avx2(values, log_height, width, roots, scalar, tables.modulus());
+                    return;
+#endif
+                default:
+                    break;
+                }
+                tables.ntt_handler().transform_columns_from_rev(values, log_height, width, roots, &scalar);
+            }
+
+            /*
+            Forward lazy NTT of batch_size vectors spaced batch_stride apart, all modulo tables.modulus(). The vectors
+            are transformed together so that every root is loaded once for all of them.
+            */
+            void ntt_negacyclic_harvey_lazy_batch(
+                uint64_t *values, size_t batch_size, size_t batch_stride, const NTTTables &tables)
+            {
+                int log_n = tables.coeff_count_power();
+                int log_block = tables.block_coeff_count_power();
+                if (log_block)
+                {
+                    size_t block_size = size_t(1) << log_block;
+                    size_t block_count = size_t(1) << (log_n - log_block);
+                    for (size_t k = 0; k < batch_size; k++)
+                    {
+                        transform_columns_to_rev(
+                            values + k * batch_stride, log_n - log_block, block_size, tables.get_from_root_powers(),
+                            tables);
+                    }
+                    for (size_t block = 0; block < block_count; block++)
+                    {
+                        transform_to_rev(
+                            values + block * block_size, batch_size, batch_stride, log_block,
+                            tables.get_from_block_root_powers() + block * block_size, tables);
+                    }
+                    return;
+                }
+                transform_to_rev(values, batch_size, batch_stride, log_n, tables.get_from_root_powers(), tables);
+            }
+
+            /*
+            Inverse lazy NTT of batch_size vectors spaced batch_stride apart, all modulo tables.modulus(). The vectors
+            are transformed together so that every root is loaded once for all of them.
+            */
+            void inverse_ntt_negacyclic_harvey_lazy_batch(
+                uint64_t *values, size_t batch_size, size_t batch_stride, const NTTTables &tables)
+            {
+                int log_n = tables.coeff_count_power();
+                int log_block = tables.block_coeff_count_power();
+                MultiplyUIntModOperand inv_degree_modulo = tables.inv_degree_modulo();
+                if (log_block)
+                {
+                    size_t coeff_count = size_t(1) << log_n;
+                    size_t block_size = size_t(1) << log_block;
+                    size_t block_count = size_t(1) << (log_n - log_block);
+                    for (size_t block = 0; block < block_count; block++)
+                    {
+                        transform_from_rev(
+                            values + block * block_size, batch_size, batch_stride, log_block,
+                            tables.get_from_block_inv_root_powers() + block * block_size, nullptr, tables);
+                    }
+
+                    // The column iterations use the last block_count - 1 inverse roots
+                    for (size_t k = 0; k < batch_size; k++)
+                    {
+                        transform_columns_from_rev(
+                            values + k * batch_stride, log_n - log_block, block_size,
+                            tables.get_from_inv_root_powers() + (coeff_count - block_count), inv_degree_modulo,
+                            tables);
+                    }
+                    return;
+                }
+                transform_from_rev(
+                    values, batch_size, batch_stride, log_n, tables.get_from_inv_root_powers(), &inv_degree_modulo,
+                    tables);
+            }
+
+            // Reduces the outputs of a forward lazy NTT of batch_size vectors spaced batch_stride apart
+            void reduce_ntt_lazy_batch(
+                uint64_t *values, size_t batch_size, size_t batch_stride, const NTTTables &tables)
+            {
+                uint64_t modulus = tables.modulus().value();
+                uint64_t two_times_modulus = modulus * 2;
+                size_t n = size_t(1) << tables.coeff_count_power();
+                for (size_t k = 0; k < batch_size; k++, values += batch_stride)
+                {
+                    SEAL_ITERATE(values, n, [&](auto &I) {
+                        // Note: I must be passed to the lambda by reference.
+                        if (I >= two_times_modulus)
+                        {
+                            I -= two_times_modulus;
+                        }
+                        if (I >= modulus)
+                        {
+                            I -= modulus;
+                        }
+                    });
+                }
+            }
+
+            // Reduces the outputs of an inverse lazy NTT of batch_size vectors spaced batch_stride apart
+            void reduce_inverse_ntt_lazy_batch(
+                uint64_t *values, size_t batch_size, size_t batch_stride, const NTTTables &tables)
+            {
+                uint64_t modulus = tables.modulus().value();
+                size_t n = size_t(1) << tables.coeff_count_power();
+                for (size_t k = 0; k < batch_size; k++, values += batch_stride)
+                {
+                    SEAL_ITERATE(values, n, [&](auto &I) {
+                        // Note: I must be passed to the lambda by reference.
+                        if (I >= modulus)
+                        {
+                            I -= modulus;
+                        }
+                    });
+                }
+            }
+#endif
+
+            /*
+            Forward NTT of batch_size vectors spaced batch_stride apart, all modulo tables.modulus(). With lazy set, the
+            outputs are in [0, 4 * modulus), and otherwise reduced.
+            */
+            void ntt_negacyclic_harvey_batch(
+                uint64_t *values, size_t batch_size, size_t batch_stride, const NTTTables &tables, bool lazy)
+            {
+#ifdef SEAL_USE_INTEL_HEXL
+                for (size_t k = 0; k < batch_size; k++, values += batch_stride)
+                {
+                    if (lazy)
+                    {
+                        ntt_negacyclic_harvey_lazy(values, tables);
+                    }
+                    else
+                    {
+                        ntt_negacyclic_harvey(values, tables);
+                    }
+                }
+#else
+                ntt_negacyclic_harvey_lazy_batch(values, batch_size, batch_stride, tables);
+                if (!lazy)
+                {
+                    reduce_ntt_lazy_batch(values, batch_size, batch_stride, tables);
+                }
+#endif
+            }
+
+            /*
+            Inverse NTT of batch_size vectors spaced batch_stride apart, all modulo tables.modulus(). With lazy set,
+            the outputs are in [0, 2 * modulus), and otherwise reduced.
+            */
+            void inverse_ntt_negacyclic_harvey_batch(
+                uint64_t *values, size_t batch_size, size_t batch_stride, const NTTTables &tables, bool lazy)
+            {
+#ifdef SEAL_USE_INTEL_HEXL
+                for (size_t k = 0; k < batch_size; k++, values += batch_stride)
+                {
+                    if (lazy)
+                    {
+                        inverse_ntt_negacyclic_harvey_lazy(values, tables);
+                    }
+                    else
+                    {
+                        inverse_ntt_negacyclic_harvey(values, tables);
+                    }
+                }
+#else
+                inverse_ntt_negacyclic_harvey_lazy_batch(values, batch_size, batch_stride, tables);
+                if (!lazy)
+                {
+                    reduce_inverse_ntt_lazy_batch(values, batch_size, batch_stride, tables);
+                }
+#endif
+            }
+
+            // Runs func(i) for every RNS component i in [0, coeff_modulus_size), on thread_pool if one is given
+            template <typename F>
+            void for_each_rns_component(size_t coeff_modulus_size, ThreadPool *thread_pool, F &&func)
+            {
+                if (thread_pool)
+                {
+                    thread_pool->parallel_for(coeff_modulus_size, func);
+                    return;
+                }
+                for (size_t i = 0; i < coeff_modulus_size; i++)
+                {
+                    func(i);
+                }
+            }
+        } // namespace
+
         NTTTables::NTTTables(int coeff_count_power, const Modulus &modulus, MemoryPoolHandle pool) : pool_(move(pool))
         {
 #ifdef SEAL_DEBUG
@@ -294,6 +570,63 @@ namespace seal
             }
             inv_degree_modulo_.set_quotient(modulus_);
 
+#ifndef SEAL_USE_INTEL_HEXL
+            if (coeff_count_power_ >= ntt_blocked_coeff_count_power_min)
+            {
+                // Gather the roots of each row transform of a blocked transform into a contiguous table
+                block_coeff_count_power_ = ntt_block_coeff_count_power;
+                size_t block_size = size_t(1) << block_coeff_count_power_;
+                size_t block_count = coeff_count_ >> block_coeff_count_power_;
+                block_root_powers_ = allocate<MultiplyUIntModOperand>(coeff_count_, pool_);
+                block_inv_root_powers_ = allocate<MultiplyUIntModOperand>(coeff_count_, pool_);
+                for (size_t block = 0; block < block_count; block++)
+                {
+                    MultiplyUIntModOperand *block_roots = block_root_powers_.get() + block * block_size;
+                    MultiplyUIntModOperand *block_inv_roots = block_inv_root_powers_.get() + block * block_size;
+                    block_roots[0] = root_powers_[0];
+                    block_inv_roots[0] = inv_root_powers_[0];
+
+                    // Iteration with m groups per row uses groups block * m, ..., block * m + m - 1 of the iteration
+                    // with block_count * m groups of the full transform
+                    for (size_t m = 1; m < block_size; m <<= 1)
+                    {
+                        copy_n(root_powers_.get() + (block_count + block) * m, m, block_roots + m);
+                    }
+                    MultiplyUIntModOperand *block_inv_roots_ptr = block_inv_roots + 1;
+                    for (size_t m = block_size >> 1; m > 0; m >>= 1)
+                    {
+                        block_inv_roots_ptr = copy_n(
+                            inv_root_powers_.get() + coeff_count_ - ((block_count * m) << 1) + 1 + block * m, m,
+                            block_inv_roots_ptr);
+                    }
+                }
+            }
+
+            // Select the kernels for the transforms of all coefficients or of the rows of blocked transforms once
+            int transform_coeff_count_power = block_coeff_count_power_ ? block_coeff_count_power_ : coeff_count_power_;
+            switch (global_variables::simd_level)
+            {
+#ifdef SEAL_USE_AVX512
+            case simd_level_type::avx512:
+                if (transform_coeff_count_power >= 4)
+                {
+                    transform_kernels_ = { ntt_transform_to_rev_avx512, ntt_transform_from_rev_avx512 };
+                }
+                break;
+#endif
+#ifdef SEAL_USE_AVX2
+            case simd_level_type::avx2:
+                if (transform_coeff_count_power >= 3)
+                {
+                    transform_kernels_ = { ntt_transform_to_rev_avx2, ntt_transform_from_rev_avx2 };
+                }
+                break;
+#endif
+            default:
+                break;
+            }
+#endif
+
             mod_arith_lazy_ = ModArithLazy(modulus_);
             ntt_handler_ = NTTHandler(mod_arith_lazy_);
         }
@@ -399,8 +732,7 @@ namespace seal
 
             intel::seal_ext::compute_forward_ntt(operand, N, p, root, 4, 4);
 #else
-            tables.ntt_handler().transform_to_rev(
-                operand.ptr(), tables.coeff_count_power(), tables.get_from_root_powers());
+            ntt_negacyclic_harvey_lazy_batch(operand.ptr(), 1, 0, tables);
 #endif
         }
 
@@ -417,21 +749,7 @@ namespace seal
             // Finally maybe we need to reduce every coefficient modulo q, but we
             // know that they are in the range [0, 4q).
             // Since word size is controlled this is fast.
-            std::uint64_t modulus = tables.modulus().value();
-            std::uint64_t two_times_modulus = modulus * 2;
-            std::size_t n = std::size_t(1) << tables.coeff_count_power();
-
-            SEAL_ITERATE(operand, n, [&](auto &I) {
-                // Note: I must be passed to the lambda by reference.
-                if (I >= two_times_modulus)
-                {
-                    I -= two_times_modulus;
-                }
-                if (I >= modulus)
-                {
-                    I -= modulus;
-                }
-            });
+            reduce_ntt_lazy_batch(operand.ptr(), 1, 0, tables);
 #endif
         }
 
@@ -443,9 +761,7 @@ namespace seal
             uint64_t root = tables.get_root();
             intel::seal_ext::compute_inverse_ntt(operand, N, p, root, 2, 2);
 #else
-            MultiplyUIntModOperand inv_degree_modulo = tables.inv_degree_modulo();
-            tables.ntt_handler().transform_from_rev(
-                operand.ptr(), tables.coeff_count_power(), tables.get_from_inv_root_powers(), &inv_degree_modulo);
+            inverse_ntt_negacyclic_harvey_lazy_batch(operand.ptr(), 1, 0, tables);
 #endif
         }
 
@@ -458,19 +774,206 @@ namespace seal
             intel::seal_ext::compute_inverse_ntt(operand, N, p, root, 2, 1);
 #else
             inverse_ntt_negacyclic_harvey_lazy(operand, tables);
-            std::uint64_t modulus = tables.modulus().value();
-            std::size_t n = std::size_t(1) << tables.coeff_count_power();
 
             // Final adjustments; compute a[j] = a[j] * n^{-1} mod q.
             // We incorporated the final adjustment in the butterfly. Only need to reduce here.
-            SEAL_ITERATE(operand, n, [&](auto &I) {
-                // Note: I must be passed to the lambda by reference.
-                if (I >= modulus)
-                {
-                    I -= modulus;
-                }
+            reduce_inverse_ntt_lazy_batch(operand.ptr(), 1, 0, tables);
+#endif
+        }
+
+        void ntt_negacyclic_harvey_lazy(
+            RNSIter operand, size_t coeff_modulus_size, ConstNTTTablesIter tables, ThreadPool *thread_pool)
+        {
+#ifdef SEAL_DEBUG
+            if (!operand)
+            {
+                throw invalid_argument("operand");
+            }
+            if (!tables)
+            {
+                throw invalid_argument("tables");
+            }
+#endif
+            for_each_rns_component(coeff_modulus_size, thread_pool, [&](size_t i) {
+                ntt_negacyclic_harvey_batch(operand[i].ptr(), 1, 0, tables[i], true);
+            });
+        }
+
+        void ntt_negacyclic_harvey_lazy(
+            PolyIter operand, size_t size, ConstNTTTablesIter tables, ThreadPool *thread_pool)
+        {
+#ifdef SEAL_DEBUG
+            if (!operand)
+            {
+                throw invalid_argument("operand");
+            }
+            if (!tables)
+            {
+                throw invalid_argument("tables");
+            }
+#endif
+            // Components of all polynomials with the same modulus are transformed together
+            size_t poly_stride = operand.coeff_modulus_size() * operand.poly_modulus_degree();
+            for_each_rns_component(operand.coeff_modulus_size(), thread_pool, [&](size_t i) {
+                ntt_negacyclic_harvey_batch((*operand)[i].ptr(), size, poly_stride, tables[i], true);
+            });
+        }
+
+        void ntt_negacyclic_harvey_lazy(RNSIter operand, size_t count, const NTTTables &tables)
+        {
+#ifdef SEAL_DEBUG
+            if (!operand)
+            {
+                throw invalid_argument("operand");
+            }
+#endif
+            ntt_negacyclic_harvey_batch((*operand).ptr(), count, operand.poly_modulus_degree(), tables, true);
+        }
+
+        void ntt_negacyclic_harvey(
+            RNSIter operand, size_t coeff_modulus_size, ConstNTTTablesIter tables, ThreadPool *thread_pool)
+        {
+#ifdef SEAL_DEBUG
+            if (!operand)
+            {
+                throw invalid_argument("operand");
+            }
+            if (!tables)
+            {
+                throw invalid_argument("tables");
+            }
+#endif
+            for_each_rns_component(coeff_modulus_size, thread_pool, [&](size_t i) {
+                ntt_negacyclic_harvey_batch(operand[i].ptr(), 1, 0, tables[i], false);
+            });
+        }
+
+        void ntt_negacyclic_harvey(PolyIter operand, size_t size, ConstNTTTablesIter tables, ThreadPool *thread_pool)
+        {
+#ifdef SEAL_DEBUG
+            if (!operand)
+            {
+                throw invalid_argument("operand");
+            }
+            if (!tables)
+            {
+                throw invalid_argument("tables");
+            }
+#endif
+            // Components of all polynomials with the same modulus are transformed together
+            size_t poly_stride = operand.coeff_modulus_size() * operand.poly_modulus_degree();
+            for_each_rns_component(operand.coeff_modulus_size(), thread_pool, [&](size_t i) {
+                ntt_negacyclic_harvey_batch((*operand)[i].ptr(), size, poly_stride, tables[i], false);
+            });
+        }
+
+        void ntt_negacyclic_harvey(RNSIter operand, size_t count, const NTTTables &tables)
+        {
+#ifdef SEAL_DEBUG
+            if (!operand)
+            {
+                throw invalid_argument("operand");
+            }
+#endif
+            ntt_negacyclic_harvey_batch((*operand).ptr(), count, operand.poly_modulus_degree(), tables, false);
+        }
+
+        void inverse_ntt_negacyclic_harvey_lazy(
+            RNSIter operand, size_t coeff_modulus_size, ConstNTTTablesIter tables, ThreadPool *thread_pool)
+        {
+#ifdef SEAL_DEBUG
+            if (!operand)
+            {
+                throw invalid_argument("operand");
+            }
+            if (!tables)
+            {
+                throw invalid_argument("tables");
+            }
+#endif
+            for_each_rns_component(coeff_modulus_size, thread_pool, [&](size_t i) {
+                inverse_ntt_negacyclic_harvey_batch(operand[i].ptr(), 1, 0, tables[i], true);
             });
+        }
+
+        void inverse_ntt_negacyclic_harvey_lazy(
+            PolyIter operand, size_t size, ConstNTTTablesIter tables, ThreadPool *thread_pool)
+        {
+#ifdef SEAL_DEBUG
+            if (!operand)
+            {
+                throw invalid_argument("operand");
+            }
+            if (!tables)
+            {
+                throw invalid_argument("tables");
+            }
+#endif
+            // Components of all polynomials with the same modulus are transformed together
+            size_t poly_stride = operand.coeff_modulus_size() * operand.poly_modulus_degree();
+            for_each_rns_component(operand.coeff_modulus_size(), thread_pool, [&](size_t i) {
+                inverse_ntt_negacyclic_harvey_batch((*operand)[i].ptr(), size, poly_stride, tables[i], true);
+            });
+        }
+
+        void inverse_ntt_negacyclic_harvey_lazy(RNSIter operand, size_t count, const NTTTables &tables)
+        {
+#ifdef SEAL_DEBUG
+            if (!operand)
+            {
+                throw invalid_argument("operand");
+            }
+#endif
+            inverse_ntt_negacyclic_harvey_batch((*operand).ptr(), count, operand.poly_modulus_degree(), tables, true);
+        }
+
+        void inverse_ntt_negacyclic_harvey(
+            RNSIter operand, size_t coeff_modulus_size, ConstNTTTablesIter tables, ThreadPool *thread_pool)
+        {
+#ifdef SEAL_DEBUG
+            if (!operand)
+            {
+                throw invalid_argument("operand");
+            }
+            if (!tables)
+            {
+                throw invalid_argument("tables");
+            }
+#endif
+            for_each_rns_component(coeff_modulus_size, thread_pool, [&](size_t i) {
+                inverse_ntt_negacyclic_harvey_batch(operand[i].ptr(), 1, 0, tables[i], false);
+            });
+        }
+
+        void inverse_ntt_negacyclic_harvey(
+            PolyIter operand, size_t size, ConstNTTTablesIter tables, ThreadPool *thread_pool)
+        {
+#ifdef SEAL_DEBUG
+            if (!operand)
+            {
+                throw invalid_argument("operand");
+            }
+            if (!tables)
+            {
+                throw invalid_argument("tables");
+            }
+#endif
+            // Components of all polynomials with the same modulus are transformed together
+            size_t poly_stride = operand.coeff_modulus_size() * operand.poly_modulus_degree();
+            for_each_rns_component(operand.coeff_modulus_size(), thread_pool, [&](size_t i) {
+                inverse_ntt_negacyclic_harvey_batch((*operand)[i].ptr(), size, poly_stride, tables[i], false);
+            });
+        }
+
+        void inverse_ntt_negacyclic_harvey(RNSIter operand, size_t count, const NTTTables &tables)
+        {
+#ifdef SEAL_DEBUG
+            if (!operand)
+            {
+                throw invalid_argument("operand");
+            }
 #endif
+            inverse_ntt_negacyclic_harvey_batch((*operand).ptr(), count, operand.poly_modulus_degree(), tables, false);
         }
     } // namespace util
 } // namespace seal
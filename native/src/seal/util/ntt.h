@@ -9,6 +9,7 @@
 #include "seal/util/dwthandler.h"
 #include "seal/util/iterator.h"
 #include "seal/util/pointer.h"
+#include "seal/util/threadpool.h"
 #include "seal/util/uintarithsmallmod.h"
 #include "seal/util/uintcore.h"
 #include <stdexcept>
@@ -66,6 +67,27 @@ namespace seal
             std::uint64_t two_times_modulus_;
         };
 
+        /**
+        Kernels for the forward and inverse transforms of all coefficients, or of the rows of a blocked transform, of
+        NTTTables. The kernels are selected once for the transform size and the SIMD level when the tables are created,
+        so that transforms do not check the SIMD level on every call; null kernels stand for the transforms of
+        NTTTables::ntt_handler().
+        */
+        struct NTTTransformKernels
+        {
+            using ToRev = void (*)(
+                std::uint64_t *values, std::size_t batch_size, std::size_t batch_stride, int log_n,
+                const MultiplyUIntModOperand *roots, const Modulus &modulus);
+
+            using FromRev = void (*)(
+                std::uint64_t *values, std::size_t batch_size, std::size_t batch_stride, int log_n,
+                const MultiplyUIntModOperand *roots, const MultiplyUIntModOperand *scalar, const Modulus &modulus);
+
+            ToRev to_rev;
+
+            FromRev from_rev;
+        };
+
         class NTTTables
         {
             using ModArithLazy = Arithmetic<uint64_t, MultiplyUIntModOperand, MultiplyUIntModOperand>;
@@ -83,6 +105,17 @@ namespace seal
 
                 std::copy_n(copy.root_powers_.get(), coeff_count_, root_powers_.get());
                 std::copy_n(copy.inv_root_powers_.get(), coeff_count_, inv_root_powers_.get());
+
+                block_coeff_count_power_ = copy.block_coeff_count_power_;
+                transform_kernels_ = copy.transform_kernels_;
+                if (block_coeff_count_power_)
+                {
+                    block_root_powers_ = allocate<MultiplyUIntModOperand>(coeff_count_, pool_);
+                    block_inv_root_powers_ = allocate<MultiplyUIntModOperand>(coeff_count_, pool_);
+
+                    std::copy_n(copy.block_root_powers_.get(), coeff_count_, block_root_powers_.get());
+                    std::copy_n(copy.block_inv_root_powers_.get(), coeff_count_, block_inv_root_powers_.get());
+                }
             }
 
             NTTTables(int coeff_count_power, const Modulus &modulus, MemoryPoolHandle pool = MemoryManager::GetPool());
@@ -124,6 +157,42 @@ namespace seal
                 return inv_root_powers_[index];
             }
 
+            /**
+            Returns log 2 of the row size if transforms are blocked (four-step) for better cache locality, or zero
+            otherwise. A blocked transform views the coefficients as a row-major matrix with rows of this size.
+            */
+            SEAL_NODISCARD inline int block_coeff_count_power() const
+            {
+                return block_coeff_count_power_;
+            }
+
+            /**
+            Returns the roots for the forward transforms of the rows of a blocked transform. The roots for the row
+            starting at coefficient index i start at index i and are ordered as for NTTHandler::transform_to_rev.
+            */
+            SEAL_NODISCARD inline const MultiplyUIntModOperand *get_from_block_root_powers() const
+            {
+                return block_root_powers_.get();
+            }
+
+            /**
+            Returns the roots for the inverse transforms of the rows of a blocked transform. The roots for the row
+            starting at coefficient index i start at index i and are ordered as for NTTHandler::transform_from_rev.
+            */
+            SEAL_NODISCARD inline const MultiplyUIntModOperand *get_from_block_inv_root_powers() const
+            {
+                return block_inv_root_powers_.get();
+            }
+
+            /**
+            Returns the kernels for transforms of 2^block_coeff_count_power() coefficients if transforms are blocked,
+            or of all coefficients otherwise.
+            */
+            SEAL_NODISCARD inline const NTTTransformKernels &transform_kernels() const
+            {
+                return transform_kernels_;
+            }
+
             SEAL_NODISCARD inline const MultiplyUIntModOperand &inv_degree_modulo() const
             {
                 return inv_degree_modulo_;
@@ -177,6 +246,17 @@ namespace seal
             // Holds 1~(n-1)-th powers of inv_root_ in scrambled order, the 0-th power is left unset.
             Pointer<MultiplyUIntModOperand> inv_root_powers_;
 
+            // Log 2 of the row size of blocked transforms, or zero if transforms are not blocked.
+            int block_coeff_count_power_ = 0;
+
+            // Holds the roots of the row transforms of a blocked transform, one contiguous table per row.
+            Pointer<MultiplyUIntModOperand> block_root_powers_;
+
+            // Holds the inverse roots of the row transforms of a blocked transform, one contiguous table per row.
+            Pointer<MultiplyUIntModOperand> block_inv_root_powers_;
+
+            NTTTransformKernels transform_kernels_{};
+
             ModArithLazy mod_arith_lazy_;
 
             NTTHandler ntt_handler_;
@@ -192,149 +272,108 @@ namespace seal
             int coeff_count_power, const std::vector<Modulus> &modulus, Pointer<NTTTables> &tables,
             MemoryPoolHandle pool);
 
+        /**
+        The functions below compute negacyclic NTTs with Harvey's butterflies. The lazy forward transform takes inputs
+        in [0, 4 * modulus) and returns outputs in [0, 4 * modulus), and the lazy inverse transform takes inputs in
+        [0, 2 * modulus) and returns outputs in [0, 2 * modulus); the other transforms return reduced outputs.
+
+        The overloads for RNSIter and PolyIter transform all RNS components in one call. The components of all
+        polynomials that share a modulus are transformed together, so every root is loaded once for all of them and
+        their independent butterflies are interleaved. The components with different moduli are independent tasks;
+        they run in parallel on thread_pool if one is given. The overloads for RNSIter with a single NTTTables
+        transform count polynomials with the same modulus together.
+        */
         void ntt_negacyclic_harvey_lazy(CoeffIter operand, const NTTTables &tables);
 
-        inline void ntt_negacyclic_harvey_lazy(
-            RNSIter operand, std::size_t coeff_modulus_size, ConstNTTTablesIter tables)
-        {
-#ifdef SEAL_DEBUG
-            if (!operand)
-            {
-                throw std::invalid_argument("operand");
-            }
-            if (!tables)
-            {
-                throw std::invalid_argument("tables");
-            }
-#endif
-            SEAL_ITERATE(iter(operand, tables), coeff_modulus_size, [&](auto I) {
-                ntt_negacyclic_harvey_lazy(get<0>(I), get<1>(I));
-            });
-        }
+        void ntt_negacyclic_harvey_lazy(
+            RNSIter operand, std::size_t coeff_modulus_size, ConstNTTTablesIter tables,
+            ThreadPool *thread_pool = nullptr);
 
-        inline void ntt_negacyclic_harvey_lazy(PolyIter operand, std::size_t size, ConstNTTTablesIter tables)
-        {
-#ifdef SEAL_DEBUG
-            if (!operand)
-            {
-                throw std::invalid_argument("operand");
-            }
-            if (!tables)
-            {
-                throw std::invalid_argument("tables");
-            }
-#endif
-            SEAL_ITERATE(
-                operand, size, [&](auto I) { ntt_negacyclic_harvey_lazy(I, operand.coeff_modulus_size(), tables); });
-        }
+        void ntt_negacyclic_harvey_lazy(
+            PolyIter operand, std::size_t size, ConstNTTTablesIter tables, ThreadPool *thread_pool = nullptr);
+
+        void ntt_negacyclic_harvey_lazy(RNSIter operand, std::size_t count, const NTTTables &tables);
 
         void ntt_negacyclic_harvey(CoeffIter operand, const NTTTables &tables);
 
-        inline void ntt_negacyclic_harvey(RNSIter operand, std::size_t coeff_modulus_size, ConstNTTTablesIter tables)
-        {
-#ifdef SEAL_DEBUG
-            if (!operand)
-            {
-                throw std::invalid_argument("operand");
-            }
-            if (!tables)
-            {
-                throw std::invalid_argument("tables");
-            }
-#endif
-            SEAL_ITERATE(iter(operand, tables), coeff_modulus_size, [&](auto I) {
-                ntt_negacyclic_harvey(get<0>(I), get<1>(I));
-            });
-        }
+        void ntt_negacyclic_harvey(
+            RNSIter operand, std::size_t coeff_modulus_size, ConstNTTTablesIter tables,
+            ThreadPool *thread_pool = nullptr);
 
-        inline void ntt_negacyclic_harvey(PolyIter operand, std::size_t size, ConstNTTTablesIter tables)
-        {
-#ifdef SEAL_DEBUG
-            if (!operand)
-            {
-                throw std::invalid_argument("operand");
-            }
-            if (!tables)
-            {
-                throw std::invalid_argument("tables");
-            }
-#endif
-            SEAL_ITERATE(
-                operand, size, [&](auto I) { ntt_negacyclic_harvey(I, operand.coeff_modulus_size(), tables); });
-        }
+        void ntt_negacyclic_harvey(
+            PolyIter operand, std::size_t size, ConstNTTTablesIter tables, ThreadPool *thread_pool = nullptr);
+
+        void ntt_negacyclic_harvey(RNSIter operand, std::size_t count, const NTTTables &tables);
 
         void inverse_ntt_negacyclic_harvey_lazy(CoeffIter operand, const NTTTables &tables);
 
-        inline void inverse_ntt_negacyclic_harvey_lazy(
-            RNSIter operand, std::size_t coeff_modulus_size, ConstNTTTablesIter tables)
-        {
-#ifdef SEAL_DEBUG
-            if (!operand)
-            {
-                throw std::invalid_argument("operand");
-            }
-            if (!tables)
-            {
-                throw std::invalid_argument("tables");
-            }
-#endif
-            SEAL_ITERATE(iter(operand, tables), coeff_modulus_size, [&](auto I) {
-                inverse_ntt_negacyclic_harvey_lazy(get<0>(I), get<1>(I));
-            });
-        }
+        void inverse_ntt_negacyclic_harvey_lazy(
+            RNSIter operand, std::size_t coeff_modulus_size, ConstNTTTablesIter tables,
+            ThreadPool *thread_pool = nullptr);
 
-        inline void inverse_ntt_negacyclic_harvey_lazy(PolyIter operand, std::size_t size, ConstNTTTablesIter tables)
-        {
-#ifdef SEAL_DEBUG
-            if (!operand)
-            {
-                throw std::invalid_argument("operand");
-            }
-            if (!tables)
-            {
-                throw std::invalid_argument("tables");
-            }
-#endif
-            SEAL_ITERATE(operand, size, [&](auto I) {
-                inverse_ntt_negacyclic_harvey_lazy(I, operand.coeff_modulus_size(), tables);
-            });
-        }
+        void inverse_ntt_negacyclic_harvey_lazy(
+            PolyIter operand, std::size_t size, ConstNTTTablesIter tables, ThreadPool *thread_pool = nullptr);
+
+        void inverse_ntt_negacyclic_harvey_lazy(RNSIter operand, std::size_t count, const NTTTables &tables);
 
         void inverse_ntt_negacyclic_harvey(CoeffIter operand, const NTTTables &tables);
 
-        inline void inverse_ntt_negacyclic_harvey(
-            RNSIter operand, std::size_t coeff_modulus_size, ConstNTTTablesIter tables)
-        {
-#ifdef SEAL_DEBUG
-            if (!operand)
-            {
-                throw std::invalid_argument("operand");
-            }
-            if (!tables)
-            {
-                throw std::invalid_argument("tables");
-            }
+        void inverse_ntt_negacyclic_harvey(
+            RNSIter operand, std::size_t coeff_modulus_size, ConstNTTTablesIter tables,
+            ThreadPool *thread_pool = nullptr);
+
+        void inverse_ntt_negacyclic_harvey(
+            PolyIter operand, std::size_t size, ConstNTTTablesIter tables, ThreadPool *thread_pool = nullptr);
+
+        void inverse_ntt_negacyclic_harvey(RNSIter operand, std::size_t count, const NTTTables &tables);
+
+#ifdef SEAL_USE_AVX2
+        /**
+        AVX2 implementations of transform_to_rev, transform_from_rev, transform_columns_to_rev, and
+        transform_columns_from_rev of NTTTables::ntt_handler() with identical inputs and outputs. Transforms need at
+        least 8 values and column transforms a width that is a multiple of 16. Transforms apply to batch_size vectors
+        spaced batch_stride apart at once.
+        */
+        void ntt_transform_to_rev_avx2(
+            std::uint64_t *values, std::size_t batch_size, std::size_t batch_stride, int log_n,
+            const MultiplyUIntModOperand *roots, const Modulus &modulus);
+
+        void ntt_transform_from_rev_avx2(
+            std::uint64_t *values, std::size_t batch_size, std::size_t batch_stride, int log_n,
+            const MultiplyUIntModOperand *roots, const MultiplyUIntModOperand *scalar, const Modulus &modulus);
+
+        void ntt_transform_columns_to_rev_avx2(
+            std::uint64_t *values, int log_height, std::size_t width, const MultiplyUIntModOperand *roots,
+            const Modulus &modulus);
+
+        void ntt_transform_columns_from_rev_avx2(
+            std::uint64_t *values, int log_height, std::size_t width, const MultiplyUIntModOperand *roots,
+            const MultiplyUIntModOperand &scalar, const Modulus &modulus);
 #endif
-            SEAL_ITERATE(iter(operand, tables), coeff_modulus_size, [&](auto I) {
-                inverse_ntt_negacyclic_harvey(get<0>(I), get<1>(I));
-            });
-        }
 
-        inline void inverse_ntt_negacyclic_harvey(PolyIter operand, std::size_t size, ConstNTTTablesIter tables)
-        {
-#ifdef SEAL_DEBUG
-            if (!operand)
-            {
-                throw std::invalid_argument("operand");
-            }
-            if (!tables)
-            {
-                throw std::invalid_argument("tables");
-            }
+#ifdef SEAL_USE_AVX512
+        /**
+        AVX-512 implementations of transform_to_rev, transform_from_rev, transform_columns_to_rev, and
+        transform_columns_from_rev of NTTTables::ntt_handler() with identical inputs and outputs. Transforms need at
+        least 16 values and column transforms a width that is a multiple of 16. Transforms apply to batch_size vectors
+        spaced batch_stride apart at once.
+        */
+        void ntt_transform_to_rev_avx512(
+            std::uint64_t *values, std::size_t batch_size, std::size_t batch_stride, int log_n,
+            const MultiplyUIntModOperand *roots, const Modulus &modulus);
+
+        void ntt_transform_from_rev_avx512(
+            std::uint64_t *values, std::size_t batch_size, std::size_t batch_stride, int log_n,
+            const MultiplyUIntModOperand *roots, const MultiplyUIntModOperand *scalar, const Modulus &modulus);
+
+        void ntt_transform_columns_to_rev_avx512(
+            std::uint64_t *values, int log_height, std::size_t width, const MultiplyUIntModOperand *roots,
+            const Modulus &modulus);
+
+        void ntt_transform_columns_from_rev_avx512(
+            std::uint64_t *values, int log_height, std::size_t width, const MultiplyUIntModOperand *roots,
+            const MultiplyUIntModOperand &scalar, const Modulus &modulus);
 #endif
-            SEAL_ITERATE(
-                operand, size, [&](auto I) { inverse_ntt_negacyclic_harvey(I, operand.coeff_modulus_size(), tables); });
-        }
 
         void ntt_negacyclic_harvey_new(CoeffIter operand, const NTTTables &tables);
         void inverse_ntt_negacyclic_harvey_new(CoeffIter operand, const NTTTables &tables);
@@ -0,0 +1,537 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/ntt.h"
+
+#ifdef SEAL_USE_AVX2
+#include "seal/util/avx.h"
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            /*
+            Multiplication by roots in the butterflies, which returns values in [0, 2 * modulus) for inputs in
+            [0, 4 * modulus). A root given by the operands and quotients of MultiplyUIntModOperand is first converted
+            with make_root and then applied to any number of vectors.
+            */
+
+            // Integer arithmetic with the precomputed quotients
+            struct ShoupMultiplierAVX2
+            {
+                struct root_type
+                {
+                    __m256i operand;
+                    __m256i quotient;
+                };
+
+                __m256i modulus;
+
+                SEAL_TARGET_AVX2 inline root_type make_root(__m256i operand, __m256i quotient) const
+                {
+                    return { operand, quotient };
+                }
+
+                SEAL_TARGET_AVX2 inline __m256i multiply_lazy(__m256i x, const root_type &r) const
+                {
+                    return multiply_uint_mod_lazy_avx2(x, r.operand, r.quotient, modulus);
+                }
+            };
+
+            // 32-bit word arithmetic for moduli of at most SEAL_SMALL_MOD_BIT_COUNT_MAX bits
+            struct SmallWordMultiplierAVX2
+            {
+                using root_type = ShoupMultiplierAVX2::root_type;
+
+                __m256i modulus;
+
+                SEAL_TARGET_AVX2 inline root_type make_root(__m256i operand, __m256i quotient) const
+                {
+                    return { operand, _mm256_srli_epi64(quotient, 32) };
+                }
+
+                SEAL_TARGET_AVX2 inline __m256i multiply_lazy(__m256i x, const root_type &r) const
+                {
+                    return multiply_uint_mod_lazy_32_avx2(x, r.operand, r.quotient, modulus);
+                }
+            };
+
+            // Double-precision arithmetic with FMA for moduli of at most SEAL_FMA_MOD_BIT_COUNT_MAX bits
+            struct FMAMultiplierAVX2
+            {
+                using root_type = __m256d;
+
+                __m256d modulus;
+                __m256d modulus_inv;
+                __m256d two_times_modulus;
+
+                SEAL_TARGET_AVX2 inline root_type make_root(__m256i operand, SEAL_MAYBE_UNUSED __m256i quotient) const
+                {
+                    return uint52_to_double_avx2(operand);
+                }
+
+                SEAL_TARGET_AVX2 inline __m256i multiply_lazy(__m256i x, root_type r) const
+                {
+                    return double_to_uint52_avx2(multiply_double_mod_lazy_avx2(
+                        uint52_to_double_avx2(x), r, modulus, modulus_inv, two_times_modulus));
+                }
+            };
+
+            SEAL_TARGET_AVX2 inline ShoupMultiplierAVX2 make_shoup_multiplier_avx2(const Modulus &modulus)
+            {
+                return { _mm256_set1_epi64x(static_cast<long long>(modulus.value())) };
+            }
+
+            SEAL_TARGET_AVX2 inline SmallWordMultiplierAVX2 make_small_word_multiplier_avx2(const Modulus &modulus)
+            {
+                return { _mm256_set1_epi64x(static_cast<long long>(modulus.value())) };
+            }
+
+            SEAL_TARGET_AVX2 inline FMAMultiplierAVX2 make_fma_multiplier_avx2(const Modulus &modulus)
+            {
+                double modulus_d = static_cast<double>(modulus.value());
+                return { _mm256_set1_pd(modulus_d), _mm256_set1_pd(1.0 / modulus_d), _mm256_set1_pd(2.0 * modulus_d) };
+            }
+
+            template <typename Multiplier>
+            SEAL_TARGET_AVX2 inline typename Multiplier::root_type load_root_avx2(
+                const Multiplier &mul, const MultiplyUIntModOperand &r)
+            {
+                return mul.make_root(
+                    _mm256_set1_epi64x(static_cast<long long>(r.operand)),
+                    _mm256_set1_epi64x(static_cast<long long>(r.quotient)));
+            }
+
+            // Harvey's lazy forward butterfly on four lanes; inputs and outputs are in [0, 4 * modulus).
+            template <typename Multiplier>
+            SEAL_TARGET_AVX2 inline void forward_butterfly_avx2(
+                __m256i &x, __m256i &y, const typename Multiplier::root_type &r, const Multiplier &mul,
+                __m256i two_times_modulus)
+            {
+                __m256i u = guard_avx2(x, two_times_modulus);
+                __m256i v = mul.multiply_lazy(y, r);
+                x = _mm256_add_epi64(u, v);
+                y = _mm256_sub_epi64(_mm256_add_epi64(u, two_times_modulus), v);
+            }
+
+            // Harvey's lazy inverse butterfly on four lanes; inputs and outputs are in [0, 2 * modulus).
+            template <typename Multiplier>
+            SEAL_TARGET_AVX2 inline void inverse_butterfly_avx2(
+                __m256i &x, __m256i &y, const typename Multiplier::root_type &r, const Multiplier &mul,
+                __m256i two_times_modulus)
+            {
+                __m256i u = x;
+                __m256i v = y;
+                x = guard_avx2(_mm256_add_epi64(u, v), two_times_modulus);
+                y = mul.multiply_lazy(_mm256_sub_epi64(_mm256_add_epi64(u, two_times_modulus), v), r);
+            }
+
+            /*
+            Butterflies with gap 2 and 1 do not fill a vector, so two vectors holding 8 consecutive values are
+            rearranged such that x holds all "upper" and y all "lower" inputs. The required roots are read from
+            (operand, quotient) pairs of MultiplyUIntModOperand. Both rearrangements are their own inverses.
+            */
+            SEAL_TARGET_AVX2 inline void split_gap_2_avx2(__m256i a, __m256i b, __m256i &x, __m256i &y)
+            {
+                // x = [a0 a1 b0 b1], y = [a2 a3 b2 b3]
+                x = _mm256_permute2x128_si256(a, b, 0x20);
+                y = _mm256_permute2x128_si256(a, b, 0x31);
+            }
+
+            SEAL_TARGET_AVX2 inline void load_roots_gap_2_avx2(
+                const MultiplyUIntModOperand *roots, __m256i &r_operand, __m256i &r_quotient)
+            {
+                // Two roots r0, r1 are needed as [r0 r0 r1 r1]
+                __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(roots));
+                r_operand = _mm256_permute4x64_epi64(r, 0xA0);
+                r_quotient = _mm256_permute4x64_epi64(r, 0xF5);
+            }
+
+            SEAL_TARGET_AVX2 inline void split_gap_1_avx2(__m256i a, __m256i b, __m256i &x, __m256i &y)
+            {
+                // x = [a0 b0 a2 b2], y = [a1 b1 a3 b3]
+                x = _mm256_unpacklo_epi64(a, b);
+                y = _mm256_unpackhi_epi64(a, b);
+            }
+
+            SEAL_TARGET_AVX2 inline void load_roots_gap_1_avx2(
+                const MultiplyUIntModOperand *roots, __m256i &r_operand, __m256i &r_quotient)
+            {
+                // Four roots r0, r1, r2, r3 are needed as [r0 r2 r1 r3]
+                __m256i r01 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(roots));
+                __m256i r23 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(roots + 2));
+                r_operand = _mm256_unpacklo_epi64(r01, r23);
+                r_quotient = _mm256_unpackhi_epi64(r01, r23);
+            }
+
+            /*
+            Forward butterflies with a single root between count values at x and y, for batch_size pairs of vectors
+            spaced batch_stride apart.
+            */
+            template <typename Multiplier>
+            SEAL_TARGET_AVX2 inline void forward_stage_avx2(
+                uint64_t *x, uint64_t *y, size_t count, size_t batch_size, size_t batch_stride,
+                const MultiplyUIntModOperand &r, const Multiplier &mul, __m256i two_times_modulus)
+            {
+                const auto root = load_root_avx2(mul, r);
+                for (size_t j = 0; j < count; j += 4)
+                {
+                    for (size_t k = 0, offset = j; k < batch_size; k++, offset += batch_stride)
+                    {
+                        __m256i vx = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + offset));
+                        __m256i vy = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(y + offset));
+                        forward_butterfly_avx2(vx, vy, root, mul, two_times_modulus);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(x + offset), vx);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(y + offset), vy);
+                    }
+                }
+            }
+
+            /*
+            Inverse butterflies with a single root between count values at x and y, for batch_size pairs of vectors
+            spaced batch_stride apart.
+            */
+            template <typename Multiplier>
+            SEAL_TARGET_AVX2 inline void inverse_stage_avx2(
+                uint64_t *x, uint64_t *y, size_t count, size_t batch_size, size_t batch_stride,
+                const MultiplyUIntModOperand &r, const Multiplier &mul, __m256i two_times_modulus)
+            {
+                const auto root = load_root_avx2(mul, r);
+                for (size_t j = 0; j < count; j += 4)
+                {
+                    for (size_t k = 0, offset = j; k < batch_size; k++, offset += batch_stride)
+                    {
+                        __m256i vx = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + offset));
+                        __m256i vy = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(y + offset));
+                        inverse_butterfly_avx2(vx, vy, root, mul, two_times_modulus);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(x + offset), vx);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(y + offset), vy);
+                    }
+                }
+            }
+
+            /*
+            Last inverse stage, merged with the multiplication by scalar, for batch_size pairs of vectors spaced
+            batch_stride apart; scaled_r is the root times scalar.
+            */
+            template <typename Multiplier>
+            SEAL_TARGET_AVX2 inline void inverse_last_stage_avx2(
+                uint64_t *x, uint64_t *y, size_t count, size_t batch_size, size_t batch_stride,
+                const MultiplyUIntModOperand &scaled_r, const MultiplyUIntModOperand &scalar, const Multiplier &mul,
+                __m256i two_times_modulus)
+            {
+                const auto s_root = load_root_avx2(mul, scalar);
+                const auto r_root = load_root_avx2(mul, scaled_r);
+                for (size_t j = 0; j < count; j += 4)
+                {
+                    for (size_t k = 0, offset = j; k < batch_size; k++, offset += batch_stride)
+                    {
+                        __m256i u = guard_avx2(
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + offset)), two_times_modulus);
+                        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(y + offset));
+                        __m256i vx = mul.multiply_lazy(guard_avx2(_mm256_add_epi64(u, v), two_times_modulus), s_root);
+                        __m256i vy =
+                            mul.multiply_lazy(_mm256_sub_epi64(_mm256_add_epi64(u, two_times_modulus), v), r_root);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(x + offset), vx);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(y + offset), vy);
+                    }
+                }
+            }
+
+            /*
+            Runs the stage with gap 2 (Gap2 is true) or gap 1 over all n values of batch_size vectors spaced
+            batch_stride apart, using m roots starting at roots[1]. Each block of roots is loaded and rearranged once
+            for all vectors.
+            */
+            template <bool Gap2, bool Inverse, typename Multiplier>
+            SEAL_TARGET_AVX2 inline void small_gap_stage_avx2(
+                uint64_t *values, size_t batch_size, size_t batch_stride, size_t m,
+                const MultiplyUIntModOperand *roots, const Multiplier &mul, __m256i two_times_modulus)
+            {
+                constexpr size_t roots_per_block = Gap2 ? 2 : 4;
+                for (size_t i = 0; i < m; i += roots_per_block, values += 8)
+                {
+                    __m256i r_operand, r_quotient;
+                    if (Gap2)
+                    {
+                        load_roots_gap_2_avx2(roots + 1 + i, r_operand, r_quotient);
+                    }
+                    else
+                    {
+                        load_roots_gap_1_avx2(roots + 1 + i, r_operand, r_quotient);
+                    }
+                    const auto root = mul.make_root(r_operand, r_quotient);
+                    uint64_t *batch_values = values;
+                    for (size_t k = 0; k < batch_size; k++, batch_values += batch_stride)
+                    {
+                        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(batch_values));
+                        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(batch_values + 4));
+                        __m256i x, y;
+                        if (Gap2)
+                        {
+                            split_gap_2_avx2(a, b, x, y);
+                        }
+                        else
+                        {
+                            split_gap_1_avx2(a, b, x, y);
+                        }
+                        if (Inverse)
+                        {
+                            inverse_butterfly_avx2(x, y, root, mul, two_times_modulus);
+                        }
+                        else
+                        {
+                            forward_butterfly_avx2(x, y, root, mul, two_times_modulus);
+                        }
+                        if (Gap2)
+                        {
+                            split_gap_2_avx2(x, y, a, b);
+                        }
+                        else
+                        {
+                            split_gap_1_avx2(x, y, a, b);
+                        }
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(batch_values), a);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(batch_values + 4), b);
+                    }
+                }
+            }
+
+            // Columns of a blocked transform are processed in tiles of this many values per row.
+            constexpr size_t column_tile_width = 16;
+
+            template <typename Multiplier>
+            SEAL_TARGET_AVX2 inline void transform_to_rev_avx2(
+                uint64_t *values, size_t batch_size, size_t batch_stride, int log_n,
+                const MultiplyUIntModOperand *roots, const Modulus &modulus, const Multiplier &mul)
+            {
+                size_t n = size_t(1) << log_n;
+                const __m256i two_times_modulus = _mm256_set1_epi64x(static_cast<long long>(modulus.value() << 1));
+
+                size_t gap = n >> 1;
+                size_t m = 1;
+                for (; gap >= 4; m <<= 1, gap >>= 1)
+                {
+                    uint64_t *x = values;
+                    for (size_t i = 0; i < m; i++, x += gap << 1)
+                    {
+                        forward_stage_avx2(x, x + gap, gap, batch_size, batch_stride, *++roots, mul, two_times_modulus);
+                    }
+                }
+
+                small_gap_stage_avx2<true, false>(values, batch_size, batch_stride, m, roots, mul, two_times_modulus);
+                roots += m;
+                m <<= 1;
+                small_gap_stage_avx2<false, false>(values, batch_size, batch_stride, m, roots, mul, two_times_modulus);
+            }
+
+            template <typename Multiplier>
+            SEAL_TARGET_AVX2 inline void transform_from_rev_avx2(
+                uint64_t *values, size_t batch_size, size_t batch_stride, int log_n,
+                const MultiplyUIntModOperand *roots, const MultiplyUIntModOperand *scalar, const Modulus &modulus,
+                const Multiplier &mul)
+            {
+                size_t n = size_t(1) << log_n;
+                const __m256i two_times_modulus = _mm256_set1_epi64x(static_cast<long long>(modulus.value() << 1));
+
+                size_t m = n >> 1;
+                small_gap_stage_avx2<false, true>(values, batch_size, batch_stride, m, roots, mul, two_times_modulus);
+                roots += m;
+                m >>= 1;
+                small_gap_stage_avx2<true, true>(values, batch_size, batch_stride, m, roots, mul, two_times_modulus);
+                roots += m;
+                m >>= 1;
+
+                size_t gap = n / (m << 1);
+                for (; m > 1; m >>= 1, gap <<= 1)
+                {
+                    uint64_t *x = values;
+                    for (size_t i = 0; i < m; i++, x += gap << 1)
+                    {
+                        inverse_stage_avx2(x, x + gap, gap, batch_size, batch_stride, *++roots, mul, two_times_modulus);
+                    }
+                }
+
+                if (scalar)
+                {
+                    // Last stage merges the multiplication with scalar
+                    MultiplyUIntModOperand scaled_r;
+                    scaled_r.set(multiply_uint_mod((*++roots).operand, *scalar, modulus), modulus);
+                    inverse_last_stage_avx2(
+                        values, values + gap, gap, batch_size, batch_stride, scaled_r, *scalar, mul, two_times_modulus);
+                }
+                else
+                {
+                    inverse_stage_avx2(
+                        values, values + gap, gap, batch_size, batch_stride, *++roots, mul, two_times_modulus);
+                }
+            }
+
+            template <typename Multiplier>
+            SEAL_TARGET_AVX2 inline void transform_columns_to_rev_avx2(
+                uint64_t *values, int log_height, size_t width, const MultiplyUIntModOperand *roots,
+                const Modulus &modulus, const Multiplier &mul)
+            {
+                size_t height = size_t(1) << log_height;
+                const __m256i two_times_modulus = _mm256_set1_epi64x(static_cast<long long>(modulus.value() << 1));
+
+                for (size_t column = 0; column < width; column += column_tile_width)
+                {
+                    const MultiplyUIntModOperand *r = roots;
+                    size_t gap = (height >> 1) * width;
+                    for (size_t m = 1; m < height; m <<= 1, gap >>= 1)
+                    {
+                        uint64_t *x = values + column;
+                        for (size_t i = 0; i < m; i++, x += gap << 1)
+                        {
+                            MultiplyUIntModOperand root = *++r;
+                            for (uint64_t *row = x; row != x + gap; row += width)
+                            {
+                                forward_stage_avx2(
+                                    row, row + gap, column_tile_width, 1, 0, root, mul, two_times_modulus);
+                            }
+                        }
+                    }
+                }
+            }
+
+            template <typename Multiplier>
+            SEAL_TARGET_AVX2 inline void transform_columns_from_rev_avx2(
+                uint64_t *values, int log_height, size_t width, const MultiplyUIntModOperand *roots,
+                const MultiplyUIntModOperand &scalar, const Modulus &modulus, const Multiplier &mul)
+            {
+                size_t height = size_t(1) << log_height;
+                const __m256i two_times_modulus = _mm256_set1_epi64x(static_cast<long long>(modulus.value() << 1));
+                MultiplyUIntModOperand scaled_r;
+                scaled_r.set(multiply_uint_mod(roots[height - 1].operand, scalar, modulus), modulus);
+
+                for (size_t column = 0; column < width; column += column_tile_width)
+                {
+                    const MultiplyUIntModOperand *r = roots;
+                    size_t gap = width;
+                    for (size_t m = height >> 1; m > 1; m >>= 1, gap <<= 1)
+                    {
+                        uint64_t *x = values + column;
+                        for (size_t i = 0; i < m; i++, x += gap << 1)
+                        {
+                            MultiplyUIntModOperand root = *++r;
+                            for (uint64_t *row = x; row != x + gap; row += width)
+                            {
+                                inverse_stage_avx2(
+                                    row, row + gap, column_tile_width, 1, 0, root, mul, two_times_modulus);
+                            }
+                        }
+                    }
+
+                    // Last stage merges the multiplication with scalar
+                    uint64_t *x = values + column;
+                    for (uint64_t *row = x; row != x + gap; row += width)
+                    {
+                        inverse_last_stage_avx2(
+                            row, row + gap, column_tile_width, 1, 0, scaled_r, scalar, mul, two_times_modulus);
+                    }
+                }
+            }
+        } // namespace
+
+        /*
+        The kernels multiply by roots with Shoup's method on 32-bit words for moduli of at most
+        SEAL_SMALL_MOD_BIT_COUNT_MAX bits, in double precision for moduli of at most SEAL_FMA_MOD_BIT_COUNT_MAX bits,
+        where all values in [0, 4 * modulus) are exact doubles, and with Shoup's method on 64-bit words otherwise.
+        */
+
+        SEAL_TARGET_AVX2 void ntt_transform_to_rev_avx2(
+            uint64_t *values, size_t batch_size, size_t batch_stride, int log_n, const MultiplyUIntModOperand *roots,
+            const Modulus &modulus)
+        {
+            static_assert(
+                sizeof(MultiplyUIntModOperand) == 2 * sizeof(uint64_t), "MultiplyUIntModOperand must be packed");
+
+            if (modulus.bit_count() <= SEAL_SMALL_MOD_BIT_COUNT_MAX)
+            {
+                transform_to_rev_avx2(
+                    values, batch_size, batch_stride, log_n, roots, modulus, make_small_word_multiplier_avx2(modulus));
+            }
+            else if (modulus.bit_count() <= SEAL_FMA_MOD_BIT_COUNT_MAX)
+            {
+                transform_to_rev_avx2(
+                    values, batch_size, batch_stride, log_n, roots, modulus, make_fma_multiplier_avx2(modulus));
+            }
+            else
+            {
+                transform_to_rev_avx2(
+                    values, batch_size, batch_stride, log_n, roots, modulus, make_shoup_multiplier_avx2(modulus));
+            }
+        }
+
+        SEAL_TARGET_AVX2 void ntt_transform_from_rev_avx2(
+            uint64_t *values, size_t batch_size, size_t batch_stride, int log_n, const MultiplyUIntModOperand *roots,
+            const MultiplyUIntModOperand *scalar, const Modulus &modulus)
+        {
+            if (modulus.bit_count() <= SEAL_SMALL_MOD_BIT_COUNT_MAX)
+            {
+                transform_from_rev_avx2(
+                    values, batch_size, batch_stride, log_n, roots, scalar, modulus,
+                    make_small_word_multiplier_avx2(modulus));
+            }
+            else if (modulus.bit_count() <= SEAL_FMA_MOD_BIT_COUNT_MAX)
+            {
+                transform_from_rev_avx2(
+                    values, batch_size, batch_stride, log_n, roots, scalar, modulus, make_fma_multiplier_avx2(modulus));
+            }
+            else
+            {
+                transform_from_rev_avx2(
+                    values, batch_size, batch_stride, log_n, roots, scalar, modulus,
+                    make_shoup_multiplier_avx2(modulus));
+            }
+        }
+
+        SEAL_TARGET_AVX2 void ntt_transform_columns_to_rev_avx2(
+            uint64_t *values, int log_height, size_t width, const MultiplyUIntModOperand *roots, const Modulus &modulus)
+        {
+            if (modulus.bit_count() <= SEAL_SMALL_MOD_BIT_COUNT_MAX)
+            {
+                transform_columns_to_rev_avx2(
+                    values, log_height, width, roots, modulus, make_small_word_multiplier_avx2(modulus));
+            }
+            else if (modulus.bit_count() <= SEAL_FMA_MOD_BIT_COUNT_MAX)
+            {
+                transform_columns_to_rev_avx2(
+                    values, log_height, width, roots, modulus, make_fma_multiplier_avx2(modulus));
+            }
+            else
+            {
+                transform_columns_to_rev_avx2(
+                    values, log_height, width, roots, modulus, make_shoup_multiplier_avx2(modulus));
+            }
+        }
+
+        SEAL_TARGET_AVX2 void ntt_transform_columns_from_rev_avx2(
+            uint64_t *values, int log_height, size_t width, const MultiplyUIntModOperand *roots,
+            const MultiplyUIntModOperand &scalar, const Modulus &modulus)
+        {
+            if (modulus.bit_count() <= SEAL_SMALL_MOD_BIT_COUNT_MAX)
+            {
+                transform_columns_from_rev_avx2(
+                    values, log_height, width, roots, scalar, modulus, make_small_word_multiplier_avx2(modulus));
+            }
+            else if (modulus.bit_count() <= SEAL_FMA_MOD_BIT_COUNT_MAX)
+            {
+                transform_columns_from_rev_avx2(
+                    values, log_height, width, roots, scalar, modulus, make_fma_multiplier_avx2(modulus));
+            }
+            else
+            {
+                transform_columns_from_rev_avx2(
+                    values, log_height, width, roots, scalar, modulus, make_shoup_multiplier_avx2(modulus));
+            }
+        }
+    } // namespace util
+} // namespace seal
+
+#endif
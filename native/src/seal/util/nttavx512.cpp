@@ -0,0 +1,541 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/ntt.h"
+
+#ifdef SEAL_USE_AVX512
+#include "seal/util/avx.h"
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            /*
+            Multiplication by roots in the butterflies, which returns values in [0, 2 * modulus) for inputs in
+            [0, 4 * modulus). A root given by the operands and quotients of MultiplyUIntModOperand is first converted
+            with make_root and then applied to any number of vectors.
+            */
+            struct RootAVX512
+            {
+                __m512i operand;
+                __m512i quotient;
+            };
+
+            // Shoup's method on 64-bit words
+            struct ShoupMultiplierAVX512
+            {
+                __m512i modulus;
+
+                SEAL_TARGET_AVX512 inline RootAVX512 make_root(__m512i operand, __m512i quotient) const
+                {
+                    return { operand, quotient };
+                }
+
+                SEAL_TARGET_AVX512 inline __m512i multiply_lazy(__m512i x, const RootAVX512 &r) const
+                {
+                    return multiply_uint_mod_lazy_avx512(x, r.operand, r.quotient, modulus);
+                }
+            };
+
+            // Shoup's method on 32-bit words for moduli of at most SEAL_SMALL_MOD_BIT_COUNT_MAX bits
+            struct SmallWordMultiplierAVX512
+            {
+                __m512i modulus;
+
+                SEAL_TARGET_AVX512 inline RootAVX512 make_root(__m512i operand, __m512i quotient) const
+                {
+                    return { operand, _mm512_srli_epi64(quotient, 32) };
+                }
+
+                SEAL_TARGET_AVX512 inline __m512i multiply_lazy(__m512i x, const RootAVX512 &r) const
+                {
+                    return multiply_uint_mod_lazy_32_avx512(x, r.operand, r.quotient, modulus);
+                }
+            };
+
+            SEAL_TARGET_AVX512 inline ShoupMultiplierAVX512 make_shoup_multiplier_avx512(const Modulus &modulus)
+            {
+                return { _mm512_set1_epi64(static_cast<long long>(modulus.value())) };
+            }
+
+            SEAL_TARGET_AVX512 inline SmallWordMultiplierAVX512 make_small_word_multiplier_avx512(
+                const Modulus &modulus)
+            {
+                return { _mm512_set1_epi64(static_cast<long long>(modulus.value())) };
+            }
+
+            template <typename Multiplier>
+            SEAL_TARGET_AVX512 inline RootAVX512 load_root_avx512(
+                const Multiplier &mul, const MultiplyUIntModOperand &r)
+            {
+                return mul.make_root(
+                    _mm512_set1_epi64(static_cast<long long>(r.operand)),
+                    _mm512_set1_epi64(static_cast<long long>(r.quotient)));
+            }
+
+            // Harvey's lazy forward butterfly on eight lanes; inputs and outputs are in [0, 4 * modulus).
+            template <typename Multiplier>
+            SEAL_TARGET_AVX512 inline void forward_butterfly_avx512(
+                __m512i &x, __m512i &y, const RootAVX512 &r, const Multiplier &mul, __m512i two_times_modulus)
+            {
+                __m512i u = guard_avx512(x, two_times_modulus);
+                __m512i v = mul.multiply_lazy(y, r);
+                x = _mm512_add_epi64(u, v);
+                y = _mm512_sub_epi64(_mm512_add_epi64(u, two_times_modulus), v);
+            }
+
+            // Harvey's lazy inverse butterfly on eight lanes; inputs and outputs are in [0, 2 * modulus).
+            template <typename Multiplier>
+            SEAL_TARGET_AVX512 inline void inverse_butterfly_avx512(
+                __m512i &x, __m512i &y, const RootAVX512 &r, const Multiplier &mul, __m512i two_times_modulus)
+            {
+                __m512i u = x;
+                __m512i v = y;
+                x = guard_avx512(_mm512_add_epi64(u, v), two_times_modulus);
+                y = mul.multiply_lazy(_mm512_sub_epi64(_mm512_add_epi64(u, two_times_modulus), v), r);
+            }
+
+            /*
+            Butterflies with gap 4, 2, and 1 do not fill a vector, so two vectors holding 16 consecutive values are
+            rearranged such that x holds all "upper" and y all "lower" inputs. The required roots are read from
+            (operand, quotient) pairs of MultiplyUIntModOperand.
+            */
+            enum class SmallGap
+            {
+                four,
+                two,
+                one
+            };
+
+            template <SmallGap G>
+            struct SmallGapButterflyAVX512;
+
+            template <>
+            struct SmallGapButterflyAVX512<SmallGap::four>
+            {
+                static constexpr size_t roots_per_block = 2;
+
+                SEAL_TARGET_AVX512 static void split(__m512i a, __m512i b, __m512i &x, __m512i &y)
+                {
+                    // x = [a0 a1 a2 a3 b0 b1 b2 b3], y = [a4 a5 a6 a7 b4 b5 b6 b7]
+                    x = _mm512_shuffle_i64x2(a, b, 0x44);
+                    y = _mm512_shuffle_i64x2(a, b, 0xEE);
+                }
+
+                SEAL_TARGET_AVX512 static void merge(__m512i x, __m512i y, __m512i &a, __m512i &b)
+                {
+                    a = _mm512_shuffle_i64x2(x, y, 0x44);
+                    b = _mm512_shuffle_i64x2(x, y, 0xEE);
+                }
+
+                SEAL_TARGET_AVX512 static void load_roots(
+                    const MultiplyUIntModOperand *roots, __m512i &r_operand, __m512i &r_quotient)
+                {
+                    // Roots r0, r1 are needed as [r0 r0 r0 r0 r1 r1 r1 r1]
+                    __m512i r = _mm512_castsi256_si512(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(roots)));
+                    r_operand = _mm512_permutexvar_epi64(_mm512_set_epi64(2, 2, 2, 2, 0, 0, 0, 0), r);
+                    r_quotient = _mm512_permutexvar_epi64(_mm512_set_epi64(3, 3, 3, 3, 1, 1, 1, 1), r);
+                }
+            };
+
+            template <>
+            struct SmallGapButterflyAVX512<SmallGap::two>
+            {
+                static constexpr size_t roots_per_block = 4;
+
+                SEAL_TARGET_AVX512 static void split(__m512i a, __m512i b, __m512i &x, __m512i &y)
+                {
+                    // x = [a0 a1 a4 a5 b0 b1 b4 b5], y = [a2 a3 a6 a7 b2 b3 b6 b7]
+                    x = _mm512_permutex2var_epi64(a, _mm512_set_epi64(13, 12, 9, 8, 5, 4, 1, 0), b);
+                    y = _mm512_permutex2var_epi64(a, _mm512_set_epi64(15, 14, 11, 10, 7, 6, 3, 2), b);
+                }
+
+                SEAL_TARGET_AVX512 static void merge(__m512i x, __m512i y, __m512i &a, __m512i &b)
+                {
+                    a = _mm512_permutex2var_epi64(x, _mm512_set_epi64(11, 10, 3, 2, 9, 8, 1, 0), y);
+                    b = _mm512_permutex2var_epi64(x, _mm512_set_epi64(15, 14, 7, 6, 13, 12, 5, 4), y);
+                }
+
+                SEAL_TARGET_AVX512 static void load_roots(
+                    const MultiplyUIntModOperand *roots, __m512i &r_operand, __m512i &r_quotient)
+                {
+                    // Roots r0, r1, r2, r3 are needed as [r0 r0 r1 r1 r2 r2 r3 r3]
+                    __m512i r = _mm512_loadu_si512(reinterpret_cast<const void *>(roots));
+                    r_operand = _mm512_permutexvar_epi64(_mm512_set_epi64(6, 6, 4, 4, 2, 2, 0, 0), r);
+                    r_quotient = _mm512_permutexvar_epi64(_mm512_set_epi64(7, 7, 5, 5, 3, 3, 1, 1), r);
+                }
+            };
+
+            template <>
+            struct SmallGapButterflyAVX512<SmallGap::one>
+            {
+                static constexpr size_t roots_per_block = 8;
+
+                SEAL_TARGET_AVX512 static void split(__m512i a, __m512i b, __m512i &x, __m512i &y)
+                {
+                    // x = [a0 b0 a2 b2 a4 b4 a6 b6], y = [a1 b1 a3 b3 a5 b5 a7 b7]
+                    x = _mm512_unpacklo_epi64(a, b);
+                    y = _mm512_unpackhi_epi64(a, b);
+                }
+
+                SEAL_TARGET_AVX512 static void merge(__m512i x, __m512i y, __m512i &a, __m512i &b)
+                {
+                    a = _mm512_unpacklo_epi64(x, y);
+                    b = _mm512_unpackhi_epi64(x, y);
+                }
+
+                SEAL_TARGET_AVX512 static void load_roots(
+                    const MultiplyUIntModOperand *roots, __m512i &r_operand, __m512i &r_quotient)
+                {
+                    // Roots r0, ..., r7 are needed as [r0 r4 r1 r5 r2 r6 r3 r7]
+                    __m512i r0123 = _mm512_loadu_si512(reinterpret_cast<const void *>(roots));
+                    __m512i r4567 = _mm512_loadu_si512(reinterpret_cast<const void *>(roots + 4));
+                    r_operand = _mm512_unpacklo_epi64(r0123, r4567);
+                    r_quotient = _mm512_unpackhi_epi64(r0123, r4567);
+                }
+            };
+
+            /*
+            Runs one stage with a small gap over all n values of batch_size vectors spaced batch_stride apart, using m
+            roots starting at roots[1]. Each block of roots is loaded and rearranged once for all vectors.
+            */
+            template <SmallGap G, bool Inverse, typename Multiplier>
+            SEAL_TARGET_AVX512 inline void small_gap_stage_avx512(
+                uint64_t *values, size_t batch_size, size_t batch_stride, size_t m,
+                const MultiplyUIntModOperand *roots, const Multiplier &mul, __m512i two_times_modulus)
+            {
+                using Butterfly = SmallGapButterflyAVX512<G>;
+                for (size_t i = 0; i < m; i += Butterfly::roots_per_block, values += 16)
+                {
+                    __m512i r_operand, r_quotient;
+                    Butterfly::load_roots(roots + 1 + i, r_operand, r_quotient);
+                    const RootAVX512 root = mul.make_root(r_operand, r_quotient);
+                    uint64_t *batch_values = values;
+                    for (size_t k = 0; k < batch_size; k++, batch_values += batch_stride)
+                    {
+                        __m512i a = _mm512_loadu_si512(reinterpret_cast<const void *>(batch_values));
+                        __m512i b = _mm512_loadu_si512(reinterpret_cast<const void *>(batch_values + 8));
+                        __m512i x, y;
+                        Butterfly::split(a, b, x, y);
+                        if (Inverse)
+                        {
+                            inverse_butterfly_avx512(x, y, root, mul, two_times_modulus);
+                        }
+                        else
+                        {
+                            forward_butterfly_avx512(x, y, root, mul, two_times_modulus);
+                        }
+                        Butterfly::merge(x, y, a, b);
+                        _mm512_storeu_si512(reinterpret_cast<void *>(batch_values), a);
+                        _mm512_storeu_si512(reinterpret_cast<void *>(batch_values + 8), b);
+                    }
+                }
+            }
+
+            /*
+            Forward butterflies with a single root between count values at x and y, for batch_size pairs of vectors
+            spaced batch_stride apart.
+            */
+            template <typename Multiplier>
+            SEAL_TARGET_AVX512 inline void forward_stage_avx512(
+                uint64_t *x, uint64_t *y, size_t count, size_t batch_size, size_t batch_stride,
+                const MultiplyUIntModOperand &r, const Multiplier &mul, __m512i two_times_modulus)
+            {
+                const RootAVX512 root = load_root_avx512(mul, r);
+                for (size_t j = 0; j < count; j += 8)
+                {
+                    for (size_t k = 0, offset = j; k < batch_size; k++, offset += batch_stride)
+                    {
+                        __m512i vx = _mm512_loadu_si512(reinterpret_cast<const void *>(x + offset));
+                        __m512i vy = _mm512_loadu_si512(reinterpret_cast<const void *>(y + offset));
+                        forward_butterfly_avx512(vx, vy, root, mul, two_times_modulus);
+                        _mm512_storeu_si512(reinterpret_cast<void *>(x + offset), vx);
+                        _mm512_storeu_si512(reinterpret_cast<void *>(y + offset), vy);
+                    }
+                }
+            }
+
+            /*
+            Inverse butterflies with a single root between count values at x and y, for batch_size pairs of vectors
+            spaced batch_stride apart.
+            */
+            template <typename Multiplier>
+            SEAL_TARGET_AVX512 inline void inverse_stage_avx512(
+                uint64_t *x, uint64_t *y, size_t count, size_t batch_size, size_t batch_stride,
+                const MultiplyUIntModOperand &r, const Multiplier &mul, __m512i two_times_modulus)
+            {
+                const RootAVX512 root = load_root_avx512(mul, r);
+                for (size_t j = 0; j < count; j += 8)
+                {
+                    for (size_t k = 0, offset = j; k < batch_size; k++, offset += batch_stride)
+                    {
+                        __m512i vx = _mm512_loadu_si512(reinterpret_cast<const void *>(x + offset));
+                        __m512i vy = _mm512_loadu_si512(reinterpret_cast<const void *>(y + offset));
+                        inverse_butterfly_avx512(vx, vy, root, mul, two_times_modulus);
+                        _mm512_storeu_si512(reinterpret_cast<void *>(x + offset), vx);
+                        _mm512_storeu_si512(reinterpret_cast<void *>(y + offset), vy);
+                    }
+                }
+            }
+
+            /*
+            Last inverse stage, merged with the multiplication by scalar, for batch_size pairs of vectors spaced
+            batch_stride apart; scaled_r is the root times scalar.
+            */
+            template <typename Multiplier>
+            SEAL_TARGET_AVX512 inline void inverse_last_stage_avx512(
+                uint64_t *x, uint64_t *y, size_t count, size_t batch_size, size_t batch_stride,
+                const MultiplyUIntModOperand &scaled_r, const MultiplyUIntModOperand &scalar, const Multiplier &mul,
+                __m512i two_times_modulus)
+            {
+                const RootAVX512 s_root = load_root_avx512(mul, scalar);
+                const RootAVX512 r_root = load_root_avx512(mul, scaled_r);
+                for (size_t j = 0; j < count; j += 8)
+                {
+                    for (size_t k = 0, offset = j; k < batch_size; k++, offset += batch_stride)
+                    {
+                        __m512i u = guard_avx512(
+                            _mm512_loadu_si512(reinterpret_cast<const void *>(x + offset)), two_times_modulus);
+                        __m512i v = _mm512_loadu_si512(reinterpret_cast<const void *>(y + offset));
+                        __m512i vx = mul.multiply_lazy(guard_avx512(_mm512_add_epi64(u, v), two_times_modulus), s_root);
+                        __m512i vy =
+                            mul.multiply_lazy(_mm512_sub_epi64(_mm512_add_epi64(u, two_times_modulus), v), r_root);
+                        _mm512_storeu_si512(reinterpret_cast<void *>(x + offset), vx);
+                        _mm512_storeu_si512(reinterpret_cast<void *>(y + offset), vy);
+                    }
+                }
+            }
+
+            // Columns of a blocked transform are processed in tiles of this many values per row.
+            constexpr size_t column_tile_width = 16;
+
+            template <typename Multiplier>
+            SEAL_TARGET_AVX512 inline void transform_to_rev_avx512(
+                uint64_t *values, size_t batch_size, size_t batch_stride, int log_n,
+                const MultiplyUIntModOperand *roots, const Modulus &modulus, const Multiplier &mul)
+            {
+                size_t n = size_t(1) << log_n;
+                const __m512i two_times_modulus = _mm512_add_epi64(mul.modulus, mul.modulus);
+
+                size_t gap = n >> 1;
+                size_t m = 1;
+                for (; gap >= 8; m <<= 1, gap >>= 1)
+                {
+                    uint64_t *x = values;
+                    for (size_t i = 0; i < m; i++, x += gap << 1)
+                    {
+                        forward_stage_avx512(
+                            x, x + gap, gap, batch_size, batch_stride, *++roots, mul, two_times_modulus);
+                    }
+                }
+
+                small_gap_stage_avx512<SmallGap::four, false>(
+                    values, batch_size, batch_stride, m, roots, mul, two_times_modulus);
+                roots += m;
+                m <<= 1;
+                small_gap_stage_avx512<SmallGap::two, false>(
+                    values, batch_size, batch_stride, m, roots, mul, two_times_modulus);
+                roots += m;
+                m <<= 1;
+                small_gap_stage_avx512<SmallGap::one, false>(
+                    values, batch_size, batch_stride, m, roots, mul, two_times_modulus);
+            }
+
+            template <typename Multiplier>
+            SEAL_TARGET_AVX512 inline void transform_from_rev_avx512(
+                uint64_t *values, size_t batch_size, size_t batch_stride, int log_n,
+                const MultiplyUIntModOperand *roots, const MultiplyUIntModOperand *scalar, const Modulus &modulus,
+                const Multiplier &mul)
+            {
+                size_t n = size_t(1) << log_n;
+                const __m512i two_times_modulus = _mm512_add_epi64(mul.modulus, mul.modulus);
+
+                size_t m = n >> 1;
+                small_gap_stage_avx512<SmallGap::one, true>(
+                    values, batch_size, batch_stride, m, roots, mul, two_times_modulus);
+                roots += m;
+                m >>= 1;
+                small_gap_stage_avx512<SmallGap::two, true>(
+                    values, batch_size, batch_stride, m, roots, mul, two_times_modulus);
+                roots += m;
+                m >>= 1;
+                small_gap_stage_avx512<SmallGap::four, true>(
+                    values, batch_size, batch_stride, m, roots, mul, two_times_modulus);
+                roots += m;
+                m >>= 1;
+
+                size_t gap = n / (m << 1);
+                for (; m > 1; m >>= 1, gap <<= 1)
+                {
+                    uint64_t *x = values;
+                    for (size_t i = 0; i < m; i++, x += gap << 1)
+                    {
+                        inverse_stage_avx512(
+                            x, x + gap, gap, batch_size, batch_stride, *++roots, mul, two_times_modulus);
+                    }
+                }
+
+                if (scalar)
+                {
+                    // Last stage merges the multiplication with scalar
+                    MultiplyUIntModOperand scaled_r;
+                    scaled_r.set(multiply_uint_mod((*++roots).operand, *scalar, modulus), modulus);
+                    inverse_last_stage_avx512(
+                        values, values + gap, gap, batch_size, batch_stride, scaled_r, *scalar, mul,
+                        two_times_modulus);
+                }
+                else
+                {
+                    inverse_stage_avx512(
+                        values, values + gap, gap, batch_size, batch_stride, *++roots, mul, two_times_modulus);
+                }
+            }
+
+            template <typename Multiplier>
+            SEAL_TARGET_AVX512 inline void transform_columns_to_rev_avx512(
+                uint64_t *values, int log_height, size_t width, const MultiplyUIntModOperand *roots,
+                const Modulus &modulus, const Multiplier &mul)
+            {
+                size_t height = size_t(1) << log_height;
+                const __m512i two_times_modulus = _mm512_add_epi64(mul.modulus, mul.modulus);
+
+                for (size_t column = 0; column < width; column += column_tile_width)
+                {
+                    const MultiplyUIntModOperand *r = roots;
+                    size_t gap = (height >> 1) * width;
+                    for (size_t m = 1; m < height; m <<= 1, gap >>= 1)
+                    {
+                        uint64_t *x = values + column;
+                        for (size_t i = 0; i < m; i++, x += gap << 1)
+                        {
+                            MultiplyUIntModOperand root = *++r;
+                            for (uint64_t *row = x; row != x + gap; row += width)
+                            {
+                                forward_stage_avx512(
+                                    row, row + gap, column_tile_width, 1, 0, root, mul, two_times_modulus);
+                            }
+                        }
+                    }
+                }
+            }
+
+            template <typename Multiplier>
+            SEAL_TARGET_AVX512 inline void transform_columns_from_rev_avx512(
+                uint64_t *values, int log_height, size_t width, const MultiplyUIntModOperand *roots,
+                const MultiplyUIntModOperand &scalar, const Modulus &modulus, const Multiplier &mul)
+            {
+                size_t height = size_t(1) << log_height;
+                const __m512i two_times_modulus = _mm512_add_epi64(mul.modulus, mul.modulus);
+                MultiplyUIntModOperand scaled_r;
+                scaled_r.set(multiply_uint_mod(roots[height - 1].operand, scalar, modulus), modulus);
+
+                for (size_t column = 0; column < width; column += column_tile_width)
+                {
+                    const MultiplyUIntModOperand *r = roots;
+                    size_t gap = width;
+                    for (size_t m = height >> 1; m > 1; m >>= 1, gap <<= 1)
+                    {
+                        uint64_t *x = values + column;
+                        for (size_t i = 0; i < m; i++, x += gap << 1)
+                        {
+                            MultiplyUIntModOperand root = *++r;
+                            for (uint64_t *row = x; row != x + gap; row += width)
+                            {
+                                inverse_stage_avx512(
+                                    row, row + gap, column_tile_width, 1, 0, root, mul, two_times_modulus);
+                            }
+                        }
+                    }
+
+                    // Last stage merges the multiplication with scalar
+                    uint64_t *x = values + column;
+                    for (uint64_t *row = x; row != x + gap; row += width)
+                    {
+                        inverse_last_stage_avx512(
+                            row, row + gap, column_tile_width, 1, 0, scaled_r, scalar, mul, two_times_modulus);
+                    }
+                }
+            }
+        } // namespace
+
+        /*
+        The kernels multiply by roots with Shoup's method on 32-bit words for moduli of at most
+        SEAL_SMALL_MOD_BIT_COUNT_MAX bits, and on 64-bit words otherwise.
+        */
+
+        SEAL_TARGET_AVX512 void ntt_transform_to_rev_avx512(
+            uint64_t *values, size_t batch_size, size_t batch_stride, int log_n, const MultiplyUIntModOperand *roots,
+            const Modulus &modulus)
+        {
+            static_assert(
+                sizeof(MultiplyUIntModOperand) == 2 * sizeof(uint64_t), "MultiplyUIntModOperand must be packed");
+
+            if (modulus.bit_count() <= SEAL_SMALL_MOD_BIT_COUNT_MAX)
+            {
+                transform_to_rev_avx512(
+                    values, batch_size, batch_stride, log_n, roots, modulus,
+                    make_small_word_multiplier_avx512(modulus));
+            }
+            else
+            {
+                transform_to_rev_avx512(
+                    values, batch_size, batch_stride, log_n, roots, modulus, make_shoup_multiplier_avx512(modulus));
+            }
+        }
+
+        SEAL_TARGET_AVX512 void ntt_transform_from_rev_avx512(
+            uint64_t *values, size_t batch_size, size_t batch_stride, int log_n, const MultiplyUIntModOperand *roots,
+            const MultiplyUIntModOperand *scalar, const Modulus &modulus)
+        {
+            if (modulus.bit_count() <= SEAL_SMALL_MOD_BIT_COUNT_MAX)
+            {
+                transform_from_rev_avx512(
+                    values, batch_size, batch_stride, log_n, roots, scalar, modulus,
+                    make_small_word_multiplier_avx512(modulus));
+            }
+            else
+            {
+                transform_from_rev_avx512(
+                    values, batch_size, batch_stride, log_n, roots, scalar, modulus,
+                    make_shoup_multiplier_avx512(modulus));
+            }
+        }
+
+        SEAL_TARGET_AVX512 void ntt_transform_columns_to_rev_avx512(
+            uint64_t *values, int log_height, size_t width, const MultiplyUIntModOperand *roots, const Modulus &modulus)
+        {
+            if (modulus.bit_count() <= SEAL_SMALL_MOD_BIT_COUNT_MAX)
+            {
+                transform_columns_to_rev_avx512(
+                    values, log_height, width, roots, modulus, make_small_word_multiplier_avx512(modulus));
+            }
+            else
+            {
+                transform_columns_to_rev_avx512(
+                    values, log_height, width, roots, modulus, make_shoup_multiplier_avx512(modulus));
+            }
+        }
+
+        SEAL_TARGET_AVX512 void ntt_transform_columns_from_rev_avx512(
+            uint64_t *values, int log_height, size_t width, const MultiplyUIntModOperand *roots,
+            const MultiplyUIntModOperand &scalar, const Modulus &modulus)
+        {
+            if (modulus.bit_count() <= SEAL_SMALL_MOD_BIT_COUNT_MAX)
+            {
+                transform_columns_from_rev_avx512(
+                    values, log_height, width, roots, scalar, modulus, make_small_word_multiplier_avx512(modulus));
+            }
+            else
+            {
+                transform_columns_from_rev_avx512(
+                    values, log_height, width, roots, scalar, modulus, make_shoup_multiplier_avx512(modulus));
+            }
+        }
+    } // namespace util
+} // namespace seal
+
+#endif
@@ -2,8 +2,10 @@
 // Licensed under the MIT license.
 
 #include "seal/util/polyarithsmallmod.h"
+#include "seal/util/globals.h"
 #include "seal/util/uintarith.h"
 #include "seal/util/uintcore.h"
+#include <algorithm>
 
 #ifdef SEAL_USE_INTEL_HEXL
 #include "hexl/hexl.hpp"
@@ -35,6 +37,21 @@ namespace seal
 #ifdef SEAL_USE_INTEL_HEXL
             intel::hexl::EltwiseReduceMod(result, poly, coeff_count, modulus.value(), modulus.value(), 1);
 #else
+            switch (global_variables::simd_level)
+            {
+#ifdef SEAL_USE_AVX512
+            case simd_level_type::avx512:
+                modulo_poly_coeffs_avx512(poly, coeff_count, modulus, result);
+                return;
+#endif
+#ifdef SEAL_USE_AVX2
+            case simd_level_type::avx2:
+                modulo_poly_coeffs_avx2(poly, coeff_count, modulus, result);
+                return;
+#endif
+            default:
+                break;
+            }
             SEAL_ITERATE(
                 iter(poly, result), coeff_count, [&](auto I) { get<1>(I) = barrett_reduce_64(get<0>(I), modulus); });
 #endif
@@ -216,6 +233,21 @@ namespace seal
 #ifdef SEAL_USE_INTEL_HEXL
             intel::hexl::EltwiseFMAMod(&result[0], &poly[0], scalar.operand, nullptr, coeff_count, modulus.value(), 8);
 #else
+            switch (global_variables::simd_level)
+            {
+#ifdef SEAL_USE_AVX512
+            case simd_level_type::avx512:
+                multiply_poly_scalar_coeffmod_avx512(poly, coeff_count, scalar, modulus, result);
+                return;
+#endif
+#ifdef SEAL_USE_AVX2
+            case simd_level_type::avx2:
+                multiply_poly_scalar_coeffmod_avx2(poly, coeff_count, scalar, modulus, result);
+                return;
+#endif
+            default:
+                break;
+            }
             SEAL_ITERATE(iter(poly, result), coeff_count, [&](auto I) {
                 const uint64_t x = get<0>(I);
                 get<1>(I) = multiply_uint_mod(x, scalar, modulus);
@@ -252,6 +284,22 @@ namespace seal
 #ifdef SEAL_USE_INTEL_HEXL
             intel::hexl::EltwiseMultMod(&result[0], &operand1[0], &operand2[0], coeff_count, modulus.value(), 4);
 #else
+            switch (global_variables::simd_level)
+            {
+#ifdef SEAL_USE_AVX512
+            case simd_level_type::avx512:
+                dyadic_product_coeffmod_avx512(operand1, operand2, coeff_count, modulus, result);
+                return;
+#endif
+#ifdef SEAL_USE_AVX2
+            case simd_level_type::avx2:
+                dyadic_product_coeffmod_avx2(operand1, operand2, coeff_count, modulus, result);
+                return;
+#endif
+            default:
+                break;
+            }
+
             const uint64_t modulus_value = modulus.value();
             const uint64_t const_ratio_0 = modulus.const_ratio()[0];
             const uint64_t const_ratio_1 = modulus.const_ratio()[1];
@@ -283,6 +331,171 @@ namespace seal
 #endif
         }
 
+        void dyadic_product_montgomery_coeffmod(
+            ConstCoeffIter operand1, ConstCoeffIter operand2, size_t coeff_count, const Modulus &modulus,
+            CoeffIter result)
+        {
+#ifdef SEAL_DEBUG
+            if (!operand1)
+            {
+                throw invalid_argument("operand1");
+            }
+            if (!operand2)
+            {
+                throw invalid_argument("operand2");
+            }
+            if (!result)
+            {
+                throw invalid_argument("result");
+            }
+            if (coeff_count == 0)
+            {
+                throw invalid_argument("coeff_count");
+            }
+            if (!modulus.montgomery_inv())
+            {
+                throw invalid_argument("modulus");
+            }
+#endif
+            switch (global_variables::simd_level)
+            {
+#ifdef SEAL_USE_AVX512
+            case simd_level_type::avx512:
+                dyadic_product_montgomery_coeffmod_avx512(operand1, operand2, coeff_count, modulus, result);
+                return;
+#endif
+#ifdef SEAL_USE_AVX2
+            case simd_level_type::avx2:
+                dyadic_product_montgomery_coeffmod_avx2(operand1, operand2, coeff_count, modulus, result);
+                return;
+#endif
+            default:
+                break;
+            }
+
+            const uint64_t modulus_value = modulus.value();
+            const uint64_t montgomery_inv = modulus.montgomery_inv();
+
+            SEAL_ITERATE(iter(operand1, operand2, result), coeff_count, [&](auto I) {
+                // Reduces z using base 2^64 Montgomery reduction
+                unsigned long long z[2], tmp;
+                multiply_uint64(get<0>(I), get<1>(I), z);
+                multiply_uint64_hw64(z[0] * montgomery_inv, modulus_value, &tmp);
+                uint64_t diff = z[1] - tmp;
+                get<2>(I) = SEAL_COND_SELECT(z[1] < tmp, diff + modulus_value, diff);
+            });
+        }
+
+        void multiply_accumulate_poly_scalar_coeffmod(
+            ConstRNSIter poly_array, ConstCoeffIter scalars, size_t count, const Modulus &modulus, CoeffIter result)
+        {
+#ifdef SEAL_DEBUG
+            if (!poly_array && count > 0)
+            {
+                throw invalid_argument("poly_array");
+            }
+            if (!scalars && count > 0)
+            {
+                throw invalid_argument("scalars");
+            }
+            if (!result)
+            {
+                throw invalid_argument("result");
+            }
+            if (modulus.is_zero())
+            {
+                throw invalid_argument("modulus");
+            }
+#endif
+            switch (global_variables::simd_level)
+            {
+#ifdef SEAL_USE_AVX512
+            case simd_level_type::avx512:
+                multiply_accumulate_poly_scalar_coeffmod_avx512(poly_array, scalars, count, modulus, result);
+                return;
+#endif
+#ifdef SEAL_USE_AVX2
+            case simd_level_type::avx2:
+                multiply_accumulate_poly_scalar_coeffmod_avx2(poly_array, scalars, count, modulus, result);
+                return;
+#endif
+            default:
+                break;
+            }
+
+            size_t coeff_count = poly_array.poly_modulus_degree();
+            SEAL_ITERATE(iter(result, size_t(0)), coeff_count, [&](auto I) {
+                // Accumulate the products of the coefficients at index get<1>(I)
+                unsigned long long accumulator[2]{ 0, 0 };
+                unsigned long long qword[2];
+                SEAL_ITERATE(iter(poly_array, scalars, size_t(0)), count, [&](auto J) {
+                    if (get<2>(J) && !(get<2>(J) % SEAL_MULTIPLY_ACCUMULATE_MOD_MAX))
+                    {
+                        // Fold the accumulator before it can overflow
+                        accumulator[0] = barrett_reduce_128(accumulator, modulus);
+                        accumulator[1] = 0;
+                    }
+                    multiply_uint64(get<0>(J)[get<1>(I)], get<1>(J), qword);
+                    add_uint128(qword, accumulator, accumulator);
+                });
+                get<0>(I) = barrett_reduce_128(accumulator, modulus);
+            });
+        }
+
+        void dyadic_product_accumulate_coeffmod(
+            const ConstCoeffIter *operand1, const ConstCoeffIter *operand2, size_t count, size_t coeff_count,
+            const Modulus &modulus, CoeffIter result)
+        {
+#ifdef SEAL_DEBUG
+            if ((!operand1 || !operand2) && count > 0)
+            {
+                throw invalid_argument("operand");
+            }
+            if (!result)
+            {
+                throw invalid_argument("result");
+            }
+            if (modulus.is_zero())
+            {
+                throw invalid_argument("modulus");
+            }
+#endif
+            // Process the coefficients in blocks so that every operand is read in long contiguous runs while the
+            // 128-bit accumulators stay in the L1 cache
+            constexpr size_t block_size = 512;
+            unsigned long long accumulator[block_size][2];
+            for (size_t begin = 0; begin < coeff_count; begin += block_size)
+            {
+                size_t block_count = min(block_size, coeff_count - begin);
+                fill_n(&accumulator[0][0], 2 * block_count, 0ULL);
+                for (size_t j = 0; j < count; j++)
+                {
+                    if (j && !(j % SEAL_MULTIPLY_ACCUMULATE_MOD_MAX))
+                    {
+                        // Fold the accumulators before they can overflow
+                        for (size_t i = 0; i < block_count; i++)
+                        {
+                            accumulator[i][0] = barrett_reduce_128(accumulator[i], modulus);
+                            accumulator[i][1] = 0;
+                        }
+                    }
+                    const uint64_t *op1 = operand1[j].ptr() + begin;
+                    const uint64_t *op2 = operand2[j].ptr() + begin;
+                    for (size_t i = 0; i < block_count; i++)
+                    {
+                        unsigned long long qword[2];
+                        multiply_uint64(op1[i], op2[i], qword);
+                        accumulator[i][0] += qword[0];
+                        accumulator[i][1] += qword[1] + (accumulator[i][0] < qword[0]);
+                    }
+                }
+                for (size_t i = 0; i < block_count; i++)
+                {
+                    result[begin + i] = barrett_reduce_128(accumulator[i], modulus);
+                }
+            }
+        }
+
         uint64_t poly_infty_norm_coeffmod(ConstCoeffIter operand, size_t coeff_count, const Modulus &modulus)
         {
 #ifdef SEAL_DEBUG
@@ -571,6 +571,139 @@ namespace seal
             });
         }
 
+        /**
+        Converts the coefficients of poly to Montgomery form (see to_montgomery). Since the NTT, additions and
+        products with operands in normal form are linear, polynomials in Montgomery form pass through them unchanged.
+        Correctness: modulus must be odd.
+        */
+        inline void to_montgomery_poly_coeffmod(
+            ConstCoeffIter poly, std::size_t coeff_count, const Modulus &modulus, CoeffIter result)
+        {
+            MultiplyUIntModOperand factor;
+            factor.set(to_montgomery(1, modulus), modulus);
+            multiply_poly_scalar_coeffmod(poly, coeff_count, factor, modulus, result);
+        }
+
+        inline void to_montgomery_poly_coeffmod(
+            ConstRNSIter poly, std::size_t coeff_modulus_size, ConstModulusIter modulus, RNSIter result)
+        {
+#ifdef SEAL_DEBUG
+            if (!poly && coeff_modulus_size > 0)
+            {
+                throw std::invalid_argument("poly");
+            }
+            if (!result && coeff_modulus_size > 0)
+            {
+                throw std::invalid_argument("result");
+            }
+            if (!modulus && coeff_modulus_size > 0)
+            {
+                throw std::invalid_argument("modulus");
+            }
+            if (poly.poly_modulus_degree() != result.poly_modulus_degree())
+            {
+                throw std::invalid_argument("incompatible iterators");
+            }
+#endif
+            auto poly_modulus_degree = result.poly_modulus_degree();
+            SEAL_ITERATE(iter(poly, modulus, result), coeff_modulus_size, [&](auto I) {
+                to_montgomery_poly_coeffmod(get<0>(I), poly_modulus_degree, get<1>(I), get<2>(I));
+            });
+        }
+
+        inline void to_montgomery_poly_coeffmod(
+            ConstPolyIter poly_array, std::size_t size, ConstModulusIter modulus, PolyIter result)
+        {
+#ifdef SEAL_DEBUG
+            if (!poly_array && size > 0)
+            {
+                throw std::invalid_argument("poly_array");
+            }
+            if (!result && size > 0)
+            {
+                throw std::invalid_argument("result");
+            }
+            if (!modulus && size > 0)
+            {
+                throw std::invalid_argument("modulus");
+            }
+            if (poly_array.coeff_modulus_size() != result.coeff_modulus_size())
+            {
+                throw std::invalid_argument("incompatible iterators");
+            }
+#endif
+            auto coeff_modulus_size = result.coeff_modulus_size();
+            SEAL_ITERATE(iter(poly_array, result), size, [&](auto I) {
+                to_montgomery_poly_coeffmod(get<0>(I), coeff_modulus_size, modulus, get<1>(I));
+            });
+        }
+
+        /**
+        Computes the dyadic product of operand1 and operand2 mod modulus, where operand2 is in Montgomery form, using
+        Montgomery reduction in place of the Barrett reduction of dyadic_product_coeffmod. The result is in the form
+        of operand1; converting operand2 once pays off when it takes part in several products.
+        Correctness: modulus must be odd, and the coefficients of operand2 must be less than modulus. The
+        coefficients of operand1 may be any 64-bit integers.
+        */
+        void dyadic_product_montgomery_coeffmod(
+            ConstCoeffIter operand1, ConstCoeffIter operand2, std::size_t coeff_count, const Modulus &modulus,
+            CoeffIter result);
+
+        inline void dyadic_product_montgomery_coeffmod(
+            ConstRNSIter operand1, ConstRNSIter operand2, std::size_t coeff_modulus_size, ConstModulusIter modulus,
+            RNSIter result)
+        {
+#ifdef SEAL_DEBUG
+            if (!operand1 && coeff_modulus_size > 0)
+            {
+                throw std::invalid_argument("operand1");
+            }
+            if (!operand2 && coeff_modulus_size > 0)
+            {
+                throw std::invalid_argument("operand2");
+            }
+            if (!result && coeff_modulus_size > 0)
+            {
+                throw std::invalid_argument("result");
+            }
+            if (!modulus && coeff_modulus_size > 0)
+            {
+                throw std::invalid_argument("modulus");
+            }
+            if (operand1.poly_modulus_degree() != result.poly_modulus_degree() ||
+                operand2.poly_modulus_degree() != result.poly_modulus_degree())
+            {
+                throw std::invalid_argument("incompatible iterators");
+            }
+#endif
+            auto poly_modulus_degree = result.poly_modulus_degree();
+            SEAL_ITERATE(iter(operand1, operand2, modulus, result), coeff_modulus_size, [&](auto I) {
+                dyadic_product_montgomery_coeffmod(get<0>(I), get<1>(I), poly_modulus_degree, get<2>(I), get<3>(I));
+            });
+        }
+
+        /**
+        Computes the sum of poly_array[i] * scalars[i] mod modulus over the count polynomials in poly_array, each of
+        which has poly_array.poly_modulus_degree() coefficients. Products are accumulated without reduction as far as
+        possible (see dot_product_mod).
+        Correctness: Coefficients and scalars must be at most SEAL_MOD_BIT_COUNT_MAX bits, and result must not overlap
+        with poly_array.
+        */
+        void multiply_accumulate_poly_scalar_coeffmod(
+            ConstRNSIter poly_array, ConstCoeffIter scalars, std::size_t count, const Modulus &modulus,
+            CoeffIter result);
+
+        /**
+        Computes the sum of operand1[i] * operand2[i] mod modulus over the count pairs of polynomials in operand1 and
+        operand2, each of which has coeff_count coefficients. Products are accumulated without reduction as far as
+        possible (see dot_product_mod), so every coefficient is reduced only once.
+        Correctness: Coefficients must be at most SEAL_MOD_BIT_COUNT_MAX bits. The result may overlap with the
+        operands.
+        */
+        void dyadic_product_accumulate_coeffmod(
+            const ConstCoeffIter *operand1, const ConstCoeffIter *operand2, std::size_t count, std::size_t coeff_count,
+            const Modulus &modulus, CoeffIter result);
+
         std::uint64_t poly_infty_norm_coeffmod(ConstCoeffIter operand, std::size_t coeff_count, const Modulus &modulus);
 
         void negacyclic_shift_poly_coeffmod(
@@ -777,5 +910,55 @@ namespace seal
                     get<0>(I), coeff_modulus_size, mono_coeff, mono_exponent, modulus, get<1>(I), pool);
             });
         }
+
+#ifdef SEAL_USE_AVX2
+        /**
+        AVX2 implementations of the functions with the same name without suffix. They are selected at run time and
+        have identical inputs and outputs.
+        */
+        void modulo_poly_coeffs_avx2(
+            ConstCoeffIter poly, std::size_t coeff_count, const Modulus &modulus, CoeffIter result);
+
+        void multiply_poly_scalar_coeffmod_avx2(
+            ConstCoeffIter poly, std::size_t coeff_count, MultiplyUIntModOperand scalar, const Modulus &modulus,
+            CoeffIter result);
+
+        void dyadic_product_coeffmod_avx2(
+            ConstCoeffIter operand1, ConstCoeffIter operand2, std::size_t coeff_count, const Modulus &modulus,
+            CoeffIter result);
+
+        void dyadic_product_montgomery_coeffmod_avx2(
+            ConstCoeffIter operand1, ConstCoeffIter operand2, std::size_t coeff_count, const Modulus &modulus,
+            CoeffIter result);
+
+        void multiply_accumulate_poly_scalar_coeffmod_avx2(
+            ConstRNSIter poly_array, ConstCoeffIter scalars, std::size_t count, const Modulus &modulus,
+            CoeffIter result);
+#endif
+
+#ifdef SEAL_USE_AVX512
+        /**
+        AVX-512 implementations of the functions with the same name without suffix. They are selected at run time and
+        have identical inputs and outputs.
+        */
+        void modulo_poly_coeffs_avx512(
+            ConstCoeffIter poly, std::size_t coeff_count, const Modulus &modulus, CoeffIter result);
+
+        void multiply_poly_scalar_coeffmod_avx512(
+            ConstCoeffIter poly, std::size_t coeff_count, MultiplyUIntModOperand scalar, const Modulus &modulus,
+            CoeffIter result);
+
+        void dyadic_product_coeffmod_avx512(
+            ConstCoeffIter operand1, ConstCoeffIter operand2, std::size_t coeff_count, const Modulus &modulus,
+            CoeffIter result);
+
+        void dyadic_product_montgomery_coeffmod_avx512(
+            ConstCoeffIter operand1, ConstCoeffIter operand2, std::size_t coeff_count, const Modulus &modulus,
+            CoeffIter result);
+
+        void multiply_accumulate_poly_scalar_coeffmod_avx512(
+            ConstRNSIter poly_array, ConstCoeffIter scalars, std::size_t count, const Modulus &modulus,
+            CoeffIter result);
+#endif
     } // namespace util
 } // namespace seal
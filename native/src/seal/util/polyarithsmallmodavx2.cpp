@@ -0,0 +1,311 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/polyarithsmallmod.h"
+#include "seal/util/uintarith.h"
+
+#ifdef SEAL_USE_AVX2
+#include "seal/util/avx.h"
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            SEAL_TARGET_AVX2 inline __m256i load_avx2(const uint64_t *ptr)
+            {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+            }
+
+            SEAL_TARGET_AVX2 inline void store_avx2(uint64_t *ptr, __m256i x)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(ptr), x);
+            }
+
+            SEAL_TARGET_AVX2 inline __m256i set1_avx2(uint64_t x)
+            {
+                return _mm256_set1_epi64x(static_cast<long long>(x));
+            }
+
+            // Returns whether all values in x are less than 2^bit_count
+            SEAL_TARGET_AVX2 inline bool fits_in_bits_avx2(__m256i x, int bit_count)
+            {
+                return _mm256_testz_si256(x, _mm256_set1_epi64x(static_cast<long long>(~0ULL << bit_count)));
+            }
+
+            // Returns whether all values in x are less than 2^52 and can be converted to doubles
+            SEAL_TARGET_AVX2 inline bool fits_in_double_avx2(__m256i x)
+            {
+                return fits_in_bits_avx2(x, 52);
+            }
+        } // namespace
+
+        SEAL_TARGET_AVX2 void modulo_poly_coeffs_avx2(
+            ConstCoeffIter poly, size_t coeff_count, const Modulus &modulus, CoeffIter result)
+        {
+            const __m256i modulus_vec = set1_avx2(modulus.value());
+            const __m256i const_ratio_1 = set1_avx2(modulus.const_ratio()[1]);
+            const uint64_t *poly_ptr = poly.ptr();
+            uint64_t *result_ptr = result.ptr();
+
+            size_t i = 0;
+            for (; i + 4 <= coeff_count; i += 4)
+            {
+                store_avx2(result_ptr + i, barrett_reduce_64_avx2(load_avx2(poly_ptr + i), const_ratio_1, modulus_vec));
+            }
+            for (; i < coeff_count; i++)
+            {
+                result_ptr[i] = barrett_reduce_64(poly_ptr[i], modulus);
+            }
+        }
+
+        SEAL_TARGET_AVX2 void multiply_poly_scalar_coeffmod_avx2(
+            ConstCoeffIter poly, size_t coeff_count, MultiplyUIntModOperand scalar, const Modulus &modulus,
+            CoeffIter result)
+        {
+            const __m256i modulus_vec = set1_avx2(modulus.value());
+            const __m256i scalar_operand = set1_avx2(scalar.operand);
+            const __m256i scalar_quotient = set1_avx2(scalar.quotient);
+            const uint64_t *poly_ptr = poly.ptr();
+            uint64_t *result_ptr = result.ptr();
+
+            size_t i = 0;
+            if (modulus.bit_count() <= SEAL_SMALL_MOD_BIT_COUNT_MAX)
+            {
+                // Multiply 32-bit words until a vector holds a value of 2^32 or more
+                const __m256i scalar_quotient_32 = set1_avx2(scalar.quotient >> 32);
+                for (; i + 4 <= coeff_count; i += 4)
+                {
+                    __m256i x = load_avx2(poly_ptr + i);
+                    if (!fits_in_bits_avx2(x, 32))
+                    {
+                        break;
+                    }
+                    x = multiply_uint_mod_lazy_32_avx2(x, scalar_operand, scalar_quotient_32, modulus_vec);
+                    store_avx2(result_ptr + i, guard_avx2(x, modulus_vec));
+                }
+            }
+            else if (modulus.bit_count() <= SEAL_FMA_MOD_BIT_COUNT_MAX)
+            {
+                // Multiply in double precision until a vector holds a value of 2^52 or more; the rest of the values
+                // take the integer path below
+                const __m256d modulus_d = _mm256_set1_pd(static_cast<double>(modulus.value()));
+                const __m256d modulus_inv = _mm256_set1_pd(1.0 / static_cast<double>(modulus.value()));
+                const __m256d two_times_modulus_d = _mm256_add_pd(modulus_d, modulus_d);
+                const __m256d scalar_d = _mm256_set1_pd(static_cast<double>(scalar.operand));
+                for (; i + 4 <= coeff_count; i += 4)
+                {
+                    __m256i x = load_avx2(poly_ptr + i);
+                    if (!fits_in_double_avx2(x))
+                    {
+                        break;
+                    }
+                    store_avx2(
+                        result_ptr + i, double_to_uint52_avx2(multiply_double_mod_avx2(
+                                            uint52_to_double_avx2(x), scalar_d, modulus_d, modulus_inv,
+                                            two_times_modulus_d)));
+                }
+            }
+            for (; i + 4 <= coeff_count; i += 4)
+            {
+                __m256i x = multiply_uint_mod_lazy_avx2(
+                    load_avx2(poly_ptr + i), scalar_operand, scalar_quotient, modulus_vec);
+                store_avx2(result_ptr + i, guard_avx2(x, modulus_vec));
+            }
+            for (; i < coeff_count; i++)
+            {
+                result_ptr[i] = multiply_uint_mod(poly_ptr[i], scalar, modulus);
+            }
+        }
+
+        SEAL_TARGET_AVX2 void dyadic_product_coeffmod_avx2(
+            ConstCoeffIter operand1, ConstCoeffIter operand2, size_t coeff_count, const Modulus &modulus,
+            CoeffIter result)
+        {
+            const __m256i modulus_vec = set1_avx2(modulus.value());
+            const __m256i const_ratio_0 = set1_avx2(modulus.const_ratio()[0]);
+            const __m256i const_ratio_1 = set1_avx2(modulus.const_ratio()[1]);
+            const uint64_t *operand1_ptr = operand1.ptr();
+            const uint64_t *operand2_ptr = operand2.ptr();
+            uint64_t *result_ptr = result.ptr();
+
+            size_t i = 0;
+            int bit_count = modulus.bit_count();
+            if (bit_count <= SEAL_SMALL_MOD_BIT_COUNT_MAX)
+            {
+                // Multiply 32-bit words until a vector holds a value of 2^bit_count or more
+                const __m128i shift = _mm_cvtsi32_si128(bit_count - 1);
+                const __m256i ratio = set1_avx2((uint64_t(1) << (2 * bit_count)) / modulus.value());
+                for (; i + 4 <= coeff_count; i += 4)
+                {
+                    __m256i x = load_avx2(operand1_ptr + i);
+                    __m256i y = load_avx2(operand2_ptr + i);
+                    if (!fits_in_bits_avx2(_mm256_or_si256(x, y), bit_count))
+                    {
+                        break;
+                    }
+                    store_avx2(result_ptr + i, multiply_uint_mod_32_avx2(x, y, shift, ratio, modulus_vec));
+                }
+            }
+            else if (bit_count <= SEAL_FMA_MOD_BIT_COUNT_MAX)
+            {
+                // Multiply in double precision until a vector holds a value of 2^52 or more; the rest of the values
+                // take the integer path below
+                const __m256d modulus_d = _mm256_set1_pd(static_cast<double>(modulus.value()));
+                const __m256d modulus_inv = _mm256_set1_pd(1.0 / static_cast<double>(modulus.value()));
+                const __m256d two_times_modulus_d = _mm256_add_pd(modulus_d, modulus_d);
+                for (; i + 4 <= coeff_count; i += 4)
+                {
+                    __m256i x = load_avx2(operand1_ptr + i);
+                    __m256i y = load_avx2(operand2_ptr + i);
+                    if (!fits_in_double_avx2(_mm256_or_si256(x, y)))
+                    {
+                        break;
+                    }
+
+                    // Only one factor needs to be reduced
+                    __m256d x_reduced = reduce_double_avx2(uint52_to_double_avx2(x), modulus_d, modulus_inv);
+                    store_avx2(
+                        result_ptr + i, double_to_uint52_avx2(multiply_double_mod_avx2(
+                                            uint52_to_double_avx2(y), x_reduced, modulus_d, modulus_inv,
+                                            two_times_modulus_d)));
+                }
+            }
+            for (; i + 4 <= coeff_count; i += 4)
+            {
+                __m256i z_hw64, z_lw64;
+                multiply_uint64_avx2(load_avx2(operand1_ptr + i), load_avx2(operand2_ptr + i), z_hw64, z_lw64);
+                store_avx2(
+                    result_ptr + i, barrett_reduce_128_avx2(z_hw64, z_lw64, const_ratio_0, const_ratio_1, modulus_vec));
+            }
+            for (; i < coeff_count; i++)
+            {
+                unsigned long long z[2];
+                multiply_uint64(operand1_ptr[i], operand2_ptr[i], z);
+                result_ptr[i] = barrett_reduce_128(z, modulus);
+            }
+        }
+
+        SEAL_TARGET_AVX2 void dyadic_product_montgomery_coeffmod_avx2(
+            ConstCoeffIter operand1, ConstCoeffIter operand2, size_t coeff_count, const Modulus &modulus,
+            CoeffIter result)
+        {
+            const __m256i modulus_vec = set1_avx2(modulus.value());
+            const __m256i montgomery_inv = set1_avx2(modulus.montgomery_inv());
+            const uint64_t *operand1_ptr = operand1.ptr();
+            const uint64_t *operand2_ptr = operand2.ptr();
+            uint64_t *result_ptr = result.ptr();
+
+            size_t i = 0;
+            for (; i + 4 <= coeff_count; i += 4)
+            {
+                __m256i z_hw64, z_lw64;
+                multiply_uint64_avx2(load_avx2(operand1_ptr + i), load_avx2(operand2_ptr + i), z_hw64, z_lw64);
+                store_avx2(result_ptr + i, montgomery_reduce_128_avx2(z_hw64, z_lw64, montgomery_inv, modulus_vec));
+            }
+            for (; i < coeff_count; i++)
+            {
+                result_ptr[i] = multiply_uint_mod_montgomery(operand1_ptr[i], operand2_ptr[i], modulus);
+            }
+        }
+
+        SEAL_TARGET_AVX2 void multiply_accumulate_poly_scalar_coeffmod_avx2(
+            ConstRNSIter poly_array, ConstCoeffIter scalars, size_t count, const Modulus &modulus, CoeffIter result)
+        {
+            const __m256i modulus_vec = set1_avx2(modulus.value());
+            const __m256i const_ratio_0 = set1_avx2(modulus.const_ratio()[0]);
+            const __m256i const_ratio_1 = set1_avx2(modulus.const_ratio()[1]);
+            const size_t coeff_count = poly_array.poly_modulus_degree();
+            const uint64_t *poly_array_ptr = *poly_array;
+            const uint64_t *scalars_ptr = scalars.ptr();
+            uint64_t *result_ptr = result.ptr();
+
+            size_t k = 0;
+            for (; k + 16 <= coeff_count; k += 16)
+            {
+                // Four independent accumulators hide the latency of the carry chain
+                __m256i acc_hw64[4], acc_lw64[4];
+                for (size_t j = 0; j < 4; j++)
+                {
+                    acc_hw64[j] = _mm256_setzero_si256();
+                    acc_lw64[j] = _mm256_setzero_si256();
+                }
+                const uint64_t *poly_ptr = poly_array_ptr + k;
+                for (size_t i = 0; i < count; i++, poly_ptr += coeff_count)
+                {
+                    if (i && !(i % SEAL_MULTIPLY_ACCUMULATE_MOD_MAX))
+                    {
+                        // Fold the accumulators before they can overflow
+                        for (size_t j = 0; j < 4; j++)
+                        {
+                            acc_lw64[j] = barrett_reduce_128_avx2(
+                                acc_hw64[j], acc_lw64[j], const_ratio_0, const_ratio_1, modulus_vec);
+                            acc_hw64[j] = _mm256_setzero_si256();
+                        }
+                    }
+                    __m256i y = set1_avx2(scalars_ptr[i]);
+                    for (size_t j = 0; j < 4; j++)
+                    {
+                        __m256i prod_hw64, prod_lw64;
+                        multiply_uint64_avx2(load_avx2(poly_ptr + 4 * j), y, prod_hw64, prod_lw64);
+                        acc_lw64[j] = _mm256_add_epi64(acc_lw64[j], prod_lw64);
+                        acc_hw64[j] = _mm256_sub_epi64(
+                            _mm256_add_epi64(acc_hw64[j], prod_hw64), cmplt_epu64_avx2(acc_lw64[j], prod_lw64));
+                    }
+                }
+                for (size_t j = 0; j < 4; j++)
+                {
+                    store_avx2(
+                        result_ptr + k + 4 * j,
+                        barrett_reduce_128_avx2(acc_hw64[j], acc_lw64[j], const_ratio_0, const_ratio_1, modulus_vec));
+                }
+            }
+            for (; k + 4 <= coeff_count; k += 4)
+            {
+                __m256i acc_hw64 = _mm256_setzero_si256();
+                __m256i acc_lw64 = _mm256_setzero_si256();
+                const uint64_t *poly_ptr = poly_array_ptr + k;
+                for (size_t i = 0; i < count; i++, poly_ptr += coeff_count)
+                {
+                    if (i && !(i % SEAL_MULTIPLY_ACCUMULATE_MOD_MAX))
+                    {
+                        // Fold the accumulator before it can overflow
+                        acc_lw64 =
+                            barrett_reduce_128_avx2(acc_hw64, acc_lw64, const_ratio_0, const_ratio_1, modulus_vec);
+                        acc_hw64 = _mm256_setzero_si256();
+                    }
+                    __m256i prod_hw64, prod_lw64;
+                    multiply_uint64_avx2(load_avx2(poly_ptr), set1_avx2(scalars_ptr[i]), prod_hw64, prod_lw64);
+                    acc_lw64 = _mm256_add_epi64(acc_lw64, prod_lw64);
+                    acc_hw64 = _mm256_sub_epi64(
+                        _mm256_add_epi64(acc_hw64, prod_hw64), cmplt_epu64_avx2(acc_lw64, prod_lw64));
+                }
+                store_avx2(
+                    result_ptr + k,
+                    barrett_reduce_128_avx2(acc_hw64, acc_lw64, const_ratio_0, const_ratio_1, modulus_vec));
+            }
+            for (; k < coeff_count; k++)
+            {
+                unsigned long long acc[2]{ 0, 0 };
+                unsigned long long prod[2];
+                const uint64_t *poly_ptr = poly_array_ptr + k;
+                for (size_t i = 0; i < count; i++, poly_ptr += coeff_count)
+                {
+                    if (i && !(i % SEAL_MULTIPLY_ACCUMULATE_MOD_MAX))
+                    {
+                        acc[0] = barrett_reduce_128(acc, modulus);
+                        acc[1] = 0;
+                    }
+                    multiply_uint64(*poly_ptr, scalars_ptr[i], prod);
+                    add_uint128(prod, acc, acc);
+                }
+                result_ptr[k] = barrett_reduce_128(acc, modulus);
+            }
+        }
+    } // namespace util
+} // namespace seal
+
+#endif
@@ -0,0 +1,291 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/polyarithsmallmod.h"
+#include "seal/util/uintarith.h"
+
+#ifdef SEAL_USE_AVX512
+#include "seal/util/avx.h"
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            SEAL_TARGET_AVX512 inline __m512i load_avx512(const uint64_t *ptr)
+            {
+                return _mm512_loadu_si512(ptr);
+            }
+
+            SEAL_TARGET_AVX512 inline void store_avx512(uint64_t *ptr, __m512i x)
+            {
+                _mm512_storeu_si512(ptr, x);
+            }
+
+            SEAL_TARGET_AVX512 inline __m512i set1_avx512(uint64_t x)
+            {
+                return _mm512_set1_epi64(static_cast<long long>(x));
+            }
+
+            // Returns whether all values in x are less than 2^bit_count
+            SEAL_TARGET_AVX512 inline bool fits_in_bits_avx512(__m512i x, int bit_count)
+            {
+                return !_mm512_test_epi64_mask(x, set1_avx512(~0ULL << bit_count));
+            }
+        } // namespace
+
+        SEAL_TARGET_AVX512 void modulo_poly_coeffs_avx512(
+            ConstCoeffIter poly, size_t coeff_count, const Modulus &modulus, CoeffIter result)
+        {
+            const __m512i modulus_vec = set1_avx512(modulus.value());
+            const __m512i const_ratio_1 = set1_avx512(modulus.const_ratio()[1]);
+            const uint64_t *poly_ptr = poly.ptr();
+            uint64_t *result_ptr = result.ptr();
+
+            size_t i = 0;
+            for (; i + 8 <= coeff_count; i += 8)
+            {
+                store_avx512(
+                    result_ptr + i, barrett_reduce_64_avx512(load_avx512(poly_ptr + i), const_ratio_1, modulus_vec));
+            }
+            for (; i < coeff_count; i++)
+            {
+                result_ptr[i] = barrett_reduce_64(poly_ptr[i], modulus);
+            }
+        }
+
+        SEAL_TARGET_AVX512 void multiply_poly_scalar_coeffmod_avx512(
+            ConstCoeffIter poly, size_t coeff_count, MultiplyUIntModOperand scalar, const Modulus &modulus,
+            CoeffIter result)
+        {
+            const __m512i modulus_vec = set1_avx512(modulus.value());
+            const __m512i scalar_operand = set1_avx512(scalar.operand);
+            const __m512i scalar_quotient = set1_avx512(scalar.quotient);
+            const uint64_t *poly_ptr = poly.ptr();
+            uint64_t *result_ptr = result.ptr();
+
+            size_t i = 0;
+            if (modulus.bit_count() <= SEAL_SMALL_MOD_BIT_COUNT_MAX)
+            {
+                // Multiply 32-bit words until a vector holds a value of 2^32 or more; the rest of the values take the
+                // 64-bit path below
+                const __m512i scalar_quotient_32 = set1_avx512(scalar.quotient >> 32);
+                for (; i + 8 <= coeff_count; i += 8)
+                {
+                    __m512i x = load_avx512(poly_ptr + i);
+                    if (!fits_in_bits_avx512(x, 32))
+                    {
+                        break;
+                    }
+                    x = multiply_uint_mod_lazy_32_avx512(x, scalar_operand, scalar_quotient_32, modulus_vec);
+                    store_avx512(result_ptr + i, guard_avx512(x, modulus_vec));
+                }
+            }
+            for (; i + 8 <= coeff_count; i += 8)
+            {
+                __m512i x = multiply_uint_mod_lazy_avx512(
+                    load_avx512(poly_ptr + i), scalar_operand, scalar_quotient, modulus_vec);
+                store_avx512(result_ptr + i, guard_avx512(x, modulus_vec));
+            }
+            for (; i < coeff_count; i++)
+            {
+                result_ptr[i] = multiply_uint_mod(poly_ptr[i], scalar, modulus);
+            }
+        }
+
+        SEAL_TARGET_AVX512 void dyadic_product_coeffmod_avx512(
+            ConstCoeffIter operand1, ConstCoeffIter operand2, size_t coeff_count, const Modulus &modulus,
+            CoeffIter result)
+        {
+            const __m512i modulus_vec = set1_avx512(modulus.value());
+            const __m512i const_ratio_0 = set1_avx512(modulus.const_ratio()[0]);
+            const __m512i const_ratio_1 = set1_avx512(modulus.const_ratio()[1]);
+            const uint64_t *operand1_ptr = operand1.ptr();
+            const uint64_t *operand2_ptr = operand2.ptr();
+            uint64_t *result_ptr = result.ptr();
+
+            size_t i = 0;
+            int bit_count = modulus.bit_count();
+            if (bit_count <= SEAL_SMALL_MOD_BIT_COUNT_MAX)
+            {
+                // Multiply 32-bit words until a vector holds a value of 2^bit_count or more; the rest of the values
+                // take the 64-bit path below
+                const __m128i shift = _mm_cvtsi32_si128(bit_count - 1);
+                const __m512i ratio = set1_avx512((uint64_t(1) << (2 * bit_count)) / modulus.value());
+                for (; i + 8 <= coeff_count; i += 8)
+                {
+                    __m512i x = load_avx512(operand1_ptr + i);
+                    __m512i y = load_avx512(operand2_ptr + i);
+                    if (!fits_in_bits_avx512(_mm512_or_si512(x, y), bit_count))
+                    {
+                        break;
+                    }
+                    store_avx512(result_ptr + i, multiply_uint_mod_32_avx512(x, y, shift, ratio, modulus_vec));
+                }
+            }
+            for (; i + 8 <= coeff_count; i += 8)
+            {
+                __m512i x = load_avx512(operand1_ptr + i);
+                __m512i y = load_avx512(operand2_ptr + i);
+                __m512i z_hw64 = multiply_uint64_hw64_avx512(x, y);
+                __m512i z_lw64 = _mm512_mullo_epi64(x, y);
+                store_avx512(
+                    result_ptr + i,
+                    barrett_reduce_128_avx512(z_hw64, z_lw64, const_ratio_0, const_ratio_1, modulus_vec));
+            }
+            for (; i < coeff_count; i++)
+            {
+                unsigned long long z[2];
+                multiply_uint64(operand1_ptr[i], operand2_ptr[i], z);
+                result_ptr[i] = barrett_reduce_128(z, modulus);
+            }
+        }
+
+        SEAL_TARGET_AVX512 void dyadic_product_montgomery_coeffmod_avx512(
+            ConstCoeffIter operand1, ConstCoeffIter operand2, size_t coeff_count, const Modulus &modulus,
+            CoeffIter result)
+        {
+            const __m512i modulus_vec = set1_avx512(modulus.value());
+            const __m512i montgomery_inv = set1_avx512(modulus.montgomery_inv());
+            const uint64_t *operand1_ptr = operand1.ptr();
+            const uint64_t *operand2_ptr = operand2.ptr();
+            uint64_t *result_ptr = result.ptr();
+
+            size_t i = 0;
+            int bit_count = modulus.bit_count();
+            if (bit_count <= SEAL_SMALL_MOD_BIT_COUNT_MAX)
+            {
+                // Multiply 32-bit words until a vector holds a value of 2^bit_count or more; the rest of the values
+                // take the 64-bit path below
+                const __m128i shift = _mm_cvtsi32_si128(bit_count - 1);
+                const __m512i ratio = set1_avx512((uint64_t(1) << (2 * bit_count)) / modulus.value());
+                for (; i + 8 <= coeff_count; i += 8)
+                {
+                    __m512i x = load_avx512(operand1_ptr + i);
+                    __m512i y = load_avx512(operand2_ptr + i);
+                    if (!fits_in_bits_avx512(_mm512_or_si512(x, y), bit_count))
+                    {
+                        break;
+                    }
+                    store_avx512(result_ptr + i, multiply_uint_mod_32_avx512(x, y, shift, ratio, modulus_vec));
+                }
+            }
+            for (; i + 8 <= coeff_count; i += 8)
+            {
+                __m512i x = load_avx512(operand1_ptr + i);
+                __m512i y = load_avx512(operand2_ptr + i);
+                __m512i z_hw64 = multiply_uint64_hw64_avx512(x, y);
+                __m512i z_lw64 = _mm512_mullo_epi64(x, y);
+                store_avx512(
+                    result_ptr + i, montgomery_reduce_128_avx512(z_hw64, z_lw64, montgomery_inv, modulus_vec));
+            }
+            for (; i < coeff_count; i++)
+            {
+                result_ptr[i] = multiply_uint_mod_montgomery(operand1_ptr[i], operand2_ptr[i], modulus);
+            }
+        }
+
+        SEAL_TARGET_AVX512 void multiply_accumulate_poly_scalar_coeffmod_avx512(
+            ConstRNSIter poly_array, ConstCoeffIter scalars, size_t count, const Modulus &modulus, CoeffIter result)
+        {
+            const __m512i modulus_vec = set1_avx512(modulus.value());
+            const __m512i const_ratio_0 = set1_avx512(modulus.const_ratio()[0]);
+            const __m512i const_ratio_1 = set1_avx512(modulus.const_ratio()[1]);
+            const __m512i one = set1_avx512(1);
+            const size_t coeff_count = poly_array.poly_modulus_degree();
+            const uint64_t *poly_array_ptr = *poly_array;
+            const uint64_t *scalars_ptr = scalars.ptr();
+            uint64_t *result_ptr = result.ptr();
+
+            size_t k = 0;
+            for (; k + 32 <= coeff_count; k += 32)
+            {
+                // Four independent accumulators hide the latency of the carry chain
+                __m512i acc_hw64[4], acc_lw64[4];
+                for (size_t j = 0; j < 4; j++)
+                {
+                    acc_hw64[j] = _mm512_setzero_si512();
+                    acc_lw64[j] = _mm512_setzero_si512();
+                }
+                const uint64_t *poly_ptr = poly_array_ptr + k;
+                for (size_t i = 0; i < count; i++, poly_ptr += coeff_count)
+                {
+                    if (i && !(i % SEAL_MULTIPLY_ACCUMULATE_MOD_MAX))
+                    {
+                        // Fold the accumulators before they can overflow
+                        for (size_t j = 0; j < 4; j++)
+                        {
+                            acc_lw64[j] = barrett_reduce_128_avx512(
+                                acc_hw64[j], acc_lw64[j], const_ratio_0, const_ratio_1, modulus_vec);
+                            acc_hw64[j] = _mm512_setzero_si512();
+                        }
+                    }
+                    __m512i y = set1_avx512(scalars_ptr[i]);
+                    for (size_t j = 0; j < 4; j++)
+                    {
+                        __m512i x = load_avx512(poly_ptr + 8 * j);
+                        __m512i prod_lw64 = _mm512_mullo_epi64(x, y);
+                        acc_hw64[j] = _mm512_add_epi64(acc_hw64[j], multiply_uint64_hw64_avx512(x, y));
+                        acc_lw64[j] = _mm512_add_epi64(acc_lw64[j], prod_lw64);
+                        acc_hw64[j] = _mm512_mask_add_epi64(
+                            acc_hw64[j], _mm512_cmplt_epu64_mask(acc_lw64[j], prod_lw64), acc_hw64[j], one);
+                    }
+                }
+                for (size_t j = 0; j < 4; j++)
+                {
+                    store_avx512(
+                        result_ptr + k + 8 * j,
+                        barrett_reduce_128_avx512(acc_hw64[j], acc_lw64[j], const_ratio_0, const_ratio_1, modulus_vec));
+                }
+            }
+            for (; k + 8 <= coeff_count; k += 8)
+            {
+                __m512i acc_hw64 = _mm512_setzero_si512();
+                __m512i acc_lw64 = _mm512_setzero_si512();
+                const uint64_t *poly_ptr = poly_array_ptr + k;
+                for (size_t i = 0; i < count; i++, poly_ptr += coeff_count)
+                {
+                    if (i && !(i % SEAL_MULTIPLY_ACCUMULATE_MOD_MAX))
+                    {
+                        // Fold the accumulator before it can overflow
+                        acc_lw64 =
+                            barrett_reduce_128_avx512(acc_hw64, acc_lw64, const_ratio_0, const_ratio_1, modulus_vec);
+                        acc_hw64 = _mm512_setzero_si512();
+                    }
+                    __m512i x = load_avx512(poly_ptr);
+                    __m512i y = set1_avx512(scalars_ptr[i]);
+                    __m512i prod_lw64 = _mm512_mullo_epi64(x, y);
+                    acc_hw64 = _mm512_add_epi64(acc_hw64, multiply_uint64_hw64_avx512(x, y));
+                    acc_lw64 = _mm512_add_epi64(acc_lw64, prod_lw64);
+                    acc_hw64 = _mm512_mask_add_epi64(
+                        acc_hw64, _mm512_cmplt_epu64_mask(acc_lw64, prod_lw64), acc_hw64, one);
+                }
+                store_avx512(
+                    result_ptr + k,
+                    barrett_reduce_128_avx512(acc_hw64, acc_lw64, const_ratio_0, const_ratio_1, modulus_vec));
+            }
+            for (; k < coeff_count; k++)
+            {
+                unsigned long long acc[2]{ 0, 0 };
+                unsigned long long prod[2];
+                const uint64_t *poly_ptr = poly_array_ptr + k;
+                for (size_t i = 0; i < count; i++, poly_ptr += coeff_count)
+                {
+                    if (i && !(i % SEAL_MULTIPLY_ACCUMULATE_MOD_MAX))
+                    {
+                        acc[0] = barrett_reduce_128(acc, modulus);
+                        acc[1] = 0;
+                    }
+                    multiply_uint64(*poly_ptr, scalars_ptr[i], prod);
+                    add_uint128(prod, acc, acc);
+                }
+                result_ptr[k] = barrett_reduce_128(acc, modulus);
+            }
+        }
+    } // namespace util
+} // namespace seal
+
+#endif
@@ -15,6 +15,13 @@ namespace seal
 {
     namespace util
     {
+        namespace
+        {
+            // Size of the block of scaled input coefficients in BaseConverter::fast_convert_array; it should fit in
+            // the L1 data cache together with the corresponding output coefficients
+            constexpr size_t fast_convert_block_byte_count = size_t(16) * 1024;
+        } // namespace
+
         RNSBase::RNSBase(const vector<Modulus> &rnsbase, MemoryPoolHandle pool)
             : pool_(move(pool)), size_(rnsbase.size())
         {
@@ -427,39 +434,40 @@ namespace seal
             size_t obase_size = obase_.size();
             size_t count = in.poly_modulus_degree();
 
-            // Note that the stride size is ibase_size
-            SEAL_ALLOCATE_GET_STRIDE_ITER(temp, uint64_t, count, ibase_size, pool);
+            // The conversion multiplies the base change matrix with the matrix of scaled input coefficients. It is
+            // computed in blocks of coefficients so that each scaled block stays in the L1 cache while all obase
+            // elements are accumulated from it, instead of streaming the whole scaled input once per obase element.
+            size_t block_size = max<size_t>(fast_convert_block_byte_count / (ibase_size * sizeof(uint64_t)), 1);
+            block_size = min(block_size, count);
+            SEAL_ALLOCATE_GET_COEFF_ITER(temp, mul_safe(block_size, ibase_size), pool);
 
-            SEAL_ITERATE(
-                iter(in, ibase_.inv_punctured_prod_mod_base_array(), ibase_.base(), size_t(0)), ibase_size,
-                [&](auto I) {
-                    // The current ibase index
-                    size_t ibase_index = get<3>(I);
+            for (size_t block_start = 0; block_start < count; block_start += block_size)
+            {
+                size_t current_block_size = min(block_size, count - block_start);
+                RNSIter temp_block(temp, current_block_size);
 
-                    if (get<1>(I).operand == 1)
-                    {
-                        // No multiplication needed
-                        SEAL_ITERATE(iter(get<0>(I), temp), count, [&](auto J) {
-                            // Reduce modulo ibase element
-                            get<1>(J)[ibase_index] = barrett_reduce_64(get<0>(J), get<2>(I));
-                        });
-                    }
-                    else
-                    {
-                        // Multiplication needed
-                        SEAL_ITERATE(iter(get<0>(I), temp), count, [&](auto J) {
-                            // Multiply coefficient of in with ibase_.inv_punctured_prod_mod_base_array_ element
-                            get<1>(J)[ibase_index] = multiply_uint_mod(get<0>(J), get<1>(I), get<2>(I));
-                        });
-                    }
-                });
+                SEAL_ITERATE(
+                    iter(in, ibase_.inv_punctured_prod_mod_base_array(), ibase_.base(), temp_block), ibase_size,
+                    [&](auto I) {
+                        if (get<1>(I).operand == 1)
+                        {
+                            // No multiplication needed; reduce modulo ibase element
+                            modulo_poly_coeffs(get<0>(I) + block_start, current_block_size, get<2>(I), get<3>(I));
+                        }
+                        else
+                        {
+                            // Multiply coefficients of in with ibase_.inv_punctured_prod_mod_base_array_ element
+                            multiply_poly_scalar_coeffmod(
+                                get<0>(I) + block_start, current_block_size, get<1>(I), get<2>(I), get<3>(I));
+                        }
+                    });
 
-            SEAL_ITERATE(iter(out, base_change_matrix_, obase_.base()), obase_size, [&](auto I) {
-                SEAL_ITERATE(iter(get<0>(I), temp), count, [&](auto J) {
-                    // Compute the base conversion sum modulo obase element
-                    get<0>(J) = dot_product_mod(get<1>(J), get<1>(I).get(), ibase_size, get<2>(I));
+                SEAL_ITERATE(iter(out, base_change_matrix_, obase_.base()), obase_size, [&](auto I) {
+                    // Compute the base conversion sums modulo obase element
+                    multiply_accumulate_poly_scalar_coeffmod(
+                        temp_block, get<1>(I).get(), ibase_size, get<2>(I), get<0>(I) + block_start);
                 });
-            });
+            }
         }
 
         // See "An Improved RNS Variant of the BFV Homomorphic Encryption Scheme" (CT-RSA 2019) for details
@@ -538,6 +546,48 @@ namespace seal
             });
         }
 
+        void BaseConverter::exact_convert_array(ConstRNSIter in, RNSIter out, MemoryPoolHandle pool) const
+        {
+#ifdef SEAL_DEBUG
+            if (in.poly_modulus_degree() != out.poly_modulus_degree())
+            {
+                throw invalid_argument("in and out are incompatible");
+            }
+#endif
+            size_t ibase_size = ibase_.size();
+            size_t obase_size = obase_.size();
+            size_t count = in.poly_modulus_degree();
+
+            SEAL_ALLOCATE_GET_RNS_ITER(temp, count, ibase_size, pool);
+
+            // The sum of [x_{i} * \hat{q_{i}}^(-1)]_{q_{i}} / q_{i}, whose rounding is the number of multiples of
+            // prod(ibase) in the fast base conversion of the centered input
+            SEAL_ALLOCATE_GET_PTR_ITER(v, double, count, pool);
+            fill_n(v, count, 0.0);
+
+            SEAL_ITERATE(
+                iter(in, ibase_.inv_punctured_prod_mod_base_array(), ibase_.base(), temp), ibase_size, [&](auto I) {
+                    multiply_poly_scalar_coeffmod(get<0>(I), count, get<1>(I), get<2>(I), get<3>(I));
+                    double inv_divisor = 1.0 / static_cast<double>(get<2>(I).value());
+                    SEAL_ITERATE(iter(get<3>(I), v), count, [&](auto J) {
+                        get<1>(J) += static_cast<double>(get<0>(J)) * inv_divisor;
+                    });
+                });
+
+            SEAL_ITERATE(iter(out, base_change_matrix_, obase_.base()), obase_size, [&](auto I) {
+                // Compute the base conversion sums modulo obase element
+                multiply_accumulate_poly_scalar_coeffmod(temp, get<1>(I).get(), ibase_size, get<2>(I), get<0>(I));
+
+                // Subtract the rounded v times [prod(ibase)]_{p}
+                MultiplyUIntModOperand prod_mod_p;
+                prod_mod_p.set(modulo_uint(ibase_.base_prod(), ibase_size, get<2>(I)), get<2>(I));
+                SEAL_ITERATE(iter(get<0>(I), v), count, [&](auto J) {
+                    uint64_t rounded_v = static_cast<uint64_t>(get<1>(J) + 0.5);
+                    get<0>(J) = sub_uint_mod(get<0>(J), multiply_uint_mod(rounded_v, prod_mod_p, get<2>(I)), get<2>(I));
+                });
+            });
+        }
+
         void BaseConverter::initialize()
         {
             // Verify that the size is not too large
@@ -563,7 +613,7 @@ namespace seal
 
         RNSTool::RNSTool(
             size_t poly_modulus_degree, const RNSBase &coeff_modulus, const Modulus &plain_modulus,
-            MemoryPoolHandle pool)
+            MemoryPoolHandle pool, bool hps)
             : pool_(move(pool))
         {
 #ifdef SEAL_DEBUG
@@ -573,6 +623,10 @@ namespace seal
             }
 #endif
             initialize(poly_modulus_degree, coeff_modulus, plain_modulus);
+            if (hps)
+            {
+                initialize_hps();
+            }
         }
 
         void RNSTool::initialize(size_t poly_modulus_degree, const RNSBase &q, const Modulus &t)
@@ -786,6 +840,89 @@ namespace seal
             }
         }
 
+        // See "An Improved RNS Variant of the BFV Homomorphic Encryption Scheme" (CT-RSA 2019) and "Revisiting
+        // Homomorphic Encryption Schemes for Finite Fields" (ASIACRYPT 2021) for details
+        void RNSTool::initialize_hps()
+        {
+            if (t_.is_zero())
+            {
+                throw logic_error("HPS multiplication requires a plain modulus");
+            }
+
+            size_t base_q_size = base_q_->size();
+            int coeff_count_power = get_power_of_two(coeff_count_);
+
+            // The scaled product round(t/q * x) must be less than P/2 in absolute value. The product x of two
+            // ciphertext polynomials with centered coefficients is bounded by K * n * q^2 / 4, where K takes into
+            // account cross terms when larger size ciphertexts are used. As for the base B of BEHZ, we reserve 32 bits
+            // for K * n. All primes in P are SEAL_INTERNAL_MOD_BIT_COUNT (61) bits, so larger than 2^60.
+            int total_coeff_bit_count = get_significant_bit_count_uint(base_q_->base_prod(), base_q_size);
+            size_t base_P_size = safe_cast<size_t>(
+                (32 + t_.bit_count() + total_coeff_bit_count + SEAL_INTERNAL_MOD_BIT_COUNT - 2) /
+                (SEAL_INTERNAL_MOD_BIT_COUNT - 1));
+            size_t base_qP_size = add_safe(base_q_size, base_P_size);
+
+            // Size check
+            if (!product_fits_in(coeff_count_, base_qP_size))
+            {
+                throw logic_error("invalid parameters");
+            }
+
+            // The primes of P are larger than those of q, so the bases are coprime
+            base_P_ = allocate<RNSBase>(
+                pool_, get_primes(mul_safe(size_t(2), coeff_count_), SEAL_INTERNAL_MOD_BIT_COUNT, base_P_size), pool_);
+            base_qP_ = allocate<RNSBase>(pool_, base_q_->extend(*base_P_));
+
+            try
+            {
+                CreateNTTTables(
+                    coeff_count_power, vector<Modulus>(base_qP_->base(), base_qP_->base() + base_qP_size),
+                    base_qP_ntt_tables_, pool_);
+            }
+            catch (const logic_error &)
+            {
+                throw logic_error("invalid rns bases");
+            }
+
+            base_q_to_P_conv_ = allocate<BaseConverter>(pool_, *base_q_, *base_P_, pool_);
+            base_P_to_q_conv_ = allocate<BaseConverter>(pool_, *base_P_, *base_q_, pool_);
+
+            // Compute t * (prod(q) / q[i])^(-1) mod q[i]
+            t_inv_punctured_prod_q_mod_q_ = allocate<MultiplyUIntModOperand>(base_q_size, pool_);
+            SEAL_ITERATE(
+                iter(t_inv_punctured_prod_q_mod_q_, base_q_->inv_punctured_prod_mod_base_array(), base_q_->base()),
+                base_q_size, [&](auto I) {
+                    get<0>(I).set(
+                        multiply_uint_mod(barrett_reduce_64(t_.value(), get<2>(I)), get<1>(I), get<2>(I)), get<2>(I));
+                });
+
+            // Compute -q[i]^(-1) mod P[j]
+            neg_inv_q_mod_P_ = allocate_uint(mul_safe(base_P_size, base_q_size), pool_);
+            uint64_t temp;
+            for (size_t j = 0; j < base_P_size; j++)
+            {
+                for (size_t i = 0; i < base_q_size; i++)
+                {
+                    if (!try_invert_uint_mod((*base_q_)[i].value(), (*base_P_)[j], temp))
+                    {
+                        throw logic_error("invalid rns bases");
+                    }
+                    neg_inv_q_mod_P_[j * base_q_size + i] = negate_uint_mod(temp, (*base_P_)[j]);
+                }
+            }
+
+            // Compute t * prod(q)^(-1) mod P[j]
+            t_inv_prod_q_mod_P_ = allocate<MultiplyUIntModOperand>(base_P_size, pool_);
+            SEAL_ITERATE(iter(t_inv_prod_q_mod_P_, base_P_->base()), base_P_size, [&](auto I) {
+                temp = modulo_uint(base_q_->base_prod(), base_q_size, get<1>(I));
+                if (!try_invert_uint_mod(temp, get<1>(I), temp))
+                {
+                    throw logic_error("invalid rns bases");
+                }
+                get<0>(I).set(multiply_uint_mod(temp, barrett_reduce_64(t_.value(), get<1>(I)), get<1>(I)), get<1>(I));
+            });
+        }
+
         void RNSTool::divide_and_round_q_last_inplace(RNSIter input, MemoryPoolHandle pool) const
         {
 #ifdef SEAL_DEBUG
@@ -859,44 +996,48 @@ namespace seal
             uint64_t half = last_modulus.value() >> 1;
             add_poly_scalar_coeffmod(last_input, coeff_count_, half, last_modulus, last_input);
 
-            SEAL_ALLOCATE_GET_COEFF_ITER(temp, coeff_count_, pool);
-            SEAL_ITERATE(iter(input, inv_q_last_mod_q_, base_q_->base(), rns_ntt_tables), base_q_size - 1, [&](auto I) {
+            // Reduce the last component modulo every other modulus and transform all of them to NTT form together
+            SEAL_ALLOCATE_GET_RNS_ITER(temp, coeff_count_, base_q_size - 1, pool);
+            SEAL_ITERATE(iter(temp, base_q_->base()), base_q_size - 1, [&](auto I) {
                 // (ct mod qk) mod qi
-                if (get<2>(I).value() < last_modulus.value())
+                if (get<1>(I).value() < last_modulus.value())
                 {
-                    modulo_poly_coeffs(last_input, coeff_count_, get<2>(I), temp);
+                    modulo_poly_coeffs(last_input, coeff_count_, get<1>(I), get<0>(I));
                 }
                 else
                 {
-                    set_uint(last_input, coeff_count_, temp);
+                    set_uint(last_input, coeff_count_, get<0>(I));
                 }
 
                 // Lazy subtraction here. ntt_negacyclic_harvey_lazy can take 0 < x < 4*qi input.
-                uint64_t neg_half_mod = get<2>(I).value() - barrett_reduce_64(half, get<2>(I));
+                uint64_t neg_half_mod = get<1>(I).value() - barrett_reduce_64(half, get<1>(I));
 
                 // Note: lambda function parameter must be passed by reference here
-                SEAL_ITERATE(temp, coeff_count_, [&](auto &J) { J += neg_half_mod; });
+                SEAL_ITERATE(get<0>(I), coeff_count_, [&](auto &J) { J += neg_half_mod; });
+            });
+            ntt_negacyclic_harvey_lazy(temp, base_q_size - 1, rns_ntt_tables);
+
+            SEAL_ITERATE(iter(input, temp, inv_q_last_mod_q_, base_q_->base()), base_q_size - 1, [&](auto I) {
 #if SEAL_USER_MOD_BIT_COUNT_MAX <= 60
                 // Since SEAL uses at most 60-bit moduli, 8*qi < 2^63.
-                // This ntt_negacyclic_harvey_lazy results in [0, 4*qi).
-                uint64_t qi_lazy = get<2>(I).value() << 2;
-                ntt_negacyclic_harvey_lazy(temp, get<3>(I));
+                // The ntt_negacyclic_harvey_lazy above results in [0, 4*qi).
+                uint64_t qi_lazy = get<3>(I).value() << 2;
 #else
                 // 2^60 < pi < 2^62, then 4*pi < 2^64, we perfrom one reduction from [0, 4*qi) to [0, 2*qi) after ntt.
-                uint64_t qi_lazy = get<2>(I).value() << 1;
-                ntt_negacyclic_harvey_lazy(temp, get<3>(I));
+                uint64_t qi_lazy = get<3>(I).value() << 1;
 
                 // Note: lambda function parameter must be passed by reference here
-                SEAL_ITERATE(temp, coeff_count_, [&](auto &J) {
+                SEAL_ITERATE(get<1>(I), coeff_count_, [&](auto &J) {
                     J -= (qi_lazy & static_cast<uint64_t>(-static_cast<int64_t>(J >= qi_lazy)));
                 });
 #endif
                 // Lazy subtraction again, results in [0, 2*qi_lazy),
                 // The reduction [0, 2*qi_lazy) -> [0, qi) is done implicitly in multiply_poly_scalar_coeffmod.
-                SEAL_ITERATE(iter(get<0>(I), temp), coeff_count_, [&](auto J) { get<0>(J) += qi_lazy - get<1>(J); });
+                SEAL_ITERATE(
+                    iter(get<0>(I), get<1>(I)), coeff_count_, [&](auto J) { get<0>(J) += qi_lazy - get<1>(J); });
 
                 // qk^(-1) * ((ct mod qi) - (ct mod qk)) mod qi
-                multiply_poly_scalar_coeffmod(get<0>(I), coeff_count_, get<1>(I), get<2>(I), get<0>(I));
+                multiply_poly_scalar_coeffmod(get<0>(I), coeff_count_, get<2>(I), get<3>(I), get<0>(I));
             });
         }
 
@@ -1038,6 +1179,81 @@ namespace seal
                 });
         }
 
+        void RNSTool::hps_extend(ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const
+        {
+#ifdef SEAL_DEBUG
+            if (!input)
+            {
+                throw invalid_argument("input cannot be null");
+            }
+            if (!destination)
+            {
+                throw invalid_argument("destination cannot be null");
+            }
+            if (!base_P_)
+            {
+                throw logic_error("HPS multiplication is not enabled");
+            }
+#endif
+            base_q_to_P_conv_->exact_convert_array(input, destination, pool);
+        }
+
+        void RNSTool::hps_scale_and_round(ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const
+        {
+#ifdef SEAL_DEBUG
+            if (!input)
+            {
+                throw invalid_argument("input cannot be null");
+            }
+            if (!destination)
+            {
+                throw invalid_argument("destination cannot be null");
+            }
+            if (!base_P_)
+            {
+                throw logic_error("HPS multiplication is not enabled");
+            }
+#endif
+            size_t base_q_size = base_q_->size();
+            size_t base_P_size = base_P_->size();
+
+            // Write x for the input, with x[i] its residues modulo q[i]. Then t/q * x equals, up to multiples of tP,
+            // the sum of x[i] * t * (prod(q) / q[i])^(-1) * P / q[i] and an integer multiple of P[j] for each j.
+            // Let r[i] = [x[i] * t * (prod(q) / q[i])^(-1)]_{q[i]}; modulo P[j] the integer part of the sum over i is
+            // -sum(r[i] * q[i]^(-1)), the fractional part is that of sum(r[i] / q[i]), and the remaining term is
+            // [x]_{P[j]} * t * prod(q)^(-1).
+            SEAL_ALLOCATE_GET_RNS_ITER(temp_q, coeff_count_, base_q_size, pool);
+            SEAL_ALLOCATE_GET_PTR_ITER(v, double, coeff_count_, pool);
+            fill_n(v, coeff_count_, 0.0);
+            SEAL_ITERATE(
+                iter(input, t_inv_punctured_prod_q_mod_q_, base_q_->base(), temp_q), base_q_size, [&](auto I) {
+                    double inv_divisor = 1.0 / static_cast<double>(get<2>(I).value());
+                    SEAL_ITERATE(iter(get<0>(I), get<3>(I), v), coeff_count_, [&](auto J) {
+                        get<1>(J) = multiply_uint_mod(get<0>(J), get<1>(I), get<2>(I));
+                        get<2>(J) += static_cast<double>(get<1>(J)) * inv_divisor;
+                    });
+                });
+
+            // Compute round(t/q * x) in base P
+            SEAL_ALLOCATE_GET_RNS_ITER(temp_P, coeff_count_, base_P_size, pool);
+            ConstRNSIter input_P = input + base_q_size;
+            SEAL_ITERATE(
+                iter(temp_P, input_P, t_inv_prod_q_mod_P_, base_P_->base(), size_t(0)), base_P_size, [&](auto I) {
+                    multiply_accumulate_poly_scalar_coeffmod(
+                        temp_q, neg_inv_q_mod_P_.get() + get<4>(I) * base_q_size, base_q_size, get<3>(I), get<0>(I));
+                    SEAL_ITERATE(iter(get<0>(I), get<1>(I), v), coeff_count_, [&](auto J) {
+                        // The rounded fractional part is at most base_q_size, so less than P[j]
+                        uint64_t rounded_v = static_cast<uint64_t>(get<2>(J) + 0.5);
+                        get<0>(J) = add_uint_mod(
+                            add_uint_mod(get<0>(J), rounded_v, get<3>(I)),
+                            multiply_uint_mod(get<1>(J), get<2>(I), get<3>(I)), get<3>(I));
+                    });
+                });
+
+            // Convert the centered result exactly to base q
+            base_P_to_q_conv_->exact_convert_array(temp_P, destination, pool);
+        }
+
         void RNSTool::fast_floor(ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const
         {
 #ifdef SEAL_DEBUG
@@ -1250,5 +1466,185 @@ namespace seal
             // Use exact base convension rather than convert the base through the compose API
             base_q_to_t_conv_->exact_convert_array(phase, destination, pool);
         }
+
+        KSwitchTool::KSwitchTool(
+            const RNSBase &base_q, const RNSBase &base_p, size_t digit_size, const Modulus &plain_modulus,
+            MemoryPoolHandle pool)
+            : pool_(move(pool)), digit_size_(digit_size), t_(plain_modulus)
+        {
+            if (!pool_)
+            {
+                throw invalid_argument("pool is uninitialized");
+            }
+            if (!digit_size_)
+            {
+                throw invalid_argument("digit_size cannot be zero");
+            }
+
+            base_q_ = allocate<RNSBase>(pool_, base_q, pool_);
+            base_p_ = allocate<RNSBase>(pool_, base_p, pool_);
+            size_t base_q_size = base_q.size();
+            size_t base_p_size = base_p.size();
+            digit_count_ = (base_q_size + digit_size_ - 1) / digit_size_;
+
+            // Digits with more than one prime need a base conversion to the other primes of q and to p
+            if (digit_size_ > 1)
+            {
+                for (size_t digit = 0; digit < digit_count_; digit++)
+                {
+                    size_t begin = digit * digit_size_;
+                    size_t end = min(begin + digit_size_, base_q_size);
+                    vector<Modulus> digit_moduli(base_q.base() + begin, base_q.base() + end);
+                    vector<Modulus> other_moduli(base_q.base(), base_q.base() + begin);
+                    other_moduli.insert(other_moduli.end(), base_q.base() + end, base_q.base() + base_q_size);
+                    other_moduli.insert(other_moduli.end(), base_p.base(), base_p.base() + base_p_size);
+                    digit_conv_.push_back(allocate<BaseConverter>(
+                        pool_, RNSBase(digit_moduli, pool_), RNSBase(other_moduli, pool_), pool_));
+                }
+            }
+
+            // Division by P converts the components modulo p to q, and to t if the plaintext must be preserved
+            vector<Modulus> q_moduli(base_q.base(), base_q.base() + base_q_size);
+            if (!t_.is_zero())
+            {
+                q_moduli.push_back(t_);
+            }
+            base_p_to_q_conv_ = allocate<BaseConverter>(pool_, base_p, RNSBase(q_moduli, pool_), pool_);
+
+            // Compute floor(P / 2)
+            auto half_p(allocate_uint(base_p_size, pool_));
+            right_shift_uint(base_p.base_prod(), 1, base_p_size, half_p.get());
+
+            // Compute P mod q[i], P^(-1) mod q[i], and floor(P / 2) mod q[i]
+            p_mod_q_ = allocate_uint(base_q_size, pool_);
+            inv_p_mod_q_ = allocate<MultiplyUIntModOperand>(base_q_size, pool_);
+            half_p_mod_q_ = allocate_uint(base_q_size, pool_);
+            SEAL_ITERATE(iter(p_mod_q_, inv_p_mod_q_, half_p_mod_q_, base_q.base()), base_q_size, [&](auto I) {
+                get<0>(I) = modulo_uint(base_p.base_prod(), base_p_size, get<3>(I));
+                uint64_t temp;
+                if (!try_invert_uint_mod(get<0>(I), get<3>(I), temp))
+                {
+                    throw logic_error("invalid rns bases");
+                }
+                get<1>(I).set(temp, get<3>(I));
+                get<2>(I) = modulo_uint(half_p.get(), base_p_size, get<3>(I));
+            });
+
+            // Compute floor(P / 2) mod p[i]
+            half_p_mod_p_ = allocate_uint(base_p_size, pool_);
+            SEAL_ITERATE(iter(half_p_mod_p_, base_p.base()), base_p_size, [&](auto I) {
+                get<0>(I) = modulo_uint(half_p.get(), base_p_size, get<1>(I));
+            });
+
+            if (!t_.is_zero())
+            {
+                // Compute -P^(-1) mod t
+                uint64_t temp;
+                if (!try_invert_uint_mod(modulo_uint(base_p.base_prod(), base_p_size, t_), t_, temp))
+                {
+                    throw logic_error("invalid rns bases");
+                }
+                neg_inv_p_mod_t_.set(negate_uint_mod(temp, t_), t_);
+            }
+        }
+
+        void KSwitchTool::mod_up(ConstRNSIter input, size_t digit, RNSIter destination, MemoryPoolHandle pool) const
+        {
+#ifdef SEAL_DEBUG
+            if (!input || !destination)
+            {
+                throw invalid_argument("input and destination cannot be null");
+            }
+            if (digit >= digit_count_)
+            {
+                throw out_of_range("digit");
+            }
+#endif
+            size_t coeff_count = input.poly_modulus_degree();
+            size_t base_q_size = base_q_->size();
+            size_t base_p_size = base_p_->size();
+            size_t begin = digit * digit_size_;
+            size_t end = min(begin + digit_size_, base_q_size);
+
+            // Copy the primes of the digit
+            set_uint(input[begin], (end - begin) * coeff_count, destination[begin]);
+
+            if (digit_size_ == 1)
+            {
+                // A single prime extends exactly by reduction
+                SEAL_ITERATE(iter(size_t(0)), base_q_size + base_p_size, [&](auto I) {
+                    if (I != begin)
+                    {
+                        const Modulus &modulus = (I < base_q_size) ? (*base_q_)[I] : (*base_p_)[I - base_q_size];
+                        modulo_poly_coeffs(input[begin], coeff_count, modulus, destination[I]);
+                    }
+                });
+                return;
+            }
+
+            // Convert to the other primes and scatter around the digit
+            size_t other_size = base_q_size + base_p_size - (end - begin);
+            SEAL_ALLOCATE_GET_RNS_ITER(temp, coeff_count, other_size, pool);
+            digit_conv_[digit]->fast_convert_array(input + begin, temp, pool);
+            set_uint(temp, begin * coeff_count, destination);
+            set_uint(temp[begin], (other_size - begin) * coeff_count, destination[end]);
+        }
+
+        void KSwitchTool::mod_down_delta(ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const
+        {
+#ifdef SEAL_DEBUG
+            if (!input || !destination)
+            {
+                throw invalid_argument("input and destination cannot be null");
+            }
+#endif
+            size_t coeff_count = input.poly_modulus_degree();
+            size_t base_q_size = base_q_->size();
+            size_t base_p_size = base_p_->size();
+
+            SEAL_ALLOCATE_GET_RNS_ITER(temp_p, coeff_count, base_p_size, pool);
+            if (t_.is_zero())
+            {
+                // Add floor(P / 2) to round instead of floor
+                SEAL_ITERATE(iter(input, half_p_mod_p_, base_p_->base(), temp_p), base_p_size, [&](auto I) {
+                    SEAL_ITERATE(iter(get<0>(I), get<3>(I)), coeff_count, [&](auto J) {
+                        get<1>(J) = add_uint_mod(get<0>(J), get<1>(I), get<2>(I));
+                    });
+                });
+            }
+            else
+            {
+                set_uint(input, base_p_size * coeff_count, temp_p);
+            }
+
+            size_t obase_size = base_p_to_q_conv_->obase_size();
+            SEAL_ALLOCATE_GET_RNS_ITER(temp, coeff_count, obase_size, pool);
+            base_p_to_q_conv_->fast_convert_array(temp_p, temp, pool);
+
+            if (t_.is_zero())
+            {
+                // delta = [c + floor(P / 2)]_P - floor(P / 2)
+                SEAL_ITERATE(iter(temp, half_p_mod_q_, base_q_->base(), destination), base_q_size, [&](auto I) {
+                    SEAL_ITERATE(iter(get<0>(I), get<3>(I)), coeff_count, [&](auto J) {
+                        get<1>(J) = sub_uint_mod(get<0>(J), get<1>(I), get<2>(I));
+                    });
+                });
+            }
+            else
+            {
+                // k = -[c]_P * P^(-1) mod t and delta = [c]_P + k * P, so that delta = 0 mod t
+                CoeffIter k(temp[base_q_size]);
+                multiply_poly_scalar_coeffmod(k, coeff_count, neg_inv_p_mod_t_, t_, k);
+                SEAL_ITERATE(iter(temp, p_mod_q_, base_q_->base(), destination), base_q_size, [&](auto I) {
+                    MultiplyUIntModOperand p_mod_qi;
+                    p_mod_qi.set(get<1>(I), get<2>(I));
+                    SEAL_ITERATE(iter(get<0>(I), k, get<3>(I)), coeff_count, [&](auto J) {
+                        uint64_t k_mod_qi = barrett_reduce_64(get<1>(J), get<2>(I));
+                        get<2>(J) =
+                            add_uint_mod(get<0>(J), multiply_uint_mod(k_mod_qi, p_mod_qi, get<2>(I)), get<2>(I));
+                    });
+                });
+            }
+        }
     } // namespace util
 } // namespace seal
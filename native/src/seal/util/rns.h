@@ -167,6 +167,11 @@ namespace seal
             // The exact base convertion function, only supports obase size of 1.
             void exact_convert_array(ConstRNSIter in, CoeffIter out, MemoryPoolHandle) const;
 
+            // Exact base conversion of the centered representatives of the input to any obase. The input must be
+            // less than the ibase primes in absolute value up to a small error, so that the number of multiples of
+            // prod(ibase) to subtract can be found by rounding a floating-point sum.
+            void exact_convert_array(ConstRNSIter in, RNSIter out, MemoryPoolHandle pool) const;
+
         private:
             BaseConverter(const BaseConverter &copy) = delete;
 
@@ -191,13 +196,14 @@ namespace seal
         {
         public:
             /**
+            @param[in] hps If true, also generates the pre-computations for HPS multiplication
             @throws std::invalid_argument if poly_modulus_degree is out of range, coeff_modulus is not valid, or pool is
             invalid.
             @throws std::logic_error if coeff_modulus and extended bases do not support NTT or are not coprime.
             */
             RNSTool(
                 std::size_t poly_modulus_degree, const RNSBase &coeff_modulus, const Modulus &plain_modulus,
-                MemoryPoolHandle pool);
+                MemoryPoolHandle pool, bool hps = false);
 
             /**
             @param[in] input Must be in RNS form, i.e. coefficient must be less than the associated modulus.
@@ -227,6 +233,16 @@ namespace seal
             */
             void fastbconv_m_tilde(ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const;
 
+            /**
+            Exact conversion of the centered representative from q to P (HPS)
+            */
+            void hps_extend(ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const;
+
+            /**
+            Compute round(t/q * input) from q U P to P, and convert it exactly to q (HPS)
+            */
+            void hps_scale_and_round(ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const;
+
             /**
             Compute round(t/q * |input|_q) mod t exactly
             */
@@ -253,11 +269,26 @@ namespace seal
                 return base_Bsk_ntt_tables_.get();
             }
 
+            SEAL_NODISCARD inline auto base_qP_ntt_tables() const noexcept
+            {
+                return base_qP_ntt_tables_.get();
+            }
+
             SEAL_NODISCARD inline auto base_q() const noexcept
             {
                 return base_q_.get();
             }
 
+            SEAL_NODISCARD inline auto base_P() const noexcept
+            {
+                return base_P_.get();
+            }
+
+            SEAL_NODISCARD inline auto base_qP() const noexcept
+            {
+                return base_qP_.get();
+            }
+
             SEAL_NODISCARD inline auto base_B() const noexcept
             {
                 return base_B_.get();
@@ -322,6 +353,11 @@ namespace seal
             */
             void initialize(std::size_t poly_modulus_degree, const RNSBase &q, const Modulus &t);
 
+            /**
+            Generates the pre-computations for HPS multiplication.
+            */
+            void initialize_hps();
+
             MemoryPoolHandle pool_;
 
             std::size_t coeff_count_ = 0;
@@ -387,6 +423,29 @@ namespace seal
             // NTTTables for Bsk
             Pointer<NTTTables> base_Bsk_ntt_tables_;
 
+            // HPS: the auxiliary base P and q U P
+            Pointer<RNSBase> base_P_;
+
+            Pointer<RNSBase> base_qP_;
+
+            // HPS: NTTTables for q U P
+            Pointer<NTTTables> base_qP_ntt_tables_;
+
+            // HPS: base converter q --> P
+            Pointer<BaseConverter> base_q_to_P_conv_;
+
+            // HPS: base converter P --> q
+            Pointer<BaseConverter> base_P_to_q_conv_;
+
+            // HPS: t * (prod(q) / q[i])^(-1) mod q[i]
+            Pointer<MultiplyUIntModOperand> t_inv_punctured_prod_q_mod_q_;
+
+            // HPS: -q[i]^(-1) mod P[j], stored row by row for each P[j]
+            Pointer<std::uint64_t> neg_inv_q_mod_P_;
+
+            // HPS: t * prod(q)^(-1) mod P
+            Pointer<MultiplyUIntModOperand> t_inv_prod_q_mod_P_;
+
             Modulus m_tilde_;
 
             Modulus m_sk_;
@@ -399,5 +458,119 @@ namespace seal
 
             std::uint64_t q_last_mod_t_ = 1;
         };
+
+        /**
+        Pre-computations for hybrid key switching at one level of the modulus switching chain. The primes q of the
+        level are split into digits of digit_size consecutive primes, and the special primes p form the special
+        modulus P. Key switching extends each digit to q and p (mod_up), multiplies with the key switching keys, and
+        divides the result by P (mod_down_delta).
+        */
+        class KSwitchTool
+        {
+        public:
+            /**
+            @param[in] base_q The primes at this level
+            @param[in] base_p The special primes
+            @param[in] digit_size The number of primes in a digit
+            @param[in] plain_modulus The plaintext modulus that division by P must preserve (BGV), or zero
+            @throws std::invalid_argument if digit_size is zero or pool is invalid
+            @throws std::logic_error if base_q and base_p are not coprime
+            */
+            KSwitchTool(
+                const RNSBase &base_q, const RNSBase &base_p, std::size_t digit_size, const Modulus &plain_modulus,
+                MemoryPoolHandle pool);
+
+            /**
+            Extends the digit with index digit from its primes to all primes of q and p. The input holds all primes
+            of q in coefficient form. The destination receives the primes of q followed by those of p; the primes of
+            the digit are copied from the input, and the others hold the digit plus a small multiple of the product
+            of its primes.
+            */
+            void mod_up(ConstRNSIter input, std::size_t digit, RNSIter destination, MemoryPoolHandle pool) const;
+
+            /**
+            Computes from the components modulo p of a value c (coefficient form) a value delta modulo q such that
+            c - delta is divisible by P. Without a plaintext modulus (c - delta) / P rounds c / P up to a small
+            error; with a plaintext modulus t, delta is also divisible by t instead.
+            */
+            void mod_down_delta(ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const;
+
+            SEAL_NODISCARD inline std::size_t digit_size() const noexcept
+            {
+                return digit_size_;
+            }
+
+            SEAL_NODISCARD inline std::size_t digit_count() const noexcept
+            {
+                return digit_count_;
+            }
+
+            SEAL_NODISCARD inline std::size_t special_prime_count() const noexcept
+            {
+                return base_p_->size();
+            }
+
+            SEAL_NODISCARD inline auto base_q() const noexcept
+            {
+                return base_q_.get();
+            }
+
+            SEAL_NODISCARD inline auto base_p() const noexcept
+            {
+                return base_p_.get();
+            }
+
+            SEAL_NODISCARD inline auto p_mod_q() const noexcept
+            {
+                return p_mod_q_.get();
+            }
+
+            SEAL_NODISCARD inline auto inv_p_mod_q() const noexcept
+            {
+                return inv_p_mod_q_.get();
+            }
+
+        private:
+            KSwitchTool(const KSwitchTool &copy) = delete;
+
+            KSwitchTool(KSwitchTool &&source) = delete;
+
+            KSwitchTool &operator=(const KSwitchTool &assign) = delete;
+
+            KSwitchTool &operator=(KSwitchTool &&assign) = delete;
+
+            MemoryPoolHandle pool_;
+
+            Pointer<RNSBase> base_q_;
+
+            Pointer<RNSBase> base_p_;
+
+            std::size_t digit_size_ = 0;
+
+            std::size_t digit_count_ = 0;
+
+            // Base converters from each digit to the other primes of q and to p
+            std::vector<Pointer<BaseConverter>> digit_conv_;
+
+            // Base converter from p to q, extended by t if set
+            Pointer<BaseConverter> base_p_to_q_conv_;
+
+            // P mod q[i]
+            Pointer<std::uint64_t> p_mod_q_;
+
+            // P^(-1) mod q[i]
+            Pointer<MultiplyUIntModOperand> inv_p_mod_q_;
+
+            // floor(P / 2) mod q[i]
+            Pointer<std::uint64_t> half_p_mod_q_;
+
+            // floor(P / 2) mod p[i]
+            Pointer<std::uint64_t> half_p_mod_p_;
+
+            // -P^(-1) mod t
+            MultiplyUIntModOperand neg_inv_p_mod_t_;
+
+            Modulus t_;
+        };
     } // namespace util
 } // namespace seal
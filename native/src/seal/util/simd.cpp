@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/simd.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+#if defined(SEAL_USE_AVX2) || defined(SEAL_USE_AVX512)
+#if SEAL_COMPILER == SEAL_COMPILER_MSVC
+            // Checks CPUID and that the operating system saves the extended register state
+            bool cpu_supports(bool avx512) noexcept
+            {
+                int info[4];
+                __cpuid(info, 0);
+                if (info[0] < 7)
+                {
+                    return false;
+                }
+
+                // FMA, OSXSAVE, and AVX
+                __cpuid(info, 1);
+                if ((info[2] & (1 << 12)) == 0 || (info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+                {
+                    return false;
+                }
+
+                // YMM state, and for AVX-512 also opmask and ZMM state
+                unsigned long long xcr0 = _xgetbv(0);
+                unsigned long long state_mask = avx512 ? 0xE6ULL : 0x6ULL;
+                if ((xcr0 & state_mask) != state_mask)
+                {
+                    return false;
+                }
+
+                // AVX2, AVX-512F, and AVX-512DQ
+                __cpuidex(info, 7, 0);
+                unsigned feature_mask = avx512 ? ((1U << 16) | (1U << 17)) : (1U << 5);
+                return (static_cast<unsigned>(info[1]) & feature_mask) == feature_mask;
+            }
+#else
+            bool cpu_supports(bool avx512) noexcept
+            {
+                // This may run before static initializers of the runtime
+                __builtin_cpu_init();
+                if (avx512)
+                {
+                    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq");
+                }
+                return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            }
+#endif
+#endif
+        } // namespace
+
+        simd_level_type get_supported_simd_level() noexcept
+        {
+#ifdef SEAL_USE_AVX512
+            if (cpu_supports(true))
+            {
+                return simd_level_type::avx512;
+            }
+#endif
+#ifdef SEAL_USE_AVX2
+            if (cpu_supports(false))
+            {
+                return simd_level_type::avx2;
+            }
+#endif
+            return simd_level_type::none;
+        }
+
+        simd_level_type select_simd_level(const char *request, simd_level_type supported) noexcept
+        {
+            if (!request)
+            {
+                return supported;
+            }
+
+            simd_level_type requested;
+            if (!strcmp(request, "none"))
+            {
+                requested = simd_level_type::none;
+            }
+            else if (!strcmp(request, "avx2"))
+            {
+                requested = simd_level_type::avx2;
+            }
+            else if (!strcmp(request, "avx512"))
+            {
+                requested = simd_level_type::avx512;
+            }
+            else
+            {
+                return supported;
+            }
+
+            // A level above the supported one is never selected
+            return min(requested, supported);
+        }
+
+        simd_level_type select_simd_level_from_environment() noexcept
+        {
+#if SEAL_COMPILER == SEAL_COMPILER_MSVC
+#pragma warning(push)
+#pragma warning(disable : 4996)
+#endif
+            return select_simd_level(getenv("SEAL_SIMD_LEVEL"), get_supported_simd_level());
+#if SEAL_COMPILER == SEAL_COMPILER_MSVC
+#pragma warning(pop)
+#endif
+        }
+    } // namespace util
+} // namespace seal
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/util/defines.h"
+#include <cstdint>
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        Instruction set extensions for which specialized kernels exist. Each level implies all lower levels.
+        */
+        enum class simd_level_type : std::uint8_t
+        {
+            // Portable scalar kernels
+            none = 0,
+
+            // AVX2 and FMA kernels (4 lanes of 64-bit integers or doubles)
+            avx2 = 1,
+
+            // AVX-512F and AVX-512DQ kernels (8 lanes of 64-bit integers)
+            avx512 = 2
+        };
+
+        /**
+        Returns the highest SIMD level for which kernels are compiled into the library and that the running CPU and
+        operating system support.
+        */
+        SEAL_NODISCARD simd_level_type get_supported_simd_level() noexcept;
+
+        /**
+        Returns the SIMD level requested by a string ("none", "avx2", or "avx512") capped at the supported level. If the
+        string is null or not recognized, returns the supported level.
+
+        @param[in] request The requested SIMD level
+        @param[in] supported The highest supported SIMD level
+        */
+        SEAL_NODISCARD simd_level_type select_simd_level(const char *request, simd_level_type supported) noexcept;
+
+        /**
+        Returns the SIMD level selected when the library is loaded: the supported level, possibly lowered by the
+        environment variable SEAL_SIMD_LEVEL. This is useful for A/B benchmarking without rebuilding.
+        */
+        SEAL_NODISCARD simd_level_type select_simd_level_from_environment() noexcept;
+    } // namespace util
+} // namespace seal
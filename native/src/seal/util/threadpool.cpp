@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/threadpool.h"
+#include <stdexcept>
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        ThreadPool::ThreadPool(size_t thread_count)
+        {
+            if (!thread_count)
+            {
+                throw invalid_argument("thread_count must be positive");
+            }
+            workers_.reserve(thread_count - 1);
+            for (size_t i = 1; i < thread_count; i++)
+            {
+                workers_.emplace_back(&ThreadPool::worker_loop, this);
+            }
+        }
+
+        ThreadPool::~ThreadPool()
+        {
+            {
+                lock_guard<mutex> lock(mutex_);
+                stop_ = true;
+            }
+            loop_started_.notify_all();
+            for (auto &worker : workers_)
+            {
+                worker.join();
+            }
+        }
+
+        void ThreadPool::parallel_for(size_t count, const function<void(size_t)> &func)
+        {
+            bool expected = false;
+            if (count < 2 || workers_.empty() || !busy_.compare_exchange_strong(expected, true))
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    func(i);
+                }
+                return;
+            }
+
+            exception_ptr exception;
+            {
+                unique_lock<mutex> lock(mutex_);
+                func_ = &func;
+                count_ = count;
+                next_ = 0;
+                generation_++;
+                loop_started_.notify_all();
+
+                run_iterations(lock);
+                loop_finished_.wait(lock, [this] { return next_ >= count_ && !running_; });
+                func_ = nullptr;
+                exception = exception_;
+                exception_ = nullptr;
+            }
+            busy_ = false;
+
+            if (exception)
+            {
+                rethrow_exception(exception);
+            }
+        }
+
+        void ThreadPool::worker_loop()
+        {
+            size_t generation = 0;
+            unique_lock<mutex> lock(mutex_);
+            while (true)
+            {
+                loop_started_.wait(lock, [&] { return stop_ || generation_ != generation; });
+                if (stop_)
+                {
+                    return;
+                }
+                generation = generation_;
+                run_iterations(lock);
+            }
+        }
+
+        void ThreadPool::run_iterations(unique_lock<mutex> &lock)
+        {
+            while (next_ < count_)
+            {
+                size_t index = next_++;
+                running_++;
+                lock.unlock();
+                try
+                {
+                    (*func_)(index);
+                    lock.lock();
+                }
+                catch (...)
+                {
+                    lock.lock();
+                    if (!exception_)
+                    {
+                        exception_ = current_exception();
+                    }
+
+                    // Skip the remaining iterations
+                    next_ = count_;
+                }
+                running_--;
+            }
+            if (!running_)
+            {
+                loop_finished_.notify_all();
+            }
+        }
+    } // namespace util
+} // namespace seal
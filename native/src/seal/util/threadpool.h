@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/util/defines.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        A fixed set of worker threads that run the iterations of a loop in parallel. The thread calling parallel_for
+        takes part in the work, so a pool with thread_count threads starts thread_count - 1 workers.
+        */
+        class ThreadPool
+        {
+        public:
+            /**
+            Creates a thread pool.
+
+            @param[in] thread_count The number of threads running a loop, including the calling thread
+            @throws std::invalid_argument if thread_count is zero
+            */
+            explicit ThreadPool(std::size_t thread_count);
+
+            ~ThreadPool();
+
+            /**
+            Returns the number of threads running a loop, including the calling thread.
+            */
+            SEAL_NODISCARD inline std::size_t thread_count() const noexcept
+            {
+                return workers_.size() + 1;
+            }
+
+            /**
+            Calls func(i) for every i in [0, count) and returns when all calls have returned. Iterations may run in
+            any order and in parallel. If the pool is already running a loop, for example when parallel_for is called
+            from within func, the iterations run in order on the calling thread. If any call throws, the remaining
+            iterations may be skipped and the first exception is rethrown.
+
+            @param[in] count The number of iterations
+            @param[in] func The loop body
+            */
+            void parallel_for(std::size_t count, const std::function<void(std::size_t)> &func);
+
+        private:
+            ThreadPool(const ThreadPool &copy) = delete;
+
+            ThreadPool &operator=(const ThreadPool &assign) = delete;
+
+            void worker_loop();
+
+            // Runs iterations of the current loop until none are left; lock must hold mutex_
+            void run_iterations(std::unique_lock<std::mutex> &lock);
+
+            std::vector<std::thread> workers_;
+
+            // Set while a loop is running on this pool
+            std::atomic<bool> busy_{ false };
+
+            // Protects all members below
+            std::mutex mutex_;
+
+            std::condition_variable loop_started_;
+
+            std::condition_variable loop_finished_;
+
+            const std::function<void(std::size_t)> *func_ = nullptr;
+
+            std::size_t count_ = 0;
+
+            std::size_t next_ = 0;
+
+            std::size_t running_ = 0;
+
+            std::size_t generation_ = 0;
+
+            std::exception_ptr exception_;
+
+            bool stop_ = false;
+        };
+    } // namespace util
+} // namespace seal
@@ -325,6 +325,68 @@ namespace seal
             return y.operand * x - tmp1 * p;
         }
 
+        /**
+        Returns input * 2^(-64) mod modulus. This is Montgomery reduction with base 2^64.
+        Correctness: modulus must be odd, and input must be less than modulus * 2^64; this holds for the product of
+        any 64-bit integer and an integer less than modulus.
+        @param[in] input Should be at most 128-bit.
+        */
+        template <typename T, typename = std::enable_if_t<is_uint64_v<T>>>
+        SEAL_NODISCARD inline std::uint64_t montgomery_reduce_128(const T *input, const Modulus &modulus)
+        {
+#ifdef SEAL_DEBUG
+            if (!input)
+            {
+                throw std::invalid_argument("input");
+            }
+            if (!modulus.montgomery_inv())
+            {
+                throw std::invalid_argument("modulus");
+            }
+#endif
+            // The low words of input and m * modulus agree, so (input - m * modulus) / 2^64 is the difference of the
+            // high words, which lies in (-modulus, modulus)
+            unsigned long long tmp;
+            const std::uint64_t p = modulus.value();
+            std::uint64_t m = static_cast<std::uint64_t>(input[0]) * modulus.montgomery_inv();
+            multiply_uint64_hw64(m, p, &tmp);
+            std::uint64_t result = static_cast<std::uint64_t>(input[1]) - tmp;
+            return SEAL_COND_SELECT(static_cast<std::uint64_t>(input[1]) < tmp, result + p, result);
+        }
+
+        /**
+        Returns input * 2^64 mod modulus, the Montgomery form of input.
+        Correctness: modulus must be odd.
+        */
+        SEAL_NODISCARD inline std::uint64_t to_montgomery(std::uint64_t input, const Modulus &modulus)
+        {
+            std::uint64_t z[2]{ 0, input };
+            return barrett_reduce_128(z, modulus);
+        }
+
+        /**
+        Returns input * 2^(-64) mod modulus, the value of input given in Montgomery form.
+        Correctness: modulus must be odd.
+        */
+        SEAL_NODISCARD inline std::uint64_t from_montgomery(std::uint64_t input, const Modulus &modulus)
+        {
+            std::uint64_t z[2]{ input, 0 };
+            return montgomery_reduce_128(z, modulus);
+        }
+
+        /**
+        Returns x * y mod modulus, where y_montgomery is y in Montgomery form. If x is also in Montgomery form, the
+        result is x * y in Montgomery form.
+        Correctness: modulus must be odd, and y_montgomery must be less than modulus.
+        */
+        SEAL_NODISCARD inline std::uint64_t multiply_uint_mod_montgomery(
+            std::uint64_t x, std::uint64_t y_montgomery, const Modulus &modulus)
+        {
+            unsigned long long z[2];
+            multiply_uint64(x, y_montgomery, z);
+            return montgomery_reduce_128(z, modulus);
+        }
+
         /**
         Returns value[0] = value mod modulus.
         Correctness: Follows the condition of barrett_reduce_128.
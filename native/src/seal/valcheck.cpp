@@ -156,11 +156,14 @@ namespace seal
             return false;
         }
 
-        size_t decomp_mod_count = context.first_context_data()->parms().coeff_modulus().size();
+        // There is one key per digit of the key switching decomposition
+        auto first_context_data = context.first_context_data();
+        size_t digit_count = first_context_data->kswitch_tool() ? first_context_data->kswitch_tool()->digit_count()
+                                                                : first_context_data->parms().coeff_modulus().size();
         for (auto &a : in.data())
         {
             // Check that each highest level component has right size
-            if (a.size() && (a.size() != decomp_mod_count))
+            if (a.size() && (a.size() != digit_count))
             {
                 return false;
             }
@@ -414,6 +414,59 @@ namespace sealtest
         }
     }
 
+    TEST(ContextTest, KeySwitchingParameters)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        parms.set_poly_modulus_degree(4);
+        parms.set_coeff_modulus({ 41, 137, 193, 65537 });
+        {
+            SEALContext context(parms, true, sec_level_type::none);
+            ASSERT_TRUE(context.using_keyswitching());
+            ASSERT_FALSE(!!context.key_context_data()->kswitch_tool());
+            auto kswitch_tool = context.first_context_data()->kswitch_tool();
+            ASSERT_EQ(size_t(1), kswitch_tool->special_prime_count());
+            ASSERT_EQ(size_t(1), kswitch_tool->digit_size());
+            ASSERT_EQ(size_t(3), kswitch_tool->digit_count());
+            ASSERT_EQ(size_t(1), context.last_context_data()->kswitch_tool()->digit_count());
+        }
+
+        // The first level drops all special primes
+        parms.set_special_prime_count(2);
+        parms.set_decomposition_digit_count(1);
+        {
+            SEALContext context(parms, true, sec_level_type::none);
+            ASSERT_TRUE(context.parameters_set());
+            ASSERT_TRUE(context.using_keyswitching());
+            ASSERT_EQ(size_t(2), context.key_context_data()->chain_index());
+            ASSERT_EQ(5617ULL, *context.first_context_data()->total_coeff_modulus());
+            ASSERT_EQ(41ULL, *context.last_context_data()->total_coeff_modulus());
+            auto kswitch_tool = context.first_context_data()->kswitch_tool();
+            ASSERT_EQ(size_t(2), kswitch_tool->special_prime_count());
+            ASSERT_EQ(size_t(2), kswitch_tool->digit_size());
+            ASSERT_EQ(size_t(1), kswitch_tool->digit_count());
+            ASSERT_EQ(size_t(1), context.last_context_data()->kswitch_tool()->digit_count());
+        }
+
+        // Three digits of a single prime each
+        parms.set_special_prime_count(1);
+        parms.set_decomposition_digit_count(5);
+        {
+            SEALContext context(parms, true, sec_level_type::none);
+            ASSERT_EQ(size_t(1), context.first_context_data()->kswitch_tool()->digit_size());
+            ASSERT_EQ(size_t(3), context.first_context_data()->kswitch_tool()->digit_count());
+        }
+
+        // No primes left for the data levels
+        parms.set_special_prime_count(4);
+        {
+            SEALContext context(parms, true, sec_level_type::none);
+            ASSERT_FALSE(context.parameters_set());
+            ASSERT_EQ(
+                EncryptionParameterQualifiers::error_type::invalid_special_prime_count,
+                context.key_context_data()->qualifiers().parameter_error);
+        }
+    }
+
     TEST(EncryptionParameterQualifiersTest, BFVParameterError)
     {
         auto scheme = scheme_type::bfv;
@@ -147,6 +147,48 @@ namespace sealtest
             ASSERT_TRUE(parms.plain_modulus() == parms2.plain_modulus());
             ASSERT_TRUE(parms.poly_modulus_degree() == parms2.poly_modulus_degree());
             ASSERT_TRUE(parms == parms2);
+
+            // Key switching parameters are saved only if they are not the default
+            auto default_parms_id = parms.parms_id();
+            parms.set_special_prime_count(2);
+            parms.set_decomposition_digit_count(1);
+            ASSERT_TRUE(parms.parms_id() != default_parms_id);
+            ASSERT_EQ(parms.save_size(compr_mode_type::none), parms.save(stream, compr_mode_type::none));
+            parms2.load(stream);
+            ASSERT_EQ(2ULL, parms2.special_prime_count());
+            ASSERT_EQ(1ULL, parms2.decomposition_digit_count());
+            ASSERT_TRUE(parms.scheme() == parms2.scheme());
+            ASSERT_TRUE(parms.coeff_modulus() == parms2.coeff_modulus());
+            ASSERT_TRUE(parms == parms2);
+
+            parms.set_special_prime_count(1);
+            parms.set_decomposition_digit_count(0);
+            ASSERT_TRUE(parms.parms_id() == default_parms_id);
+            parms.save(stream);
+            parms2.load(stream);
+            ASSERT_EQ(1ULL, parms2.special_prime_count());
+            ASSERT_EQ(0ULL, parms2.decomposition_digit_count());
+            ASSERT_TRUE(parms == parms2);
+
+            // Likewise the multiplication method, which only BFV supports
+            if (scheme != scheme_type::bfv)
+            {
+                ASSERT_THROW(parms.set_mul_method(mul_method_type::hps), logic_error);
+                return;
+            }
+            parms.set_mul_method(mul_method_type::hps);
+            ASSERT_TRUE(parms.parms_id() != default_parms_id);
+            ASSERT_EQ(parms.save_size(compr_mode_type::none), parms.save(stream, compr_mode_type::none));
+            parms2.load(stream);
+            ASSERT_TRUE(mul_method_type::hps == parms2.mul_method());
+            ASSERT_TRUE(parms == parms2);
+
+            parms.set_mul_method(mul_method_type::behz);
+            ASSERT_TRUE(parms.parms_id() == default_parms_id);
+            parms.save(stream);
+            parms2.load(stream);
+            ASSERT_TRUE(mul_method_type::behz == parms2.mul_method());
+            ASSERT_TRUE(parms == parms2);
         };
         encryption_parameters_save_load(scheme_type::bfv);
         encryption_parameters_save_load(scheme_type::bgv);
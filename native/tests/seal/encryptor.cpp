@@ -1052,4 +1052,116 @@ namespace sealtest
             ASSERT_TRUE(pt.is_zero());
         }
     }
+
+    TEST(EncryptorTest, HybridKeySwitchingPublicKeyEncryptDecrypt)
+    {
+        // Public key encryption divides the key level by all special primes at once
+        for (size_t special_prime_count : { 2, 3 })
+        {
+            {
+                EncryptionParameters parms(scheme_type::bfv);
+                parms.set_poly_modulus_degree(64);
+                parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+                parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40, 40, 40 }));
+                parms.set_special_prime_count(special_prime_count);
+                SEALContext context(parms, true, sec_level_type::none);
+                KeyGenerator keygen(context);
+                PublicKey pk;
+                keygen.create_public_key(pk);
+
+                Encryptor encryptor(context, pk, keygen.secret_key());
+                Decryptor decryptor(context, keygen.secret_key());
+                BatchEncoder batch_encoder(context);
+
+                vector<uint64_t> plain_vec(batch_encoder.slot_count());
+                for (size_t i = 0; i < plain_vec.size(); i++)
+                {
+                    plain_vec[i] = i * 12345;
+                }
+                Plaintext plain;
+                batch_encoder.encode(plain_vec, plain);
+                Ciphertext encrypted;
+                Ciphertext symmetric_encrypted;
+                encryptor.encrypt(plain, encrypted);
+                encryptor.encrypt_symmetric(plain, symmetric_encrypted);
+                ASSERT_EQ(context.first_parms_id(), encrypted.parms_id());
+
+                // Division by P leaves about the noise of a secret key encryption
+                ASSERT_GE(
+                    decryptor.invariant_noise_budget(encrypted) + 2,
+                    decryptor.invariant_noise_budget(symmetric_encrypted));
+                vector<uint64_t> result;
+                decryptor.decrypt(encrypted, plain);
+                batch_encoder.decode(plain, result);
+                ASSERT_TRUE(plain_vec == result);
+            }
+            {
+                EncryptionParameters parms(scheme_type::bgv);
+                parms.set_poly_modulus_degree(64);
+                parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+                parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40, 40, 40 }));
+                parms.set_special_prime_count(special_prime_count);
+                SEALContext context(parms, true, sec_level_type::none);
+                KeyGenerator keygen(context);
+                PublicKey pk;
+                keygen.create_public_key(pk);
+
+                Encryptor encryptor(context, pk, keygen.secret_key());
+                Decryptor decryptor(context, keygen.secret_key());
+                BatchEncoder batch_encoder(context);
+
+                vector<uint64_t> plain_vec(batch_encoder.slot_count());
+                for (size_t i = 0; i < plain_vec.size(); i++)
+                {
+                    plain_vec[i] = i * 12345;
+                }
+                Plaintext plain;
+                batch_encoder.encode(plain_vec, plain);
+                Ciphertext encrypted;
+                Ciphertext symmetric_encrypted;
+                encryptor.encrypt(plain, encrypted);
+                encryptor.encrypt_symmetric(plain, symmetric_encrypted);
+                ASSERT_EQ(context.first_parms_id(), encrypted.parms_id());
+                ASSERT_GE(
+                    decryptor.invariant_noise_budget(encrypted) + 2,
+                    decryptor.invariant_noise_budget(symmetric_encrypted));
+                vector<uint64_t> result;
+                decryptor.decrypt(encrypted, plain);
+                batch_encoder.decode(plain, result);
+                ASSERT_TRUE(plain_vec == result);
+            }
+            {
+                EncryptionParameters parms(scheme_type::ckks);
+                parms.set_poly_modulus_degree(64);
+                parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40, 40, 40 }));
+                parms.set_special_prime_count(special_prime_count);
+                SEALContext context(parms, true, sec_level_type::none);
+                KeyGenerator keygen(context);
+                PublicKey pk;
+                keygen.create_public_key(pk);
+
+                Encryptor encryptor(context, pk);
+                Decryptor decryptor(context, keygen.secret_key());
+                CKKSEncoder encoder(context);
+
+                vector<double> plain_vec(encoder.slot_count());
+                for (size_t i = 0; i < plain_vec.size(); i++)
+                {
+                    plain_vec[i] = static_cast<double>(i) - 10.5;
+                }
+                Plaintext plain;
+                encoder.encode(plain_vec, pow(2.0, 30), plain);
+                Ciphertext encrypted;
+                encryptor.encrypt(plain, encrypted);
+                ASSERT_EQ(context.first_parms_id(), encrypted.parms_id());
+                vector<double> result;
+                decryptor.decrypt(encrypted, plain);
+                encoder.decode(plain, result);
+                for (size_t i = 0; i < plain_vec.size(); i++)
+                {
+                    ASSERT_NEAR(plain_vec[i], result[i], 0.001);
+                }
+            }
+        }
+    }
 } // namespace sealtest
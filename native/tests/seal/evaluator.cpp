@@ -11,6 +11,7 @@
 #include "seal/modulus.h"
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <ctime>
 #include <string>
 #include "gtest/gtest.h"
@@ -2498,6 +2499,30 @@ namespace sealtest
         evaluator.mod_switch_to_next_inplace(encrypted);
         decryptor.decrypt(encrypted, plain2);
         ASSERT_TRUE(plain2.to_string() == "1x^40 + 8x^30 + 18x^20 + 20x^10 + 10");
+
+        // Deferred relinearization with keys for higher powers
+        RelinKeys rlk_high;
+        keygen.create_relin_keys(3, rlk_high);
+        ASSERT_TRUE(rlk_high.has_key(4));
+        plain = "1x^10 + 2";
+        encryptor.encrypt(plain, encrypted);
+        evaluator.square(encrypted, encrypted2);
+        evaluator.multiply_inplace(encrypted2, encrypted);
+        ASSERT_EQ(size_t(4), encrypted2.size());
+        ASSERT_THROW(evaluator.relinearize(encrypted2, rlk, encrypted), invalid_argument);
+        evaluator.add_inplace(encrypted2, encrypted2);
+        evaluator.relinearize_inplace(encrypted2, rlk_high);
+        ASSERT_EQ(size_t(2), encrypted2.size());
+        decryptor.decrypt(encrypted2, plain2);
+        ASSERT_TRUE(plain2.to_string() == "2x^30 + Cx^20 + 18x^10 + 10");
+
+        encryptor.encrypt(plain, encrypted);
+        evaluator.square_inplace(encrypted);
+        evaluator.square_inplace(encrypted);
+        ASSERT_EQ(size_t(5), encrypted.size());
+        evaluator.relinearize_inplace(encrypted, rlk_high);
+        decryptor.decrypt(encrypted, plain2);
+        ASSERT_TRUE(plain2.to_string() == "1x^40 + 8x^30 + 18x^20 + 20x^10 + 10");
     }
 
     TEST(EvaluatorTest, BGVRelinearize)
@@ -2573,6 +2598,30 @@ namespace sealtest
         evaluator.mod_switch_to_next_inplace(encrypted);
         decryptor.decrypt(encrypted, plain2);
         ASSERT_TRUE(plain2.to_string() == "1x^40 + 8x^30 + 18x^20 + 20x^10 + 10");
+
+        // Deferred relinearization with keys for higher powers
+        RelinKeys rlk_high;
+        keygen.create_relin_keys(3, rlk_high);
+        ASSERT_TRUE(rlk_high.has_key(4));
+        plain = "1x^10 + 2";
+        encryptor.encrypt(plain, encrypted);
+        evaluator.square(encrypted, encrypted2);
+        evaluator.multiply_inplace(encrypted2, encrypted);
+        ASSERT_EQ(size_t(4), encrypted2.size());
+        ASSERT_THROW(evaluator.relinearize(encrypted2, rlk, encrypted), invalid_argument);
+        evaluator.add_inplace(encrypted2, encrypted2);
+        evaluator.relinearize_inplace(encrypted2, rlk_high);
+        ASSERT_EQ(size_t(2), encrypted2.size());
+        decryptor.decrypt(encrypted2, plain2);
+        ASSERT_TRUE(plain2.to_string() == "2x^30 + Cx^20 + 18x^10 + 10");
+
+        encryptor.encrypt(plain, encrypted);
+        evaluator.square_inplace(encrypted);
+        evaluator.square_inplace(encrypted);
+        ASSERT_EQ(size_t(5), encrypted.size());
+        evaluator.relinearize_inplace(encrypted, rlk_high);
+        decryptor.decrypt(encrypted, plain2);
+        ASSERT_TRUE(plain2.to_string() == "1x^40 + 8x^30 + 18x^20 + 20x^10 + 10");
     }
 
     TEST(EvaluatorTest, CKKSEncryptNaiveMultiplyDecrypt)
@@ -3741,6 +3790,109 @@ namespace sealtest
         }
     }
 
+    TEST(EvaluatorTest, CKKSEncryptMultiplyRelinFusedDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        parms.set_poly_modulus_degree(64);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 60, 40, 40, 60 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        RelinKeys rlk;
+        keygen.create_relin_keys(rlk);
+
+        CKKSEncoder encoder(context);
+        Encryptor encryptor(context, pk);
+        Decryptor decryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+        size_t slot_count = encoder.slot_count();
+        double delta = static_cast<double>(1ULL << 40);
+
+        vector<complex<double>> input1(slot_count);
+        vector<complex<double>> input2(slot_count);
+        vector<complex<double>> product(slot_count);
+        for (size_t i = 0; i < slot_count; i++)
+        {
+            input1[i] = complex<double>(static_cast<double>(i % 11), 1.0);
+            input2[i] = complex<double>(static_cast<double>(i % 5) - 2.0, 0.0);
+            product[i] = input1[i] * input2[i];
+        }
+        Plaintext plain1;
+        Plaintext plain2;
+        encoder.encode(input1, delta, plain1);
+        encoder.encode(input2, delta, plain2);
+        Ciphertext encrypted1;
+        Ciphertext encrypted2;
+        encryptor.encrypt(plain1, encrypted1);
+        encryptor.encrypt(plain2, encrypted2);
+
+        auto check = [&](const Ciphertext &encrypted, const vector<complex<double>> &expected) {
+            ASSERT_EQ(size_t(2), encrypted.size());
+            Plaintext plain;
+            vector<complex<double>> output;
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_count; i++)
+            {
+                ASSERT_TRUE(abs(expected[i].real() - output[i].real()) < 0.01);
+                ASSERT_TRUE(abs(expected[i].imag() - output[i].imag()) < 0.01);
+            }
+        };
+
+        // The fused operations match multiply, relinearize, and rescale exactly
+        Ciphertext expected;
+        evaluator.multiply(encrypted1, encrypted2, expected);
+        evaluator.relinearize_inplace(expected, rlk);
+        Ciphertext result;
+        evaluator.multiply_relin(encrypted1, encrypted2, rlk, result);
+        ASSERT_EQ(expected.parms_id(), result.parms_id());
+        ASSERT_DOUBLE_EQ(expected.scale(), result.scale());
+        ASSERT_TRUE(equal(expected.data(), expected.data() + expected.dyn_array().size(), result.data()));
+        check(result, product);
+
+        evaluator.rescale_to_next_inplace(expected);
+        evaluator.multiply_relin_rescale(encrypted1, encrypted2, rlk, result);
+        ASSERT_EQ(expected.parms_id(), result.parms_id());
+        ASSERT_DOUBLE_EQ(expected.scale(), result.scale());
+        ASSERT_TRUE(equal(expected.data(), expected.data() + expected.dyn_array().size(), result.data()));
+        check(result, product);
+
+        // Aliased operands
+        vector<complex<double>> square(slot_count);
+        for (size_t i = 0; i < slot_count; i++)
+        {
+            square[i] = input1[i] * input1[i];
+        }
+        result = encrypted1;
+        evaluator.multiply_relin_rescale_inplace(result, result, rlk);
+        check(result, square);
+
+        // Rescaling is not possible at the last level
+        evaluator.mod_switch_to_next_inplace(encrypted1);
+        evaluator.mod_switch_to_next_inplace(encrypted1);
+        ASSERT_THROW(evaluator.multiply_relin_rescale_inplace(encrypted1, encrypted1, rlk), invalid_argument);
+
+        // Only CKKS supports rescaling
+        EncryptionParameters bfv_parms(scheme_type::bfv);
+        bfv_parms.set_poly_modulus_degree(64);
+        bfv_parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+        bfv_parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40 }));
+        SEALContext bfv_context(bfv_parms, true, sec_level_type::none);
+        KeyGenerator bfv_keygen(bfv_context);
+        PublicKey bfv_pk;
+        bfv_keygen.create_public_key(bfv_pk);
+        RelinKeys bfv_rlk;
+        bfv_keygen.create_relin_keys(bfv_rlk);
+        Encryptor bfv_encryptor(bfv_context, bfv_pk);
+        Evaluator bfv_evaluator(bfv_context);
+        Ciphertext bfv_encrypted;
+        bfv_encryptor.encrypt(Plaintext("1"), bfv_encrypted);
+        ASSERT_THROW(
+            bfv_evaluator.multiply_relin_rescale_inplace(bfv_encrypted, bfv_encrypted, bfv_rlk), invalid_argument);
+    }
+
     TEST(EvaluatorTest, CKKSEncryptModSwitchDecrypt)
     {
         EncryptionParameters parms(scheme_type::ckks);
@@ -4290,6 +4442,236 @@ namespace sealtest
         }
     }
 
+    TEST(EvaluatorTest, CKKSEncryptRotateVectorManyDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        size_t slot_size = 32;
+        parms.set_poly_modulus_degree(64);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        GaloisKeys glk;
+        keygen.create_galois_keys(glk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        CKKSEncoder encoder(context);
+        const double delta = static_cast<double>(1ULL << 30);
+
+        vector<complex<double>> input(slot_size);
+        for (size_t i = 0; i < slot_size; i++)
+        {
+            input[i] = complex<double>(static_cast<double>(i), static_cast<double>(slot_size - i));
+        }
+
+        Plaintext plain;
+        Ciphertext encrypted;
+        encoder.encode(input, context.first_parms_id(), delta, plain);
+        encryptor.encrypt(plain, encrypted);
+
+        // Steps 3 and -7 have no Galois key and fall back to rotate_vector
+        vector<int> steps{ 1, 2, -1, 0, 3, -7, 8 };
+        vector<Ciphertext> rotated;
+        evaluator.rotate_vector_many(encrypted, steps, glk, rotated);
+        ASSERT_EQ(steps.size(), rotated.size());
+
+        vector<complex<double>> output(slot_size);
+        for (size_t k = 0; k < steps.size(); k++)
+        {
+            decryptor.decrypt(rotated[k], plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                size_t j = (i + static_cast<size_t>(steps[k] + static_cast<int>(slot_size))) % slot_size;
+                ASSERT_EQ(input[j].real(), round(output[i].real()));
+                ASSERT_EQ(input[j].imag(), round(output[i].imag()));
+            }
+        }
+
+        // Lower level
+        evaluator.mod_switch_to_next_inplace(encrypted);
+        evaluator.rotate_vector_many(encrypted, steps, glk, rotated);
+        for (size_t k = 0; k < steps.size(); k++)
+        {
+            decryptor.decrypt(rotated[k], plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                size_t j = (i + static_cast<size_t>(steps[k] + static_cast<int>(slot_size))) % slot_size;
+                ASSERT_EQ(input[j].real(), round(output[i].real()));
+                ASSERT_EQ(input[j].imag(), round(output[i].imag()));
+            }
+        }
+
+        ASSERT_THROW(evaluator.rotate_rows_many(encrypted, steps, glk, rotated), logic_error);
+    }
+
+    TEST(EvaluatorTest, CKKSHybridKeySwitching)
+    {
+        // Pairs of (special prime count, decomposition digit count); the special primes must be at least as large as
+        // each digit to keep the key switching noise below the scale
+        vector<pair<size_t, size_t>> configs{ { 1, 5 }, { 2, 0 }, { 2, 2 }, { 3, 1 }, { 3, 3 } };
+        for (auto &config : configs)
+        {
+            EncryptionParameters parms(scheme_type::ckks);
+            size_t slot_size = 32;
+            parms.set_poly_modulus_degree(64);
+            parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40, 40, 40 }));
+            parms.set_special_prime_count(config.first);
+            parms.set_decomposition_digit_count(config.second);
+
+            SEALContext context(parms, true, sec_level_type::none);
+            ASSERT_TRUE(context.parameters_set());
+            KeyGenerator keygen(context);
+            PublicKey pk;
+            keygen.create_public_key(pk);
+            RelinKeys rlk;
+            keygen.create_relin_keys(rlk);
+            GaloisKeys glk;
+            keygen.create_galois_keys(vector<int>{ 1, -3 }, glk);
+            ASSERT_TRUE(is_valid_for(rlk, context));
+            ASSERT_TRUE(is_valid_for(glk, context));
+
+            Encryptor encryptor(context, pk);
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            CKKSEncoder encoder(context);
+            const double delta = static_cast<double>(1ULL << 16);
+
+            vector<complex<double>> input(slot_size);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                input[i] = complex<double>(static_cast<double>(i % 8), static_cast<double>(7 - i % 8));
+            }
+
+            Plaintext plain;
+            Ciphertext encrypted;
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            encryptor.encrypt(plain, encrypted);
+
+            vector<int> steps{ 1, -3 };
+            vector<complex<double>> output(slot_size);
+            for (size_t level = 0; level < 2; level++)
+            {
+                Ciphertext squared;
+                evaluator.square(encrypted, squared);
+                evaluator.relinearize_inplace(squared, rlk);
+                ASSERT_EQ(size_t(2), squared.size());
+                decryptor.decrypt(squared, plain);
+                encoder.decode(plain, output);
+                for (size_t i = 0; i < slot_size; i++)
+                {
+                    complex<double> expected = input[i] * input[i];
+                    ASSERT_EQ(expected.real(), round(output[i].real()));
+                    ASSERT_EQ(expected.imag(), round(output[i].imag()));
+                }
+
+                vector<Ciphertext> rotated(steps.size());
+                for (size_t k = 0; k < steps.size(); k++)
+                {
+                    evaluator.rotate_vector(encrypted, steps[k], glk, rotated[k]);
+                }
+                vector<Ciphertext> rotated_many;
+                evaluator.rotate_vector_many(encrypted, steps, glk, rotated_many);
+                ASSERT_EQ(steps.size(), rotated_many.size());
+                rotated.insert(rotated.end(), rotated_many.begin(), rotated_many.end());
+                for (size_t k = 0; k < rotated.size(); k++)
+                {
+                    int step = steps[k % steps.size()];
+                    decryptor.decrypt(rotated[k], plain);
+                    encoder.decode(plain, output);
+                    for (size_t i = 0; i < slot_size; i++)
+                    {
+                        size_t j = (i + static_cast<size_t>(step + static_cast<int>(slot_size))) % slot_size;
+                        ASSERT_EQ(input[j].real(), round(output[i].real()));
+                        ASSERT_EQ(input[j].imag(), round(output[i].imag()));
+                    }
+                }
+
+                // Lower level
+                evaluator.mod_switch_to_next_inplace(encrypted);
+            }
+        }
+    }
+
+    TEST(EvaluatorTest, CKKSInnerProductPlain)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        size_t slot_size = 32;
+        parms.set_poly_modulus_degree(64);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 60, 40, 60 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        CKKSEncoder encoder(context);
+        const double delta = static_cast<double>(1ULL << 30);
+
+        size_t count = 5;
+        vector<Ciphertext> encrypteds(count);
+        vector<Plaintext> plains(count);
+        vector<complex<double>> expected(slot_size);
+        for (size_t k = 0; k < count; k++)
+        {
+            vector<complex<double>> input1(slot_size);
+            vector<complex<double>> input2(slot_size);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                input1[i] = complex<double>(static_cast<double>((i + k) % 9), static_cast<double>(k));
+                input2[i] = complex<double>(static_cast<double>((i * k) % 5) - 2.0, 1.0);
+            }
+
+            // The second ciphertext is squared and has size 3; its scale matches the other products
+            double scale = k == 1 ? delta / 1024 : delta;
+            Plaintext plain;
+            encoder.encode(input1, context.first_parms_id(), scale, plain);
+            encryptor.encrypt(plain, encrypteds[k]);
+            encoder.encode(input2, context.first_parms_id(), scale, plains[k]);
+            if (k == 1)
+            {
+                evaluator.square_inplace(encrypteds[k]);
+            }
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                expected[i] += (k == 1 ? input1[i] * input1[i] : input1[i]) * input2[i];
+            }
+        }
+
+        Ciphertext result;
+        evaluator.inner_product_plain(encrypteds, plains, result);
+        ASSERT_EQ(size_t(3), result.size());
+        ASSERT_TRUE(result.is_ntt_form());
+        ASSERT_DOUBLE_EQ(delta * delta, result.scale());
+
+        Plaintext plain;
+        vector<complex<double>> output;
+        decryptor.decrypt(result, plain);
+        encoder.decode(plain, output);
+        for (size_t i = 0; i < slot_size; i++)
+        {
+            ASSERT_EQ(expected[i].real(), round(output[i].real()));
+            ASSERT_EQ(expected[i].imag(), round(output[i].imag()));
+        }
+
+        // Mismatching scales, sizes, and aliasing are rejected
+        ASSERT_THROW(evaluator.inner_product_plain(encrypteds, plains, encrypteds[0]), invalid_argument);
+        ASSERT_THROW(
+            evaluator.inner_product_plain(encrypteds, vector<Plaintext>(plains.begin(), plains.end() - 1), result),
+            invalid_argument);
+        ASSERT_THROW(evaluator.inner_product_plain({}, {}, result), invalid_argument);
+        encoder.encode(1.0, context.first_parms_id(), delta * 2, plains[0]);
+        ASSERT_THROW(evaluator.inner_product_plain(encrypteds, plains, result), invalid_argument);
+    }
+
     TEST(EvaluatorTest, CKKSEncryptRescaleRotateDecrypt)
     {
         EncryptionParameters parms(scheme_type::ckks);
@@ -5452,96 +5834,624 @@ namespace sealtest
         ASSERT_TRUE((plain_vec == vector<uint64_t>{ 2, 3, 4, 1, 6, 7, 8, 5 }));
     }
 
-    TEST(EvaluatorTest, BFVEncryptModSwitchToNextDecrypt)
+    TEST(EvaluatorTest, BFVEncryptRotateRowsManyDecrypt)
     {
-        // The common parameters: the plaintext and the polynomial moduli
-        Modulus plain_modulus(1 << 6);
-
-        // The parameters and the context of the higher level
         EncryptionParameters parms(scheme_type::bfv);
-        parms.set_poly_modulus_degree(128);
-        parms.set_plain_modulus(plain_modulus);
-        parms.set_coeff_modulus(CoeffModulus::Create(128, { 30, 30, 30, 30 }));
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40 }));
 
         SEALContext context(parms, true, sec_level_type::none);
         KeyGenerator keygen(context);
-        SecretKey secret_key = keygen.secret_key();
         PublicKey pk;
         keygen.create_public_key(pk);
+        GaloisKeys glk;
+        keygen.create_galois_keys(glk);
 
         Encryptor encryptor(context, pk);
         Evaluator evaluator(context);
         Decryptor decryptor(context, keygen.secret_key());
-        auto parms_id = context.first_parms_id();
+        BatchEncoder batch_encoder(context);
+        size_t row_size = batch_encoder.slot_count() / 2;
 
-        Ciphertext encrypted(context);
-        Ciphertext encryptedRes;
         Plaintext plain;
-
-        plain = 0;
-        encryptor.encrypt(plain, encrypted);
-        evaluator.mod_switch_to_next(encrypted, encryptedRes);
-        decryptor.decrypt(encryptedRes, plain);
-        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
-        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
-        ASSERT_TRUE(plain.to_string() == "0");
-
-        evaluator.mod_switch_to_next_inplace(encryptedRes);
-        decryptor.decrypt(encryptedRes, plain);
-        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
-        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
-        ASSERT_TRUE(plain.to_string() == "0");
-
-        parms_id = context.first_parms_id();
-        plain = 1;
+        vector<uint64_t> plain_vec(batch_encoder.slot_count());
+        for (size_t i = 0; i < plain_vec.size(); i++)
+        {
+            plain_vec[i] = i + 1;
+        }
+        batch_encoder.encode(plain_vec, plain);
+        Ciphertext encrypted;
         encryptor.encrypt(plain, encrypted);
-        evaluator.mod_switch_to_next(encrypted, encryptedRes);
-        decryptor.decrypt(encryptedRes, plain);
-        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
-        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
-        ASSERT_TRUE(plain.to_string() == "1");
-
-        evaluator.mod_switch_to_next_inplace(encryptedRes);
-        decryptor.decrypt(encryptedRes, plain);
-        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
-        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
-        ASSERT_TRUE(plain.to_string() == "1");
 
-        parms_id = context.first_parms_id();
-        plain = "1x^127";
-        encryptor.encrypt(plain, encrypted);
-        evaluator.mod_switch_to_next(encrypted, encryptedRes);
-        decryptor.decrypt(encryptedRes, plain);
-        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
-        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
-        ASSERT_TRUE(plain.to_string() == "1x^127");
+        // Steps 3 and -5 have no Galois key and fall back to rotate_rows
+        vector<int> steps{ 1, -1, 0, 4, 3, -5, 16 };
+        vector<Ciphertext> rotated;
+        evaluator.rotate_rows_many(encrypted, steps, glk, rotated);
+        ASSERT_EQ(steps.size(), rotated.size());
 
-        evaluator.mod_switch_to_next_inplace(encryptedRes);
-        decryptor.decrypt(encryptedRes, plain);
-        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
-        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
-        ASSERT_TRUE(plain.to_string() == "1x^127");
+        vector<uint64_t> result;
+        for (size_t k = 0; k < steps.size(); k++)
+        {
+            decryptor.decrypt(rotated[k], plain);
+            batch_encoder.decode(plain, result);
+            for (size_t i = 0; i < row_size; i++)
+            {
+                size_t j = (i + static_cast<size_t>(steps[k] + static_cast<int>(row_size))) % row_size;
+                ASSERT_EQ(plain_vec[j], result[i]);
+                ASSERT_EQ(plain_vec[row_size + j], result[row_size + i]);
+            }
+        }
 
-        parms_id = context.first_parms_id();
-        plain = "5x^64 + Ax^5";
-        encryptor.encrypt(plain, encrypted);
-        evaluator.mod_switch_to_next(encrypted, encryptedRes);
-        decryptor.decrypt(encryptedRes, plain);
-        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
-        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
-        ASSERT_TRUE(plain.to_string() == "5x^64 + Ax^5");
+        // Lower level
+        evaluator.mod_switch_to_next_inplace(encrypted);
+        evaluator.rotate_rows_many(encrypted, steps, glk, rotated);
+        for (size_t k = 0; k < steps.size(); k++)
+        {
+            decryptor.decrypt(rotated[k], plain);
+            batch_encoder.decode(plain, result);
+            for (size_t i = 0; i < row_size; i++)
+            {
+                size_t j = (i + static_cast<size_t>(steps[k] + static_cast<int>(row_size))) % row_size;
+                ASSERT_EQ(plain_vec[j], result[i]);
+                ASSERT_EQ(plain_vec[row_size + j], result[row_size + i]);
+            }
+        }
 
-        evaluator.mod_switch_to_next_inplace(encryptedRes);
-        decryptor.decrypt(encryptedRes, plain);
-        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
-        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
-        ASSERT_TRUE(plain.to_string() == "5x^64 + Ax^5");
+        ASSERT_THROW(evaluator.rotate_vector_many(encrypted, steps, glk, rotated), logic_error);
     }
 
-    TEST(EvaluatorTest, BFVEncryptModSwitchToDecrypt)
+    TEST(EvaluatorTest, BFVHybridKeySwitching)
     {
-        // The common parameters: the plaintext and the polynomial moduli
-        Modulus plain_modulus(1 << 6);
+        // Pairs of (special prime count, decomposition digit count)
+        vector<pair<size_t, size_t>> configs{ { 1, 2 }, { 2, 0 }, { 2, 1 }, { 2, 2 }, { 3, 3 } };
+        for (auto &config : configs)
+        {
+            EncryptionParameters parms(scheme_type::bfv);
+            parms.set_poly_modulus_degree(64);
+            parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+            parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40, 40, 40 }));
+            parms.set_special_prime_count(config.first);
+            parms.set_decomposition_digit_count(config.second);
+
+            SEALContext context(parms, true, sec_level_type::none);
+            ASSERT_TRUE(context.parameters_set());
+            KeyGenerator keygen(context);
+            PublicKey pk;
+            keygen.create_public_key(pk);
+            RelinKeys rlk;
+            keygen.create_relin_keys(rlk);
+            GaloisKeys glk;
+            keygen.create_galois_keys(vector<int>{ 1, -3 }, glk);
+            ASSERT_TRUE(is_valid_for(rlk, context));
+            ASSERT_TRUE(is_valid_for(glk, context));
+
+            Encryptor encryptor(context, pk);
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            BatchEncoder batch_encoder(context);
+            uint64_t t = parms.plain_modulus().value();
+            size_t row_size = batch_encoder.slot_count() / 2;
+
+            Plaintext plain;
+            vector<uint64_t> plain_vec(batch_encoder.slot_count());
+            for (size_t i = 0; i < plain_vec.size(); i++)
+            {
+                plain_vec[i] = i + 1;
+            }
+            batch_encoder.encode(plain_vec, plain);
+            Ciphertext encrypted;
+            encryptor.encrypt(plain, encrypted);
+
+            vector<int> steps{ 1, -3 };
+            vector<uint64_t> result;
+            for (size_t level = 0; level < 2; level++)
+            {
+                Ciphertext squared;
+                evaluator.square(encrypted, squared);
+                evaluator.relinearize_inplace(squared, rlk);
+                ASSERT_EQ(size_t(2), squared.size());
+                decryptor.decrypt(squared, plain);
+                batch_encoder.decode(plain, result);
+                for (size_t i = 0; i < plain_vec.size(); i++)
+                {
+                    ASSERT_EQ((plain_vec[i] * plain_vec[i]) % t, result[i]);
+                }
+
+                vector<Ciphertext> rotated(steps.size());
+                for (size_t k = 0; k < steps.size(); k++)
+                {
+                    evaluator.rotate_rows(encrypted, steps[k], glk, rotated[k]);
+                }
+                vector<Ciphertext> rotated_many;
+                evaluator.rotate_rows_many(encrypted, steps, glk, rotated_many);
+                ASSERT_EQ(steps.size(), rotated_many.size());
+                rotated.insert(rotated.end(), rotated_many.begin(), rotated_many.end());
+                for (size_t k = 0; k < rotated.size(); k++)
+                {
+                    int step = steps[k % steps.size()];
+                    decryptor.decrypt(rotated[k], plain);
+                    batch_encoder.decode(plain, result);
+                    for (size_t i = 0; i < row_size; i++)
+                    {
+                        size_t j = (i + static_cast<size_t>(step + static_cast<int>(row_size))) % row_size;
+                        ASSERT_EQ(plain_vec[j], result[i]);
+                        ASSERT_EQ(plain_vec[row_size + j], result[row_size + i]);
+                    }
+                }
+
+                // Lower level
+                evaluator.mod_switch_to_next_inplace(encrypted);
+            }
+        }
+    }
+
+    TEST(EvaluatorTest, BFVInnerProductPlain)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        BatchEncoder batch_encoder(context);
+        uint64_t t = parms.plain_modulus().value();
+        size_t slot_count = batch_encoder.slot_count();
+
+        size_t count = 7;
+        vector<Ciphertext> encrypteds(count);
+        vector<Plaintext> plains(count);
+        vector<uint64_t> expected(slot_count, 0);
+        for (size_t k = 0; k < count; k++)
+        {
+            vector<uint64_t> values1(slot_count);
+            vector<uint64_t> values2(slot_count);
+            for (size_t i = 0; i < slot_count; i++)
+            {
+                values1[i] = (i * 3 + k) % 1000;
+                values2[i] = t - 1 - (i + k * 5) % 1000;
+                expected[i] = (expected[i] + values1[i] * values2[i]) % t;
+            }
+            Plaintext plain;
+            batch_encoder.encode(values1, plain);
+            encryptor.encrypt(plain, encrypteds[k]);
+            evaluator.transform_to_ntt_inplace(encrypteds[k]);
+            batch_encoder.encode(values2, plains[k]);
+            evaluator.transform_to_ntt_inplace(plains[k], context.first_parms_id());
+        }
+
+        Ciphertext result;
+        evaluator.inner_product_plain(encrypteds, plains, result);
+        ASSERT_EQ(size_t(2), result.size());
+        ASSERT_TRUE(result.is_ntt_form());
+        evaluator.transform_from_ntt_inplace(result);
+
+        Plaintext plain;
+        vector<uint64_t> output;
+        decryptor.decrypt(result, plain);
+        batch_encoder.decode(plain, output);
+        ASSERT_TRUE(expected == output);
+
+        // Operands must be in NTT form and at the same level
+        Plaintext plain_normal;
+        batch_encoder.encode(vector<uint64_t>(slot_count, 1), plain_normal);
+        plains[2] = plain_normal;
+        ASSERT_THROW(evaluator.inner_product_plain(encrypteds, plains, result), invalid_argument);
+        evaluator.transform_to_ntt_inplace(plain_normal, context.first_context_data()->next_context_data()->parms_id());
+        plains[2] = plain_normal;
+        ASSERT_THROW(evaluator.inner_product_plain(encrypteds, plains, result), invalid_argument);
+    }
+
+    TEST(EvaluatorTest, BFVEncryptMultiplyRelinFusedDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        RelinKeys rlk;
+        keygen.create_relin_keys(rlk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        BatchEncoder batch_encoder(context);
+        uint64_t t = parms.plain_modulus().value();
+        size_t slot_count = batch_encoder.slot_count();
+
+        vector<uint64_t> values1(slot_count);
+        vector<uint64_t> values2(slot_count);
+        for (size_t i = 0; i < slot_count; i++)
+        {
+            values1[i] = (i * 3 + 1) % 1000;
+            values2[i] = t - 1 - (i * 7) % 1000;
+        }
+        Plaintext plain1;
+        Plaintext plain2;
+        batch_encoder.encode(values1, plain1);
+        batch_encoder.encode(values2, plain2);
+        Ciphertext encrypted1;
+        Ciphertext encrypted2;
+        encryptor.encrypt(plain1, encrypted1);
+        encryptor.encrypt(plain2, encrypted2);
+
+        auto check = [&](const Ciphertext &encrypted, const vector<uint64_t> &expected) {
+            ASSERT_EQ(size_t(2), encrypted.size());
+            Plaintext plain;
+            vector<uint64_t> output;
+            decryptor.decrypt(encrypted, plain);
+            batch_encoder.decode(plain, output);
+            ASSERT_TRUE(expected == output);
+        };
+        vector<uint64_t> product(slot_count);
+        vector<uint64_t> square(slot_count);
+        for (size_t i = 0; i < slot_count; i++)
+        {
+            product[i] = (values1[i] * values2[i]) % t;
+            square[i] = (values1[i] * values1[i]) % t;
+        }
+
+        // The fused operation matches multiply followed by relinearize exactly
+        Ciphertext expected;
+        evaluator.multiply(encrypted1, encrypted2, expected);
+        evaluator.relinearize_inplace(expected, rlk);
+        Ciphertext result;
+        evaluator.multiply_relin(encrypted1, encrypted2, rlk, result);
+        ASSERT_EQ(expected.parms_id(), result.parms_id());
+        ASSERT_EQ(expected.correction_factor(), result.correction_factor());
+        ASSERT_TRUE(equal(expected.data(), expected.data() + expected.dyn_array().size(), result.data()));
+        check(result, product);
+
+        // Aliased operands
+        result = encrypted1;
+        evaluator.multiply_relin_inplace(result, result, rlk);
+        check(result, square);
+        result = encrypted2;
+        evaluator.multiply_relin(encrypted1, result, rlk, result);
+        check(result, product);
+
+        // Larger operands need relinearization keys for higher powers
+        Ciphertext encrypted3;
+        evaluator.multiply(encrypted1, encrypted1, encrypted3);
+        ASSERT_THROW(evaluator.multiply_relin(encrypted3, encrypted2, rlk, result), invalid_argument);
+
+        // Lower level
+        evaluator.mod_switch_to_next_inplace(encrypted1);
+        evaluator.mod_switch_to_next_inplace(encrypted2);
+        evaluator.multiply_relin(encrypted1, encrypted2, rlk, result);
+        check(result, product);
+
+        ASSERT_THROW(evaluator.multiply_relin(encrypted1, encrypted3, rlk, result), invalid_argument);
+    }
+
+    TEST(EvaluatorTest, BFVEncryptMultiplyHPSDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 50, 50, 50, 50 }));
+        parms.set_mul_method(mul_method_type::hps);
+
+        SEALContext context(parms, true, sec_level_type::none);
+        ASSERT_TRUE(context.parameters_set());
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        RelinKeys rlk;
+        keygen.create_relin_keys(rlk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        BatchEncoder batch_encoder(context);
+        uint64_t t = parms.plain_modulus().value();
+        size_t slot_count = batch_encoder.slot_count();
+
+        vector<uint64_t> values1(slot_count);
+        vector<uint64_t> values2(slot_count);
+        for (size_t i = 0; i < slot_count; i++)
+        {
+            values1[i] = (i * 5 + 2) % 1000;
+            values2[i] = t - 1 - (i * 11) % 1000;
+        }
+        Plaintext plain1;
+        Plaintext plain2;
+        batch_encoder.encode(values1, plain1);
+        batch_encoder.encode(values2, plain2);
+        Ciphertext encrypted1;
+        Ciphertext encrypted2;
+        encryptor.encrypt(plain1, encrypted1);
+        encryptor.encrypt(plain2, encrypted2);
+
+        auto check = [&](const Ciphertext &encrypted, const vector<uint64_t> &expected) {
+            Plaintext plain;
+            vector<uint64_t> output;
+            decryptor.decrypt(encrypted, plain);
+            batch_encoder.decode(plain, output);
+            ASSERT_TRUE(expected == output);
+        };
+        vector<uint64_t> product(slot_count);
+        vector<uint64_t> square(slot_count);
+        vector<uint64_t> cube(slot_count);
+        for (size_t i = 0; i < slot_count; i++)
+        {
+            product[i] = (values1[i] * values2[i]) % t;
+            square[i] = (values1[i] * values1[i]) % t;
+            cube[i] = (square[i] * values1[i]) % t;
+        }
+
+        Ciphertext result;
+        evaluator.multiply(encrypted1, encrypted2, result);
+        ASSERT_EQ(size_t(3), result.size());
+        check(result, product);
+
+        evaluator.square(encrypted1, result);
+        check(result, square);
+
+        // Larger ciphertexts
+        evaluator.multiply_inplace(result, encrypted1);
+        ASSERT_EQ(size_t(4), result.size());
+        check(result, cube);
+
+        evaluator.multiply_relin(encrypted1, encrypted2, rlk, result);
+        ASSERT_EQ(size_t(2), result.size());
+        check(result, product);
+
+        // The noise grows as with BEHZ
+        evaluator.square(encrypted1, result);
+        int budget = decryptor.invariant_noise_budget(result);
+        parms.set_mul_method(mul_method_type::behz);
+        SEALContext behz_context(parms, true, sec_level_type::none);
+        KeyGenerator behz_keygen(behz_context);
+        PublicKey behz_pk;
+        behz_keygen.create_public_key(behz_pk);
+        Encryptor behz_encryptor(behz_context, behz_pk);
+        Decryptor behz_decryptor(behz_context, behz_keygen.secret_key());
+        Evaluator behz_evaluator(behz_context);
+        Ciphertext behz_result;
+        behz_encryptor.encrypt(plain1, behz_result);
+        behz_evaluator.square_inplace(behz_result);
+        ASSERT_GT(budget, 0);
+        ASSERT_LE(abs(budget - behz_decryptor.invariant_noise_budget(behz_result)), 2);
+
+        // Lower level
+        evaluator.mod_switch_to_next_inplace(encrypted1);
+        evaluator.mod_switch_to_next_inplace(encrypted2);
+        evaluator.multiply(encrypted1, encrypted2, result);
+        check(result, product);
+    }
+
+    TEST(EvaluatorTest, BFVNTTResident)
+    {
+        // Pairs of (multiplication method, special prime count)
+        vector<pair<mul_method_type, size_t>> configs{ { mul_method_type::behz, 1 },
+                                                       { mul_method_type::hps, 1 },
+                                                       { mul_method_type::behz, 2 } };
+        for (auto &config : configs)
+        {
+            EncryptionParameters parms(scheme_type::bfv);
+            parms.set_poly_modulus_degree(64);
+            parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+            parms.set_coeff_modulus(CoeffModulus::Create(64, { 50, 50, 50, 50, 50 }));
+            parms.set_mul_method(config.first);
+            parms.set_special_prime_count(config.second);
+
+            SEALContext context(parms, true, sec_level_type::none);
+            ASSERT_TRUE(context.parameters_set());
+            KeyGenerator keygen(context);
+            PublicKey pk;
+            keygen.create_public_key(pk);
+            RelinKeys rlk;
+            keygen.create_relin_keys(rlk);
+            GaloisKeys galk;
+            keygen.create_galois_keys(galk);
+
+            Encryptor encryptor(context, pk);
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            BatchEncoder batch_encoder(context);
+            uint64_t t = parms.plain_modulus().value();
+            size_t slot_count = batch_encoder.slot_count();
+            size_t row_size = slot_count / 2;
+
+            vector<uint64_t> values1(slot_count);
+            vector<uint64_t> values2(slot_count);
+            for (size_t i = 0; i < slot_count; i++)
+            {
+                values1[i] = (i * 5 + 2) % 1000;
+                values2[i] = t - 1 - (i * 11) % 1000;
+            }
+            Plaintext plain1;
+            Plaintext plain2;
+            batch_encoder.encode(values1, plain1);
+            batch_encoder.encode(values2, plain2);
+            Ciphertext encrypted1;
+            Ciphertext encrypted2;
+            encryptor.encrypt(plain1, encrypted1);
+            encryptor.encrypt(plain2, encrypted2);
+            evaluator.transform_to_ntt_inplace(encrypted1);
+            evaluator.transform_to_ntt_inplace(encrypted2);
+
+            auto check = [&](const Ciphertext &encrypted, const vector<uint64_t> &expected) {
+                ASSERT_TRUE(encrypted.is_ntt_form());
+                ASSERT_GT(decryptor.invariant_noise_budget(encrypted), 0);
+                Plaintext plain;
+                vector<uint64_t> output;
+                decryptor.decrypt(encrypted, plain);
+                batch_encoder.decode(plain, output);
+                ASSERT_TRUE(expected == output);
+            };
+            vector<uint64_t> sum(slot_count);
+            vector<uint64_t> difference(slot_count);
+            vector<uint64_t> product(slot_count);
+            vector<uint64_t> square(slot_count);
+            for (size_t i = 0; i < slot_count; i++)
+            {
+                sum[i] = (values1[i] + values2[i]) % t;
+                difference[i] = (values1[i] + t - values2[i]) % t;
+                product[i] = (values1[i] * values2[i]) % t;
+                square[i] = (values1[i] * values1[i]) % t;
+            }
+
+            Ciphertext result;
+            evaluator.add_plain(encrypted1, plain2, result);
+            check(result, sum);
+            evaluator.sub_plain(encrypted1, plain2, result);
+            check(result, difference);
+            evaluator.multiply_plain(encrypted1, plain2, result);
+            check(result, product);
+
+            evaluator.multiply(encrypted1, encrypted2, result);
+            ASSERT_EQ(size_t(3), result.size());
+            check(result, product);
+            evaluator.relinearize_inplace(result, rlk);
+            check(result, product);
+            evaluator.multiply_relin(encrypted1, encrypted2, rlk, result);
+            ASSERT_EQ(size_t(2), result.size());
+            check(result, product);
+            evaluator.square(encrypted1, result);
+            check(result, square);
+
+            // Rotations, one at a time and hoisted
+            vector<uint64_t> rotated(slot_count);
+            for (size_t i = 0; i < slot_count; i++)
+            {
+                size_t row = i / row_size;
+                rotated[i] = square[(1 - row) * row_size + (i % row_size + 1) % row_size];
+            }
+            evaluator.relinearize_inplace(result, rlk);
+            evaluator.rotate_rows_inplace(result, 1, galk);
+            evaluator.rotate_columns_inplace(result, galk);
+            check(result, rotated);
+            vector<Ciphertext> rotations;
+            evaluator.rotate_rows_many(encrypted1, { 1 }, galk, rotations);
+            vector<uint64_t> expected(slot_count);
+            for (size_t i = 0; i < slot_count; i++)
+            {
+                expected[i] = values1[(i / row_size) * row_size + (i % row_size + 1) % row_size];
+            }
+            check(rotations[0], expected);
+
+            // Lower level
+            evaluator.mod_switch_to_next_inplace(encrypted1);
+            evaluator.mod_switch_to_next_inplace(encrypted2);
+            evaluator.multiply_relin(encrypted1, encrypted2, rlk, result);
+            check(result, product);
+
+            // The ciphertexts come back to coefficient form
+            evaluator.transform_from_ntt_inplace(result);
+            Plaintext plain;
+            decryptor.decrypt(result, plain);
+            vector<uint64_t> output;
+            batch_encoder.decode(plain, output);
+            ASSERT_TRUE(product == output);
+
+            // Both operands of a multiplication must be in the same form
+            ASSERT_THROW(evaluator.multiply(encrypted1, result, result), invalid_argument);
+        }
+    }
+
+    TEST(EvaluatorTest, BFVEncryptModSwitchToNextDecrypt)
+    {
+        // The common parameters: the plaintext and the polynomial moduli
+        Modulus plain_modulus(1 << 6);
+
+        // The parameters and the context of the higher level
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(128);
+        parms.set_plain_modulus(plain_modulus);
+        parms.set_coeff_modulus(CoeffModulus::Create(128, { 30, 30, 30, 30 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        SecretKey secret_key = keygen.secret_key();
+        PublicKey pk;
+        keygen.create_public_key(pk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        auto parms_id = context.first_parms_id();
+
+        Ciphertext encrypted(context);
+        Ciphertext encryptedRes;
+        Plaintext plain;
+
+        plain = 0;
+        encryptor.encrypt(plain, encrypted);
+        evaluator.mod_switch_to_next(encrypted, encryptedRes);
+        decryptor.decrypt(encryptedRes, plain);
+        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
+        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
+        ASSERT_TRUE(plain.to_string() == "0");
+
+        evaluator.mod_switch_to_next_inplace(encryptedRes);
+        decryptor.decrypt(encryptedRes, plain);
+        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
+        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
+        ASSERT_TRUE(plain.to_string() == "0");
+
+        parms_id = context.first_parms_id();
+        plain = 1;
+        encryptor.encrypt(plain, encrypted);
+        evaluator.mod_switch_to_next(encrypted, encryptedRes);
+        decryptor.decrypt(encryptedRes, plain);
+        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
+        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
+        ASSERT_TRUE(plain.to_string() == "1");
+
+        evaluator.mod_switch_to_next_inplace(encryptedRes);
+        decryptor.decrypt(encryptedRes, plain);
+        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
+        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
+        ASSERT_TRUE(plain.to_string() == "1");
+
+        parms_id = context.first_parms_id();
+        plain = "1x^127";
+        encryptor.encrypt(plain, encrypted);
+        evaluator.mod_switch_to_next(encrypted, encryptedRes);
+        decryptor.decrypt(encryptedRes, plain);
+        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
+        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
+        ASSERT_TRUE(plain.to_string() == "1x^127");
+
+        evaluator.mod_switch_to_next_inplace(encryptedRes);
+        decryptor.decrypt(encryptedRes, plain);
+        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
+        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
+        ASSERT_TRUE(plain.to_string() == "1x^127");
+
+        parms_id = context.first_parms_id();
+        plain = "5x^64 + Ax^5";
+        encryptor.encrypt(plain, encrypted);
+        evaluator.mod_switch_to_next(encrypted, encryptedRes);
+        decryptor.decrypt(encryptedRes, plain);
+        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
+        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
+        ASSERT_TRUE(plain.to_string() == "5x^64 + Ax^5");
+
+        evaluator.mod_switch_to_next_inplace(encryptedRes);
+        decryptor.decrypt(encryptedRes, plain);
+        parms_id = context.get_context_data(parms_id)->next_context_data()->parms_id();
+        ASSERT_TRUE(encryptedRes.parms_id() == parms_id);
+        ASSERT_TRUE(plain.to_string() == "5x^64 + Ax^5");
+    }
+
+    TEST(EvaluatorTest, BFVEncryptModSwitchToDecrypt)
+    {
+        // The common parameters: the plaintext and the polynomial moduli
+        Modulus plain_modulus(1 << 6);
 
         // The parameters and the context of the higher level
         EncryptionParameters parms(scheme_type::bfv);
@@ -5879,6 +6789,305 @@ namespace sealtest
         ASSERT_TRUE((plain_vec == vector<uint64_t>{ 2, 3, 4, 1, 6, 7, 8, 5 }));
     }
 
+    TEST(EvaluatorTest, BGVEncryptRotateRowsManyDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::bgv);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        GaloisKeys glk;
+        keygen.create_galois_keys(glk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        BatchEncoder batch_encoder(context);
+        size_t row_size = batch_encoder.slot_count() / 2;
+
+        Plaintext plain;
+        vector<uint64_t> plain_vec(batch_encoder.slot_count());
+        for (size_t i = 0; i < plain_vec.size(); i++)
+        {
+            plain_vec[i] = i + 1;
+        }
+        batch_encoder.encode(plain_vec, plain);
+        Ciphertext encrypted;
+        encryptor.encrypt(plain, encrypted);
+
+        // Steps 3 and -5 have no Galois key and fall back to rotate_rows
+        vector<int> steps{ 1, -1, 0, 4, 3, -5, 16 };
+        vector<Ciphertext> rotated;
+        evaluator.rotate_rows_many(encrypted, steps, glk, rotated);
+        ASSERT_EQ(steps.size(), rotated.size());
+
+        vector<uint64_t> result;
+        for (size_t k = 0; k < steps.size(); k++)
+        {
+            decryptor.decrypt(rotated[k], plain);
+            batch_encoder.decode(plain, result);
+            for (size_t i = 0; i < row_size; i++)
+            {
+                size_t j = (i + static_cast<size_t>(steps[k] + static_cast<int>(row_size))) % row_size;
+                ASSERT_EQ(plain_vec[j], result[i]);
+                ASSERT_EQ(plain_vec[row_size + j], result[row_size + i]);
+            }
+        }
+
+        // Lower level
+        evaluator.mod_switch_to_next_inplace(encrypted);
+        evaluator.rotate_rows_many(encrypted, steps, glk, rotated);
+        for (size_t k = 0; k < steps.size(); k++)
+        {
+            decryptor.decrypt(rotated[k], plain);
+            batch_encoder.decode(plain, result);
+            for (size_t i = 0; i < row_size; i++)
+            {
+                size_t j = (i + static_cast<size_t>(steps[k] + static_cast<int>(row_size))) % row_size;
+                ASSERT_EQ(plain_vec[j], result[i]);
+                ASSERT_EQ(plain_vec[row_size + j], result[row_size + i]);
+            }
+        }
+
+        ASSERT_THROW(evaluator.rotate_vector_many(encrypted, steps, glk, rotated), logic_error);
+    }
+
+    TEST(EvaluatorTest, BGVHybridKeySwitching)
+    {
+        // Pairs of (special prime count, decomposition digit count)
+        vector<pair<size_t, size_t>> configs{ { 1, 2 }, { 2, 0 }, { 2, 1 }, { 2, 2 }, { 3, 3 } };
+        for (auto &config : configs)
+        {
+            EncryptionParameters parms(scheme_type::bgv);
+            parms.set_poly_modulus_degree(64);
+            parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+            parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40, 40, 40 }));
+            parms.set_special_prime_count(config.first);
+            parms.set_decomposition_digit_count(config.second);
+
+            SEALContext context(parms, true, sec_level_type::none);
+            ASSERT_TRUE(context.parameters_set());
+            KeyGenerator keygen(context);
+            PublicKey pk;
+            keygen.create_public_key(pk);
+            RelinKeys rlk;
+            keygen.create_relin_keys(rlk);
+            GaloisKeys glk;
+            keygen.create_galois_keys(vector<int>{ 1, -3 }, glk);
+            ASSERT_TRUE(is_valid_for(rlk, context));
+            ASSERT_TRUE(is_valid_for(glk, context));
+
+            Encryptor encryptor(context, pk);
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            BatchEncoder batch_encoder(context);
+            uint64_t t = parms.plain_modulus().value();
+            size_t row_size = batch_encoder.slot_count() / 2;
+
+            Plaintext plain;
+            vector<uint64_t> plain_vec(batch_encoder.slot_count());
+            for (size_t i = 0; i < plain_vec.size(); i++)
+            {
+                plain_vec[i] = i + 1;
+            }
+            batch_encoder.encode(plain_vec, plain);
+            Ciphertext encrypted;
+            encryptor.encrypt(plain, encrypted);
+
+            vector<int> steps{ 1, -3 };
+            vector<uint64_t> result;
+            for (size_t level = 0; level < 2; level++)
+            {
+                Ciphertext squared;
+                evaluator.square(encrypted, squared);
+                evaluator.relinearize_inplace(squared, rlk);
+                ASSERT_EQ(size_t(2), squared.size());
+                decryptor.decrypt(squared, plain);
+                batch_encoder.decode(plain, result);
+                for (size_t i = 0; i < plain_vec.size(); i++)
+                {
+                    ASSERT_EQ((plain_vec[i] * plain_vec[i]) % t, result[i]);
+                }
+
+                vector<Ciphertext> rotated(steps.size());
+                for (size_t k = 0; k < steps.size(); k++)
+                {
+                    evaluator.rotate_rows(encrypted, steps[k], glk, rotated[k]);
+                }
+                vector<Ciphertext> rotated_many;
+                evaluator.rotate_rows_many(encrypted, steps, glk, rotated_many);
+                ASSERT_EQ(steps.size(), rotated_many.size());
+                rotated.insert(rotated.end(), rotated_many.begin(), rotated_many.end());
+                for (size_t k = 0; k < rotated.size(); k++)
+                {
+                    int step = steps[k % steps.size()];
+                    decryptor.decrypt(rotated[k], plain);
+                    batch_encoder.decode(plain, result);
+                    for (size_t i = 0; i < row_size; i++)
+                    {
+                        size_t j = (i + static_cast<size_t>(step + static_cast<int>(row_size))) % row_size;
+                        ASSERT_EQ(plain_vec[j], result[i]);
+                        ASSERT_EQ(plain_vec[row_size + j], result[row_size + i]);
+                    }
+                }
+
+                // Lower level
+                evaluator.mod_switch_to_next_inplace(encrypted);
+            }
+        }
+    }
+
+    TEST(EvaluatorTest, BGVInnerProductPlain)
+    {
+        EncryptionParameters parms(scheme_type::bgv);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        BatchEncoder batch_encoder(context);
+        uint64_t t = parms.plain_modulus().value();
+        size_t slot_count = batch_encoder.slot_count();
+
+        size_t count = 7;
+        vector<Ciphertext> encrypteds(count);
+        vector<Plaintext> plains(count);
+        vector<uint64_t> expected(slot_count, 0);
+        for (size_t k = 0; k < count; k++)
+        {
+            vector<uint64_t> values1(slot_count);
+            vector<uint64_t> values2(slot_count);
+            for (size_t i = 0; i < slot_count; i++)
+            {
+                values1[i] = (i * 3 + k) % 1000;
+                values2[i] = t - 1 - (i + k * 5) % 1000;
+                expected[i] = (expected[i] + values1[i] * values2[i]) % t;
+            }
+            Plaintext plain;
+            batch_encoder.encode(values1, plain);
+            encryptor.encrypt(plain, encrypteds[k]);
+            batch_encoder.encode(values2, plains[k]);
+            evaluator.transform_to_ntt_inplace(plains[k], context.first_parms_id());
+        }
+
+        Ciphertext result;
+        evaluator.inner_product_plain(encrypteds, plains, result);
+        ASSERT_EQ(size_t(2), result.size());
+        ASSERT_TRUE(result.is_ntt_form());
+
+        Plaintext plain;
+        vector<uint64_t> output;
+        decryptor.decrypt(result, plain);
+        batch_encoder.decode(plain, output);
+        ASSERT_TRUE(expected == output);
+
+        // Operands must be in NTT form and at the same level
+        Plaintext plain_normal;
+        batch_encoder.encode(vector<uint64_t>(slot_count, 1), plain_normal);
+        plains[2] = plain_normal;
+        ASSERT_THROW(evaluator.inner_product_plain(encrypteds, plains, result), invalid_argument);
+        evaluator.transform_to_ntt_inplace(plain_normal, context.first_context_data()->next_context_data()->parms_id());
+        plains[2] = plain_normal;
+        ASSERT_THROW(evaluator.inner_product_plain(encrypteds, plains, result), invalid_argument);
+    }
+
+    TEST(EvaluatorTest, BGVEncryptMultiplyRelinFusedDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::bgv);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        RelinKeys rlk;
+        keygen.create_relin_keys(rlk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        BatchEncoder batch_encoder(context);
+        uint64_t t = parms.plain_modulus().value();
+        size_t slot_count = batch_encoder.slot_count();
+
+        vector<uint64_t> values1(slot_count);
+        vector<uint64_t> values2(slot_count);
+        for (size_t i = 0; i < slot_count; i++)
+        {
+            values1[i] = (i * 3 + 1) % 1000;
+            values2[i] = t - 1 - (i * 7) % 1000;
+        }
+        Plaintext plain1;
+        Plaintext plain2;
+        batch_encoder.encode(values1, plain1);
+        batch_encoder.encode(values2, plain2);
+        Ciphertext encrypted1;
+        Ciphertext encrypted2;
+        encryptor.encrypt(plain1, encrypted1);
+        encryptor.encrypt(plain2, encrypted2);
+
+        auto check = [&](const Ciphertext &encrypted, const vector<uint64_t> &expected) {
+            ASSERT_EQ(size_t(2), encrypted.size());
+            Plaintext plain;
+            vector<uint64_t> output;
+            decryptor.decrypt(encrypted, plain);
+            batch_encoder.decode(plain, output);
+            ASSERT_TRUE(expected == output);
+        };
+        vector<uint64_t> product(slot_count);
+        vector<uint64_t> square(slot_count);
+        for (size_t i = 0; i < slot_count; i++)
+        {
+            product[i] = (values1[i] * values2[i]) % t;
+            square[i] = (values1[i] * values1[i]) % t;
+        }
+
+        // The fused operation matches multiply followed by relinearize exactly
+        Ciphertext expected;
+        evaluator.multiply(encrypted1, encrypted2, expected);
+        evaluator.relinearize_inplace(expected, rlk);
+        Ciphertext result;
+        evaluator.multiply_relin(encrypted1, encrypted2, rlk, result);
+        ASSERT_EQ(expected.parms_id(), result.parms_id());
+        ASSERT_EQ(expected.correction_factor(), result.correction_factor());
+        ASSERT_TRUE(equal(expected.data(), expected.data() + expected.dyn_array().size(), result.data()));
+        check(result, product);
+
+        // Aliased operands
+        result = encrypted1;
+        evaluator.multiply_relin_inplace(result, result, rlk);
+        check(result, square);
+        result = encrypted2;
+        evaluator.multiply_relin(encrypted1, result, rlk, result);
+        check(result, product);
+
+        // Larger operands need relinearization keys for higher powers
+        Ciphertext encrypted3;
+        evaluator.multiply(encrypted1, encrypted1, encrypted3);
+        ASSERT_THROW(evaluator.multiply_relin(encrypted3, encrypted2, rlk, result), invalid_argument);
+
+        // Lower level
+        evaluator.mod_switch_to_next_inplace(encrypted1);
+        evaluator.mod_switch_to_next_inplace(encrypted2);
+        evaluator.multiply_relin(encrypted1, encrypted2, rlk, result);
+        check(result, product);
+
+        ASSERT_THROW(evaluator.multiply_relin(encrypted1, encrypted3, rlk, result), invalid_argument);
+    }
+
     TEST(EvaluatorTest, BGVEncryptModSwitchToNextDecrypt)
     {
         {
@@ -6140,4 +7349,116 @@ namespace sealtest
         ASSERT_TRUE(encrypted.parms_id() == parms_id);
         ASSERT_TRUE(plain.to_string() == "5x^64 + Ax^5");
     }
+
+    TEST(EvaluatorTest, MultithreadedEvaluation)
+    {
+        // Pairs of (special prime count, decomposition digit count)
+        vector<pair<size_t, size_t>> configs{ { 1, 0 }, { 2, 2 } };
+        for (scheme_type scheme : { scheme_type::bfv, scheme_type::ckks, scheme_type::bgv })
+        {
+            for (auto &config : configs)
+            {
+                EncryptionParameters parms(scheme);
+                parms.set_poly_modulus_degree(64);
+                if (scheme != scheme_type::ckks)
+                {
+                    parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+                }
+                parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40, 40, 40 }));
+                parms.set_special_prime_count(config.first);
+                parms.set_decomposition_digit_count(config.second);
+
+                SEALContext context(parms, true, sec_level_type::none);
+                KeyGenerator keygen(context);
+                PublicKey pk;
+                keygen.create_public_key(pk);
+                RelinKeys rlk;
+                keygen.create_relin_keys(rlk);
+                GaloisKeys glk;
+                keygen.create_galois_keys(vector<int>{ 1, -3 }, glk);
+
+                Encryptor encryptor(context, pk);
+                Evaluator evaluator(context);
+                Evaluator threaded_evaluator(context, 4);
+                ASSERT_EQ(size_t(1), evaluator.thread_count());
+                ASSERT_EQ(size_t(4), threaded_evaluator.thread_count());
+                ASSERT_EQ(size_t(1), Evaluator(context, 1).thread_count());
+                ASSERT_LE(size_t(1), Evaluator(context, 0).thread_count());
+
+                // The threaded evaluator produces exactly the same ciphertexts
+                auto expect_equal = [](const Ciphertext &expected, const Ciphertext &result) {
+                    ASSERT_EQ(expected.parms_id(), result.parms_id());
+                    ASSERT_EQ(expected.size(), result.size());
+                    ASSERT_EQ(expected.is_ntt_form(), result.is_ntt_form());
+                    ASSERT_TRUE(equal(expected.data(), expected.data() + expected.dyn_array().size(), result.data()));
+                };
+
+                Ciphertext encrypted1;
+                Ciphertext encrypted2;
+                encryptor.encrypt_zero(encrypted1);
+                encryptor.encrypt_zero(encrypted2);
+
+                Ciphertext expected;
+                Ciphertext result;
+                evaluator.multiply(encrypted1, encrypted2, expected);
+                threaded_evaluator.multiply(encrypted1, encrypted2, result);
+                expect_equal(expected, result);
+
+                evaluator.relinearize_inplace(expected, rlk);
+                threaded_evaluator.relinearize_inplace(result, rlk);
+                expect_equal(expected, result);
+
+                // A memory pool that is not the default one
+                auto pool = MemoryManager::GetPool(mm_prof_opt::mm_force_new);
+                threaded_evaluator.multiply_relin(encrypted1, encrypted2, rlk, result, pool);
+                expect_equal(expected, result);
+
+                vector<Ciphertext> expected_many;
+                vector<Ciphertext> result_many;
+                if (scheme == scheme_type::ckks)
+                {
+                    evaluator.rotate_vector(encrypted1, -3, glk, expected);
+                    threaded_evaluator.rotate_vector(encrypted1, -3, glk, result);
+                    evaluator.rotate_vector_many(encrypted1, { 1, -3, 0 }, glk, expected_many);
+                    threaded_evaluator.rotate_vector_many(encrypted1, { 1, -3, 0 }, glk, result_many);
+                }
+                else
+                {
+                    evaluator.rotate_rows(encrypted1, -3, glk, expected);
+                    threaded_evaluator.rotate_rows(encrypted1, -3, glk, result);
+                    evaluator.rotate_rows_many(encrypted1, { 1, -3, 0 }, glk, expected_many);
+                    threaded_evaluator.rotate_rows_many(encrypted1, { 1, -3, 0 }, glk, result_many);
+                }
+                expect_equal(expected, result);
+                ASSERT_EQ(expected_many.size(), result_many.size());
+                for (size_t i = 0; i < expected_many.size(); i++)
+                {
+                    expect_equal(expected_many[i], result_many[i]);
+                }
+
+                vector<Ciphertext> encrypteds{ encrypted1, encrypted2, encrypted1 };
+                vector<Plaintext> plains(encrypteds.size());
+                for (size_t i = 0; i < encrypteds.size(); i++)
+                {
+                    if (scheme == scheme_type::ckks)
+                    {
+                        CKKSEncoder encoder(context);
+                        encoder.encode(static_cast<double>(i + 1), 1.0, plains[i]);
+                    }
+                    else
+                    {
+                        if (scheme == scheme_type::bfv)
+                        {
+                            evaluator.transform_to_ntt_inplace(encrypteds[i]);
+                        }
+                        plains[i] = Plaintext("1x^3 + 2");
+                        evaluator.transform_to_ntt_inplace(plains[i], context.first_parms_id());
+                    }
+                }
+                evaluator.inner_product_plain(encrypteds, plains, expected);
+                threaded_evaluator.inner_product_plain(encrypteds, plains, result);
+                expect_equal(expected, result);
+            }
+        }
+    }
 } // namespace sealtest
@@ -0,0 +1,186 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/batchencoder.h"
+#include "seal/ckks.h"
+#include "seal/context.h"
+#include "seal/decryptor.h"
+#include "seal/encryptor.h"
+#include "seal/evaluator.h"
+#include "seal/evaluatorworkspace.h"
+#include "seal/keygenerator.h"
+#include "seal/memorymanager.h"
+#include "seal/modulus.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace seal;
+using namespace std;
+
+namespace sealtest
+{
+    namespace
+    {
+        // Number of allocation requests served by the global memory pool so far
+        uint64_t global_request_count()
+        {
+            MemoryPoolStats stats = MemoryManager::GetPool().stats();
+            return stats.hit_count + stats.miss_count;
+        }
+
+        // Runs ops once to warm up the workspace, then again, and checks that the second run neither reserves memory
+        // in the workspace nor allocates from the global memory pool
+        void check_allocation_free(const EvaluatorWorkspace &workspace, const function<void()> &ops)
+        {
+            ops();
+            ASSERT_EQ(0ULL, workspace.pool().stats().in_use_byte_count);
+
+            size_t reserved_byte_count = workspace.reserved_byte_count();
+            uint64_t miss_count = workspace.pool().stats().miss_count;
+            uint64_t request_count = global_request_count();
+
+            ops();
+            ASSERT_EQ(reserved_byte_count, workspace.reserved_byte_count());
+            ASSERT_EQ(miss_count, workspace.pool().stats().miss_count);
+            ASSERT_EQ(request_count, global_request_count());
+            ASSERT_EQ(0ULL, workspace.pool().stats().in_use_byte_count);
+        }
+    } // namespace
+
+    TEST(EvaluatorWorkspaceTest, Create)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(65537);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40 }));
+        SEALContext context(parms, false, sec_level_type::none);
+
+        EvaluatorWorkspace workspace(context);
+        ASSERT_TRUE(workspace.pool());
+        ASSERT_EQ(
+            EvaluatorWorkspace::EstimateByteCount(context, context.first_parms_id()), workspace.reserved_byte_count());
+        ASSERT_LE(
+            EvaluatorWorkspace::EstimateByteCount(context, context.last_parms_id()),
+            EvaluatorWorkspace::EstimateByteCount(context, context.first_parms_id()));
+
+        MemoryPoolHandle pool = workspace;
+        ASSERT_EQ(workspace.reserved_byte_count(), pool.alloc_byte_count());
+
+        ASSERT_THROW(EvaluatorWorkspace(context, parms_id_zero), invalid_argument);
+        parms.set_plain_modulus(0);
+        ASSERT_THROW(EvaluatorWorkspace(SEALContext(parms, false, sec_level_type::none)), invalid_argument);
+    }
+
+    TEST(EvaluatorWorkspaceTest, BFVAllocationFree)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 60, 60, 60, 60 }));
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        RelinKeys rlk;
+        keygen.create_relin_keys(rlk);
+        GaloisKeys galk;
+        keygen.create_galois_keys(vector<int>{ 0, 1 }, galk);
+
+        Encryptor encryptor(context, pk);
+        Decryptor decryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+        BatchEncoder encoder(context);
+
+        vector<uint64_t> values(encoder.slot_count());
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            values[i] = i % 7;
+        }
+        Plaintext plain;
+        encoder.encode(values, plain);
+        Ciphertext encrypted, result;
+        encryptor.encrypt(plain, encrypted);
+
+        // Reserve the result once so that the operations do not resize it
+        result.reserve(context, 3);
+
+        EvaluatorWorkspace workspace(context);
+        check_allocation_free(workspace, [&]() {
+            result = encrypted;
+            evaluator.multiply_inplace(result, encrypted, workspace);
+            evaluator.relinearize_inplace(result, rlk, workspace);
+            evaluator.rotate_rows_inplace(result, 1, galk, workspace);
+            evaluator.rotate_columns_inplace(result, galk, workspace);
+            evaluator.mod_switch_to_next_inplace(result, workspace);
+        });
+
+        Plaintext plain_result;
+        decryptor.decrypt(result, plain_result);
+        vector<uint64_t> values_result;
+        encoder.decode(plain_result, values_result);
+        size_t row_size = values.size() / 2;
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            size_t row = i / row_size;
+            size_t source = (1 - row) * row_size + (i % row_size + 1) % row_size;
+            ASSERT_EQ(values[source] * values[source], values_result[i]);
+        }
+    }
+
+    TEST(EvaluatorWorkspaceTest, CKKSAllocationFree)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        parms.set_poly_modulus_degree(64);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 60, 40, 40, 60 }));
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        RelinKeys rlk;
+        keygen.create_relin_keys(rlk);
+        GaloisKeys galk;
+        keygen.create_galois_keys(galk);
+
+        Encryptor encryptor(context, pk);
+        Decryptor decryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+        CKKSEncoder encoder(context);
+
+        double scale = pow(2.0, 40);
+        vector<double> values(encoder.slot_count());
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            values[i] = static_cast<double>(i % 5) / 4.0;
+        }
+        Plaintext plain;
+        encoder.encode(values, scale, plain);
+        Ciphertext encrypted, result;
+        encryptor.encrypt(plain, encrypted);
+
+        result.reserve(context, 3);
+
+        EvaluatorWorkspace workspace(context);
+        check_allocation_free(workspace, [&]() {
+            result = encrypted;
+            evaluator.square_inplace(result, workspace);
+            evaluator.relinearize_inplace(result, rlk, workspace);
+            evaluator.rescale_to_next_inplace(result, workspace);
+            evaluator.rotate_vector_inplace(result, 1, galk, workspace);
+            evaluator.complex_conjugate_inplace(result, galk, workspace);
+        });
+
+        Plaintext plain_result;
+        decryptor.decrypt(result, plain_result);
+        vector<double> values_result;
+        encoder.decode(plain_result, values_result);
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            double expected = values[(i + 1) % values.size()] * values[(i + 1) % values.size()];
+            ASSERT_NEAR(expected, values_result[i], 0.01);
+        }
+    }
+} // namespace sealtest
@@ -48,6 +48,14 @@ namespace sealtest
             }
             ASSERT_TRUE(is_valid_for(evk, context));
 
+            keygen.create_relin_keys(3, evk);
+            ASSERT_EQ(3ULL, evk.size());
+            ASSERT_TRUE(evk.has_key(2));
+            ASSERT_TRUE(evk.has_key(4));
+            ASSERT_FALSE(evk.has_key(5));
+            ASSERT_TRUE(is_valid_for(evk, context));
+            ASSERT_THROW(keygen.create_relin_keys(0, evk), invalid_argument);
+
             GaloisKeys galks;
             keygen.create_galois_keys(galks);
             for (auto &a : galks.data())
@@ -0,0 +1,293 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/batchencoder.h"
+#include "seal/ckks.h"
+#include "seal/context.h"
+#include "seal/decryptor.h"
+#include "seal/encryptor.h"
+#include "seal/evaluator.h"
+#include "seal/keygenerator.h"
+#include "seal/lineartransform.h"
+#include "seal/modulus.h"
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace seal;
+using namespace std;
+
+namespace sealtest
+{
+    TEST(LinearTransformTest, Diagonals)
+    {
+        vector<vector<int>> matrix{ { 1, 2, 0 }, { 0, 3, 0 }, { 4, 0, 0 } };
+        auto diagonals = LinearTransform::Diagonals(matrix);
+        ASSERT_EQ(size_t(2), diagonals.size());
+        ASSERT_TRUE((vector<int>{ 1, 3, 0 }) == diagonals[0]);
+        ASSERT_TRUE((vector<int>{ 2, 0, 4 }) == diagonals[1]);
+        ASSERT_EQ(size_t(0), diagonals.count(2));
+
+        ASSERT_THROW(LinearTransform::Diagonals(vector<vector<int>>{}), invalid_argument);
+        ASSERT_THROW(LinearTransform::Diagonals(vector<vector<int>>{ { 1, 2 }, { 3 } }), invalid_argument);
+    }
+
+    TEST(LinearTransformTest, CKKSApply)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        parms.set_poly_modulus_degree(64);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 60, 40, 40, 60 }));
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        CKKSEncoder encoder(context);
+        size_t slot_count = encoder.slot_count();
+        const double delta = static_cast<double>(1ULL << 30);
+
+        vector<complex<double>> input(slot_count);
+        for (size_t i = 0; i < slot_count; i++)
+        {
+            input[i] = complex<double>(static_cast<double>(i % 7), -static_cast<double>(i % 3));
+        }
+
+        // A dense matrix and a tridiagonal matrix
+        vector<vector<complex<double>>> dense(slot_count, vector<complex<double>>(slot_count));
+        vector<vector<complex<double>>> tridiagonal(slot_count, vector<complex<double>>(slot_count));
+        for (size_t i = 0; i < slot_count; i++)
+        {
+            for (size_t j = 0; j < slot_count; j++)
+            {
+                dense[i][j] = static_cast<double>((i * 3 + j * 5) % 5) - 2.0;
+            }
+            tridiagonal[i][i] = 2.0;
+            tridiagonal[i][(i + 1) % slot_count] = -1.0;
+            tridiagonal[i][(i + slot_count - 1) % slot_count] = complex<double>(0.0, 1.0);
+        }
+        map<int, vector<complex<double>>> tridiagonal_diagonals{
+            { 0, vector<complex<double>>(slot_count, 2.0) },
+            { 1, vector<complex<double>>(slot_count, -1.0) },
+            { -1, vector<complex<double>>(slot_count, complex<double>(0.0, 1.0)) }
+        };
+
+        auto test = [&](const vector<vector<complex<double>>> &matrix, const LinearTransform &transform) {
+            GaloisKeys glk;
+            keygen.create_galois_keys(transform.galois_steps(), glk);
+
+            Plaintext plain;
+            Ciphertext encrypted;
+            encoder.encode(input, transform.parms_id(), delta, plain);
+            encryptor.encrypt(plain, encrypted);
+            Ciphertext result;
+            transform.apply(evaluator, encrypted, glk, result);
+            ASSERT_EQ(transform.parms_id(), result.parms_id());
+            ASSERT_DOUBLE_EQ(delta * transform.scale(), result.scale());
+
+            vector<complex<double>> output;
+            decryptor.decrypt(result, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_count; i++)
+            {
+                complex<double> expected = 0;
+                for (size_t j = 0; j < slot_count; j++)
+                {
+                    expected += matrix[i][j] * input[j];
+                }
+                ASSERT_EQ(expected.real(), round(output[i].real()));
+                ASSERT_EQ(expected.imag(), round(output[i].imag()));
+            }
+        };
+
+        {
+            LinearTransform transform(
+                context, encoder, LinearTransform::Diagonals(dense), context.first_parms_id(), delta);
+            ASSERT_EQ(slot_count, transform.dimension());
+            ASSERT_LT(transform.rotation_count(), size_t(12));
+            test(dense, transform);
+        }
+        {
+            // Explicit baby step counts, including the degenerate ones
+            for (size_t baby_step_count : { size_t(1), size_t(4), size_t(7), slot_count })
+            {
+                LinearTransform transform(
+                    context, encoder, LinearTransform::Diagonals(dense), context.first_parms_id(), delta,
+                    baby_step_count);
+                ASSERT_EQ(baby_step_count, transform.baby_step_count());
+                test(dense, transform);
+            }
+        }
+        {
+            LinearTransform transform(context, encoder, tridiagonal_diagonals, context.first_parms_id(), delta);
+            ASSERT_EQ(size_t(2), transform.rotation_count());
+            test(tridiagonal, transform);
+        }
+        {
+            // Lower level
+            auto parms_id = context.first_context_data()->next_context_data()->parms_id();
+            LinearTransform transform(context, encoder, tridiagonal_diagonals, parms_id, delta);
+            test(tridiagonal, transform);
+
+            GaloisKeys glk;
+            keygen.create_galois_keys(transform.galois_steps(), glk);
+            Plaintext plain;
+            Ciphertext encrypted;
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            encryptor.encrypt(plain, encrypted);
+            Ciphertext result;
+            ASSERT_THROW(transform.apply(evaluator, encrypted, glk, result), invalid_argument);
+        }
+
+        ASSERT_THROW(
+            LinearTransform(context, encoder, map<int, vector<complex<double>>>{}, context.first_parms_id(), delta),
+            invalid_argument);
+        ASSERT_THROW(
+            LinearTransform(
+                context, encoder,
+                map<int, vector<complex<double>>>{
+                    { 0, vector<complex<double>>(slot_count) },
+                    { static_cast<int>(slot_count), vector<complex<double>>(slot_count) } },
+                context.first_parms_id(), delta),
+            invalid_argument);
+        ASSERT_THROW(
+            LinearTransform(
+                context, encoder, map<int, vector<complex<double>>>{ { 0, vector<complex<double>>(slot_count - 1) } },
+                context.first_parms_id(), delta),
+            invalid_argument);
+    }
+
+    TEST(LinearTransformTest, BFVBGVApply)
+    {
+        auto test_scheme = [](scheme_type scheme) {
+            EncryptionParameters parms(scheme);
+            parms.set_poly_modulus_degree(64);
+            parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+            parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40 }));
+            SEALContext context(parms, true, sec_level_type::none);
+            KeyGenerator keygen(context);
+            PublicKey pk;
+            keygen.create_public_key(pk);
+
+            Encryptor encryptor(context, pk);
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            BatchEncoder encoder(context);
+            uint64_t t = parms.plain_modulus().value();
+            size_t slot_count = encoder.slot_count();
+            size_t row_size = slot_count / 2;
+
+            vector<uint64_t> input(slot_count);
+            for (size_t i = 0; i < slot_count; i++)
+            {
+                input[i] = (i * 7 + 3) % 100;
+            }
+
+            // Row-size diagonals apply to both rows; full diagonals differ between the rows
+            map<int, vector<uint64_t>> shared_diagonals;
+            map<int, vector<uint64_t>> full_diagonals;
+            for (size_t k = 0; k < row_size; k += 3)
+            {
+                vector<uint64_t> diagonal(slot_count);
+                for (size_t i = 0; i < slot_count; i++)
+                {
+                    diagonal[i] = (i * 5 + k * 11) % 50 + (i < row_size ? 0 : t - 60);
+                }
+                full_diagonals.emplace(static_cast<int>(k), diagonal);
+                diagonal.resize(row_size);
+                shared_diagonals.emplace(static_cast<int>(k) - static_cast<int>(row_size), diagonal);
+            }
+
+            auto test = [&](const map<int, vector<uint64_t>> &diagonals, const LinearTransform &transform,
+                            bool ntt_form) {
+                GaloisKeys glk;
+                keygen.create_galois_keys(transform.galois_steps(), glk);
+
+                Plaintext plain;
+                Ciphertext encrypted;
+                encoder.encode(input, plain);
+                encryptor.encrypt(plain, encrypted);
+                while (encrypted.parms_id() != transform.parms_id())
+                {
+                    evaluator.mod_switch_to_next_inplace(encrypted);
+                }
+                if (ntt_form)
+                {
+                    // BFV ciphertexts in NTT form stay in NTT form
+                    evaluator.transform_to_ntt_inplace(encrypted);
+                }
+                Ciphertext result;
+                transform.apply(evaluator, encrypted, glk, result);
+                if (ntt_form)
+                {
+                    ASSERT_TRUE(result.is_ntt_form());
+                    evaluator.transform_from_ntt_inplace(result);
+                }
+
+                vector<uint64_t> output;
+                decryptor.decrypt(result, plain);
+                encoder.decode(plain, output);
+                for (size_t row = 0; row < 2; row++)
+                {
+                    for (size_t i = 0; i < row_size; i++)
+                    {
+                        uint64_t expected = 0;
+                        for (const auto &diagonal : diagonals)
+                        {
+                            size_t k = static_cast<size_t>(diagonal.first + static_cast<int>(row_size)) % row_size;
+                            size_t index = diagonal.second.size() == row_size ? i : row * row_size + i;
+                            uint64_t value = input[row * row_size + (i + k) % row_size];
+                            expected = (expected + diagonal.second[index] * value) % t;
+                        }
+                        ASSERT_EQ(expected, output[row * row_size + i]);
+                    }
+                }
+            };
+
+            {
+                LinearTransform transform(context, encoder, shared_diagonals, context.first_parms_id());
+                ASSERT_EQ(row_size, transform.dimension());
+                ASSERT_DOUBLE_EQ(1.0, transform.scale());
+                test(shared_diagonals, transform, false);
+            }
+            {
+                LinearTransform transform(context, encoder, full_diagonals, context.first_parms_id(), 4);
+                ASSERT_EQ(size_t(4), transform.baby_step_count());
+                test(full_diagonals, transform, false);
+                if (scheme == scheme_type::bfv)
+                {
+                    test(full_diagonals, transform, true);
+                }
+            }
+            {
+                // Lower level
+                auto parms_id = context.first_context_data()->next_context_data()->parms_id();
+                LinearTransform transform(context, encoder, full_diagonals, parms_id);
+                test(full_diagonals, transform, false);
+                if (scheme == scheme_type::bfv)
+                {
+                    test(full_diagonals, transform, true);
+                }
+            }
+
+            ASSERT_THROW(
+                LinearTransform(
+                    context, encoder, map<int, vector<uint64_t>>{ { 1, vector<uint64_t>(row_size + 1) } },
+                    context.first_parms_id()),
+                invalid_argument);
+            ASSERT_THROW(
+                LinearTransform(
+                    context, encoder, map<int, vector<uint64_t>>{ { 1, vector<uint64_t>(row_size) } },
+                    context.first_parms_id(), row_size + 1),
+                invalid_argument);
+        };
+        test_scheme(scheme_type::bfv);
+        test_scheme(scheme_type::bgv);
+    }
+} // namespace sealtest
@@ -1,10 +1,19 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+#include "seal/ciphertext.h"
+#include "seal/context.h"
+#include "seal/decryptor.h"
 #include "seal/dynarray.h"
+#include "seal/encryptor.h"
+#include "seal/evaluator.h"
+#include "seal/keygenerator.h"
 #include "seal/memorymanager.h"
 #include "seal/util/pointer.h"
 #include "seal/util/uintcore.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
 #include "gtest/gtest.h"
 
 using namespace seal;
@@ -67,4 +76,229 @@ namespace sealtest
         }
         ASSERT_EQ(1L, pool.use_count());
     }
+
+    TEST(MemoryPoolHandleTest, Stats)
+    {
+        MemoryPoolHandle pool;
+        ASSERT_TRUE(pool.stats().size_classes.empty());
+        ASSERT_THROW(pool.set_stats_callback(nullptr), logic_error);
+
+        auto test_stats = [](MemoryPoolHandle pool) {
+            size_t report_count = 0;
+            MemoryPoolStats last_report;
+            pool.set_stats_callback([&](const MemoryPoolStats &stats) {
+                report_count++;
+                last_report = stats;
+            });
+
+            {
+                auto ptr1(allocate_uint(5, pool));
+                ASSERT_EQ(1ULL, report_count);
+                ASSERT_EQ(5ULL * bytes_per_uint64, last_report.alloc_byte_count);
+                ASSERT_EQ(1ULL, last_report.miss_count);
+
+                auto ptr2(allocate_uint(5, pool));
+                auto ptr3(allocate_uint(2, pool));
+                ASSERT_EQ(3ULL, report_count);
+
+                MemoryPoolStats stats = pool.stats();
+                ASSERT_EQ(2ULL, stats.size_classes.size());
+                ASSERT_EQ(5ULL * bytes_per_uint64, stats.size_classes[0].item_byte_count);
+                ASSERT_EQ(3ULL, stats.size_classes[0].item_count);
+                ASSERT_EQ(2ULL, stats.size_classes[0].in_use_count);
+                ASSERT_EQ(1ULL, stats.size_classes[0].free_count());
+                ASSERT_EQ(2ULL * bytes_per_uint64, stats.size_classes[1].item_byte_count);
+                ASSERT_EQ(1ULL, stats.size_classes[1].in_use_count);
+                ASSERT_EQ(17ULL * bytes_per_uint64, stats.alloc_byte_count);
+                ASSERT_EQ(12ULL * bytes_per_uint64, stats.in_use_byte_count);
+                ASSERT_EQ(0ULL, stats.hit_count);
+                ASSERT_EQ(3ULL, stats.miss_count);
+            }
+
+            // Released memory is reused without reserving more
+            MemoryPoolStats stats = pool.stats();
+            ASSERT_EQ(0ULL, stats.in_use_byte_count);
+            {
+                auto ptr1(allocate_uint(5, pool));
+                auto ptr2(allocate_uint(5, pool));
+            }
+            ASSERT_EQ(3ULL, report_count);
+            stats = pool.stats();
+            ASSERT_EQ(2ULL, stats.hit_count);
+            ASSERT_EQ(3ULL, stats.miss_count);
+            ASSERT_EQ(17ULL * bytes_per_uint64, stats.alloc_byte_count);
+            ASSERT_EQ(17ULL * bytes_per_uint64, stats.peak_alloc_byte_count);
+            ASSERT_EQ(3ULL, stats.size_classes[0].peak_item_count);
+            ASSERT_TRUE(stats.allocation_rate() >= 0.0);
+
+            // Removing the callback
+            pool.set_stats_callback(nullptr);
+            auto ptr(allocate_uint(7, pool));
+            ASSERT_EQ(3ULL, report_count);
+        };
+
+        test_stats(MemoryPoolHandle::New());
+        test_stats(MemoryPoolHandle(make_shared<MemoryPoolST>()));
+    }
+
+    TEST(MemoryPoolHandleTest, Trim)
+    {
+        MemoryPoolHandle pool;
+        ASSERT_EQ(0ULL, pool.trim());
+        ASSERT_THROW(pool.set_trim_policy(MemoryPoolTrimPolicy()), logic_error);
+
+        auto test_trim = [](MemoryPoolHandle pool) {
+            {
+                auto ptr1(allocate_uint(100, pool));
+                auto ptr2(allocate_uint(50, pool));
+                ASSERT_EQ(150ULL * bytes_per_uint64, pool.alloc_byte_count());
+
+                // Only the size class with no allocation in use is released
+                ptr1.release();
+                ASSERT_EQ(100ULL * bytes_per_uint64, pool.trim());
+                ASSERT_EQ(1ULL, pool.pool_count());
+                ASSERT_EQ(50ULL * bytes_per_uint64, pool.alloc_byte_count());
+            }
+            ASSERT_EQ(50ULL * bytes_per_uint64, pool.trim());
+            ASSERT_EQ(0ULL, pool.pool_count());
+            ASSERT_EQ(0ULL, pool.alloc_byte_count());
+            ASSERT_EQ(0ULL, pool.trim());
+
+            // The pool works as before after trimming
+            auto ptr(allocate_uint(100, pool));
+            ASSERT_EQ(100ULL * bytes_per_uint64, pool.alloc_byte_count());
+            ptr.release();
+
+            // Bounded capacity releases the least recently used idle size classes when the pool grows
+            MemoryPoolTrimPolicy policy;
+            policy.max_alloc_byte_count = 150 * bytes_per_uint64;
+            pool.set_trim_policy(policy);
+            ASSERT_EQ(policy.max_alloc_byte_count, pool.trim_policy().max_alloc_byte_count);
+            {
+                auto ptr1(allocate_uint(20, pool));
+                ASSERT_EQ(120ULL * bytes_per_uint64, pool.alloc_byte_count());
+                auto ptr2(allocate_uint(40, pool));
+                ASSERT_EQ(60ULL * bytes_per_uint64, pool.alloc_byte_count());
+                ASSERT_EQ(2ULL, pool.pool_count());
+
+                // Memory in use is not limited
+                auto ptr3(allocate_uint(200, pool));
+                ASSERT_EQ(260ULL * bytes_per_uint64, pool.alloc_byte_count());
+            }
+
+            // Idle size classes are released after max_idle_time while the pool is used
+            policy = MemoryPoolTrimPolicy();
+            policy.max_idle_time = chrono::milliseconds(1);
+            pool.set_trim_policy(policy);
+            this_thread::sleep_for(chrono::milliseconds(5));
+            for (int i = 0; i < 10000 && pool.pool_count() > 1; i++)
+            {
+                auto ptr1(allocate_uint(20, pool));
+                this_thread::sleep_for(chrono::microseconds(1));
+            }
+            ASSERT_EQ(1ULL, pool.pool_count());
+            ASSERT_EQ(20ULL * bytes_per_uint64, pool.alloc_byte_count());
+        };
+
+        test_trim(MemoryPoolHandle::New());
+        test_trim(MemoryPoolHandle(make_shared<MemoryPoolST>()));
+    }
+
+    TEST(MemoryManagerTest, MMProfNUMA)
+    {
+        MMProfNUMA prof(true);
+        ASSERT_EQ(numa_node_count(), prof.pool_count());
+        ASSERT_TRUE(current_numa_node() < prof.pool_count());
+        ASSERT_THROW(auto pool = prof.pool_for_node(prof.pool_count()), out_of_range);
+
+        // Every node has its own pool
+        for (size_t node = 0; node < prof.pool_count(); node++)
+        {
+            MemoryPoolHandle pool = prof.pool_for_node(node);
+            ASSERT_TRUE(pool);
+            for (size_t other = 0; other < node; other++)
+            {
+                ASSERT_FALSE(pool == prof.pool_for_node(other));
+            }
+
+            // Allocations of whole pages and of parts of a page work alike
+            auto ptr1(allocate_uint(10, pool));
+            auto ptr2(allocate_uint(4096, pool));
+            ptr1[9] = 1;
+            ptr2[4095] = 2;
+            ASSERT_EQ(2ULL, pool.pool_count());
+        }
+
+        // The profile hands out the pool of the node of the calling thread
+        MemoryPoolHandle pool = prof.get_pool(mm_prof_opt::mm_default);
+        ASSERT_TRUE(pool);
+        if (prof.pool_count() == 1)
+        {
+            ASSERT_TRUE(pool == prof.pool_for_node(0));
+        }
+        {
+            MMProfGuard guard(make_unique<MMProfNUMA>());
+            DynArray<uint64_t> arr(100);
+            ASSERT_EQ(100ULL, arr.size());
+        }
+
+        // Memory preferring a node is allocated as usual on every system
+        auto bound_pool = make_shared<MemoryPoolMT>(false, false, 0);
+        ASSERT_EQ(0, bound_pool->numa_node());
+        auto ptr(allocate_uint(10000, MemoryPoolHandle(bound_pool)));
+        fill_n(ptr.get(), 10000, uint64_t(1));
+        ASSERT_EQ(10000ULL * bytes_per_uint64, bound_pool->alloc_byte_count());
+    }
+
+    TEST(MemoryManagerTest, MMProfArena)
+    {
+        MemoryPoolHandle arena;
+        {
+            MMProfGuard guard(make_unique<MMProfArena>(4096));
+            arena = MemoryManager::GetPool();
+            ASSERT_TRUE(arena == MemoryManager::GetPool(mm_prof_opt::mm_default));
+            ASSERT_FALSE(arena == MemoryManager::GetPool(mm_prof_opt::mm_force_global));
+
+            // Objects allocated in the scope take their memory from the arena
+            DynArray<uint64_t> arr1(100);
+            DynArray<uint64_t> arr2(1000);
+            ASSERT_TRUE(arr1.pool() == arena);
+            ASSERT_TRUE(arena.alloc_byte_count() >= 1100ULL * bytes_per_uint64);
+            ASSERT_EQ(1100ULL * bytes_per_uint64, arena.stats().in_use_byte_count);
+        }
+
+        // The arena lives on while a handle to it remains
+        ASSERT_EQ(0ULL, arena.stats().in_use_byte_count);
+        ASSERT_TRUE(arena.use_count() == 1);
+        ASSERT_FALSE(MemoryManager::GetPool() == arena);
+
+        // Ciphertexts and evaluator temporaries use the arena without changes to their use
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(257);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 60, 60, 60 }));
+        SEALContext context(parms, false, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        RelinKeys rlk;
+        keygen.create_relin_keys(rlk);
+        Encryptor encryptor(context, pk);
+        Decryptor decryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+        Plaintext plain;
+        {
+            MMProfGuard guard(make_unique<MMProfArena>());
+            arena = MemoryManager::GetPool();
+            Ciphertext encrypted;
+            encryptor.encrypt(Plaintext("3"), encrypted);
+            evaluator.square_inplace(encrypted);
+            evaluator.relinearize_inplace(encrypted, rlk);
+            decryptor.decrypt(encrypted, plain);
+            ASSERT_TRUE(encrypted.pool() == arena);
+            ASSERT_TRUE(arena.stats().miss_count + arena.stats().hit_count > 0);
+        }
+        ASSERT_EQ("9", plain.to_string());
+        ASSERT_EQ(0ULL, arena.stats().in_use_byte_count);
+    }
 } // namespace sealtest
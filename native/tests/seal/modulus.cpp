@@ -221,6 +221,13 @@ namespace sealtest
         // Too small primes requested
         ASSERT_THROW(auto modulus = CoeffModulus::Create(2, Modulus(2), { 2 }), logic_error);
         ASSERT_THROW(auto modulus = CoeffModulus::Create(2, Modulus(30), { 6, 6 }), logic_error);
+
+        // Invalid bit_count
+        ASSERT_THROW(auto modulus = CoeffModulus::CreateSmallWord(2048, 0), invalid_argument);
+        ASSERT_THROW(auto modulus = CoeffModulus::CreateSmallWord(2048, 30 * 256 + 1), invalid_argument);
+
+        // Too small primes requested
+        ASSERT_THROW(auto modulus = CoeffModulus::CreateSmallWord(1024, 8), logic_error);
         ASSERT_THROW(auto modulus = CoeffModulus::Create(1024, Modulus(257), { 20 }), logic_error);
         ASSERT_THROW(auto modulus = CoeffModulus::Create(1024, Modulus(255), { 22, 22, 22 }), logic_error);
     }
@@ -297,5 +304,17 @@ namespace sealtest
         ASSERT_EQ(22, get_significant_bit_count(cm[1].value()));
         ASSERT_EQ(3133441ULL, cm[0].value());
         ASSERT_EQ(3655681ULL, cm[1].value());
+
+        cm = CoeffModulus::CreateSmallWord(4096, 30);
+        ASSERT_EQ(1, cm.size());
+        ASSERT_EQ(30, cm[0].bit_count());
+
+        cm = CoeffModulus::CreateSmallWord(8192, 218);
+        ASSERT_EQ(8, cm.size());
+        for (size_t i = 0; i < cm.size(); i++)
+        {
+            ASSERT_EQ(i < 2 ? 28 : 27, cm[i].bit_count());
+            ASSERT_EQ(1ULL, cm[i].value() % 16384);
+        }
     }
 } // namespace sealtest
@@ -9,6 +9,7 @@
 #include "seal/util/uintcore.h"
 #include <algorithm>
 #include <memory>
+#include <thread>
 #include <vector>
 #include "gtest/gtest.h"
 
@@ -561,5 +562,229 @@ namespace sealtest
             auto ptr = allocate(bytes.begin(), bytes.size(), pool);
             ASSERT_TRUE(equal(bytes.begin(), bytes.end(), ptr.get()));
         }
+
+        TEST(MemoryPoolTests, HugePages)
+        {
+            auto test_pool = [](MemoryPool &pool) {
+                vector<Pointer<seal_byte>> held;
+                for (size_t byte_count : { size_t(1), size_t(8), size_t(100), size_t(4096), size_t(1) << 16,
+                                           (size_t(1) << 21) + 8, size_t(3) << 22 })
+                {
+                    for (size_t i = 0; i < 5; i++)
+                    {
+                        held.push_back(pool.get_for_byte_count(byte_count));
+                        ASSERT_EQ(0ULL, reinterpret_cast<uintptr_t>(held.back().get()) % 64);
+
+                        // The memory is usable in full
+                        fill_n(held.back().get(), byte_count, seal_byte(i));
+                    }
+                }
+
+                // Sizes are padded to multiples of 64 bytes
+                ASSERT_EQ(6ULL, pool.pool_count());
+                ASSERT_TRUE(pool.alloc_byte_count() >= 5 * ((size_t(1) << 21) + 64 + (size_t(3) << 22)));
+                held.clear();
+                size_t alloc_byte_count = pool.alloc_byte_count();
+                ASSERT_EQ(alloc_byte_count, pool.trim());
+                ASSERT_EQ(0ULL, pool.pool_count());
+            };
+
+            MemoryPoolMT pool_mt(true, true);
+            test_pool(pool_mt);
+            MemoryPoolST pool_st(false, true);
+            test_pool(pool_st);
+        }
+
+        TEST(MemoryPoolTests, Stack)
+        {
+            MemoryPoolStack pool(1000);
+            ASSERT_EQ(1024ULL, pool.alloc_byte_count());
+            ASSERT_EQ(1ULL, pool.pool_count());
+            {
+                // Allocations are consecutive and aligned
+                auto ptr1 = pool.get_for_byte_count(8);
+                auto ptr2 = pool.get_for_byte_count(100);
+                ASSERT_EQ(0ULL, reinterpret_cast<uintptr_t>(ptr1.get()) % 64);
+                ASSERT_EQ(ptr1.get() + 64, ptr2.get());
+                ASSERT_THROW(pool.reserve(2048), logic_error);
+
+                // Memory released at the top is reused
+                seal_byte *top = ptr2.get();
+                ptr2.release();
+                ptr2 = pool.get_for_byte_count(64);
+                ASSERT_EQ(top, ptr2.get());
+
+                // Memory released below the top is reused once the top is released
+                ptr1.release();
+                auto ptr3 = pool.get_for_byte_count(64);
+                ASSERT_EQ(top + 64, ptr3.get());
+                ptr3.release();
+                ptr2.release();
+                ptr3 = pool.get_for_byte_count(64);
+                ASSERT_EQ(top - 64, ptr3.get());
+            }
+            MemoryPoolStats stats = pool.stats();
+            ASSERT_EQ(0ULL, stats.in_use_byte_count);
+            ASSERT_EQ(5ULL, stats.hit_count);
+            ASSERT_EQ(0ULL, stats.miss_count);
+
+            // A request that does not fit reserves another block, and the blocks are merged once all are released
+            {
+                auto ptr1 = pool.get_for_byte_count(1000);
+                auto ptr2 = pool.get_for_byte_count(1000);
+                fill_n(ptr2.get(), 1000, seal_byte(1));
+                ASSERT_EQ(2048ULL, pool.alloc_byte_count());
+            }
+            ASSERT_EQ(1ULL, pool.stats().miss_count);
+            {
+                auto ptr1 = pool.get_for_byte_count(1000);
+                auto ptr2 = pool.get_for_byte_count(1000);
+                ASSERT_EQ(ptr1.get() + 1024, ptr2.get());
+                ASSERT_EQ(2048ULL, pool.alloc_byte_count());
+            }
+            ASSERT_EQ(1ULL, pool.stats().miss_count);
+            ASSERT_EQ(1ULL, pool.pool_count());
+
+            // Elements are initialized and copied in full
+            {
+                auto values = allocate<uint64_t>(100, pool, uint64_t(7));
+                ASSERT_TRUE(all_of(values.get(), values.get() + 100, [](uint64_t value) { return value == 7; }));
+                auto copies = allocate(values.get(), 100, pool);
+                ASSERT_TRUE(equal(values.get(), values.get() + 100, copies.get()));
+            }
+
+            pool.reserve(4096);
+            ASSERT_EQ(4096ULL, pool.alloc_byte_count());
+            ASSERT_EQ(4096ULL, pool.trim());
+            ASSERT_EQ(0ULL, pool.alloc_byte_count());
+            auto ptr = pool.get_for_byte_count(10);
+            ASSERT_EQ(64ULL, pool.alloc_byte_count());
+        }
+
+        TEST(MemoryPoolTests, Arena)
+        {
+            MemoryPoolArena pool(1000);
+            ASSERT_EQ(0ULL, pool.alloc_byte_count());
+            ASSERT_EQ(0ULL, pool.pool_count());
+            vector<Pointer<seal_byte>> held;
+            {
+                // Allocations are aligned, follow each other, and are not reused once released
+                auto ptr1 = pool.get_for_byte_count(8);
+                ASSERT_EQ(1024ULL, pool.alloc_byte_count());
+                auto ptr2 = pool.get_for_byte_count(100);
+                ASSERT_EQ(0ULL, reinterpret_cast<uintptr_t>(ptr1.get()) % 64);
+                ASSERT_TRUE(ptr2.get() > ptr1.get());
+                ASSERT_EQ(0ULL, reinterpret_cast<uintptr_t>(ptr2.get()) % 64);
+                seal_byte *last = ptr2.get();
+                ptr2.release();
+                ptr2 = pool.get_for_byte_count(100);
+                ASSERT_TRUE(ptr2.get() > last);
+                ASSERT_THROW(pool.reset(), logic_error);
+
+                // Elements are initialized in full
+                auto values = allocate<uint64_t>(20, pool, uint64_t(7));
+                ASSERT_TRUE(all_of(values.get(), values.get() + 20, [](uint64_t value) { return value == 7; }));
+
+                // A full chunk is followed by one at least twice as large
+                held.push_back(pool.get_for_byte_count(1500));
+                ASSERT_EQ(1024ULL + 2048ULL, pool.alloc_byte_count());
+                fill_n(held.back().get(), 1500, seal_byte(1));
+                held.push_back(pool.get_for_byte_count(8000));
+                ASSERT_TRUE(pool.alloc_byte_count() >= 1024ULL + 2048ULL + 8000ULL);
+                fill_n(held.back().get(), 8000, seal_byte(2));
+            }
+            MemoryPoolStats stats = pool.stats();
+            ASSERT_EQ(1500ULL + 8000ULL, stats.in_use_byte_count);
+            ASSERT_EQ(3ULL, stats.miss_count);
+            ASSERT_EQ(3ULL, stats.hit_count);
+            held.clear();
+
+            // A reset makes the memory available again in a single chunk
+            size_t alloc_byte_count = pool.alloc_byte_count();
+            pool.reset();
+            ASSERT_EQ(alloc_byte_count, pool.alloc_byte_count());
+            {
+                auto ptr1 = pool.get_for_byte_count(alloc_byte_count / 2);
+                auto ptr2 = pool.get_for_byte_count(alloc_byte_count / 4);
+                ASSERT_EQ(3ULL, pool.stats().miss_count);
+            }
+
+            ASSERT_EQ(alloc_byte_count, pool.trim());
+            ASSERT_EQ(0ULL, pool.alloc_byte_count());
+
+            // Threads allocate concurrently without overlapping
+            MemoryPoolArena shared_pool;
+            vector<thread> threads;
+            vector<size_t> failures(4, 0);
+            for (size_t t = 0; t < failures.size(); t++)
+            {
+                threads.emplace_back([&, t]() {
+                    vector<Pointer<seal_byte>> ptrs;
+                    for (size_t i = 0; i < 500; i++)
+                    {
+                        ptrs.push_back(shared_pool.get_for_byte_count(100 + i));
+                        fill_n(ptrs.back().get(), 100 + i, static_cast<seal_byte>(t));
+                    }
+                    for (size_t i = 0; i < ptrs.size(); i++)
+                    {
+                        failures[t] += static_cast<size_t>(
+                            !all_of(ptrs[i].get(), ptrs[i].get() + 100 + i, [t](seal_byte b) {
+                                return b == static_cast<seal_byte>(t);
+                            }));
+                    }
+                });
+            }
+            for (auto &th : threads)
+            {
+                th.join();
+            }
+            for (auto failure : failures)
+            {
+                ASSERT_EQ(0ULL, failure);
+            }
+            ASSERT_EQ(0ULL, shared_pool.stats().in_use_byte_count);
+        }
+
+        TEST(MemoryPoolTests, ConcurrentMT)
+        {
+            MemoryPoolMT pool(true);
+            size_t thread_count = 8;
+            size_t round_count = 2000;
+            vector<size_t> failures(thread_count, 0);
+            vector<thread> threads;
+            for (size_t t = 0; t < thread_count; t++)
+            {
+                threads.emplace_back([&, t]() {
+                    // Every thread writes its own id into the memory it holds; a buffer handed out twice at the same
+                    // time would be overwritten by another thread
+                    for (size_t round = 0; round < round_count; round++)
+                    {
+                        size_t count = 1 + (round + t) % 40;
+                        vector<Pointer<uint64_t>> held;
+                        for (size_t i = 0; i < count; i++)
+                        {
+                            held.push_back(allocate_uint(1 + i % 3, pool));
+                            fill_n(held.back().get(), 1 + i % 3, static_cast<uint64_t>(t));
+                        }
+                        for (size_t i = 0; i < count; i++)
+                        {
+                            if (any_of(held[i].get(), held[i].get() + 1 + i % 3, [&](uint64_t v) { return v != t; }))
+                            {
+                                failures[t]++;
+                            }
+                        }
+                    }
+                });
+            }
+            for (auto &th : threads)
+            {
+                th.join();
+            }
+            for (size_t t = 0; t < thread_count; t++)
+            {
+                ASSERT_EQ(0ULL, failures[t]);
+            }
+            ASSERT_EQ(3ULL, pool.pool_count());
+        }
     } // namespace util
 } // namespace sealtest
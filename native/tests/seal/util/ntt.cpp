@@ -5,6 +5,8 @@
 #include "seal/util/ntt.h"
 #include "seal/util/numth.h"
 #include "seal/util/polycore.h"
+#include "seal/util/simd.h"
+#include "seal/util/threadpool.h"
 #include <cstddef>
 #include <cstdint>
 #include <random>
@@ -131,5 +133,343 @@ namespace sealtest
                 ASSERT_EQ(temp[i], poly[i]);
             }
         }
+
+        TEST(NTTTablesTest, BatchedNegacyclicNTTTest)
+        {
+            MemoryPoolHandle pool = MemoryPoolHandle::Global();
+            Pointer<NTTTables> tables;
+            random_device rd;
+            ThreadPool thread_pool(3);
+
+            for (int coeff_count_power : { 4, 10, 15 })
+            {
+                size_t coeff_count = size_t(1) << coeff_count_power;
+                size_t coeff_modulus_size = 3;
+                size_t size = 3;
+                auto moduli = get_primes(uint64_t(2) << coeff_count_power, 60, coeff_modulus_size);
+                ASSERT_NO_THROW(CreateNTTTables(coeff_count_power, moduli, tables, pool));
+
+                auto poly(allocate_poly_array(size, coeff_count, coeff_modulus_size, pool));
+                auto expected(allocate_poly_array(size, coeff_count, coeff_modulus_size, pool));
+                PolyIter poly_iter(poly.get(), coeff_count, coeff_modulus_size);
+                RNSIter expected_iter(expected.get(), coeff_count);
+
+                // Transforms of whole polynomials must match transforms of each component
+                auto test_transforms = [&](ThreadPool *threads) {
+                    for (size_t i = 0; i < size * coeff_modulus_size * coeff_count; i++)
+                    {
+                        poly[i] = static_cast<uint64_t>(rd()) % moduli[(i / coeff_count) % coeff_modulus_size].value();
+                        expected[i] = poly[i];
+                    }
+
+                    inverse_ntt_negacyclic_harvey_lazy(poly_iter, size, tables.get(), threads);
+                    for (size_t k = 0; k < size * coeff_modulus_size; k++)
+                    {
+                        inverse_ntt_negacyclic_harvey_lazy(expected_iter[k], tables[k % coeff_modulus_size]);
+                    }
+                    for (size_t i = 0; i < size * coeff_modulus_size * coeff_count; i++)
+                    {
+                        ASSERT_EQ(expected[i], poly[i]);
+                    }
+
+                    ntt_negacyclic_harvey(poly_iter, size, tables.get(), threads);
+                    for (size_t k = 0; k < size * coeff_modulus_size; k++)
+                    {
+                        ntt_negacyclic_harvey(expected_iter[k], tables[k % coeff_modulus_size]);
+                    }
+                    for (size_t i = 0; i < size * coeff_modulus_size * coeff_count; i++)
+                    {
+                        ASSERT_EQ(expected[i], poly[i]);
+                    }
+
+                    inverse_ntt_negacyclic_harvey(*poly_iter, coeff_modulus_size, tables.get(), threads);
+                    for (size_t k = 0; k < coeff_modulus_size; k++)
+                    {
+                        inverse_ntt_negacyclic_harvey(expected_iter[k], tables[k]);
+                    }
+                    for (size_t i = 0; i < coeff_modulus_size * coeff_count; i++)
+                    {
+                        ASSERT_EQ(expected[i], poly[i]);
+                    }
+
+                    ntt_negacyclic_harvey_lazy(*poly_iter, coeff_modulus_size, tables.get(), threads);
+                    for (size_t k = 0; k < coeff_modulus_size; k++)
+                    {
+                        ntt_negacyclic_harvey_lazy(expected_iter[k], tables[k]);
+                    }
+                    for (size_t i = 0; i < coeff_modulus_size * coeff_count; i++)
+                    {
+                        ASSERT_EQ(expected[i], poly[i]);
+                    }
+                };
+                test_transforms(nullptr);
+                test_transforms(&thread_pool);
+
+                // Several polynomials with the same modulus
+                RNSIter same_modulus_iter(poly.get(), coeff_count);
+                for (size_t i = 0; i < size * coeff_count; i++)
+                {
+                    poly[i] = static_cast<uint64_t>(rd()) % moduli[0].value();
+                    expected[i] = poly[i];
+                }
+                inverse_ntt_negacyclic_harvey_lazy(same_modulus_iter, size, tables[0]);
+                ntt_negacyclic_harvey(same_modulus_iter, size, tables[0]);
+                ntt_negacyclic_harvey_lazy(same_modulus_iter, size, tables[0]);
+                for (size_t k = 0; k < size; k++)
+                {
+                    inverse_ntt_negacyclic_harvey_lazy(expected_iter[k], tables[0]);
+                    ntt_negacyclic_harvey(expected_iter[k], tables[0]);
+                    ntt_negacyclic_harvey_lazy(expected_iter[k], tables[0]);
+                }
+                for (size_t i = 0; i < size * coeff_count; i++)
+                {
+                    ASSERT_EQ(expected[i], poly[i]);
+                }
+            }
+        }
+
+        TEST(NTTTablesTest, BlockedNegacyclicNTTTest)
+        {
+            MemoryPoolHandle pool = MemoryPoolHandle::Global();
+            Pointer<NTTTables> tables;
+            random_device rd;
+
+            // Blocked lazy transforms must match the unblocked scalar implementation exactly
+            for (int coeff_count_power = 15; coeff_count_power <= 17; coeff_count_power++)
+            {
+                size_t coeff_count = size_t(1) << coeff_count_power;
+                Modulus modulus(get_prime(uint64_t(2) << coeff_count_power, 60));
+                ASSERT_NO_THROW(tables = allocate<NTTTables>(pool, coeff_count_power, modulus, pool));
+#ifndef SEAL_USE_INTEL_HEXL
+                ASSERT_NE(0, tables->block_coeff_count_power());
+#endif
+                auto poly(allocate_poly(coeff_count, 1, pool));
+                auto expected(allocate_poly(coeff_count, 1, pool));
+
+                for (size_t i = 0; i < coeff_count; i++)
+                {
+                    poly[i] = static_cast<uint64_t>(rd()) % (modulus.value() << 2);
+                    expected[i] = poly[i];
+                }
+                ntt_negacyclic_harvey_lazy(poly.get(), *tables);
+                tables->ntt_handler().transform_to_rev(
+                    expected.get(), coeff_count_power, tables->get_from_root_powers());
+                for (size_t i = 0; i < coeff_count; i++)
+                {
+                    ASSERT_EQ(expected[i], poly[i]);
+                }
+
+                for (size_t i = 0; i < coeff_count; i++)
+                {
+                    poly[i] = static_cast<uint64_t>(rd()) % (modulus.value() << 1);
+                    expected[i] = poly[i];
+                }
+                inverse_ntt_negacyclic_harvey_lazy(poly.get(), *tables);
+                MultiplyUIntModOperand inv_degree_modulo = tables->inv_degree_modulo();
+                tables->ntt_handler().transform_from_rev(
+                    expected.get(), coeff_count_power, tables->get_from_inv_root_powers(), &inv_degree_modulo);
+                for (size_t i = 0; i < coeff_count; i++)
+                {
+                    ASSERT_EQ(expected[i], poly[i]);
+                }
+            }
+        }
+
+#ifndef SEAL_USE_INTEL_HEXL
+        TEST(NTTTablesTest, BlockedNegacyclicNTTStepsTest)
+        {
+            MemoryPoolHandle pool = MemoryPoolHandle::Global();
+            Pointer<NTTTables> tables;
+            random_device rd;
+
+            int coeff_count_power = 15;
+            size_t coeff_count = size_t(1) << coeff_count_power;
+            Modulus modulus(get_prime(uint64_t(2) << coeff_count_power, 60));
+            ASSERT_NO_THROW(tables = allocate<NTTTables>(pool, coeff_count_power, modulus, pool));
+            int log_block = tables->block_coeff_count_power();
+            ASSERT_NE(0, log_block);
+            size_t block_size = size_t(1) << log_block;
+            size_t block_count = coeff_count >> log_block;
+            MultiplyUIntModOperand inv_degree_modulo = tables->inv_degree_modulo();
+            const auto &handler = tables->ntt_handler();
+            auto poly(allocate_poly(coeff_count, 1, pool));
+            auto expected(allocate_poly(coeff_count, 1, pool));
+
+            // Column iterations followed by row iterations are the full lazy transform, bit for bit
+            for (size_t i = 0; i < coeff_count; i++)
+            {
+                poly[i] = static_cast<uint64_t>(rd()) % (modulus.value() << 2);
+                expected[i] = poly[i];
+            }
+            handler.transform_columns_to_rev(
+                poly.get(), coeff_count_power - log_block, block_size, tables->get_from_root_powers());
+            for (size_t block = 0; block < block_count; block++)
+            {
+                handler.transform_to_rev(
+                    poly.get() + block * block_size, log_block,
+                    tables->get_from_block_root_powers() + block * block_size);
+            }
+            handler.transform_to_rev(expected.get(), coeff_count_power, tables->get_from_root_powers());
+            for (size_t i = 0; i < coeff_count; i++)
+            {
+                ASSERT_EQ(expected[i], poly[i]);
+            }
+
+            for (size_t i = 0; i < coeff_count; i++)
+            {
+                poly[i] = static_cast<uint64_t>(rd()) % (modulus.value() << 1);
+                expected[i] = poly[i];
+            }
+            for (size_t block = 0; block < block_count; block++)
+            {
+                handler.transform_from_rev(
+                    poly.get() + block * block_size, log_block,
+                    tables->get_from_block_inv_root_powers() + block * block_size);
+            }
+            handler.transform_columns_from_rev(
+                poly.get(), coeff_count_power - log_block, block_size,
+                tables->get_from_inv_root_powers() + (coeff_count - block_count), &inv_degree_modulo);
+            handler.transform_from_rev(
+                expected.get(), coeff_count_power, tables->get_from_inv_root_powers(), &inv_degree_modulo);
+            for (size_t i = 0; i < coeff_count; i++)
+            {
+                ASSERT_EQ(expected[i], poly[i]);
+            }
+        }
+#endif
+
+#if defined(SEAL_USE_AVX2) || defined(SEAL_USE_AVX512)
+        TEST(NTTTablesTest, NegacyclicNTTSIMDTest)
+        {
+            MemoryPoolHandle pool = MemoryPoolHandle::Global();
+            Pointer<NTTTables> tables;
+            random_device rd;
+
+            using transform_type =
+                void (*)(uint64_t *, size_t, size_t, int, const MultiplyUIntModOperand *, const Modulus &);
+            using inverse_transform_type = void (*)(
+                uint64_t *, size_t, size_t, int, const MultiplyUIntModOperand *, const MultiplyUIntModOperand *,
+                const Modulus &);
+            using columns_transform_type =
+                void (*)(uint64_t *, int, size_t, const MultiplyUIntModOperand *, const Modulus &);
+            using inverse_columns_transform_type = void (*)(
+                uint64_t *, int, size_t, const MultiplyUIntModOperand *, const MultiplyUIntModOperand &,
+                const Modulus &);
+
+            // Lazy outputs below bound must match the scalar implementation exactly, or only modulo the modulus when
+            // the kernel multiplies differently for moduli of at most congruent_bit_count_max bits
+            auto test_ntt = [&](int min_coeff_count_power, int congruent_bit_count_max, transform_type forward,
+                                inverse_transform_type inverse, columns_transform_type forward_columns,
+                                inverse_columns_transform_type inverse_columns) {
+                for (int coeff_count_power = min_coeff_count_power; coeff_count_power <= 12; coeff_count_power++)
+                {
+                    for (int bit_size : { 20, 30, 40, 50, 60, 61 })
+                    {
+                        size_t coeff_count = size_t(1) << coeff_count_power;
+                        Modulus modulus(get_prime(uint64_t(2) << coeff_count_power, bit_size));
+                        bool exact = bit_size > congruent_bit_count_max;
+                        auto matches = [&](uint64_t expected_value, uint64_t value, uint64_t bound) {
+                            return exact ? expected_value == value
+                                         : value < bound && expected_value % modulus.value() ==
+                                                                value % modulus.value();
+                        };
+                        ASSERT_NO_THROW(tables = allocate<NTTTables>(pool, coeff_count_power, modulus, pool));
+                        const auto &handler = tables->ntt_handler();
+                        MultiplyUIntModOperand inv_degree_modulo = tables->inv_degree_modulo();
+                        auto poly(allocate_poly(coeff_count, 3, pool));
+                        auto expected(allocate_poly(coeff_count, 3, pool));
+
+                        // Batches of three vectors
+                        for (size_t i = 0; i < 3 * coeff_count; i++)
+                        {
+                            poly[i] = static_cast<uint64_t>(rd()) % (modulus.value() << 2);
+                            expected[i] = poly[i];
+                        }
+                        forward(poly.get(), 3, coeff_count, coeff_count_power, tables->get_from_root_powers(), modulus);
+                        for (size_t k = 0; k < 3; k++)
+                        {
+                            handler.transform_to_rev(
+                                expected.get() + k * coeff_count, coeff_count_power, tables->get_from_root_powers());
+                        }
+                        for (size_t i = 0; i < 3 * coeff_count; i++)
+                        {
+                            ASSERT_TRUE(matches(expected[i], poly[i], modulus.value() << 2));
+                        }
+
+                        for (size_t i = 0; i < 3 * coeff_count; i++)
+                        {
+                            poly[i] = static_cast<uint64_t>(rd()) % (modulus.value() << 1);
+                            expected[i] = poly[i];
+                        }
+                        inverse(
+                            poly.get(), 3, coeff_count, coeff_count_power, tables->get_from_inv_root_powers(),
+                            &inv_degree_modulo, modulus);
+                        for (size_t k = 0; k < 3; k++)
+                        {
+                            handler.transform_from_rev(
+                                expected.get() + k * coeff_count, coeff_count_power,
+                                tables->get_from_inv_root_powers(), &inv_degree_modulo);
+                        }
+                        for (size_t i = 0; i < 3 * coeff_count; i++)
+                        {
+                            ASSERT_TRUE(matches(expected[i], poly[i], modulus.value() << 1));
+                        }
+
+                        // Column iterations with tiles of 16 columns
+                        if (coeff_count_power < 5)
+                        {
+                            continue;
+                        }
+                        int log_height = coeff_count_power - 4;
+                        size_t height = size_t(1) << log_height;
+                        for (size_t i = 0; i < coeff_count; i++)
+                        {
+                            poly[i] = static_cast<uint64_t>(rd()) % (modulus.value() << 2);
+                            expected[i] = poly[i];
+                        }
+                        forward_columns(poly.get(), log_height, 16, tables->get_from_root_powers(), modulus);
+                        handler.transform_columns_to_rev(
+                            expected.get(), log_height, 16, tables->get_from_root_powers());
+                        for (size_t i = 0; i < coeff_count; i++)
+                        {
+                            ASSERT_TRUE(matches(expected[i], poly[i], modulus.value() << 2));
+                        }
+
+                        for (size_t i = 0; i < coeff_count; i++)
+                        {
+                            poly[i] = static_cast<uint64_t>(rd()) % (modulus.value() << 1);
+                            expected[i] = poly[i];
+                        }
+                        const MultiplyUIntModOperand *inv_roots =
+                            tables->get_from_inv_root_powers() + (coeff_count - height);
+                        inverse_columns(poly.get(), log_height, 16, inv_roots, inv_degree_modulo, modulus);
+                        handler.transform_columns_from_rev(
+                            expected.get(), log_height, 16, inv_roots, &inv_degree_modulo);
+                        for (size_t i = 0; i < coeff_count; i++)
+                        {
+                            ASSERT_TRUE(matches(expected[i], poly[i], modulus.value() << 1));
+                        }
+                    }
+                }
+            };
+
+#ifdef SEAL_USE_AVX2
+            if (get_supported_simd_level() >= simd_level_type::avx2)
+            {
+                test_ntt(
+                    3, SEAL_FMA_MOD_BIT_COUNT_MAX, ntt_transform_to_rev_avx2, ntt_transform_from_rev_avx2,
+                    ntt_transform_columns_to_rev_avx2, ntt_transform_columns_from_rev_avx2);
+            }
+#endif
+#ifdef SEAL_USE_AVX512
+            if (get_supported_simd_level() >= simd_level_type::avx512)
+            {
+                test_ntt(
+                    4, SEAL_SMALL_MOD_BIT_COUNT_MAX, ntt_transform_to_rev_avx512, ntt_transform_from_rev_avx512,
+                    ntt_transform_columns_to_rev_avx512, ntt_transform_columns_from_rev_avx512);
+            }
+#endif
+        }
+#endif
     } // namespace util
 } // namespace sealtest
@@ -2,11 +2,16 @@
 // Licensed under the MIT license.
 
 #include "seal/util/defines.h"
+#include "seal/util/numth.h"
 #include "seal/util/polyarithsmallmod.h"
 #include "seal/util/polycore.h"
+#include "seal/util/simd.h"
 #include "seal/util/uintcore.h"
 #include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
 #include "gtest/gtest.h"
 
 using namespace seal;
@@ -639,6 +644,234 @@ namespace sealtest
             }
         }
 
+        TEST(PolyArithSmallMod, DyadicProductMontgomeryCoeffMod)
+        {
+            MemoryPool &pool = *global_variables::global_memory_pool;
+            {
+                SEAL_ALLOCATE_ZERO_GET_RNS_ITER(poly1, 3, 2, pool);
+                SEAL_ALLOCATE_ZERO_GET_RNS_ITER(poly2, 3, 2, pool);
+                SEAL_ALLOCATE_ZERO_GET_RNS_ITER(result, 3, 2, pool);
+                vector<Modulus> mod{ 13, 7 };
+
+                poly1[0][0] = 1;
+                poly1[0][1] = 2;
+                poly1[0][2] = 1;
+                poly1[1][0] = 2;
+                poly1[1][1] = 1;
+                poly1[1][2] = 2;
+
+                poly2[0][0] = 2;
+                poly2[0][1] = 3;
+                poly2[0][2] = 4;
+                poly2[1][0] = 2;
+                poly2[1][1] = 3;
+                poly2[1][2] = 4;
+
+                to_montgomery_poly_coeffmod(poly2, 2, mod, poly2);
+                ASSERT_EQ(to_montgomery(3, mod[0]), poly2[0][1]);
+                ASSERT_EQ(to_montgomery(4, mod[1]), poly2[1][2]);
+
+                dyadic_product_montgomery_coeffmod(poly1, poly2, 2, mod, result);
+                ASSERT_EQ(2ULL, result[0][0]);
+                ASSERT_EQ(6ULL, result[0][1]);
+                ASSERT_EQ(4ULL, result[0][2]);
+                ASSERT_EQ(4ULL, result[1][0]);
+                ASSERT_EQ(3ULL, result[1][1]);
+                ASSERT_EQ(1ULL, result[1][2]);
+            }
+            {
+                // Compares with the Barrett reduction of dyadic_product_coeffmod for every kernel; the first operand
+                // may be any 64-bit integer, and 37 coefficients exercise the remainder loops
+                random_device rd;
+                auto random_uint64 = [&]() {
+                    return (static_cast<uint64_t>(rd()) << 32) | static_cast<uint64_t>(rd());
+                };
+                size_t coeff_count = 37;
+                SEAL_ALLOCATE_GET_COEFF_ITER(poly1, coeff_count, pool);
+                SEAL_ALLOCATE_GET_COEFF_ITER(poly2, coeff_count, pool);
+                SEAL_ALLOCATE_GET_COEFF_ITER(poly2_montgomery, coeff_count, pool);
+                SEAL_ALLOCATE_GET_COEFF_ITER(expected, coeff_count, pool);
+                SEAL_ALLOCATE_GET_COEFF_ITER(result, coeff_count, pool);
+
+                vector<void (*)(ConstCoeffIter, ConstCoeffIter, size_t, const Modulus &, CoeffIter)> kernels{
+                    dyadic_product_montgomery_coeffmod
+                };
+#ifdef SEAL_USE_AVX2
+                if (get_supported_simd_level() >= simd_level_type::avx2)
+                {
+                    kernels.push_back(dyadic_product_montgomery_coeffmod_avx2);
+                }
+#endif
+#ifdef SEAL_USE_AVX512
+                if (get_supported_simd_level() >= simd_level_type::avx512)
+                {
+                    kernels.push_back(dyadic_product_montgomery_coeffmod_avx512);
+                }
+#endif
+                for (int bit_size : { 2, 20, 30, 40, 50, 60, 61 })
+                {
+                    Modulus mod(get_prime(2, bit_size));
+                    for (size_t j = 0; j < coeff_count; j++)
+                    {
+                        poly1[j] = random_uint64();
+                        poly2[j] = barrett_reduce_64(random_uint64(), mod);
+                    }
+                    poly1[0] = numeric_limits<uint64_t>::max();
+                    poly2[0] = mod.value() - 1;
+
+                    to_montgomery_poly_coeffmod(poly2, coeff_count, mod, poly2_montgomery);
+                    dyadic_product_coeffmod(poly1, poly2, coeff_count, mod, expected);
+                    for (size_t j = 0; j < coeff_count; j++)
+                    {
+                        ASSERT_EQ(to_montgomery(poly2[j], mod), poly2_montgomery[j]);
+                    }
+                    for (auto kernel : kernels)
+                    {
+                        kernel(poly1, poly2_montgomery, coeff_count, mod, result);
+                        for (size_t j = 0; j < coeff_count; j++)
+                        {
+                            ASSERT_EQ(expected[j], result[j]);
+                        }
+                    }
+                }
+            }
+        }
+
+        TEST(PolyArithSmallMod, MultiplyAccumulatePolyScalarCoeffMod)
+        {
+            MemoryPool &pool = *global_variables::global_memory_pool;
+            {
+                SEAL_ALLOCATE_ZERO_GET_RNS_ITER(poly_array, 3, 2, pool);
+                SEAL_ALLOCATE_ZERO_GET_COEFF_ITER(scalars, 2, pool);
+                SEAL_ALLOCATE_ZERO_GET_COEFF_ITER(result, 3, pool);
+                Modulus mod(13);
+
+                poly_array[0][0] = 1;
+                poly_array[0][1] = 2;
+                poly_array[0][2] = 12;
+                poly_array[1][0] = 5;
+                poly_array[1][1] = 0;
+                poly_array[1][2] = 12;
+                scalars[0] = 3;
+                scalars[1] = 4;
+
+                multiply_accumulate_poly_scalar_coeffmod(poly_array, scalars, 2, mod, result);
+                ASSERT_EQ(10ULL, result[0]);
+                ASSERT_EQ(6ULL, result[1]);
+                ASSERT_EQ(6ULL, result[2]);
+            }
+            {
+                // Long sums of large values must be folded before the accumulator overflows
+                random_device rd;
+                for (size_t count : { size_t(1), size_t(16), size_t(64), size_t(65), size_t(200) })
+                {
+                    Modulus mod(get_prime(2, 61));
+                    uint64_t max_value = (uint64_t(1) << 61) - 1;
+                    SEAL_ALLOCATE_GET_RNS_ITER(poly_array, 13, count, pool);
+                    SEAL_ALLOCATE_GET_COEFF_ITER(scalars, count, pool);
+                    SEAL_ALLOCATE_GET_COEFF_ITER(result, 13, pool);
+                    auto column(allocate_uint(count, pool));
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        scalars[i] = max_value - (static_cast<uint64_t>(rd()) & 0xFF);
+                        for (size_t j = 0; j < 13; j++)
+                        {
+                            poly_array[i][j] = max_value - (static_cast<uint64_t>(rd()) & 0xFF);
+                        }
+                    }
+
+                    multiply_accumulate_poly_scalar_coeffmod(poly_array, scalars, count, mod, result);
+                    for (size_t j = 0; j < 13; j++)
+                    {
+                        for (size_t i = 0; i < count; i++)
+                        {
+                            column[i] = poly_array[i][j];
+                        }
+                        ASSERT_EQ(dot_product_mod(column.get(), scalars, count, mod), result[j]);
+                    }
+                }
+            }
+        }
+
+        TEST(PolyArithSmallMod, DyadicProductAccumulateCoeffMod)
+        {
+            MemoryPool &pool = *global_variables::global_memory_pool;
+            {
+                SEAL_ALLOCATE_ZERO_GET_RNS_ITER(poly_array1, 3, 2, pool);
+                SEAL_ALLOCATE_ZERO_GET_RNS_ITER(poly_array2, 3, 2, pool);
+                Modulus mod(13);
+
+                poly_array1[0][0] = 1;
+                poly_array1[0][1] = 2;
+                poly_array1[0][2] = 12;
+                poly_array1[1][0] = 5;
+                poly_array1[1][1] = 0;
+                poly_array1[1][2] = 12;
+                poly_array2[0][0] = 3;
+                poly_array2[0][1] = 7;
+                poly_array2[0][2] = 12;
+                poly_array2[1][0] = 4;
+                poly_array2[1][1] = 9;
+                poly_array2[1][2] = 1;
+
+                ConstCoeffIter operands1[2]{ poly_array1[0], poly_array1[1] };
+                ConstCoeffIter operands2[2]{ poly_array2[0], poly_array2[1] };
+                SEAL_ALLOCATE_ZERO_GET_COEFF_ITER(result, 3, pool);
+                dyadic_product_accumulate_coeffmod(operands1, operands2, 2, 3, mod, result);
+                ASSERT_EQ(10ULL, result[0]);
+                ASSERT_EQ(1ULL, result[1]);
+                ASSERT_EQ(0ULL, result[2]);
+
+                // The result may overlap with an operand
+                dyadic_product_accumulate_coeffmod(operands1, operands2, 2, 3, mod, poly_array1[0]);
+                ASSERT_EQ(10ULL, poly_array1[0][0]);
+                ASSERT_EQ(1ULL, poly_array1[0][1]);
+                ASSERT_EQ(0ULL, poly_array1[0][2]);
+
+                dyadic_product_accumulate_coeffmod(operands1, operands2, 0, 3, mod, result);
+                ASSERT_EQ(0ULL, result[0]);
+                ASSERT_EQ(0ULL, result[1]);
+                ASSERT_EQ(0ULL, result[2]);
+            }
+            {
+                // Long sums of large values must be folded before the accumulator overflows
+                random_device rd;
+                for (size_t count : { size_t(1), size_t(16), size_t(64), size_t(65), size_t(200) })
+                {
+                    Modulus mod(get_prime(2, 61));
+                    uint64_t max_value = (uint64_t(1) << 61) - 1;
+                    SEAL_ALLOCATE_GET_RNS_ITER(poly_array1, 13, count, pool);
+                    SEAL_ALLOCATE_GET_RNS_ITER(poly_array2, 13, count, pool);
+                    SEAL_ALLOCATE_GET_COEFF_ITER(result, 13, pool);
+                    vector<ConstCoeffIter> operands1(count);
+                    vector<ConstCoeffIter> operands2(count);
+                    auto column1(allocate_uint(count, pool));
+                    auto column2(allocate_uint(count, pool));
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        for (size_t j = 0; j < 13; j++)
+                        {
+                            poly_array1[i][j] = max_value - (static_cast<uint64_t>(rd()) & 0xFF);
+                            poly_array2[i][j] = max_value - (static_cast<uint64_t>(rd()) & 0xFF);
+                        }
+                        operands1[i] = poly_array1[i];
+                        operands2[i] = poly_array2[i];
+                    }
+
+                    dyadic_product_accumulate_coeffmod(operands1.data(), operands2.data(), count, 13, mod, result);
+                    for (size_t j = 0; j < 13; j++)
+                    {
+                        for (size_t i = 0; i < count; i++)
+                        {
+                            column1[i] = poly_array1[i][j];
+                            column2[i] = poly_array2[i][j];
+                        }
+                        ASSERT_EQ(dot_product_mod(column1.get(), column2.get(), count, mod), result[j]);
+                    }
+                }
+            }
+        }
+
         TEST(PolyArithSmallMod, PolyInftyNormCoeffMod)
         {
             MemoryPool &pool = *global_variables::global_memory_pool;
@@ -880,5 +1113,118 @@ namespace sealtest
                 ASSERT_EQ(1ULL, result[1][1][3]);
             }
         }
+
+#if defined(SEAL_USE_AVX2) || defined(SEAL_USE_AVX512)
+        TEST(PolyArithSmallMod, SIMDKernels)
+        {
+            MemoryPool &pool = *global_variables::global_memory_pool;
+            random_device rd;
+            auto random_uint64 = [&]() { return (static_cast<uint64_t>(rd()) << 32) | static_cast<uint64_t>(rd()); };
+
+            // Compares every SIMD kernel with the scalar arithmetic; 37 coefficients exercise the remainder loops
+            auto test_kernels = [&](void (*modulo)(ConstCoeffIter, size_t, const Modulus &, CoeffIter),
+                                    void (*multiply_scalar)(
+                                        ConstCoeffIter, size_t, MultiplyUIntModOperand, const Modulus &, CoeffIter),
+                                    void (*dyadic)(ConstCoeffIter, ConstCoeffIter, size_t, const Modulus &, CoeffIter),
+                                    void (*multiply_accumulate)(
+                                        ConstRNSIter, ConstCoeffIter, size_t, const Modulus &, CoeffIter)) {
+                size_t coeff_count = 37;
+                size_t count = 70;
+                for (int bit_size : { 2, 20, 30, 40, 50, 60, 61 })
+                {
+                    Modulus mod(get_prime(2, bit_size));
+                    SEAL_ALLOCATE_GET_RNS_ITER(poly, coeff_count, count, pool);
+                    SEAL_ALLOCATE_GET_COEFF_ITER(result, coeff_count, pool);
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        for (size_t j = 0; j < coeff_count; j++)
+                        {
+                            poly[i][j] = barrett_reduce_64(random_uint64(), mod);
+                        }
+                    }
+
+                    // Arbitrary 64-bit inputs
+                    SEAL_ALLOCATE_GET_COEFF_ITER(raw, coeff_count, pool);
+                    for (size_t j = 0; j < coeff_count; j++)
+                    {
+                        raw[j] = random_uint64();
+                    }
+                    raw[0] = numeric_limits<uint64_t>::max();
+                    modulo(raw, coeff_count, mod, result);
+                    for (size_t j = 0; j < coeff_count; j++)
+                    {
+                        ASSERT_EQ(barrett_reduce_64(raw[j], mod), result[j]);
+                    }
+
+                    MultiplyUIntModOperand scalar;
+                    scalar.set(mod.value() - 1, mod);
+                    multiply_scalar(raw, coeff_count, scalar, mod, result);
+                    for (size_t j = 0; j < coeff_count; j++)
+                    {
+                        ASSERT_EQ(multiply_uint_mod(raw[j], scalar, mod), result[j]);
+                    }
+
+                    // Reduced inputs also take the 32-bit word or double-precision paths for small moduli
+                    scalar.set(barrett_reduce_64(random_uint64(), mod), mod);
+                    multiply_scalar(poly[0], coeff_count, scalar, mod, result);
+                    for (size_t j = 0; j < coeff_count; j++)
+                    {
+                        ASSERT_EQ(multiply_uint_mod(poly[0][j], scalar, mod), result[j]);
+                    }
+
+                    dyadic(poly[0], poly[1], coeff_count, mod, result);
+                    for (size_t j = 0; j < coeff_count; j++)
+                    {
+                        ASSERT_EQ(multiply_uint_mod(poly[0][j], poly[1][j], mod), result[j]);
+                    }
+
+                    SEAL_ALLOCATE_GET_COEFF_ITER(scalars, count, pool);
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        scalars[i] = barrett_reduce_64(random_uint64(), mod);
+                    }
+                    multiply_accumulate(poly, scalars, count, mod, result);
+                    for (size_t j = 0; j < coeff_count; j++)
+                    {
+                        uint64_t expected = 0;
+                        for (size_t i = 0; i < count; i++)
+                        {
+                            expected = multiply_add_uint_mod(poly[i][j], scalars[i], expected, mod);
+                        }
+                        ASSERT_EQ(expected, result[j]);
+                    }
+                }
+            };
+
+#ifdef SEAL_USE_AVX2
+            if (get_supported_simd_level() >= simd_level_type::avx2)
+            {
+                test_kernels(
+                    modulo_poly_coeffs_avx2, multiply_poly_scalar_coeffmod_avx2, dyadic_product_coeffmod_avx2,
+                    multiply_accumulate_poly_scalar_coeffmod_avx2);
+            }
+#endif
+#ifdef SEAL_USE_AVX512
+            if (get_supported_simd_level() >= simd_level_type::avx512)
+            {
+                test_kernels(
+                    modulo_poly_coeffs_avx512, multiply_poly_scalar_coeffmod_avx512, dyadic_product_coeffmod_avx512,
+                    multiply_accumulate_poly_scalar_coeffmod_avx512);
+            }
+#endif
+        }
+
+        TEST(PolyArithSmallMod, SelectSIMDLevel)
+        {
+            simd_level_type supported = get_supported_simd_level();
+            ASSERT_EQ(supported, select_simd_level(nullptr, supported));
+            ASSERT_EQ(supported, select_simd_level("unknown", supported));
+            ASSERT_EQ(simd_level_type::none, select_simd_level("none", supported));
+            ASSERT_EQ(simd_level_type::none, select_simd_level("avx512", simd_level_type::none));
+            ASSERT_EQ(simd_level_type::avx2, select_simd_level("avx512", simd_level_type::avx2));
+            ASSERT_EQ(simd_level_type::avx2, select_simd_level("avx2", simd_level_type::avx512));
+            ASSERT_TRUE(global_variables::simd_level <= supported);
+        }
+#endif
     } // namespace util
 } // namespace sealtest
@@ -437,6 +437,47 @@ namespace sealtest
             }
         }
 
+        TEST(BaseConverterTest, ConvertArrayBlocks)
+        {
+            auto pool = MemoryManager::GetPool();
+
+            // Enough coefficients and input primes for several blocks, with a partial block and partial vectors at
+            // the end; the result must match the conversion of each coefficient on its own
+            size_t count = 1001;
+            auto primes = get_primes(1024 * 2, 60, 15);
+            RNSBase ibase(vector<Modulus>(primes.begin(), primes.begin() + 12), pool);
+            RNSBase obase(vector<Modulus>(primes.begin() + 12, primes.end()), pool);
+            BaseConverter bct(ibase, obase, pool);
+
+            vector<uint64_t> in(count * ibase.size());
+            uint64_t seed = 1;
+            for (size_t i = 0; i < ibase.size(); i++)
+            {
+                for (size_t j = 0; j < count; j++)
+                {
+                    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                    in[i * count + j] = seed % ibase[i].value();
+                }
+            }
+            vector<uint64_t> out(count * obase.size());
+            bct.fast_convert_array(ConstRNSIter(in.data(), count), RNSIter(out.data(), count), pool);
+
+            vector<uint64_t> in_coeff(ibase.size());
+            vector<uint64_t> out_coeff(obase.size());
+            for (size_t j = 0; j < count; j++)
+            {
+                for (size_t i = 0; i < ibase.size(); i++)
+                {
+                    in_coeff[i] = in[i * count + j];
+                }
+                bct.fast_convert(in_coeff.data(), out_coeff.data(), pool);
+                for (size_t i = 0; i < obase.size(); i++)
+                {
+                    ASSERT_EQ(out_coeff[i], out[i * count + j]);
+                }
+            }
+        }
+
         TEST(RNSToolTest, Initialize)
         {
             auto pool = MemoryManager::GetPool();
@@ -901,6 +942,51 @@ namespace sealtest
 #endif
         }
 
+        TEST(RNSToolTest, HPSScaleAndRound)
+        {
+            auto pool = MemoryManager::GetPool();
+            Pointer<RNSTool> rns_tool;
+            size_t poly_modulus_degree = 2;
+            Modulus plain_t = 3;
+            ASSERT_NO_THROW(
+                rns_tool = allocate<RNSTool>(pool, poly_modulus_degree, RNSBase({ 5, 13 }, pool), plain_t, pool, true));
+            ASSERT_EQ(1ULL, rns_tool->base_P()->size());
+            ASSERT_EQ(3ULL, rns_tool->base_qP()->size());
+            uint64_t p = (*rns_tool->base_P())[0].value();
+
+            // The centered representatives of 3 and 64 (i.e., -1) modulo q = 65 are extended to P
+            vector<uint64_t> in_q{ 3, 4, 3, 12 };
+            vector<uint64_t> out_P(poly_modulus_degree);
+            rns_tool->hps_extend(ConstRNSIter(in_q.data(), poly_modulus_degree), RNSIter(out_P.data(), 2), pool);
+            ASSERT_EQ(3ULL, out_P[0]);
+            ASSERT_EQ(p - 1, out_P[1]);
+
+            // round(3/65 * 100) = 5 and round(3/65 * -100) = -5
+            vector<uint64_t> in_qP{ 0, 0, 9, 4, 100, p - 100 };
+            vector<uint64_t> out_q(poly_modulus_degree * 2);
+            rns_tool->hps_scale_and_round(
+                ConstRNSIter(in_qP.data(), poly_modulus_degree), RNSIter(out_q.data(), poly_modulus_degree), pool);
+            ASSERT_EQ(0ULL, out_q[0]);
+            ASSERT_EQ(0ULL, out_q[1]);
+            ASSERT_EQ(5ULL, out_q[2]);
+            ASSERT_EQ(8ULL, out_q[3]);
+
+            // round(3/65 * 10) = 0 and round(3/65 * 11) = 1; residues modulo q may be lazily reduced
+            in_qP = { 0, 6, 10 + 13, 11, 10, 11 };
+            rns_tool->hps_scale_and_round(
+                ConstRNSIter(in_qP.data(), poly_modulus_degree), RNSIter(out_q.data(), poly_modulus_degree), pool);
+            ASSERT_EQ(0ULL, out_q[0]);
+            ASSERT_EQ(1ULL, out_q[1]);
+            ASSERT_EQ(0ULL, out_q[2]);
+            ASSERT_EQ(1ULL, out_q[3]);
+
+            // HPS needs a plain modulus
+            ASSERT_THROW(
+                rns_tool =
+                    allocate<RNSTool>(pool, poly_modulus_degree, RNSBase({ 5, 13 }, pool), Modulus(0), pool, true),
+                logic_error);
+        }
+
         TEST(RNSToolTest, DivideAndRoundQLastInplace)
         {
             // This function approximately divides the input values by the last prime in the base q.
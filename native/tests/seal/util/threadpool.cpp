@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/threadpool.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace seal::util;
+using namespace std;
+
+namespace sealtest
+{
+    namespace util
+    {
+        TEST(ThreadPoolTest, ParallelFor)
+        {
+            ASSERT_THROW(ThreadPool(0), invalid_argument);
+
+            for (size_t thread_count : { 1, 2, 4 })
+            {
+                ThreadPool thread_pool(thread_count);
+                ASSERT_EQ(thread_count, thread_pool.thread_count());
+
+                // Every iteration runs exactly once
+                for (size_t count : { 0, 1, 3, 100 })
+                {
+                    vector<atomic<int>> calls(count);
+                    thread_pool.parallel_for(count, [&](size_t i) { calls[i]++; });
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        ASSERT_EQ(1, calls[i].load());
+                    }
+                }
+
+                // Nested loops run on the calling thread
+                atomic<size_t> sum{ 0 };
+                thread_pool.parallel_for(8, [&](size_t i) {
+                    thread_pool.parallel_for(8, [&](size_t j) { sum += i * 8 + j; });
+                });
+                ASSERT_EQ(size_t(64 * 63 / 2), sum.load());
+
+                // The first exception is rethrown and the pool remains usable
+                ASSERT_THROW(
+                    thread_pool.parallel_for(
+                        16,
+                        [](size_t i) {
+                            if (i == 5)
+                            {
+                                throw logic_error("iteration failed");
+                            }
+                        }),
+                    logic_error);
+                atomic<size_t> count{ 0 };
+                thread_pool.parallel_for(16, [&](size_t) { count++; });
+                ASSERT_EQ(size_t(16), count.load());
+            }
+        }
+    } // namespace util
+} // namespace sealtest
@@ -483,6 +483,44 @@ namespace sealtest
             ASSERT_EQ(2305843009211596802ULL, multiply_uint_mod_lazy(2305843009211596800ULL, y, mod));
         }
 
+        TEST(UIntArithSmallMod, Montgomery)
+        {
+            Modulus mod(10);
+            ASSERT_EQ(0ULL, mod.montgomery_inv());
+
+            mod = 13;
+            ASSERT_EQ(1ULL, mod.value() * mod.montgomery_inv());
+            ASSERT_EQ(3ULL, to_montgomery(1, mod));
+            ASSERT_EQ(6ULL, to_montgomery(2, mod));
+            ASSERT_EQ(1ULL, from_montgomery(3, mod));
+            ASSERT_EQ(0ULL, from_montgomery(0, mod));
+            ASSERT_EQ(2ULL, multiply_uint_mod_montgomery(7, to_montgomery(4, mod), mod));
+            ASSERT_EQ(
+                multiply_uint_mod(0xFFFFFFFFFFFFFFFFULL, 12, mod),
+                multiply_uint_mod_montgomery(0xFFFFFFFFFFFFFFFFULL, to_montgomery(12, mod), mod));
+
+            // Compares with Barrett reduction
+            mod = 2305843009211596801ULL;
+            ASSERT_EQ(1ULL, mod.value() * mod.montgomery_inv());
+            uint64_t values[]{ 0, 1, 2, 1152921504605798400ULL, 1152921504605798401ULL, 2305843009211596800ULL,
+                               0xFFFFFFFFFFFFFFFFULL };
+            for (uint64_t x : values)
+            {
+                for (uint64_t y : values)
+                {
+                    uint64_t y_reduced = barrett_reduce_64(y, mod);
+                    ASSERT_EQ(y_reduced, from_montgomery(to_montgomery(y_reduced, mod), mod));
+                    ASSERT_EQ(
+                        multiply_uint_mod(x, y_reduced, mod),
+                        multiply_uint_mod_montgomery(x, to_montgomery(y_reduced, mod), mod));
+
+                    unsigned long long z[2];
+                    multiply_uint64(x, y_reduced, z);
+                    ASSERT_EQ(barrett_reduce_128(z, mod), to_montgomery(montgomery_reduce_128(z, mod), mod));
+                }
+            }
+        }
+
         TEST(UIntArithSmallMod, MultiplyAddMod2)
         {
             Modulus mod(7);